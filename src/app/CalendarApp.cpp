@@ -1,17 +1,21 @@
 #include "CalendarApp.h"
 #include "backends/local/DirectoryBackend.h"
+#include "core/data/SynchronizedStorage.h"
 #ifdef AKONADI_BACKEND_AVAILABLE
 #include "backends/akonadi/AkonadiCalendarBackend.h"
 #endif
+#include <QCoreApplication>
 #include <QDebug>
 #include <QDir>
+#include <QPointer>
 #include <QStandardPaths>
 
 using namespace PersonalCalendar::Core;
 using namespace PersonalCalendar::Local;
 
 CalendarApp::CalendarApp(QObject *parent)
-    : QObject(parent), m_eventsModel(new EventsModel(this)), m_monthModel(new MonthModel(this))
+    : QObject(parent), m_executor(std::make_shared<StorageExecutor>()), m_eventsModel(new EventsModel(this)),
+      m_monthModel(new MonthModel(this))
 {
     // Sync models
     connect(m_monthModel, &MonthModel::selectedChanged, this,
@@ -21,14 +25,27 @@ CalendarApp::CalendarApp(QObject *parent)
     m_eventsModel->setSelectedDate(m_monthModel->selected());
 }
 
+CalendarApp::~CalendarApp()
+{
+    // The watcher was created on the storage thread and has to be stopped there,
+    // before this releases the storage and the executor shuts that thread down
+    if (m_localBackend) {
+        auto storage = std::static_pointer_cast<SynchronizedStorage>(m_storage);
+        auto directory = std::static_pointer_cast<DirectoryBackend>(storage->inner());
+        m_executor
+            ->run([storage, directory]() { storage->locked([&directory]() { directory->setWatchEnabled(false); }); })
+            .waitForFinished();
+    }
+    m_operations.reset();
+    m_storage.reset();
+}
+
 void CalendarApp::initialize(const QString &storagePath)
 {
 #ifdef AKONADI_BACKEND_AVAILABLE
     if (qEnvironmentVariable("PERSONAL_CALENDAR_BACKEND") == QLatin1String("akonadi")) {
         qDebug() << "Initializing AkonadiBackend";
-        m_storage = std::make_shared<PersonalCalendar::Akonadi::AkonadiCalendarBackend>(this);
-        m_eventsModel->setStorage(m_storage);
-        m_monthModel->setStorage(m_storage);
+        attachStorage(std::make_shared<PersonalCalendar::Akonadi::AkonadiCalendarBackend>(this));
         m_backendName = QStringLiteral("Akonadi");
         return;
     }
@@ -39,25 +56,160 @@ void CalendarApp::initialize(const QString &storagePath)
         path = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QStringLiteral("/calendars");
     }
 
-    QDir dir(path);
-    if (!dir.exists()) {
-        dir.mkpath(QStringLiteral("."));
-    }
-
     qDebug() << "Initializing DirectoryBackend at:" << path;
-    auto backend = std::make_shared<DirectoryBackend>(path);
-    m_storage = backend;
-
-    if (m_storage->getCalendarIds().isEmpty()) {
-        qDebug() << "Creating default 'Personal' calendar";
-        // Default color Blue
-        backend->createCalendar(QStringLiteral("personal"), QStringLiteral("Personal"));
-        backend->setCalendarColor(QStringLiteral("personal"), QStringLiteral("#2196F3"));
+    loadLocalBackend(path);
+}
+
+void CalendarApp::loadLocalBackend(const QString &path)
+{
+    const int generation = ++m_loadGeneration;
+    setLoadState(true);
+
+    // Progress is reported on the storage thread; hop back to the GUI before touching properties
+    auto onProgress = [this, generation](int loaded, int total, const QString &) {
+        QMetaObject::invokeMethod(
+            this,
+            [this, generation, loaded, total]() {
+                if (generation == m_loadGeneration) setLoadState(true, loaded, total);
+            },
+            Qt::QueuedConnection);
+    };
+
+    m_executor
+        ->run([path, onProgress]() {
+            QDir dir(path);
+            if (!dir.exists()) {
+                dir.mkpath(QStringLiteral("."));
+            }
+
+            auto backend = std::make_shared<DirectoryBackend>(path, true, onProgress);
+            // Mutations only change memory; attachStorage() writes the files outside the lock
+            backend->setDurability(ICSFileBackend::Durability::Manual);
+            if (backend->getCalendarIds().isEmpty()) {
+                qDebug() << "Creating default 'Personal' calendar";
+                // Default color Blue
+                backend->createCalendar(QStringLiteral("personal"), QStringLiteral("Personal"));
+                backend->setCalendarColor(QStringLiteral("personal"), QStringLiteral("#2196F3"));
+                backend->flush();
+            }
+            return backend;
+        })
+        .then(this, [this, generation](const std::shared_ptr<DirectoryBackend> &backend) {
+            // The user switched backends while this one was loading
+            if (generation != m_loadGeneration) return;
+
+            attachStorage(backend);
+            m_backendName = QStringLiteral("Local");
+            setLoadState(false);
+            Q_EMIT backendChanged();
+            m_eventsModel->refresh();
+        });
+}
+
+void CalendarApp::setLoadState(bool loading, int loaded, int total)
+{
+    if (m_loading == loading && m_loadedCalendars == loaded && m_totalCalendars == total) return;
+    m_loading = loading;
+    m_loadedCalendars = loaded;
+    m_totalCalendars = total;
+    Q_EMIT loadingChanged();
+}
+
+void CalendarApp::attachStorage(const ICalendarStoragePtr &backend)
+{
+    // Local files are written on the storage thread so saving never blocks the GUI.
+    // Akonadi jobs already run asynchronously and must stay on the GUI thread.
+    auto directory = std::dynamic_pointer_cast<DirectoryBackend>(backend);
+    m_localBackend = directory != nullptr;
+    if (m_localBackend) {
+        auto storage = std::make_shared<SynchronizedStorage>(backend);
+
+        // The lock covers serializing the changes; the GUI keeps reading while the files are written
+        auto writePending = [storage = storage.get(), directory = directory.get()]() {
+            auto writes = storage->locked([directory]() { return directory->takePendingWrites(); });
+            if (writes.isEmpty()) return;
+            for (auto &write : writes) {
+                ICSFileBackend::writePending(write);
+            }
+            storage->locked([directory, &writes]() { directory->finishPendingWrites(writes); });
+        };
+        storage->setWriteHook(writePending);
+
+        // Pick up edits made by other programs. Watcher and timer callbacks queue behind
+        // pending saves and take the same lock; setup runs under it on the storage thread, which owns the watcher
+        std::weak_ptr<SynchronizedStorage> weakStorage = storage;
+        std::weak_ptr<StorageExecutor> weakExecutor = m_executor;
+        QPointer<CalendarApp> self(this);
+        m_executor->post([self, directory, weakStorage, weakExecutor, writePending]() {
+            auto shared = weakStorage.lock();
+            if (!shared) return;
+            shared->locked([&]() {
+                directory->setCallbackDispatcher([weakStorage, weakExecutor, writePending](std::function<void()> callback) {
+                    if (auto executor = weakExecutor.lock()) {
+                        executor->post([weakStorage, writePending, callback = std::move(callback)]() {
+                            if (auto storage = weakStorage.lock()) {
+                                // A reload would otherwise flush unsaved changes while holding the lock
+                                writePending();
+                                storage->locked(callback);
+                            }
+                        });
+                    }
+                });
+                directory->setChangeCallback([self](const DirectoryBackend::CalendarChanges &) {
+                    // Queue on the application object; the app itself may be gone by the time this runs
+                    QMetaObject::invokeMethod(
+                        QCoreApplication::instance(),
+                        [self]() {
+                            if (!self) return;
+                            self->m_eventsModel->refresh();
+                            self->m_monthModel->refresh();
+                        },
+                        Qt::QueuedConnection);
+                });
+                directory->setWatchEnabled(true);
+            });
+        });
+
+        m_storage = storage;
+        m_operations = std::make_shared<EventOperations>(m_storage, m_executor);
+    } else {
+        m_storage = backend;
+        m_operations = std::make_shared<EventOperations>(m_storage);
     }
 
     m_eventsModel->setStorage(m_storage);
     m_monthModel->setStorage(m_storage);
-    m_backendName = QStringLiteral("Local");
+}
+
+void CalendarApp::runStorageTask(std::function<void()> task)
+{
+    if (!m_localBackend) {
+        task();
+        m_eventsModel->refresh();
+        m_monthModel->refresh();
+        Q_EMIT calendarsChanged();
+        return;
+    }
+    m_executor->run(std::move(task)).then(this, [this]() {
+        m_eventsModel->refresh();
+        m_monthModel->refresh();
+        Q_EMIT calendarsChanged();
+    });
+}
+
+void CalendarApp::setEventTimes(CalendarEvent &event, const QDateTime &start, const QDateTime &end, bool allDay)
+{
+    event.isAllDay = allDay;
+    if (!allDay) {
+        event.startDateTime = start;
+        event.endDateTime = end;
+        return;
+    }
+
+    // The editor picks inclusive days; stored all-day ends are exclusive (RFC 5545 DTEND)
+    const QDate last = qMax(start.date(), end.date());
+    event.startDateTime = QDateTime(start.date(), QTime(0, 0));
+    event.endDateTime = QDateTime(last.addDays(1), QTime(0, 0));
 }
 
 EventsModel *CalendarApp::eventsModel() const
@@ -75,114 +227,160 @@ QString CalendarApp::backendName() const
     return m_backendName;
 }
 
+bool CalendarApp::isLoading() const
+{
+    return m_loading;
+}
+
+int CalendarApp::loadedCalendars() const
+{
+    return m_loadedCalendars;
+}
+
+int CalendarApp::totalCalendars() const
+{
+    return m_totalCalendars;
+}
+
 void CalendarApp::createEvent(const QString &title, const QDateTime &start, const QDateTime &end, bool allDay,
                               const QString &description, const QString &location, const QString &calendarId)
 {
-    if (!m_storage) return;
+    if (!m_operations) return;
 
     auto event = std::make_shared<CalendarEvent>();
     event->title = title;
     event->description = description;
     event->location = location;
-    event->startDateTime = start;
-    event->endDateTime = end;
-    event->isAllDay = allDay;
+    setEventTimes(*event, start, end, allDay);
     event->calendarId = calendarId;
     event->uid = QString::number(QDateTime::currentMSecsSinceEpoch());
 
-    if (m_storage->createEvent(event)) {
-        qDebug() << "Event created:" << title;
-        m_eventsModel->refresh();
-    } else {
-        qWarning() << "Failed to create event";
-    }
+    m_operations->createEvent(
+        event,
+        [this](const CalendarEventPtr &created) {
+            qDebug() << "Event created:" << created->title;
+            m_eventsModel->refresh();
+            m_monthModel->eventChanged(created);
+        },
+        [](const QString &) { qWarning() << "Failed to create event"; });
 }
 
 void CalendarApp::updateEvent(const QString &uid, const QString &title, const QDateTime &start, const QDateTime &end,
                               bool allDay, const QString &description, const QString &location)
 {
-    if (!m_storage) return;
+    if (!m_operations) return;
+
+    auto existing = m_storage->getEvent(uid);
+    if (!existing) return;
 
-    auto event = m_storage->getEvent(uid);
-    if (!event) return;
+    // Edit a copy: the stored instance may still be read by the storage thread
+    auto event = std::make_shared<CalendarEvent>(*existing);
 
     event->title = title;
     event->description = description;
     event->location = location;
-    event->startDateTime = start;
-    event->endDateTime = end;
-    event->isAllDay = allDay;
-
-    if (m_storage->updateEvent(event)) {
-        qDebug() << "Event updated:" << uid;
-        m_eventsModel->refresh();
-    }
+    setEventTimes(*event, start, end, allDay);
+
+    m_operations->updateEvent(
+        event,
+        [this](const CalendarEventPtr &updated) {
+            qDebug() << "Event updated:" << updated->uid;
+            m_eventsModel->refresh();
+            m_monthModel->eventChanged(updated);
+        },
+        nullptr);
 }
 
 void CalendarApp::deleteEvent(const QString &uid)
 {
-    if (m_storage && m_storage->deleteEvent(uid)) {
-        m_eventsModel->refresh();
+    if (!m_operations) return;
+    m_operations->deleteEvent(
+        uid,
+        [this, uid](const CalendarEventPtr &) {
+            m_eventsModel->refresh();
+            m_monthModel->eventRemoved(uid);
+        },
+        nullptr);
+}
+
+QVariantList CalendarApp::suggestTimes(const QDateTime &from, int durationMinutes, int count)
+{
+    QVariantList list;
+    if (!m_storage) return list;
+
+    FreeSlotQuery query;
+    query.start = from;
+    query.end = from.addDays(28);
+    query.durationMinutes = durationMinutes;
+    query.workingHours = WorkingHours::officeHours();
+    query.maxResults = count;
+    query.alignMinutes = 15;
+
+    for (const auto &slot : m_storage->findFreeSlots(query)) {
+        QVariantMap map;
+        map[QStringLiteral("start")] = slot.start;
+        map[QStringLiteral("end")] = slot.end;
+        list.append(map);
     }
+    return list;
 }
 
 void CalendarApp::createCalendar(const QString &name, const QString &color)
 {
-    if (!m_storage) return;
+    if (!m_storage || !m_localBackend) return;
 
-    auto backend = std::dynamic_pointer_cast<DirectoryBackend>(m_storage);
-    if (!backend) return;
+    auto storage = m_storage;
+    runStorageTask([storage, name, color]() {
+        QString id = name.toLower().replace(QStringLiteral(" "), QStringLiteral("-"));
 
-    QString id = name.toLower().replace(QStringLiteral(" "), QStringLiteral("-"));
-    
-    // Ensure unique ID
-    if (backend->getCalendarIds().contains(id)) {
-        id += QString::number(QDateTime::currentMSecsSinceEpoch() % 1000);
-    }
+        // Ensure unique ID
+        if (storage->getCalendarIds().contains(id)) {
+            id += QString::number(QDateTime::currentMSecsSinceEpoch() % 1000);
+        }
 
-    if (backend->createCalendar(id, name)) {
-        backend->setCalendarColor(id, color);
-        qDebug() << "Created calendar:" << name << color;
-    }
+        if (storage->createCalendar(id, name)) {
+            storage->setCalendarColor(id, color);
+            qDebug() << "Created calendar:" << name << color;
+        }
+    });
 }
 
 void CalendarApp::deleteCalendar(const QString &id)
 {
     if (!m_storage) return;
-    m_storage->deleteCalendar(id);
-    m_eventsModel->refresh();
+    auto storage = m_storage;
+    runStorageTask([storage, id]() { storage->deleteCalendar(id); });
 }
 
 void CalendarApp::setCalendarColor(const QString &id, const QString &color)
 {
-    auto backend = std::dynamic_pointer_cast<DirectoryBackend>(m_storage);
-    if (backend) {
-        backend->setCalendarColor(id, color);
-        m_eventsModel->refresh(); // Refresh needed if events use calendar color
+    if (m_storage && m_localBackend) {
+        // Refreshed afterwards: events use the calendar color
+        auto storage = m_storage;
+        runStorageTask([storage, id, color]() { storage->setCalendarColor(id, color); });
     }
 }
 
 void CalendarApp::setCalendarVisibility(const QString &id, bool visible)
 {
-    auto backend = std::dynamic_pointer_cast<DirectoryBackend>(m_storage);
-    if (backend) {
-        backend->setCalendarVisibility(id, visible);
-        m_eventsModel->refresh(); // Refresh to hide/show events
+    if (m_storage && m_localBackend) {
+        // Refreshed afterwards to hide/show events; showing may parse a deferred calendar
+        auto storage = m_storage;
+        runStorageTask([storage, id, visible]() { storage->setCalendarVisibility(id, visible); });
     }
 }
 
 QVariantList CalendarApp::getCalendars()
 {
     QVariantList list;
-    auto backend = std::dynamic_pointer_cast<DirectoryBackend>(m_storage);
-    if (!backend) return list;
+    if (!m_storage || !m_localBackend) return list;
 
-    for (const auto &id : backend->getCalendarIds()) {
+    for (const auto &id : m_storage->getCalendarIds()) {
         QVariantMap map;
         map[QStringLiteral("id")] = id;
-        map[QStringLiteral("name")] = backend->getCalendarName(id);
-        map[QStringLiteral("color")] = backend->getCalendarColor(id);
-        map[QStringLiteral("visible")] = backend->getCalendarVisibility(id);
+        map[QStringLiteral("name")] = m_storage->getCalendarName(id);
+        map[QStringLiteral("color")] = m_storage->getCalendarColor(id);
+        map[QStringLiteral("visible")] = m_storage->getCalendarVisibility(id);
         list.append(map);
     }
     return list;
@@ -203,8 +401,8 @@ void CalendarApp::sync()
 {
     if (m_storage) {
         qDebug() << "Syncing...";
-        m_storage->sync();
-        m_eventsModel->refresh();
+        auto storage = m_storage;
+        runStorageTask([storage]() { storage->sync(); });
     }
 }
 
@@ -213,9 +411,9 @@ void CalendarApp::switchBackend(const QString &backend)
 #ifdef AKONADI_BACKEND_AVAILABLE
     if (backend == QLatin1String("akonadi")) {
         qDebug() << "Switching to Akonadi backend";
-        m_storage = std::make_shared<PersonalCalendar::Akonadi::AkonadiCalendarBackend>(this);
-        m_eventsModel->setStorage(m_storage);
-        m_monthModel->setStorage(m_storage);
+        ++m_loadGeneration;
+        setLoadState(false);
+        attachStorage(std::make_shared<PersonalCalendar::Akonadi::AkonadiCalendarBackend>(this));
         m_backendName = QStringLiteral("Akonadi");
         Q_EMIT backendChanged();
         m_eventsModel->refresh();
@@ -224,16 +422,7 @@ void CalendarApp::switchBackend(const QString &backend)
 #endif
     if (backend == QLatin1String("local")) {
         QString path = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QStringLiteral("/calendars");
-        QDir dir(path);
-        if (!dir.exists()) {
-            dir.mkpath(QStringLiteral("."));
-        }
         qDebug() << "Switching to Local backend at:" << path;
-        m_storage = std::make_shared<DirectoryBackend>(path);
-        m_eventsModel->setStorage(m_storage);
-        m_monthModel->setStorage(m_storage);
-        m_backendName = QStringLiteral("Local");
-        Q_EMIT backendChanged();
-        m_eventsModel->refresh();
+        loadLocalBackend(path);
     }
 }
\ No newline at end of file
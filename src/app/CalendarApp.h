@@ -1,6 +1,8 @@
 #pragma once
 
 #include "core/data/ICalendarStorage.h"
+#include "core/operations/EventOperations.h"
+#include "core/operations/StorageExecutor.h"
 #include "models/EventsModel.h"
 #include "models/MonthModel.h"
 #include <QDate>
@@ -12,9 +14,13 @@ class CalendarApp : public QObject
     Q_PROPERTY(EventsModel *eventsModel READ eventsModel CONSTANT)
     Q_PROPERTY(MonthModel *monthModel READ monthModel CONSTANT)
     Q_PROPERTY(QString backendName READ backendName NOTIFY backendChanged)
+    Q_PROPERTY(bool loading READ isLoading NOTIFY loadingChanged)
+    Q_PROPERTY(int loadedCalendars READ loadedCalendars NOTIFY loadingChanged)
+    Q_PROPERTY(int totalCalendars READ totalCalendars NOTIFY loadingChanged)
 
 public:
     explicit CalendarApp(QObject *parent = nullptr);
+    ~CalendarApp() override;
 
     // Initialize with a storage path (or default)
     void initialize(const QString &storagePath = QString());
@@ -22,6 +28,9 @@ public:
     EventsModel *eventsModel() const;
     MonthModel *monthModel() const;
     QString backendName() const;
+    bool isLoading() const;
+    int loadedCalendars() const;
+    int totalCalendars() const;
 
     // QML Invokables
     Q_INVOKABLE void createEvent(const QString &title, const QDateTime &start, const QDateTime &end, bool allDay,
@@ -31,6 +40,9 @@ public:
                                  bool allDay, const QString &description = QString(),
                                  const QString &location = QString());
     Q_INVOKABLE void deleteEvent(const QString &uid);
+
+    // Earliest free slots within office hours, as {start, end} maps
+    Q_INVOKABLE QVariantList suggestTimes(const QDateTime &from, int durationMinutes, int count = 3);
     
     // Calendar Management
     Q_INVOKABLE void createCalendar(const QString &name, const QString &color);
@@ -47,10 +59,30 @@ public:
 
 Q_SIGNALS:
     void backendChanged();
+    void loadingChanged();
+    // A calendar was created, deleted or changed on the storage thread
+    void calendarsChanged();
 
 private:
+    static void setEventTimes(PersonalCalendar::Core::CalendarEvent &event, const QDateTime &start,
+                              const QDateTime &end, bool allDay);
+    // Wraps local backends for the storage thread and points the models at the result
+    void attachStorage(const PersonalCalendar::Core::ICalendarStoragePtr &backend);
+    // Parses the calendar directory on the storage thread, reporting progress as calendars arrive
+    void loadLocalBackend(const QString &path);
+    void setLoadState(bool loading, int loaded = 0, int total = 0);
+    // Runs a storage call behind any pending saves, then refreshes the models
+    void runStorageTask(std::function<void()> task);
+
+    std::shared_ptr<PersonalCalendar::Core::StorageExecutor> m_executor;
     PersonalCalendar::Core::ICalendarStoragePtr m_storage;
+    std::shared_ptr<PersonalCalendar::Core::EventOperations> m_operations;
+    bool m_localBackend = false;
     EventsModel *m_eventsModel;
     MonthModel *m_monthModel;
     QString m_backendName;
+    bool m_loading = false;
+    int m_loadedCalendars = 0;
+    int m_totalCalendars = 0;
+    int m_loadGeneration = 0; // Bumped on every backend switch so a stale load is dropped
 };
@@ -1,5 +1,7 @@
 #include "EventsModel.h"
+#include "core/operations/ConflictDetector.h"
 #include <QDebug>
+#include <QSet>
 
 using namespace PersonalCalendar::Core;
 
@@ -15,15 +17,16 @@ int EventsModel::rowCount(const QModelIndex &parent) const
 {
     if (parent.isValid())
         return 0;
-    return m_events.count();
+    return m_occurrences.count();
 }
 
 QVariant EventsModel::data(const QModelIndex &index, int role) const
 {
-    if (!index.isValid() || index.row() >= m_events.count())
+    if (!index.isValid() || index.row() >= m_occurrences.count())
         return QVariant();
 
-    const auto &event = m_events[index.row()];
+    const auto &occurrence = m_occurrences[index.row()];
+    const auto &event = occurrence.event;
 
     switch (role) {
         case UidRole:
@@ -33,9 +36,9 @@ QVariant EventsModel::data(const QModelIndex &index, int role) const
         case DescriptionRole:
             return event->description;
         case StartDateRole:
-            return event->startDateTime;
+            return occurrence.start;
         case EndDateRole:
-            return event->endDateTime;
+            return occurrence.end;
         case IsAllDayRole:
             return event->isAllDay;
         case LocationRole:
@@ -44,6 +47,8 @@ QVariant EventsModel::data(const QModelIndex &index, int role) const
             return event->calendarId;
         case ColorRole:
             return m_storage ? m_storage->getCalendarColor(event->calendarId) : QVariant();
+        case HasConflictRole:
+            return m_hasConflict.value(index.row());
     }
 
     return QVariant();
@@ -61,6 +66,7 @@ QHash<int, QByteArray> EventsModel::roleNames() const
     roles[LocationRole] = QByteArrayLiteral("location");
     roles[CalendarIdRole] = QByteArrayLiteral("calendarId");
     roles[ColorRole] = QByteArrayLiteral("color");
+    roles[HasConflictRole] = QByteArrayLiteral("hasConflict");
     return roles;
 }
 
@@ -89,15 +95,24 @@ void EventsModel::updateEvents()
         return;
 
     beginResetModel();
-    // Fetch events for the selected date
-    // Note: getEventsByDate returns events that occur on this date (including spanning events)
-    m_events = m_storage->getEventsByDate(m_selectedDate);
-
-    // Sort by start time
-    std::sort(m_events.begin(), m_events.end(),
-              [](const CalendarEventPtr &a, const CalendarEventPtr &b) { return a->startDateTime < b->startDateTime; });
+    // Fetch occurrences for the selected date, already sorted by start time
+    // Note: this includes spanning events and instances of recurring series
+    m_occurrences = m_storage->getOccurrencesByDateRange(m_selectedDate, m_selectedDate);
+
+    // Double bookings among the day's occurrences, for the conflict badge
+    QSet<std::pair<QString, qint64>> conflicting;
+    const auto conflicts = ConflictDetector::findConflicts(m_occurrences);
+    for (const auto &conflict : conflicts) {
+        conflicting.insert({conflict.first.event->uid, conflict.first.utcStart.secsSinceEpoch()});
+        conflicting.insert({conflict.second.event->uid, conflict.second.utcStart.secsSinceEpoch()});
+    }
+    m_hasConflict.clear();
+    m_hasConflict.reserve(m_occurrences.size());
+    for (const auto &occurrence : std::as_const(m_occurrences)) {
+        m_hasConflict.append(conflicting.contains({occurrence.event->uid, occurrence.utcStart.secsSinceEpoch()}));
+    }
 
     endResetModel();
 
-    qDebug() << "Loaded" << m_events.size() << "events for" << m_selectedDate;
+    qDebug() << "Loaded" << m_occurrences.size() << "events for" << m_selectedDate;
 }
@@ -2,6 +2,7 @@
 
 #include "core/data/ICalendarStorage.h"
 #include "core/models/CalendarEvent.h"
+#include "core/models/EventOccurrence.h"
 #include <QAbstractListModel>
 #include <QDateTime>
 #include <QList>
@@ -21,7 +22,8 @@ public:
         IsAllDayRole,
         LocationRole,
         CalendarIdRole,
-        ColorRole
+        ColorRole,
+        HasConflictRole
     };
 
     explicit EventsModel(QObject *parent = nullptr);
@@ -48,6 +50,7 @@ private:
     void updateEvents();
 
     PersonalCalendar::Core::ICalendarStoragePtr m_storage;
-    QList<PersonalCalendar::Core::CalendarEventPtr> m_events;
+    QList<PersonalCalendar::Core::EventOccurrence> m_occurrences;
+    QList<bool> m_hasConflict; // Per row: overlaps another event on this day
     QDate m_selectedDate;
 };
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: LGPL-2.1-or-later
 
 #include "MonthModel.h"
+#include "core/operations/ConflictDetector.h"
 #include <QDate>
 #include <QRandomGenerator>
 
@@ -10,6 +11,21 @@ struct MonthModel::Private {
     int month;
     QCalendar calendar = QCalendar();
     QDate selected;
+
+    // Number of leading days from the previous month in the first row
+    int prefix(int firstDayOfWeek) const
+    {
+        int prefix = calendar.dayOfWeek(QDate(year, month, 1)) - firstDayOfWeek;
+        if (prefix <= 1) {
+            prefix += 7;
+        } else if (prefix > 7) {
+            prefix -= 7;
+        }
+        return prefix;
+    }
+
+    // Conflicts of the 42 visible days, scanned once per month instead of per cell
+    PersonalCalendar::Core::ConflictDetector conflicts;
 };
 
 MonthModel::MonthModel(QObject *parent) : QAbstractListModel(parent), d(new MonthModel::Private())
@@ -23,9 +39,46 @@ MonthModel::~MonthModel() {}
 void MonthModel::setStorage(PersonalCalendar::Core::ICalendarStoragePtr storage)
 {
     m_storage = storage;
+    rescanConflicts();
     Q_EMIT dataChanged(index(0, 0), index(41, 0));
 }
 
+void MonthModel::refresh()
+{
+    rescanConflicts();
+    emitEventRolesChanged();
+}
+
+void MonthModel::eventChanged(const PersonalCalendar::Core::CalendarEventPtr &event)
+{
+    if (!m_storage) {
+        return;
+    }
+    d->conflicts.eventChanged(*m_storage, event);
+    emitEventRolesChanged();
+}
+
+void MonthModel::eventRemoved(const QString &uid)
+{
+    d->conflicts.eventRemoved(uid);
+    emitEventRolesChanged();
+}
+
+void MonthModel::rescanConflicts()
+{
+    if (!m_storage) {
+        d->conflicts = PersonalCalendar::Core::ConflictDetector();
+        return;
+    }
+    const QDate first = QDate(d->year, d->month, 1).addDays(-d->prefix(m_locale.firstDayOfWeek()));
+    d->conflicts.scan(*m_storage, first, first.addDays(rowCount({}) - 1));
+}
+
+void MonthModel::emitEventRolesChanged()
+{
+    Q_EMIT dataChanged(index(0, 0), index(41, 0), {Roles::HasEvents, Roles::HasConflicts});
+}
+
 int MonthModel::year() const
 {
     return d->year;
@@ -38,6 +91,7 @@ void MonthModel::setYear(int year)
     }
     d->year = year;
     Q_EMIT yearChanged();
+    rescanConflicts();
     Q_EMIT dataChanged(index(0, 0), index(41, 0));
     setSelected(
         QDate(year, d->selected.month(), qMin(d->selected.day(), d->calendar.daysInMonth(d->selected.month(), year))));
@@ -55,6 +109,7 @@ void MonthModel::setMonth(int month)
     }
     d->month = month;
     Q_EMIT monthChanged();
+    rescanConflicts();
     Q_EMIT dataChanged(index(0, 0), index(41, 0));
     setSelected(QDate(d->selected.year(), d->month,
                       qMin(d->selected.day(), d->calendar.daysInMonth(d->month, d->selected.year()))));
@@ -129,13 +184,7 @@ QVariant MonthModel::data(const QModelIndex &index, int role) const
 
     if (!index.parent().isValid()) {
         // Fetch days in month
-        int prefix = d->calendar.dayOfWeek(QDate(d->year, d->month, 1)) - m_locale.firstDayOfWeek();
-
-        if (prefix <= 1) {
-            prefix += 7;
-        } else if (prefix > 7) {
-            prefix -= 7;
-        }
+        const int prefix = d->prefix(m_locale.firstDayOfWeek());
 
         switch (role) {
             case Qt::DisplayRole:
@@ -143,7 +192,8 @@ QVariant MonthModel::data(const QModelIndex &index, int role) const
             case IsSelected:
             case IsToday:
             case Date:
-            case HasEvents: {
+            case HasEvents:
+            case HasConflicts: {
                 int day = -1;
                 int month = d->month;
                 int year = d->year;
@@ -179,7 +229,10 @@ QVariant MonthModel::data(const QModelIndex &index, int role) const
                     return date == QDate::currentDate();
                 }
                 if (role == HasEvents) {
-                    return m_storage ? !m_storage->getEventsByDate(date).isEmpty() : false;
+                    return m_storage ? !m_storage->getOccurrencesByDateRange(date, date).isEmpty() : false;
+                }
+                if (role == HasConflicts) {
+                    return d->conflicts.conflictsOn(date) > 0;
                 }
                 return {};
             }
@@ -204,6 +257,6 @@ QHash<int, QByteArray> MonthModel::roleNames() const
         {Qt::DisplayRole, QByteArrayLiteral("display")},      {Roles::DayNumber, QByteArrayLiteral("dayNumber")},
         {Roles::SameMonth, QByteArrayLiteral("sameMonth")},   {Roles::Date, QByteArrayLiteral("date")},
         {Roles::IsSelected, QByteArrayLiteral("isSelected")}, {Roles::IsToday, QByteArrayLiteral("isToday")},
-        {Roles::HasEvents, QByteArrayLiteral("hasEvents")},
+        {Roles::HasEvents, QByteArrayLiteral("hasEvents")},   {Roles::HasConflicts, QByteArrayLiteral("hasConflicts")},
     };
 }
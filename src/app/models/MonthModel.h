@@ -30,7 +30,8 @@ public:
         Date,                     ///< Date of the day.
         IsSelected,               ///< Date is equal the selected date.
         IsToday,                  ///< Date is today.
-        HasEvents                 ///< Date has events.
+        HasEvents,                ///< Date has events.
+        HasConflicts              ///< Date has overlapping (double-booked) events.
     };
 
 public:
@@ -39,6 +40,13 @@ public:
 
     void setStorage(PersonalCalendar::Core::ICalendarStoragePtr storage);
 
+    /// Re-read the visible weeks after a bulk change (sync, calendar added or removed).
+    void refresh();
+    /// Update the conflict markers after one event was created or edited.
+    void eventChanged(const PersonalCalendar::Core::CalendarEventPtr &event);
+    /// Update the conflict markers after one event was deleted.
+    void eventRemoved(const QString &uid);
+
     int year() const;
     void setYear(int year);
     int month() const;
@@ -66,6 +74,9 @@ Q_SIGNALS:
     void selectedChanged();
 
 private:
+    void rescanConflicts();
+    void emitEventRolesChanged();
+
     class Private;
     QLocale m_locale;
     PersonalCalendar::Core::ICalendarStoragePtr m_storage;
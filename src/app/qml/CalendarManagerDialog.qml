@@ -24,6 +24,16 @@ Dialog {
 
     onOpened: refresh()
 
+    // Calendar changes are saved on the storage thread and reported when done
+    Connections {
+        target: CalendarApp
+        function onCalendarsChanged() {
+            if (root.opened) {
+                root.refresh()
+            }
+        }
+    }
+
     ListModel {
         id: calendarModel
     }
@@ -71,7 +81,6 @@ Dialog {
                         visible: model.id !== "personal" // Prevent deleting default
                         onClicked: {
                             CalendarApp.deleteCalendar(model.id)
-                            root.refresh()
                         }
                     }
                 }
@@ -104,7 +113,6 @@ Dialog {
                 onClicked: {
                     CalendarApp.createCalendar(newCalName.text, colorPicker.currentValue)
                     newCalName.text = ""
-                    root.refresh()
                 }
             }
         }
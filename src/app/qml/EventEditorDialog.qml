@@ -152,6 +152,23 @@ Dialog {
                 }
             }
         }
+
+        Button {
+            text: "Suggest Time"
+            enabled: !allDaySwitch.checked
+            onClicked: {
+                // Keep the current length, move to the next free slot from the chosen start
+                var minutes = (getEndDateTime() - getStartDateTime()) / 60000;
+                if (minutes <= 0)
+                    minutes = 60;
+                var slots = CalendarApp.suggestTimes(getStartDateTime(), minutes, 1);
+                if (slots.length > 0) {
+                    var start = slots[0].start;
+                    eventDate = start;
+                    setTimes(start, new Date(start.getTime() + minutes * 60000));
+                }
+            }
+        }
         TextField {
             id: locationField
             placeholderText: "Location"
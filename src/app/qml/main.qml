@@ -41,6 +41,21 @@ ApplicationWindow {
 
                 Item { Layout.fillWidth: true }
 
+                Label {
+                    visible: CalendarApp.loading && CalendarApp.totalCalendars > 0
+                    text: "Loading " + CalendarApp.loadedCalendars + "/" + CalendarApp.totalCalendars
+                    color: Material.secondaryTextColor
+                }
+
+                ProgressBar {
+                    visible: CalendarApp.loading
+                    indeterminate: CalendarApp.totalCalendars === 0
+                    from: 0
+                    to: Math.max(1, CalendarApp.totalCalendars)
+                    value: CalendarApp.loadedCalendars
+                    Layout.preferredWidth: 120
+                }
+
                 Button {
                     text: "⟳ Sync"
                     flat: true
@@ -172,7 +187,7 @@ ApplicationWindow {
                             font.bold: model.isToday
                         }
 
-                        // Event indicator dot
+                        // Event indicator dot, red when events overlap
                         Rectangle {
                             anchors.bottom: parent.bottom
                             anchors.bottomMargin: 4
@@ -180,7 +195,8 @@ ApplicationWindow {
                             width: 4
                             height: 4
                             radius: 2
-                            color: model.isSelected ? "white" : Material.accent
+                            color: model.isSelected ? "white"
+                                 : model.hasConflicts ? Material.color(Material.Red) : Material.accent
                             visible: model.hasEvents
                         }
 
@@ -248,11 +264,21 @@ ApplicationWindow {
                                 Layout.fillWidth: true
                                 spacing: 2
 
-                                Label {
-                                    text: model.title
-                                    font.bold: true
-                                    font.pixelSize: 16
-                                    elide: Text.ElideRight
+                                RowLayout {
+                                    Label {
+                                        text: model.title
+                                        font.bold: true
+                                        font.pixelSize: 16
+                                        elide: Text.ElideRight
+                                        Layout.fillWidth: true
+                                    }
+
+                                    Label {
+                                        text: "Conflict"
+                                        visible: model.hasConflict
+                                        color: Material.color(Material.Red)
+                                        font.pixelSize: 12
+                                    }
                                 }
 
                                 Label {
@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "CategoryIndex.h"
+#include <algorithm>
+
+namespace PersonalCalendar::Local
+{
+
+void CategoryIndex::Bits::set(int id)
+{
+    if (id < 64) {
+        m_first |= quint64(1) << id;
+        return;
+    }
+
+    const size_t word = size_t(id / 64 - 1);
+    if (m_rest.size() <= word) {
+        m_rest.resize(word + 1, 0);
+    }
+    m_rest[word] |= quint64(1) << (id % 64);
+}
+
+bool CategoryIndex::Bits::intersects(const Bits &other) const
+{
+    if (m_first & other.m_first) {
+        return true;
+    }
+
+    const size_t words = std::min(m_rest.size(), other.m_rest.size());
+    for (size_t i = 0; i < words; ++i) {
+        if (m_rest[i] & other.m_rest[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CategoryIndex::Bits::isEmpty() const
+{
+    return m_first == 0 && std::all_of(m_rest.cbegin(), m_rest.cend(), [](quint64 word) { return word == 0; });
+}
+
+void CategoryIndex::insert(const Core::CalendarEventPtr &event)
+{
+    if (!event) {
+        return;
+    }
+
+    Bits bits;
+    for (const QString &category : std::as_const(event->categories)) {
+        bits.set(intern(category));
+    }
+
+    if (bits.isEmpty()) {
+        m_events.remove(event->uid);
+    } else {
+        m_events.insert(event->uid, std::move(bits));
+    }
+}
+
+void CategoryIndex::remove(const QString &uid)
+{
+    m_events.remove(uid);
+}
+
+void CategoryIndex::clear()
+{
+    m_ids.clear();
+    m_names.clear();
+    m_events.clear();
+}
+
+CategoryIndex::Bits CategoryIndex::mask(const QStringList &categories) const
+{
+    Bits bits;
+    for (const QString &category : categories) {
+        auto it = m_ids.constFind(category);
+        if (it != m_ids.constEnd()) {
+            bits.set(it.value());
+        }
+    }
+    return bits;
+}
+
+bool CategoryIndex::matches(const QString &uid, const Bits &mask) const
+{
+    auto it = m_events.constFind(uid);
+    return it != m_events.constEnd() && it.value().intersects(mask);
+}
+
+QList<Core::CalendarEventPtr> CategoryIndex::filter(const QList<Core::CalendarEventPtr> &events, const Bits &mask) const
+{
+    QList<Core::CalendarEventPtr> result;
+    if (mask.isEmpty()) {
+        return result;
+    }
+
+    for (const auto &event : events) {
+        if (matches(event->uid, mask)) {
+            result.append(event);
+        }
+    }
+    return result;
+}
+
+int CategoryIndex::intern(const QString &category)
+{
+    auto it = m_ids.constFind(category);
+    if (it != m_ids.constEnd()) {
+        return it.value();
+    }
+
+    const int id = int(m_names.size());
+    m_ids.insert(category, id);
+    m_names.append(category);
+    return id;
+}
+
+} // namespace PersonalCalendar::Local
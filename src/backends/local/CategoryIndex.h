@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include "core/models/CalendarEvent.h"
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+namespace PersonalCalendar::Local
+{
+
+/**
+ * @brief Category dictionary and per-event category bitsets
+ *
+ * Category names are interned to small integers the first time they are
+ * seen, and every event keeps the set of its categories as a bitset. A
+ * filter on "any of these categories" becomes one mask built per query and
+ * one AND per candidate event, with no string comparisons. The first 64
+ * categories fit in an inline word, so most events never allocate.
+ */
+class CategoryIndex
+{
+public:
+    /**
+     * @brief Bitset over interned category IDs
+     */
+    class Bits
+    {
+    public:
+        void set(int id);
+        bool intersects(const Bits &other) const;
+        bool isEmpty() const;
+
+    private:
+        quint64 m_first = 0;
+        std::vector<quint64> m_rest; // IDs 64 and up
+    };
+
+    /**
+     * @brief Set the categories of an event (keyed by its UID)
+     */
+    void insert(const Core::CalendarEventPtr &event);
+
+    /**
+     * @brief Forget an event
+     */
+    void remove(const QString &uid);
+
+    /**
+     * @brief Forget all events and the dictionary
+     */
+    void clear();
+
+    /**
+     * @brief Mask matching events that carry any of @p categories
+     *
+     * Unknown names are skipped: no event can match them.
+     */
+    Bits mask(const QStringList &categories) const;
+
+    /**
+     * @brief Check whether an event carries any category of @p mask
+     */
+    bool matches(const QString &uid, const Bits &mask) const;
+
+    /**
+     * @brief Keep only the events that carry any category of @p mask
+     */
+    QList<Core::CalendarEventPtr> filter(const QList<Core::CalendarEventPtr> &events, const Bits &mask) const;
+
+    /**
+     * @brief Number of distinct category names seen
+     */
+    int categoryCount() const { return int(m_names.size()); }
+
+private:
+    int intern(const QString &category);
+
+    QHash<QString, int> m_ids;
+    QStringList m_names;
+    QHash<QString, Bits> m_events; // Only events with at least one category
+};
+
+} // namespace PersonalCalendar::Local
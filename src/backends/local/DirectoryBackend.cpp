@@ -2,19 +2,29 @@
 // SPDX-License-Identifier: LGPL-2.1-or-later
 
 #include "DirectoryBackend.h"
+#include "core/utils/FreeBusyCalculator.h"
 #include <QDateTime>
 #include <QDebug>
 #include <QFile>
 #include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QHash>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QMutex>
+#include <QThread>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <algorithm>
 
 namespace PersonalCalendar::Local
 {
 
-DirectoryBackend::DirectoryBackend(const QString &directoryPath, bool createIfMissing)
-    : m_directoryPath(directoryPath), m_directory(directoryPath)
+DirectoryBackend::DirectoryBackend(const QString &directoryPath, bool createIfMissing, LoadProgressCallback onProgress,
+                                   LoadMode loadMode)
+    : m_directoryPath(directoryPath), m_directory(directoryPath), m_loadMode(loadMode),
+      m_loadProgress(std::move(onProgress))
 {
     if (!m_directory.exists()) {
         if (createIfMissing) {
@@ -37,18 +47,39 @@ DirectoryBackend::DirectoryBackend(const QString &directoryPath, bool createIfMi
 
 DirectoryBackend::~DirectoryBackend()
 {
+    // The watcher belongs to the thread that enabled it, which need not be this one
+    if (m_watcher && m_watcher->thread() != QThread::currentThread()) {
+        QObject::disconnect(m_watcher.get(), nullptr, nullptr, nullptr);
+        m_watcher.release()->deleteLater();
+    }
+    m_watcher.reset();
+
+    // Flush first so the stored summaries describe the files as written
+    flush();
+    if (refreshSummaries() || m_metadataDirty) {
+        writeCalendarMetadata();
+    }
     m_calendars.clear();
     qDebug() << "DirectoryBackend: Destroyed";
 }
 
 bool DirectoryBackend::initialize()
 {
+    // Metadata comes first: visibility decides which calendars are parsed in lazy mode
+    if (!loadCalendarMetadata()) {
+        qWarning() << "DirectoryBackend: Failed to load calendar metadata";
+    }
+
     if (!discoverCalendars()) {
         return false;
     }
 
-    if (!loadCalendarMetadata()) {
-        qWarning() << "DirectoryBackend: Failed to load calendar metadata";
+    // Calendars whose file is gone keep their name and color in case the file
+    // comes back; only deleteCalendar() forgets them. Their summary is stale though
+    for (auto it = m_metadata.begin(); it != m_metadata.end(); ++it) {
+        if (!m_calendars.contains(it.key())) {
+            it.value().summary = CalendarSummary();
+        }
     }
 
     qDebug() << "DirectoryBackend: Initialized with" << m_calendars.size() << "calendars";
@@ -58,25 +89,94 @@ bool DirectoryBackend::initialize()
 bool DirectoryBackend::discoverCalendars()
 {
     m_calendars.clear();
-    m_eventToCalendar.clear();
+    m_uidIndex.clear();
 
     m_directory.setFilter(QDir::Files);
     m_directory.setNameFilters({QLatin1String("*.ics")});
 
+    // Register every calendar; hidden ones stay unloaded in lazy mode
+    QStringList toLoad;
     const auto files = m_directory.entryList();
     for (const auto &filename : files) {
-        QString filepath = m_directory.filePath(filename);
-        QString calendarId = filename.left(filename.length() - 4); // Remove .ics
-
-        auto backend = std::make_shared<ICSFileBackend>(filepath);
-        m_calendars[calendarId] = backend;
+        const QString calendarId = filename.left(filename.length() - 4); // Remove .ics
 
         // Ensure metadata entry exists
         if (!m_metadata.contains(calendarId)) {
             m_metadata[calendarId] = CalendarMetadata{calendarId, QString(), true};
         }
 
-        qDebug() << "DirectoryBackend: Discovered calendar:" << calendarId;
+        CalendarMetadata &meta = m_metadata[calendarId];
+        if (m_loadMode == LoadMode::LazyHidden && !meta.visible) {
+            m_calendars[calendarId] = nullptr;
+
+            // A summary is only trusted while the file is unchanged
+            const QFileInfo info(m_directory.filePath(filename));
+            if (meta.fileSize != info.size() || meta.fileModified != info.lastModified().toMSecsSinceEpoch()) {
+                meta.summary = CalendarSummary();
+            }
+            qDebug() << "DirectoryBackend: Deferred hidden calendar:" << calendarId;
+            continue;
+        }
+        toLoad.append(filename);
+    }
+
+    const int total = toLoad.size();
+    if (total == 0) {
+        return true;
+    }
+
+    // Parse every file on its own worker. ICSFileBackend holds no thread
+    // affine state until its first mutation, so it can be built off-thread
+    // and handed over once loaded.
+    struct LoadedCalendar {
+        QString id;
+        std::shared_ptr<ICSFileBackend> backend;
+    };
+    QMutex mutex;
+    QWaitCondition ready;
+    QList<LoadedCalendar> finished;
+
+    // A private pool: loading must not starve (or be starved by) global pool users
+    QThreadPool pool;
+    pool.setMaxThreadCount(std::min(QThread::idealThreadCount(), total));
+
+    for (const auto &filename : std::as_const(toLoad)) {
+        const QString filepath = m_directory.filePath(filename);
+        const QString calendarId = filename.left(filename.length() - 4); // Remove .ics
+        const QString snapshot = snapshotPath(calendarId);
+
+        // Workers only see their own paths and the hand-over queue, never the backend
+        pool.start([&mutex, &ready, &finished, filepath, snapshot, calendarId]() {
+            auto backend = std::make_shared<ICSFileBackend>(filepath, snapshot);
+            QMutexLocker locker(&mutex);
+            finished.append(LoadedCalendar{calendarId, std::move(backend)});
+            ready.wakeOne();
+        });
+    }
+
+    // Publish calendars in completion order
+    int loaded = 0;
+    while (loaded < total) {
+        QList<LoadedCalendar> batch;
+        {
+            QMutexLocker locker(&mutex);
+            while (finished.isEmpty()) {
+                ready.wait(&mutex);
+            }
+            batch.swap(finished);
+        }
+
+        for (auto &calendar : batch) {
+            adoptCalendar(calendar.id, *calendar.backend);
+            m_calendars[calendar.id] = calendar.backend;
+            indexCalendar(calendar.id, *calendar.backend);
+
+            qDebug() << "DirectoryBackend: Discovered calendar:" << calendar.id;
+            ++loaded;
+            if (m_loadProgress) {
+                m_loadProgress(loaded, total, calendar.id);
+            }
+        }
     }
 
     return true;
@@ -91,7 +191,7 @@ bool DirectoryBackend::createEvent(const Core::CalendarEventPtr &event)
 
     QString calendarId = event->calendarId;
     if (calendarId.isEmpty() || !m_calendars.contains(calendarId)) {
-        calendarId = m_eventToCalendar.value(event->uid);
+        calendarId = m_uidIndex.value(event->uid);
     }
 
     if (calendarId.isEmpty()) {
@@ -105,7 +205,7 @@ bool DirectoryBackend::createEvent(const Core::CalendarEventPtr &event)
         }
     }
 
-    auto backend = m_calendars.value(calendarId);
+    auto backend = calendar(calendarId);
     if (!backend) {
         m_lastError = QLatin1String("Calendar not found");
         return false;
@@ -113,7 +213,8 @@ bool DirectoryBackend::createEvent(const Core::CalendarEventPtr &event)
 
     bool success = backend->createEvent(event);
     if (success) {
-        m_eventToCalendar[event->uid] = calendarId;
+        event->calendarId = calendarId;
+        m_uidIndex.insert(event->uid, calendarId);
     }
     return success;
 }
@@ -125,20 +226,13 @@ Core::CalendarEventPtr DirectoryBackend::getEvent(const QString &uid)
         return nullptr;
     }
 
-    QString calendarId = m_eventToCalendar.value(uid);
+    QString calendarId = locate(uid);
     if (calendarId.isEmpty()) {
-        for (auto it = m_calendars.begin(); it != m_calendars.end(); ++it) {
-            auto event = it.value()->getEvent(uid);
-            if (event) {
-                m_eventToCalendar[uid] = it.key();
-                return event;
-            }
-        }
         m_lastError = QLatin1String("Event not found");
         return nullptr;
     }
 
-    auto backend = m_calendars.value(calendarId);
+    auto backend = calendar(calendarId);
     if (backend) {
         return backend->getEvent(uid);
     }
@@ -154,13 +248,13 @@ bool DirectoryBackend::updateEvent(const Core::CalendarEventPtr &event)
         return false;
     }
 
-    QString calendarId = m_eventToCalendar.value(event->uid);
+    QString calendarId = locate(event->uid);
     if (calendarId.isEmpty()) {
         m_lastError = QLatin1String("Event not found");
         return false;
     }
 
-    auto backend = m_calendars.value(calendarId);
+    auto backend = calendar(calendarId);
     if (!backend) {
         m_lastError = QLatin1String("Calendar not found");
         return false;
@@ -176,13 +270,13 @@ bool DirectoryBackend::deleteEvent(const QString &uid)
         return false;
     }
 
-    QString calendarId = m_eventToCalendar.value(uid);
+    QString calendarId = locate(uid);
     if (calendarId.isEmpty()) {
         m_lastError = QLatin1String("Event not found");
         return false;
     }
 
-    auto backend = m_calendars.value(calendarId);
+    auto backend = calendar(calendarId);
     if (!backend) {
         m_lastError = QLatin1String("Calendar not found");
         return false;
@@ -190,21 +284,221 @@ bool DirectoryBackend::deleteEvent(const QString &uid)
 
     bool success = backend->deleteEvent(uid);
     if (success) {
-        m_eventToCalendar.remove(uid);
+        m_uidIndex.remove(uid);
     }
     return success;
 }
 
+bool DirectoryBackend::applyBatch(const QList<Core::EventMutation> &mutations)
+{
+    using Type = Core::EventMutation::Type;
+
+    // Route every mutation to the file that owns its event. Calendar moves
+    // become a delete in the old file plus a create in the new one. The
+    // overlay tracks where each touched UID lives after the mutations seen
+    // so far (empty = deleted), so validation sees the batch's own effects.
+    QHash<QString, QString> overlay;
+    QHash<QString, QList<Core::EventMutation>> groups;
+    QStringList order;
+    bool needsDefaultCalendar = false;
+
+    // New UIDs are only checked against loaded calendars, so creating
+    // events never forces hidden calendars to be parsed
+    auto whereIs = [&](const QString &uid, bool searchUnloaded) {
+        auto it = overlay.constFind(uid);
+        if (it != overlay.constEnd()) {
+            return it.value();
+        }
+        return searchUnloaded ? locate(uid) : m_uidIndex.value(uid);
+    };
+    auto route = [&](const QString &calendarId, const Core::EventMutation &mutation) {
+        if (!groups.contains(calendarId)) {
+            order.append(calendarId);
+        }
+        groups[calendarId].append(mutation);
+    };
+
+    for (qsizetype i = 0; i < mutations.size(); ++i) {
+        const auto &mutation = mutations.at(i);
+        const QString uid = mutation.targetUid();
+        const bool needsEvent = mutation.type != Type::Delete;
+        if (uid.isEmpty() || (needsEvent && (!mutation.event || !mutation.event->isValid()))) {
+            m_lastError = QLatin1String("Invalid mutation at index ") + QString::number(i);
+            return false;
+        }
+
+        const QString current = whereIs(uid, mutation.type != Type::Create);
+        switch (mutation.type) {
+            case Type::Create: {
+                if (!current.isEmpty()) {
+                    m_lastError = QLatin1String("Event already exists: ") + uid;
+                    return false;
+                }
+                QString target = mutation.event->calendarId;
+                if (target.isEmpty() || !m_calendars.contains(target)) {
+                    target = defaultCalendarId();
+                    needsDefaultCalendar = needsDefaultCalendar || m_calendars.isEmpty();
+                }
+                route(target, mutation);
+                overlay[uid] = target;
+                break;
+            }
+            case Type::Update: {
+                if (current.isEmpty()) {
+                    m_lastError = QLatin1String("Event not found: ") + uid;
+                    return false;
+                }
+                const QString &requested = mutation.event->calendarId;
+                if (!requested.isEmpty() && requested != current && m_calendars.contains(requested)) {
+                    route(current, Core::EventMutation::remove(uid));
+                    route(requested, Core::EventMutation::create(mutation.event));
+                    overlay[uid] = requested;
+                } else {
+                    route(current, mutation);
+                    overlay[uid] = current;
+                }
+                break;
+            }
+            case Type::Delete: {
+                if (current.isEmpty()) {
+                    m_lastError = QLatin1String("Event not found: ") + uid;
+                    return false;
+                }
+                route(current, mutation);
+                overlay[uid] = QString();
+                break;
+            }
+        }
+    }
+
+    if (needsDefaultCalendar && !m_calendars.contains(defaultCalendarId())) {
+        if (!createCalendar(QLatin1String("personal"), QLatin1String("Personal"))) {
+            return false;
+        }
+    }
+
+    // Apply one batch per file. Each file commits atomically on its own; if a
+    // later file fails, the already committed ones are restored by applying
+    // the inverse batch recorded before they were touched.
+    QList<QPair<ICSFileBackend *, QList<Core::EventMutation>>> applied;
+    for (const QString &calendarId : std::as_const(order)) {
+        ICSFileBackend *backend = calendar(calendarId).get();
+        const auto &group = groups[calendarId];
+
+        QHash<QString, Core::CalendarEventPtr> state;
+        QList<Core::EventMutation> undo;
+        for (const auto &mutation : group) {
+            const QString uid = mutation.targetUid();
+            auto known = state.constFind(uid);
+            Core::CalendarEventPtr before = known != state.constEnd() ? known.value() : backend->getEvent(uid);
+            switch (mutation.type) {
+                case Type::Create:
+                    undo.prepend(Core::EventMutation::remove(uid));
+                    state[uid] = mutation.event;
+                    break;
+                case Type::Update:
+                    undo.prepend(Core::EventMutation::update(std::make_shared<Core::CalendarEvent>(*before)));
+                    state[uid] = mutation.event;
+                    break;
+                case Type::Delete:
+                    undo.prepend(Core::EventMutation::create(std::make_shared<Core::CalendarEvent>(*before)));
+                    state[uid] = nullptr;
+                    break;
+            }
+        }
+
+        if (!backend->applyBatch(group)) {
+            m_lastError = backend->lastError();
+            for (auto it = applied.rbegin(); it != applied.rend(); ++it) {
+                if (!it->first->applyBatch(it->second)) {
+                    qWarning() << "DirectoryBackend: Failed to roll back batch:" << it->first->lastError();
+                }
+            }
+            return false;
+        }
+        applied.append(qMakePair(backend, undo));
+    }
+
+    for (auto it = overlay.constBegin(); it != overlay.constEnd(); ++it) {
+        if (it.value().isEmpty()) {
+            m_uidIndex.remove(it.key());
+        } else {
+            m_uidIndex.insert(it.key(), it.value());
+        }
+    }
+    for (const auto &mutation : mutations) {
+        if (mutation.type != Type::Delete) {
+            mutation.event->calendarId = overlay.value(mutation.event->uid);
+        }
+    }
+    return true;
+}
+
+int DirectoryBackend::deleteWhere(const Core::EventPredicate &predicate, const QStringList &calendarIds)
+{
+    if (!predicate) {
+        m_lastError = QLatin1String("Predicate is empty");
+        return -1;
+    }
+
+    // Every calendar file is purged in one pass and written once
+    int total = 0;
+    const auto ids = m_calendars.keys();
+    for (const QString &id : ids) {
+        if (!calendarIds.isEmpty() && !calendarIds.contains(id))
+            continue;
+
+        auto backend = calendar(id);
+        QStringList removed;
+        const int count = backend->deleteWhere([&](const Core::CalendarEvent &event) {
+            if (!predicate(event))
+                return false;
+            removed.append(event.uid);
+            return true;
+        });
+        if (count < 0) {
+            m_lastError = backend->lastError();
+            return -1;
+        }
+
+        for (const QString &uid : std::as_const(removed))
+            m_uidIndex.remove(uid);
+        total += count;
+    }
+    return total;
+}
+
+void DirectoryBackend::indexCalendar(const QString &calendarId, ICSFileBackend &backend)
+{
+    const auto events = backend.getEventsByCollection(QLatin1String("local"));
+    m_uidIndex.reserve(m_uidIndex.size() + events.size());
+    for (const auto &event : events) {
+        event->calendarId = calendarId;
+        m_uidIndex.insert(event->uid, calendarId);
+    }
+
+    const auto todos = backend.getTodos();
+    for (const auto &todo : todos) {
+        todo->calendarId = calendarId;
+    }
+}
+
+QString DirectoryBackend::defaultCalendarId() const
+{
+    return m_calendars.isEmpty() ? QStringLiteral("personal") : m_calendars.firstKey();
+}
+
 QList<Core::CalendarEventPtr> DirectoryBackend::getEventsByDate(const QDate &date)
 {
     QList<Core::CalendarEventPtr> result;
     if (!date.isValid())
         return result;
 
-    for (auto it = m_calendars.begin(); it != m_calendars.end(); ++it) {
+    const auto ids = m_calendars.keys();
+    for (const QString &id : ids) {
         // Check visibility
-        if (getCalendarVisibility(it.key())) {
-            result.append(it.value()->getEventsByDate(date));
+        if (getCalendarVisibility(id)) {
+            result.append(calendar(id)->getEventsByDate(date));
         }
     }
     return result;
@@ -216,24 +510,349 @@ QList<Core::CalendarEventPtr> DirectoryBackend::getEventsByDateRange(const QDate
     if (!start.isValid() || !end.isValid())
         return result;
 
-    for (auto it = m_calendars.begin(); it != m_calendars.end(); ++it) {
-        if (getCalendarVisibility(it.key())) {
-            result.append(it.value()->getEventsByDateRange(start, end));
+    const auto ids = m_calendars.keys();
+    for (const QString &id : ids) {
+        if (getCalendarVisibility(id)) {
+            result.append(calendar(id)->getEventsByDateRange(start, end));
+        }
+    }
+    return result;
+}
+
+QList<Core::EventOccurrence> DirectoryBackend::getOccurrencesByDateRange(const QDate &start, const QDate &end)
+{
+    QList<Core::EventOccurrence> result;
+    if (!start.isValid() || !end.isValid())
+        return result;
+
+    const auto ids = m_calendars.keys();
+    for (const QString &id : ids) {
+        if (getCalendarVisibility(id)) {
+            result.append(calendar(id)->getOccurrencesByDateRange(start, end));
+        }
+    }
+
+    std::stable_sort(result.begin(), result.end(),
+                     [](const Core::EventOccurrence &a, const Core::EventOccurrence &b) { return a.utcStart < b.utcStart; });
+    return result;
+}
+
+QList<Core::CalendarEventPtr> DirectoryBackend::getEventsWithCategories(const QDate &start, const QDate &end,
+                                                                        const QStringList &categories)
+{
+    QList<Core::CalendarEventPtr> result;
+    if (!start.isValid() || !end.isValid())
+        return result;
+
+    // Each calendar interns its own category names, so the mask is built per calendar
+    const auto ids = m_calendars.keys();
+    for (const QString &id : ids) {
+        if (getCalendarVisibility(id)) {
+            result.append(calendar(id)->getEventsWithCategories(start, end, categories));
+        }
+    }
+    return result;
+}
+
+QList<Core::EventOccurrence> DirectoryBackend::getOccurrencesWithCategories(const QDate &start, const QDate &end,
+                                                                            const QStringList &categories)
+{
+    QList<Core::EventOccurrence> result;
+    if (!start.isValid() || !end.isValid())
+        return result;
+
+    const auto ids = m_calendars.keys();
+    for (const QString &id : ids) {
+        if (getCalendarVisibility(id)) {
+            result.append(calendar(id)->getOccurrencesWithCategories(start, end, categories));
+        }
+    }
+
+    std::stable_sort(result.begin(), result.end(),
+                     [](const Core::EventOccurrence &a, const Core::EventOccurrence &b) { return a.utcStart < b.utcStart; });
+    return result;
+}
+
+QList<Core::CalendarEventPtr> DirectoryBackend::getEventsBetween(const QDateTime &start, const QDateTime &end,
+                                                                 bool includeCancelled)
+{
+    QList<Core::CalendarEventPtr> result;
+    if (!start.isValid() || !end.isValid())
+        return result;
+
+    const auto ids = m_calendars.keys();
+    for (const QString &id : ids) {
+        if (getCalendarVisibility(id)) {
+            result.append(calendar(id)->getEventsBetween(start, end, includeCancelled));
         }
     }
+
+    std::stable_sort(result.begin(), result.end(), [](const Core::CalendarEventPtr &a, const Core::CalendarEventPtr &b) {
+        return a->utcStart < b->utcStart;
+    });
     return result;
 }
 
 QList<Core::CalendarEventPtr> DirectoryBackend::getEventsByCollection(const QString &collectionId)
 {
     QList<Core::CalendarEventPtr> result;
-    auto backend = m_calendars.value(collectionId);
+    auto backend = calendar(collectionId);
     if (backend) {
         result = backend->getEventsByCollection(QLatin1String("local"));
     }
     return result;
 }
 
+Core::SearchResults DirectoryBackend::searchEvents(const Core::SearchQuery &query)
+{
+    QStringList ids = query.calendarIds;
+    if (ids.isEmpty()) {
+        const auto all = m_calendars.keys();
+        for (const QString &id : all) {
+            if (getCalendarVisibility(id))
+                ids.append(id);
+        }
+    }
+
+    // The requested page is within the first offset + limit hits of each calendar
+    Core::SearchQuery perCalendar = query;
+    perCalendar.calendarIds.clear();
+    perCalendar.offset = 0;
+    perCalendar.limit = std::max(query.offset, 0) + std::max(query.limit, 0);
+
+    QList<Core::SearchHit> hits;
+    int total = 0;
+    for (const QString &id : std::as_const(ids)) {
+        auto backend = m_calendars.contains(id) ? calendar(id) : nullptr;
+        if (!backend)
+            continue;
+        Core::SearchResults results = backend->searchEvents(perCalendar);
+        total += results.total;
+        hits.append(std::move(results.hits));
+    }
+
+    Core::SearchResults results = rankAndPage(std::move(hits), query.offset, query.limit);
+    results.total = total;
+    return results;
+}
+
+Core::FreeBusy DirectoryBackend::getFreeBusy(const Core::FreeBusyQuery &query)
+{
+    Core::FreeBusy result;
+    if (!query.start.isValid() || !query.end.isValid() || query.start >= query.end) {
+        m_lastError = QLatin1String("Date time is invalid");
+        return result;
+    }
+    result.start = query.start.toUTC();
+    result.end = query.end.toUTC();
+
+    QStringList ids = query.calendarIds;
+    if (ids.isEmpty()) {
+        const auto all = m_calendars.keys();
+        for (const QString &id : all) {
+            if (getCalendarVisibility(id))
+                ids.append(id);
+        }
+    }
+
+    // Each calendar hands back its merged periods; merging those again is cheap
+    Core::FreeBusyQuery perCalendar = query;
+    perCalendar.calendarIds.clear();
+
+    std::vector<Core::BusyPeriod> periods;
+    for (const QString &id : std::as_const(ids)) {
+        auto backend = m_calendars.contains(id) ? calendar(id) : nullptr;
+        if (!backend)
+            continue;
+        const Core::FreeBusy part = backend->getFreeBusy(perCalendar);
+        periods.insert(periods.end(), part.periods.cbegin(), part.periods.cend());
+    }
+
+    result.periods =
+        Core::FreeBusyCalculator::merge(periods, query.start.toSecsSinceEpoch(), query.end.toSecsSinceEpoch());
+    return result;
+}
+
+bool DirectoryBackend::createTodo(const Core::TodoItemPtr &todo)
+{
+    if (!todo || !todo->isValid()) {
+        m_lastError = QLatin1String("Todo is invalid");
+        return false;
+    }
+
+    // Like events, new UIDs are only checked against loaded calendars
+    if (!locateTodo(todo->uid, false).isEmpty()) {
+        m_lastError = QLatin1String("Todo with same UID already exists");
+        return false;
+    }
+
+    QString calendarId = todo->calendarId;
+    if (calendarId.isEmpty() || !m_calendars.contains(calendarId)) {
+        if (m_calendars.isEmpty() && !createCalendar(QLatin1String("personal"), QLatin1String("Personal"))) {
+            return false;
+        }
+        calendarId = defaultCalendarId();
+    }
+
+    auto backend = calendar(calendarId);
+    if (!backend) {
+        m_lastError = QLatin1String("Calendar not found");
+        return false;
+    }
+
+    if (!backend->createTodo(todo)) {
+        m_lastError = backend->lastError();
+        return false;
+    }
+    todo->calendarId = calendarId;
+    return true;
+}
+
+Core::TodoItemPtr DirectoryBackend::getTodo(const QString &uid)
+{
+    if (uid.isEmpty()) {
+        m_lastError = QLatin1String("UID is empty");
+        return nullptr;
+    }
+
+    const QString calendarId = locateTodo(uid, true);
+    if (calendarId.isEmpty()) {
+        m_lastError = QLatin1String("Todo not found");
+        return nullptr;
+    }
+    return calendar(calendarId)->getTodo(uid);
+}
+
+bool DirectoryBackend::updateTodo(const Core::TodoItemPtr &todo)
+{
+    if (!todo || !todo->isValid()) {
+        m_lastError = QLatin1String("Todo is invalid");
+        return false;
+    }
+
+    const QString calendarId = locateTodo(todo->uid, true);
+    if (calendarId.isEmpty()) {
+        m_lastError = QLatin1String("Todo not found");
+        return false;
+    }
+
+    auto backend = calendar(calendarId);
+    if (!backend->updateTodo(todo)) {
+        m_lastError = backend->lastError();
+        return false;
+    }
+    todo->calendarId = calendarId;
+    return true;
+}
+
+bool DirectoryBackend::deleteTodo(const QString &uid)
+{
+    if (uid.isEmpty()) {
+        m_lastError = QLatin1String("UID is empty");
+        return false;
+    }
+
+    const QString calendarId = locateTodo(uid, true);
+    if (calendarId.isEmpty()) {
+        m_lastError = QLatin1String("Todo not found");
+        return false;
+    }
+
+    auto backend = calendar(calendarId);
+    if (!backend->deleteTodo(uid)) {
+        m_lastError = backend->lastError();
+        return false;
+    }
+    return true;
+}
+
+QList<Core::TodoItemPtr> DirectoryBackend::getTodos()
+{
+    QList<Core::TodoItemPtr> result;
+    const auto ids = m_calendars.keys();
+    for (const QString &id : ids) {
+        if (getCalendarVisibility(id)) {
+            result.append(calendar(id)->getTodos());
+        }
+    }
+    return result;
+}
+
+QList<Core::TodoItemPtr> DirectoryBackend::getOverdueTodos(const QDateTime &now)
+{
+    QList<Core::TodoItemPtr> result;
+    if (!now.isValid())
+        return result;
+
+    const auto ids = m_calendars.keys();
+    for (const QString &id : ids) {
+        if (getCalendarVisibility(id)) {
+            result.append(calendar(id)->getOverdueTodos(now));
+        }
+    }
+
+    std::stable_sort(result.begin(), result.end(), [](const Core::TodoItemPtr &a, const Core::TodoItemPtr &b) {
+        return a->dueDateTime < b->dueDateTime;
+    });
+    return result;
+}
+
+QList<Core::TodoItemPtr> DirectoryBackend::getTodosDueBetween(const QDateTime &start, const QDateTime &end)
+{
+    QList<Core::TodoItemPtr> result;
+    if (!start.isValid() || !end.isValid())
+        return result;
+
+    const auto ids = m_calendars.keys();
+    for (const QString &id : ids) {
+        if (getCalendarVisibility(id)) {
+            result.append(calendar(id)->getTodosDueBetween(start, end));
+        }
+    }
+
+    std::stable_sort(result.begin(), result.end(), [](const Core::TodoItemPtr &a, const Core::TodoItemPtr &b) {
+        return a->dueDateTime < b->dueDateTime;
+    });
+    return result;
+}
+
+QList<Core::TodoItemPtr> DirectoryBackend::getTodosByStatus(Core::TodoItem::Status status)
+{
+    QList<Core::TodoItemPtr> result;
+    const auto ids = m_calendars.keys();
+    for (const QString &id : ids) {
+        if (getCalendarVisibility(id)) {
+            result.append(calendar(id)->getTodosByStatus(status));
+        }
+    }
+
+    std::sort(result.begin(), result.end(),
+              [](const Core::TodoItemPtr &a, const Core::TodoItemPtr &b) { return a->uid < b->uid; });
+    return result;
+}
+
+QList<Core::TodoItemPtr> DirectoryBackend::getTopTodosByPriority(int count)
+{
+    QList<Core::TodoItemPtr> result;
+    if (count <= 0)
+        return result;
+
+    // The overall top N is among the top N of each calendar
+    const auto ids = m_calendars.keys();
+    for (const QString &id : ids) {
+        if (getCalendarVisibility(id)) {
+            result.append(calendar(id)->getTopTodosByPriority(count));
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [](const Core::TodoItemPtr &a, const Core::TodoItemPtr &b) {
+        return isHigherPriority(*a, *b);
+    });
+    if (result.size() > count)
+        result.resize(count);
+    return result;
+}
+
 QList<QString> DirectoryBackend::getCalendarIds()
 {
     return m_calendars.keys();
@@ -250,7 +869,14 @@ bool DirectoryBackend::createCalendar(const QString &id, const QString &name)
         return false;
 
     QString filepath = m_directory.filePath(id + QLatin1String(".ics"));
-    auto backend = std::make_shared<ICSFileBackend>(filepath);
+    auto backend = std::make_shared<ICSFileBackend>(filepath, snapshotPath(id));
+    adoptCalendar(id, *backend);
+
+    // Create the file right away so the calendar is discovered on the next start
+    if (!backend->flush()) {
+        m_lastError = QLatin1String("Cannot create calendar file");
+        return false;
+    }
 
     m_calendars[id] = backend;
     m_metadata[id] = CalendarMetadata{name, QString(), true};
@@ -262,20 +888,28 @@ bool DirectoryBackend::createCalendar(const QString &id, const QString &name)
 
 bool DirectoryBackend::deleteCalendar(const QString &id)
 {
-    if (id.isEmpty() || !m_calendars.contains(id))
+    if (id.isEmpty())
         return false;
 
+    // The file was removed externally; only the remembered metadata is left
+    if (!m_calendars.contains(id)) {
+        if (!m_metadata.remove(id))
+            return false;
+        saveCalendarMetadata();
+        return true;
+    }
+
     // Remove events mapping
-    for (auto it = m_eventToCalendar.begin(); it != m_eventToCalendar.end();) {
-        if (it.value() == id) {
-            it = m_eventToCalendar.erase(it);
-        } else {
-            ++it;
-        }
+    m_uidIndex.removeCalendar(id);
+
+    // Pending writes must not resurrect the file once it is removed
+    if (auto backend = m_calendars.value(id)) {
+        backend->discardChanges();
     }
 
     QString filepath = m_directory.filePath(id + QLatin1String(".ics"));
     QFile::remove(filepath);
+    QFile::remove(snapshotPath(id));
 
     m_calendars.remove(id);
     m_metadata.remove(id);
@@ -301,6 +935,11 @@ void DirectoryBackend::setCalendarVisibility(const QString &id, bool visible)
 {
     if (m_metadata.contains(id)) {
         m_metadata[id].visible = visible;
+        if (visible) {
+            calendar(id); // Materialize a calendar that was deferred while hidden
+        } else {
+            refreshSummaries();
+        }
         saveCalendarMetadata();
     }
 }
@@ -315,15 +954,301 @@ bool DirectoryBackend::getCalendarVisibility(const QString &id)
 
 bool DirectoryBackend::sync()
 {
-    if (!discoverCalendars())
+    // Write pending changes before the files are re-read, then reparse only
+    // what other programs touched
+    if (!flush()) {
+        m_lastError = QLatin1String("Failed to write pending changes");
+        return false;
+    }
+    refreshSummaries();
+    rescanDirectory();
+
+    bool success = true;
+    const auto ids = m_calendars.keys();
+    for (const QString &id : ids) {
+        success = reloadCalendar(id) && success;
+    }
+    return success;
+}
+
+void DirectoryBackend::setWatchEnabled(bool enabled)
+{
+    if (enabled == isWatchEnabled()) {
+        return;
+    }
+
+    if (!enabled) {
+        m_watcher.reset();
+        return;
+    }
+
+    m_watcher = std::make_unique<QFileSystemWatcher>();
+    m_watcher->addPath(m_directory.absolutePath());
+    for (auto it = m_calendars.constBegin(); it != m_calendars.constEnd(); ++it) {
+        m_watcher->addPath(m_directory.filePath(it.key() + QLatin1String(".ics")));
+    }
+
+    QObject::connect(m_watcher.get(), &QFileSystemWatcher::directoryChanged, m_watcher.get(), [this]() {
+        dispatch([this]() { rescanDirectory(); });
+    });
+    QObject::connect(m_watcher.get(), &QFileSystemWatcher::fileChanged, m_watcher.get(), [this](const QString &path) {
+        dispatch([this, path]() {
+            // The dispatcher must run callbacks on the thread that created the watcher
+            Q_ASSERT(!m_watcher || m_watcher->thread() == QThread::currentThread());
+            // Atomic replacement (QSaveFile, most editors) drops the inotify watch
+            if (m_watcher && QFile::exists(path) && !m_watcher->files().contains(path)) {
+                m_watcher->addPath(path);
+            }
+            const QString filename = QFileInfo(path).fileName();
+            reloadCalendar(filename.left(filename.length() - 4)); // Remove .ics
+        });
+    });
+}
+
+bool DirectoryBackend::isWatchEnabled() const
+{
+    return m_watcher != nullptr;
+}
+
+void DirectoryBackend::setChangeCallback(ChangeCallback onChange)
+{
+    m_changeCallback = std::move(onChange);
+}
+
+void DirectoryBackend::setCallbackDispatcher(ICSFileBackend::CallbackDispatcher dispatcher)
+{
+    m_dispatcher = std::move(dispatcher);
+    for (auto it = m_calendars.constBegin(); it != m_calendars.constEnd(); ++it) {
+        if (it.value()) {
+            adoptCalendar(it.key(), *it.value());
+        }
+    }
+}
+
+void DirectoryBackend::dispatch(std::function<void()> callback)
+{
+    if (m_dispatcher) {
+        m_dispatcher(std::move(callback));
+    } else {
+        callback();
+    }
+}
+
+void DirectoryBackend::adoptCalendar(const QString &id, ICSFileBackend &backend)
+{
+    backend.setDurability(m_durability);
+    if (!m_dispatcher) {
+        backend.setCallbackDispatcher(nullptr);
+        return;
+    }
+
+    // By the time a queued callback runs the calendar may be deleted or reloaded
+    const ICSFileBackend *expected = &backend;
+    backend.setCallbackDispatcher([this, id, expected](std::function<void()> callback) {
+        dispatch([this, id, expected, callback = std::move(callback)]() {
+            if (m_calendars.value(id).get() == expected) {
+                callback();
+            }
+        });
+    });
+}
+
+void DirectoryBackend::rescanDirectory()
+{
+    m_directory.setFilter(QDir::Files);
+    m_directory.setNameFilters({QLatin1String("*.ics")});
+
+    QStringList present;
+    const auto files = m_directory.entryList();
+    for (const auto &filename : files) {
+        present.append(filename.left(filename.length() - 4)); // Remove .ics
+    }
+
+    // Files that disappeared
+    const auto known = m_calendars.keys();
+    for (const QString &id : known) {
+        if (present.contains(id)) {
+            continue;
+        }
+
+        CalendarChanges changes;
+        changes.calendarId = id;
+        changes.calendarRemoved = true;
+        if (auto backend = m_calendars.value(id)) {
+            backend->discardChanges();
+            const auto events = backend->getEventsByCollection(QLatin1String("local"));
+            for (const auto &event : events) {
+                changes.removed.append(event->uid);
+            }
+        }
+        m_uidIndex.removeCalendar(id);
+        m_calendars.remove(id);
+        m_metadata[id].summary = CalendarSummary(); // Name and color survive until deleteCalendar()
+        QFile::remove(snapshotPath(id));
+        qDebug() << "DirectoryBackend: Calendar removed externally:" << id;
+
+        if (m_changeCallback) {
+            m_changeCallback(changes);
+        }
+    }
+
+    // Files that appeared
+    QStringList added;
+    for (const QString &id : std::as_const(present)) {
+        if (!m_calendars.contains(id)) {
+            added.append(id);
+        }
+    }
+
+    for (const QString &id : std::as_const(added)) {
+        if (!m_metadata.contains(id)) {
+            m_metadata[id] = CalendarMetadata{id, QString(), true};
+        }
+
+        // Registering as deferred and then resolving reuses the lazy loading path
+        m_calendars[id] = nullptr;
+        if (m_watcher) {
+            m_watcher->addPath(m_directory.filePath(id + QLatin1String(".ics")));
+        }
+
+        CalendarChanges changes;
+        changes.calendarId = id;
+        changes.calendarAdded = true;
+        if (m_loadMode == LoadMode::Eager || m_metadata.value(id).visible) {
+            const auto events = calendar(id)->getEventsByCollection(QLatin1String("local"));
+            for (const auto &event : events) {
+                changes.added.append(event->uid);
+            }
+        }
+        qDebug() << "DirectoryBackend: Calendar added externally:" << id;
+
+        if (m_changeCallback) {
+            m_changeCallback(changes);
+        }
+    }
+
+    if (!added.isEmpty()) {
+        saveCalendarMetadata();
+    }
+}
+
+bool DirectoryBackend::reloadCalendar(const QString &id)
+{
+    auto it = m_calendars.find(id);
+    if (it == m_calendars.end()) {
+        return false;
+    }
+
+    // Deferred calendars are parsed later anyway; their stored summary is
+    // validated against the file when it is needed
+    auto backend = it.value();
+    if (!backend || !backend->hasExternalChanges()) {
+        return true;
+    }
+
+    ICSFileBackend::Changes diff;
+    if (!backend->reload(diff)) {
+        m_lastError = backend->lastError();
+        qWarning() << "DirectoryBackend: Cannot reload calendar" << id << ":" << m_lastError;
         return false;
-    for (auto it = m_calendars.begin(); it != m_calendars.end(); ++it) {
-        if (!it.value()->sync())
-            return false;
+    }
+
+    for (const QString &uid : std::as_const(diff.removed)) {
+        // The event may have moved to a calendar that was reloaded first
+        if (m_uidIndex.value(uid) == id) {
+            m_uidIndex.remove(uid);
+        }
+    }
+    for (const QString &uid : std::as_const(diff.added)) {
+        if (auto event = backend->getEvent(uid)) {
+            event->calendarId = id;
+        }
+        m_uidIndex.insert(uid, id);
+    }
+
+    // Todos are always re-read as a whole
+    const auto todos = backend->getTodos();
+    for (const auto &todo : todos) {
+        todo->calendarId = id;
+    }
+
+    if (diff.isEmpty()) {
+        return true;
+    }
+
+    qDebug() << "DirectoryBackend: Reloaded" << id << "-" << diff.added.size() << "added," << diff.changed.size()
+             << "changed," << diff.removed.size() << "removed";
+    if (m_changeCallback) {
+        CalendarChanges changes;
+        changes.calendarId = id;
+        changes.added = std::move(diff.added);
+        changes.changed = std::move(diff.changed);
+        changes.removed = std::move(diff.removed);
+        m_changeCallback(changes);
     }
     return true;
 }
 
+void DirectoryBackend::setDurability(ICSFileBackend::Durability durability)
+{
+    m_durability = durability;
+    for (const auto &backend : std::as_const(m_calendars)) {
+        if (backend) {
+            backend->setDurability(durability);
+        }
+    }
+}
+
+bool DirectoryBackend::flush()
+{
+    bool success = true;
+    for (const auto &backend : std::as_const(m_calendars)) {
+        if (backend) {
+            success = backend->flush() && success;
+        }
+    }
+
+    if (m_metadataDirty) {
+        success = writeCalendarMetadata() && success;
+    }
+    return success;
+}
+
+QList<ICSFileBackend::PendingWrite> DirectoryBackend::takePendingWrites()
+{
+    QList<ICSFileBackend::PendingWrite> writes;
+    for (const auto &backend : std::as_const(m_calendars)) {
+        if (!backend) {
+            continue;
+        }
+        if (auto write = backend->takePendingWrite()) {
+            writes.append(std::move(*write));
+        }
+    }
+
+    if (m_metadataDirty) {
+        writes.append(ICSFileBackend::PendingWrite{metadataPath(), metadataContent()});
+        m_metadataDirty = false;
+    }
+    return writes;
+}
+
+void DirectoryBackend::finishPendingWrites(const QList<ICSFileBackend::PendingWrite> &writes)
+{
+    const QString metadata = metadataPath();
+    for (const auto &write : writes) {
+        if (write.filePath == metadata) {
+            m_metadataDirty = m_metadataDirty || !write.written;
+            continue;
+        }
+
+        const QString filename = QFileInfo(write.filePath).fileName();
+        if (auto backend = m_calendars.value(filename.left(filename.length() - 4))) { // Remove .ics
+            backend->finishPendingWrite(write);
+        }
+    }
+}
+
 bool DirectoryBackend::isOnline() const
 {
     return true;
@@ -331,14 +1256,147 @@ bool DirectoryBackend::isOnline() const
 
 QString DirectoryBackend::getLastSyncTime(const QString &collectionId)
 {
-    auto backend = m_calendars.value(collectionId);
-    return backend ? backend->getLastSyncTime(QLatin1String("local")) : QString();
+    if (auto backend = m_calendars.value(collectionId)) {
+        return backend->getLastSyncTime(QLatin1String("local"));
+    }
+
+    // Deferred calendars are not parsed just to report their file time
+    const QFileInfo info(m_directory.filePath(collectionId + QLatin1String(".ics")));
+    return m_calendars.contains(collectionId) && info.exists() ? info.lastModified().toString(Qt::ISODate) : QString();
+}
+
+DirectoryBackend::CalendarSummary DirectoryBackend::getCalendarSummary(const QString &id)
+{
+    if (auto backend = m_calendars.value(id)) {
+        return summarize(*backend);
+    }
+
+    // A stored summary is only valid for the file it was computed from
+    const CalendarMetadata meta = m_metadata.value(id);
+    const QFileInfo info(m_directory.filePath(id + QLatin1String(".ics")));
+    if (meta.fileSize != info.size() || meta.fileModified != info.lastModified().toMSecsSinceEpoch()) {
+        return CalendarSummary();
+    }
+    return meta.summary;
+}
+
+bool DirectoryBackend::isCalendarLoaded(const QString &id) const
+{
+    return m_calendars.value(id) != nullptr;
+}
+
+std::shared_ptr<ICSFileBackend> DirectoryBackend::calendar(const QString &id)
+{
+    auto it = m_calendars.find(id);
+    if (it == m_calendars.end()) {
+        return nullptr;
+    }
+
+    if (!it.value()) {
+        auto backend =
+            std::make_shared<ICSFileBackend>(m_directory.filePath(id + QLatin1String(".ics")), snapshotPath(id));
+        adoptCalendar(id, *backend);
+        it.value() = backend;
+        indexCalendar(id, *backend);
+        qDebug() << "DirectoryBackend: Loaded deferred calendar:" << id;
+    }
+    return it.value();
+}
+
+QString DirectoryBackend::snapshotPath(const QString &id) const
+{
+    return m_directory.filePath(QLatin1String(".calendars.cache/") + id + QLatin1String(".bin"));
+}
+
+QString DirectoryBackend::locate(const QString &uid)
+{
+    QString calendarId = m_uidIndex.value(uid);
+    if (!calendarId.isEmpty()) {
+        return calendarId;
+    }
+
+    // The UID may live in a calendar that has not been parsed yet
+    const auto ids = m_calendars.keys();
+    for (const QString &id : ids) {
+        if (!m_calendars.value(id)) {
+            calendar(id);
+            calendarId = m_uidIndex.value(uid);
+            if (!calendarId.isEmpty()) {
+                break;
+            }
+        }
+    }
+    return calendarId;
+}
+
+QString DirectoryBackend::locateTodo(const QString &uid, bool searchUnloaded)
+{
+    const auto ids = m_calendars.keys();
+    for (const QString &id : ids) {
+        const auto backend = m_calendars.value(id);
+        if (backend && backend->getTodo(uid)) {
+            return id;
+        }
+    }
+
+    if (searchUnloaded) {
+        for (const QString &id : ids) {
+            if (m_calendars.value(id)) {
+                continue;
+            }
+            const auto backend = calendar(id);
+            if (backend && backend->getTodo(uid)) {
+                return id;
+            }
+        }
+    }
+    return QString();
+}
+
+DirectoryBackend::CalendarSummary DirectoryBackend::summarize(ICSFileBackend &backend)
+{
+    CalendarSummary summary;
+    const auto events = backend.getEventsByCollection(QLatin1String("local"));
+    summary.eventCount = events.size();
+    for (const auto &event : events) {
+        const QDate first = event->startDateTime.date();
+        const QDate last = Core::CalendarEvent::lastDay(event->startDateTime, event->endDateTime);
+        if (!summary.firstDate.isValid() || first < summary.firstDate) {
+            summary.firstDate = first;
+        }
+        if (!summary.lastDate.isValid() || last > summary.lastDate) {
+            summary.lastDate = last;
+        }
+    }
+    return summary;
+}
+
+bool DirectoryBackend::refreshSummaries()
+{
+    bool changed = false;
+    for (auto it = m_calendars.begin(); it != m_calendars.end(); ++it) {
+        if (!it.value() || !m_metadata.contains(it.key())) {
+            continue;
+        }
+
+        const CalendarSummary summary = summarize(*it.value());
+        const QFileInfo info(m_directory.filePath(it.key() + QLatin1String(".ics")));
+        const qint64 modified = info.lastModified().toMSecsSinceEpoch();
+
+        CalendarMetadata &meta = m_metadata[it.key()];
+        if (meta.summary != summary || meta.fileSize != info.size() || meta.fileModified != modified) {
+            meta.summary = summary;
+            meta.fileSize = info.size();
+            meta.fileModified = modified;
+            changed = true;
+        }
+    }
+    return changed;
 }
 
 bool DirectoryBackend::loadCalendarMetadata()
 {
-    QString path = m_directory.filePath(QLatin1String(".calendars.json"));
-    QFile file(path);
+    QFile file(metadataPath());
     if (!file.open(QIODevice::ReadOnly))
         return false;
 
@@ -356,10 +1414,18 @@ bool DirectoryBackend::loadCalendarMetadata()
         QString id = it.key();
         QJsonObject meta = it.value().toObject();
 
-        if (m_calendars.contains(id)) {
-            m_metadata[id].name = meta.value(QLatin1String("name")).toString();
-            m_metadata[id].color = meta.value(QLatin1String("color")).toString();
-            m_metadata[id].visible = meta.value(QLatin1String("visible")).toBool(true);
+        CalendarMetadata &entry = m_metadata[id];
+        entry.name = meta.value(QLatin1String("name")).toString();
+        entry.color = meta.value(QLatin1String("color")).toString();
+        entry.visible = meta.value(QLatin1String("visible")).toBool(true);
+
+        const QJsonObject summary = meta.value(QLatin1String("summary")).toObject();
+        if (!summary.isEmpty()) {
+            entry.summary.eventCount = summary.value(QLatin1String("count")).toInt(-1);
+            entry.summary.firstDate = QDate::fromString(summary.value(QLatin1String("first")).toString(), Qt::ISODate);
+            entry.summary.lastDate = QDate::fromString(summary.value(QLatin1String("last")).toString(), Qt::ISODate);
+            entry.fileSize = summary.value(QLatin1String("size")).toInteger(-1);
+            entry.fileModified = summary.value(QLatin1String("modified")).toInteger(-1);
         }
     }
     return true;
@@ -367,27 +1433,55 @@ bool DirectoryBackend::loadCalendarMetadata()
 
 bool DirectoryBackend::saveCalendarMetadata()
 {
-    QString path = m_directory.filePath(QLatin1String(".calendars.json"));
-    QFile file(path);
+    if (m_durability == ICSFileBackend::Durability::Manual) {
+        m_metadataDirty = true;
+        return true;
+    }
+    return writeCalendarMetadata();
+}
+
+bool DirectoryBackend::writeCalendarMetadata()
+{
+    QFile file(metadataPath());
     if (!file.open(QIODevice::WriteOnly))
         return false;
 
+    file.write(metadataContent());
+    file.close();
+    m_metadataDirty = false;
+    return true;
+}
+
+QString DirectoryBackend::metadataPath() const
+{
+    return m_directory.filePath(QLatin1String(".calendars.json"));
+}
+
+QByteArray DirectoryBackend::metadataContent() const
+{
     QJsonObject calendars;
     for (auto it = m_metadata.begin(); it != m_metadata.end(); ++it) {
         QJsonObject meta;
         meta.insert(QLatin1String("name"), it.value().name);
         meta.insert(QLatin1String("color"), it.value().color);
         meta.insert(QLatin1String("visible"), it.value().visible);
+
+        const CalendarSummary &summary = it.value().summary;
+        if (summary.isValid()) {
+            QJsonObject summaryObject;
+            summaryObject.insert(QLatin1String("count"), summary.eventCount);
+            summaryObject.insert(QLatin1String("first"), summary.firstDate.toString(Qt::ISODate));
+            summaryObject.insert(QLatin1String("last"), summary.lastDate.toString(Qt::ISODate));
+            summaryObject.insert(QLatin1String("size"), it.value().fileSize);
+            summaryObject.insert(QLatin1String("modified"), it.value().fileModified);
+            meta.insert(QLatin1String("summary"), summaryObject);
+        }
         calendars.insert(it.key(), meta);
     }
 
     QJsonObject root;
     root.insert(QLatin1String("calendars"), calendars);
-
-    QJsonDocument doc(root);
-    file.write(doc.toJson());
-    file.close();
-    return true;
+    return QJsonDocument(root).toJson();
 }
 
-} // namespace PersonalCalendar::Local
\ No newline at end of file
+} // namespace PersonalCalendar::Local
@@ -4,8 +4,14 @@
 #pragma once
 
 #include "ICSFileBackend.h"
+#include "UidIndex.h"
+#include <QDate>
 #include <QDir>
 #include <QMap>
+#include <functional>
+#include <memory>
+
+class QFileSystemWatcher;
 
 namespace PersonalCalendar::Local
 {
@@ -15,16 +21,78 @@ namespace PersonalCalendar::Local
  *
  * Implements ICalendarStorage using a directory of .ics files
  * One .ics file per calendar, supports auto-discovery and management
+ *
+ * Loading is synchronous: the constructor returns only after every calendar
+ * that is not deferred has been parsed, so construct the backend off the GUI
+ * thread when the directory may be large. The files are parsed concurrently
+ * on a private thread pool; each calendar is published (and progress
+ * reported) on the constructing thread as soon as its file is ready.
+ *
+ * In LazyHidden mode calendars marked hidden in .calendars.json are not
+ * parsed at startup. Only their metadata and a cached summary are kept until
+ * the calendar becomes visible or is addressed by UID or collection.
+ *
+ * Parsed calendars are mirrored in binary snapshots under .calendars.cache/,
+ * which replace the text parse on later starts while the .ics is unchanged.
+ *
+ * Changes made by other programs are picked up incrementally: only files
+ * whose size or mtime changed are reparsed, and their events are diffed
+ * against memory by UID and content hash. With watching enabled this
+ * happens as soon as a file changes (requires a running event loop).
  */
 class DirectoryBackend : public Core::ICalendarStorage
 {
 public:
+    /**
+     * @brief Reports calendar loading progress
+     * @param loaded Number of calendars published so far
+     * @param total Number of calendars being loaded
+     * @param calendarId Calendar that just became available
+     */
+    using LoadProgressCallback = std::function<void(int loaded, int total, const QString &calendarId)>;
+
+    /**
+     * @brief Which calendars are parsed at startup
+     */
+    enum class LoadMode {
+        Eager,     // Parse every calendar
+        LazyHidden // Defer hidden calendars until they are needed
+    };
+
+    /**
+     * @brief Cheap description of a calendar that does not require parsing it
+     */
+    struct CalendarSummary {
+        int eventCount = -1; // -1 if unknown
+        QDate firstDate;
+        QDate lastDate;
+
+        bool isValid() const { return eventCount >= 0; }
+        bool operator==(const CalendarSummary &other) const = default;
+    };
+
+    /**
+     * @brief Differences found when a calendar is re-read from disk
+     */
+    struct CalendarChanges {
+        QString calendarId;
+        bool calendarAdded = false;   // A new .ics file appeared
+        bool calendarRemoved = false; // The .ics file disappeared
+        QStringList added;
+        QStringList changed;
+        QStringList removed;
+    };
+    using ChangeCallback = std::function<void(const CalendarChanges &changes)>;
+
     /**
      * @brief Constructor
      * @param directoryPath Path to directory containing .ics files
      * @param createIfMissing Create directory if it doesn't exist
+     * @param onProgress Called after each calendar is loaded during construction (optional)
+     * @param loadMode Whether hidden calendars are parsed at startup
      */
-    explicit DirectoryBackend(const QString &directoryPath, bool createIfMissing = true);
+    explicit DirectoryBackend(const QString &directoryPath, bool createIfMissing = true,
+                              LoadProgressCallback onProgress = nullptr, LoadMode loadMode = LoadMode::Eager);
 
     ~DirectoryBackend() override;
 
@@ -33,10 +101,30 @@ public:
     Core::CalendarEventPtr getEvent(const QString &uid) override;
     bool updateEvent(const Core::CalendarEventPtr &event) override;
     bool deleteEvent(const QString &uid) override;
+    bool applyBatch(const QList<Core::EventMutation> &mutations) override;
+    int deleteWhere(const Core::EventPredicate &predicate, const QStringList &calendarIds = QStringList()) override;
 
     QList<Core::CalendarEventPtr> getEventsByDate(const QDate &date) override;
     QList<Core::CalendarEventPtr> getEventsByDateRange(const QDate &start, const QDate &end) override;
+    QList<Core::EventOccurrence> getOccurrencesByDateRange(const QDate &start, const QDate &end) override;
+    QList<Core::CalendarEventPtr> getEventsWithCategories(const QDate &start, const QDate &end,
+                                                          const QStringList &categories) override;
+    QList<Core::EventOccurrence> getOccurrencesWithCategories(const QDate &start, const QDate &end,
+                                                              const QStringList &categories) override;
     QList<Core::CalendarEventPtr> getEventsByCollection(const QString &collectionId) override;
+    Core::SearchResults searchEvents(const Core::SearchQuery &query) override;
+    Core::FreeBusy getFreeBusy(const Core::FreeBusyQuery &query) override;
+
+    // Todos are read from the calendar that owns them; queries cover visible calendars
+    bool createTodo(const Core::TodoItemPtr &todo) override;
+    Core::TodoItemPtr getTodo(const QString &uid) override;
+    bool updateTodo(const Core::TodoItemPtr &todo) override;
+    bool deleteTodo(const QString &uid) override;
+    QList<Core::TodoItemPtr> getTodos() override;
+    QList<Core::TodoItemPtr> getOverdueTodos(const QDateTime &now) override;
+    QList<Core::TodoItemPtr> getTodosDueBetween(const QDateTime &start, const QDateTime &end) override;
+    QList<Core::TodoItemPtr> getTodosByStatus(Core::TodoItem::Status status) override;
+    QList<Core::TodoItemPtr> getTopTodosByPriority(int count) override;
 
     QList<QString> getCalendarIds() override;
     QString getCalendarName(const QString &id) override;
@@ -53,36 +141,169 @@ public:
     bool isOnline() const override;
     QString getLastSyncTime(const QString &collectionId) override;
 
+    /**
+     * @brief Events of visible calendars overlapping an exact time range
+     * @see ICSFileBackend::getEventsBetween
+     */
+    QList<Core::CalendarEventPtr> getEventsBetween(const QDateTime &start, const QDateTime &end,
+                                                   bool includeCancelled = true);
+
+    /**
+     * @brief Set the durability mode of every calendar file
+     *
+     * Applies to calendars discovered or created later as well. In Manual
+     * mode .calendars.json is also only written by flush().
+     */
+    void setDurability(ICSFileBackend::Durability durability);
+
+    /**
+     * @brief Write pending changes of all calendars
+     * @return true if every calendar was flushed successfully
+     */
+    bool flush();
+
+    /**
+     * @brief Serialize the pending changes of every calendar and of the metadata file
+     *
+     * Lets a caller that guards the backend with a mutex write to disk
+     * outside of it; see ICSFileBackend::PendingWrite.
+     */
+    QList<ICSFileBackend::PendingWrite> takePendingWrites();
+
+    /**
+     * @brief Record the outcome of ICSFileBackend::writePending() for each write
+     */
+    void finishPendingWrites(const QList<ICSFileBackend::PendingWrite> &writes);
+
+    // External changes
+
+    /**
+     * @brief Watch the directory and calendar files for external changes
+     */
+    void setWatchEnabled(bool enabled);
+    bool isWatchEnabled() const;
+
+    /**
+     * @brief Set the callback receiving each non-empty set of external changes
+     */
+    void setChangeCallback(ChangeCallback onChange);
+
+    /**
+     * @brief Route watcher and GroupCommit timer callbacks through a dispatcher
+     *
+     * Needed when the backend is shared between threads behind a lock: the
+     * dispatcher queues the callback on the thread that created the watcher
+     * (the one that called setWatchEnabled()) and takes the lock. Reloading
+     * writes out unsaved changes first, so the dispatcher should run
+     * takePendingWrites() / writePending() / finishPendingWrites() before it
+     * takes the lock. A callback of a calendar that was deleted or replaced
+     * in the meantime is dropped.
+     * @see ICSFileBackend::setCallbackDispatcher
+     */
+    void setCallbackDispatcher(ICSFileBackend::CallbackDispatcher dispatcher);
+
+    /**
+     * @brief Pick up calendar files that were added or removed
+     *
+     * A removed calendar keeps its name, color and visibility, so a file that
+     * comes back (e.g. restored or re-synced) looks as before. Only
+     * deleteCalendar() forgets them.
+     */
+    void rescanDirectory();
+
+    /**
+     * @brief Re-read one calendar if its file changed behind our back
+     * @return false if the file could not be read
+     */
+    bool reloadCalendar(const QString &id);
+
+    /**
+     * @brief Event count and date span of a calendar
+     *
+     * Computed from the events of a loaded calendar; for a deferred one the
+     * summary stored in .calendars.json is returned, or an invalid summary if
+     * the file changed since it was recorded.
+     */
+    CalendarSummary getCalendarSummary(const QString &id);
+
+    /**
+     * @brief Check whether a calendar has been parsed
+     */
+    bool isCalendarLoaded(const QString &id) const;
+
 private:
     struct CalendarMetadata {
         QString name;
         QString color;
         bool visible = true;
+
+        // Summary and the file state it was computed from
+        CalendarSummary summary;
+        qint64 fileSize = -1;
+        qint64 fileModified = -1; // msecs since epoch
     };
 
     QString m_directoryPath;
     QDir m_directory;
 
-    // Map calendar ID to backend
+    // Map calendar ID to backend, null while a calendar is deferred
     QMap<QString, std::shared_ptr<ICSFileBackend>> m_calendars;
 
     // Map calendar ID to metadata
     QMap<QString, CalendarMetadata> m_metadata;
 
-    // Map UID to calendar ID
-    QMap<QString, QString> m_eventToCalendar;
+    // Map UID to calendar ID, rebuilt whenever calendars are (re)loaded
+    UidIndex m_uidIndex;
 
     QString m_lastError;
 
+    ICSFileBackend::Durability m_durability = ICSFileBackend::Durability::Immediate;
+    LoadMode m_loadMode = LoadMode::Eager;
+    LoadProgressCallback m_loadProgress;
+    ChangeCallback m_changeCallback;
+    std::unique_ptr<QFileSystemWatcher> m_watcher;
+
+    ICSFileBackend::CallbackDispatcher m_dispatcher;
+    void dispatch(std::function<void()> callback);
+    void adoptCalendar(const QString &id, ICSFileBackend &backend);
+
     // Initialization
     bool initialize();
 
     // Directory scanning
     bool discoverCalendars();
 
-    // Metadata management
+    // Add every event of a freshly loaded calendar to the UID index
+    void indexCalendar(const QString &calendarId, ICSFileBackend &backend);
+
+    // Backend of a calendar, parsing it first if it was deferred
+    std::shared_ptr<ICSFileBackend> calendar(const QString &id);
+
+    // Binary snapshot of a calendar file
+    QString snapshotPath(const QString &id) const;
+
+    // Calendar holding a UID, loading deferred calendars until it is found
+    QString locate(const QString &uid);
+
+    // Calendar holding a todo; todos are not in the UID index, so each
+    // calendar is asked in turn
+    QString locateTodo(const QString &uid, bool searchUnloaded);
+
+    // Summaries
+    static CalendarSummary summarize(ICSFileBackend &backend);
+    bool refreshSummaries();
+
+    // Calendar a new event is created in when it does not name a valid one
+    QString defaultCalendarId() const;
+
+    // Metadata management. In Manual durability saving only marks the file
+    // dirty; flush() and takePendingWrites() write it with the calendars
     bool loadCalendarMetadata();
     bool saveCalendarMetadata();
+    bool writeCalendarMetadata();
+    QString metadataPath() const;
+    QByteArray metadataContent() const;
+    bool m_metadataDirty = false;
 };
 
 } // namespace PersonalCalendar::Local
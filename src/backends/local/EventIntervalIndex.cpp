@@ -0,0 +1,233 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "EventIntervalIndex.h"
+#include <algorithm>
+
+namespace PersonalCalendar::Local
+{
+
+void EventIntervalIndex::insert(const Core::CalendarEventPtr &event, qint64 start, qint64 end)
+{
+    if (!event) {
+        return;
+    }
+
+    remove(event->uid);
+
+    int created;
+    if (m_freeNodes.empty()) {
+        created = static_cast<int>(m_nodes.size());
+        m_nodes.emplace_back();
+    } else {
+        created = m_freeNodes.back();
+        m_freeNodes.pop_back();
+    }
+
+    Node &node = m_nodes[created];
+    node.start = start;
+    node.end = std::max(start, end);
+    node.maxEnd = node.end;
+    node.uid = event->uid;
+    node.event = event;
+    node.left = -1;
+    node.right = -1;
+    node.height = 1;
+
+    m_root = insertNode(m_root, created);
+    m_byUid.insert(event->uid, created);
+}
+
+void EventIntervalIndex::remove(const QString &uid)
+{
+    const auto it = m_byUid.constFind(uid);
+    if (it == m_byUid.constEnd()) {
+        return;
+    }
+
+    const qint64 start = m_nodes[it.value()].start;
+    m_byUid.erase(it);
+    m_root = eraseNode(m_root, start, uid);
+}
+
+void EventIntervalIndex::clear()
+{
+    m_nodes.clear();
+    m_freeNodes.clear();
+    m_root = -1;
+    m_byUid.clear();
+}
+
+int EventIntervalIndex::size() const
+{
+    return m_byUid.size();
+}
+
+QList<Core::CalendarEventPtr> EventIntervalIndex::overlapping(qint64 start, qint64 end) const
+{
+    QList<Core::CalendarEventPtr> result;
+    if (start > end) {
+        return result;
+    }
+
+    collect(m_root, start, end, result);
+    return result;
+}
+
+QList<Core::CalendarEventPtr> EventIntervalIndex::stabbing(qint64 point) const
+{
+    return overlapping(point, point);
+}
+
+bool EventIntervalIndex::less(const Node &a, qint64 start, const QString &uid) const
+{
+    if (a.start != start) {
+        return a.start < start;
+    }
+    return a.uid < uid;
+}
+
+int EventIntervalIndex::height(int node) const
+{
+    return node < 0 ? 0 : m_nodes[node].height;
+}
+
+void EventIntervalIndex::update(int node)
+{
+    Node &n = m_nodes[node];
+    n.height = 1 + std::max(height(n.left), height(n.right));
+    n.maxEnd = n.end;
+    if (n.left >= 0) {
+        n.maxEnd = std::max(n.maxEnd, m_nodes[n.left].maxEnd);
+    }
+    if (n.right >= 0) {
+        n.maxEnd = std::max(n.maxEnd, m_nodes[n.right].maxEnd);
+    }
+}
+
+int EventIntervalIndex::rotateLeft(int node)
+{
+    const int pivot = m_nodes[node].right;
+    m_nodes[node].right = m_nodes[pivot].left;
+    m_nodes[pivot].left = node;
+    update(node);
+    update(pivot);
+    return pivot;
+}
+
+int EventIntervalIndex::rotateRight(int node)
+{
+    const int pivot = m_nodes[node].left;
+    m_nodes[node].left = m_nodes[pivot].right;
+    m_nodes[pivot].right = node;
+    update(node);
+    update(pivot);
+    return pivot;
+}
+
+int EventIntervalIndex::balance(int node)
+{
+    update(node);
+    const int skew = height(m_nodes[node].left) - height(m_nodes[node].right);
+    if (skew > 1) {
+        const int left = m_nodes[node].left;
+        if (height(m_nodes[left].left) < height(m_nodes[left].right)) {
+            m_nodes[node].left = rotateLeft(left);
+        }
+        return rotateRight(node);
+    }
+    if (skew < -1) {
+        const int right = m_nodes[node].right;
+        if (height(m_nodes[right].right) < height(m_nodes[right].left)) {
+            m_nodes[node].right = rotateRight(right);
+        }
+        return rotateLeft(node);
+    }
+    return node;
+}
+
+int EventIntervalIndex::insertNode(int node, int created)
+{
+    if (node < 0) {
+        return created;
+    }
+
+    const Node &entry = m_nodes[created];
+    if (less(entry, m_nodes[node].start, m_nodes[node].uid)) {
+        const int left = insertNode(m_nodes[node].left, created);
+        m_nodes[node].left = left;
+    } else {
+        const int right = insertNode(m_nodes[node].right, created);
+        m_nodes[node].right = right;
+    }
+    return balance(node);
+}
+
+int EventIntervalIndex::eraseNode(int node, qint64 start, const QString &uid)
+{
+    if (node < 0) {
+        return -1;
+    }
+
+    Node &n = m_nodes[node];
+    if (n.start == start && n.uid == uid) {
+        const int left = n.left;
+        int right = n.right;
+        n.event.reset();
+        n.uid.clear();
+        m_freeNodes.push_back(node);
+
+        if (right < 0) {
+            return left;
+        }
+        int successor = -1;
+        right = detachMin(right, successor);
+        m_nodes[successor].left = left;
+        m_nodes[successor].right = right;
+        return balance(successor);
+    }
+
+    if (less(n, start, uid)) {
+        const int right = eraseNode(n.right, start, uid);
+        m_nodes[node].right = right;
+    } else {
+        const int left = eraseNode(n.left, start, uid);
+        m_nodes[node].left = left;
+    }
+    return balance(node);
+}
+
+int EventIntervalIndex::detachMin(int node, int &min)
+{
+    if (m_nodes[node].left < 0) {
+        min = node;
+        return m_nodes[node].right;
+    }
+    const int left = detachMin(m_nodes[node].left, min);
+    m_nodes[node].left = left;
+    return balance(node);
+}
+
+void EventIntervalIndex::collect(int node, qint64 start, qint64 end, QList<Core::CalendarEventPtr> &out) const
+{
+    // Nothing in this subtree reaches the query start
+    if (node < 0 || m_nodes[node].maxEnd < start) {
+        return;
+    }
+
+    const Node &n = m_nodes[node];
+    collect(n.left, start, end, out);
+
+    // Everything from here onwards starts after the query end
+    if (n.start > end) {
+        return;
+    }
+
+    if (n.end >= start) {
+        out.append(n.event);
+    }
+
+    collect(n.right, start, end, out);
+}
+
+} // namespace PersonalCalendar::Local
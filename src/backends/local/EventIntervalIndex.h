@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include "core/models/CalendarEvent.h"
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <vector>
+
+namespace PersonalCalendar::Local
+{
+
+/**
+ * @brief Interval index over event start/end keys
+ *
+ * An AVL tree ordered by start key (ties by UID) in which every node also
+ * stores the maximum end key of its subtree. Insert, replace and remove
+ * rebalance and fix up the maxima along one root path, O(log n). Overlap
+ * and stabbing queries cost O(log n + k) and return events in start order.
+ * Nodes live in one array and refer to each other by index, so the tree
+ * does not allocate per event.
+ *
+ * Queries do not modify the index, so concurrent queries are safe. A
+ * mutation must not run concurrently with anything else; the owning
+ * backend is expected to be guarded by one exclusive lock (see
+ * Core::SynchronizedStorage).
+ */
+class EventIntervalIndex
+{
+public:
+    /**
+     * @brief Insert or replace the interval of an event
+     * @param event Event to index (keyed by its UID)
+     * @param start Start key (inclusive)
+     * @param end End key (inclusive), clamped to start if smaller
+     */
+    void insert(const Core::CalendarEventPtr &event, qint64 start, qint64 end);
+
+    /**
+     * @brief Remove the interval of an event
+     * @param uid Event UID
+     */
+    void remove(const QString &uid);
+
+    void clear();
+    int size() const;
+
+    /**
+     * @brief Events whose interval intersects the closed range [start, end]
+     */
+    QList<Core::CalendarEventPtr> overlapping(qint64 start, qint64 end) const;
+
+    /**
+     * @brief Events whose interval contains the given point
+     */
+    QList<Core::CalendarEventPtr> stabbing(qint64 point) const;
+
+private:
+    struct Node {
+        qint64 start = 0;
+        qint64 end = 0;
+        qint64 maxEnd = 0; // Largest end key in this subtree
+        QString uid;
+        Core::CalendarEventPtr event;
+        int left = -1;
+        int right = -1;
+        int height = 1;
+    };
+
+    bool less(const Node &a, qint64 start, const QString &uid) const;
+    int height(int node) const;
+    void update(int node);
+    int rotateLeft(int node);
+    int rotateRight(int node);
+    int balance(int node);
+    int insertNode(int node, int created);
+    int eraseNode(int node, qint64 start, const QString &uid);
+    int detachMin(int node, int &min);
+    void collect(int node, qint64 start, qint64 end, QList<Core::CalendarEventPtr> &out) const;
+
+    std::vector<Node> m_nodes;
+    std::vector<int> m_freeNodes;
+    int m_root = -1;
+    QHash<QString, int> m_byUid; // UID -> node
+};
+
+} // namespace PersonalCalendar::Local
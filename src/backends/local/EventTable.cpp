@@ -0,0 +1,181 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "EventTable.h"
+#include <algorithm>
+#include <cstring>
+
+namespace PersonalCalendar::Local
+{
+
+namespace
+{
+// Rows evaluated per pass of the branch-free predicate
+constexpr qsizetype kScanBlock = 256;
+} // namespace
+
+void EventTable::insert(const Core::CalendarEventPtr &event)
+{
+    if (!event) {
+        return;
+    }
+
+    // Owners cache the compact times before inserting; fall back for bare events
+    const Core::UtcTime utcStart =
+        event->utcStart.isValid() ? event->utcStart : Core::UtcTime::fromDateTime(event->startDateTime);
+    const Core::UtcTime utcEnd = event->utcEnd.isValid() ? event->utcEnd : Core::UtcTime::fromDateTime(event->endDateTime);
+
+    const qint64 start = utcStart.secsSinceEpoch();
+    const qint64 end = utcEnd.isValid() ? std::max(start, utcEnd.secsSinceEpoch()) : start;
+    const quint8 flags = flagsFor(*event);
+
+    auto it = m_rows.constFind(event->uid);
+    if (it != m_rows.constEnd()) {
+        const qsizetype row = it.value();
+        m_start[row] = start;
+        m_end[row] = end;
+        m_flags[row] = flags;
+        m_events[row] = event;
+        return;
+    }
+
+    m_rows.insert(event->uid, qsizetype(m_events.size()));
+    m_start.push_back(start);
+    m_end.push_back(end);
+    m_flags.push_back(flags);
+    m_events.push_back(event);
+}
+
+void EventTable::remove(const QString &uid)
+{
+    auto it = m_rows.find(uid);
+    if (it == m_rows.end()) {
+        return;
+    }
+
+    const qsizetype row = it.value();
+    const qsizetype last = qsizetype(m_events.size()) - 1;
+    m_rows.erase(it);
+
+    if (row != last) {
+        m_start[row] = m_start[last];
+        m_end[row] = m_end[last];
+        m_flags[row] = m_flags[last];
+        m_events[row] = std::move(m_events[last]);
+        m_rows[m_events[row]->uid] = row;
+    }
+
+    m_start.pop_back();
+    m_end.pop_back();
+    m_flags.pop_back();
+    m_events.pop_back();
+}
+
+void EventTable::clear()
+{
+    m_start.clear();
+    m_end.clear();
+    m_flags.clear();
+    m_events.clear();
+    m_rows.clear();
+}
+
+void EventTable::reserve(qsizetype rows)
+{
+    m_start.reserve(rows);
+    m_end.reserve(rows);
+    m_flags.reserve(rows);
+    m_events.reserve(rows);
+    m_rows.reserve(rows);
+}
+
+int EventTable::size() const
+{
+    return int(m_events.size());
+}
+
+QList<Core::CalendarEventPtr> EventTable::overlapping(qint64 from, qint64 to, quint8 excluded, quint8 required) const
+{
+    std::vector<qsizetype> matches = matchingRows(from, to, excluded, required);
+    const qint64 *starts = m_start.data();
+    std::sort(matches.begin(), matches.end(), [starts](qsizetype a, qsizetype b) { return starts[a] < starts[b]; });
+
+    QList<Core::CalendarEventPtr> result;
+    result.reserve(qsizetype(matches.size()));
+    for (const qsizetype row : matches) {
+        result.append(m_events[row]);
+    }
+    return result;
+}
+
+std::vector<EventTable::Span> EventTable::spans(qint64 from, qint64 to, quint8 excluded, quint8 required) const
+{
+    const std::vector<qsizetype> matches = matchingRows(from, to, excluded, required);
+
+    std::vector<Span> result;
+    result.reserve(matches.size());
+    for (const qsizetype row : matches) {
+        result.push_back(Span{m_start[row], m_end[row], m_flags[row], m_events[row].get()});
+    }
+    return result;
+}
+
+std::vector<qsizetype> EventTable::matchingRows(qint64 from, qint64 to, quint8 excluded, quint8 required) const
+{
+    const qsizetype rows = qsizetype(m_events.size());
+    const qint64 *starts = m_start.data();
+    const qint64 *ends = m_end.data();
+    const quint8 *flags = m_flags.data();
+
+    std::vector<qsizetype> matches;
+    alignas(16) quint8 mask[kScanBlock];
+
+    for (qsizetype base = 0; base < rows; base += kScanBlock) {
+        const qsizetype count = std::min(kScanBlock, rows - base);
+
+        // No branches and no early exit: this loop vectorizes
+        for (qsizetype i = 0; i < count; ++i) {
+            const qint64 start = starts[base + i];
+            const qint64 end = ends[base + i];
+            const quint8 flag = flags[base + i];
+            mask[i] = quint8(start < to) & (quint8(end > from) | quint8(start >= from)) &
+                quint8((flag & excluded) == 0) & quint8((flag & required) == required);
+        }
+
+        // Skip eight rows at a time while nothing matched
+        for (qsizetype i = 0; i < count; i += 8) {
+            const qsizetype width = std::min<qsizetype>(8, count - i);
+            quint64 word = 0;
+            std::memcpy(&word, mask + i, size_t(width));
+            if (word == 0) {
+                continue;
+            }
+            for (qsizetype j = i; j < i + width; ++j) {
+                if (mask[j]) {
+                    matches.push_back(base + j);
+                }
+            }
+        }
+    }
+    return matches;
+}
+
+quint8 EventTable::flagsFor(const Core::CalendarEvent &event)
+{
+    quint8 flags = 0;
+    if (event.isAllDay) {
+        flags |= AllDay;
+    }
+    if (event.recurrence.isValid() || !event.recurrenceDates.isEmpty()) {
+        flags |= Recurring;
+    }
+    if (event.status == Core::EventStatus::Cancelled) {
+        flags |= Cancelled;
+    }
+    if (event.status == Core::EventStatus::Tentative) {
+        flags |= Tentative;
+    }
+    return flags;
+}
+
+} // namespace PersonalCalendar::Local
@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include "core/models/CalendarEvent.h"
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <vector>
+
+namespace PersonalCalendar::Local
+{
+
+/**
+ * @brief Columnar side table for exact-time range filtering
+ *
+ * Keeps the fields range queries look at in contiguous arrays: start and
+ * end as UTC epoch seconds, a flag byte and the event handle. A scan only
+ * touches the columns, never the events or their QDateTime/QTimeZone data,
+ * and its predicate is branch-free so the compiler turns it into vector
+ * compares over blocks of rows; only blocks with a match are visited again.
+ *
+ * Rows are unordered; removal moves the last row into the hole, so every
+ * mutation is O(1).
+ */
+class EventTable
+{
+public:
+    enum Flag : quint8 {
+        AllDay = 0x1,
+        Recurring = 0x2,
+        Cancelled = 0x4,
+        Tentative = 0x8,
+    };
+
+    /**
+     * @brief Columns of one matching row
+     */
+    struct Span {
+        qint64 start;
+        qint64 end;
+        quint8 flags;
+        const Core::CalendarEvent *event;
+    };
+
+    /**
+     * @brief Insert or replace the row of an event (keyed by its UID)
+     */
+    void insert(const Core::CalendarEventPtr &event);
+
+    /**
+     * @brief Remove the row of an event
+     */
+    void remove(const QString &uid);
+
+    void clear();
+    void reserve(qsizetype rows);
+    int size() const;
+
+    /**
+     * @brief Events overlapping the half-open range [from, to)
+     *
+     * Zero-length events match when their start lies in the range.
+     *
+     * @param from Range start, UTC epoch seconds
+     * @param to Range end, UTC epoch seconds
+     * @param excluded Rows with any of these flags are skipped
+     * @param required Rows must carry all of these flags
+     * @return Matching events in start order
+     */
+    QList<Core::CalendarEventPtr> overlapping(qint64 from, qint64 to, quint8 excluded = 0, quint8 required = 0) const;
+
+    /**
+     * @brief Columns of the rows overlapping [from, to), unordered
+     *
+     * Same predicate as overlapping(), but skips the sort and the handle
+     * copies; for callers that aggregate the times themselves.
+     */
+    std::vector<Span> spans(qint64 from, qint64 to, quint8 excluded = 0, quint8 required = 0) const;
+
+    static quint8 flagsFor(const Core::CalendarEvent &event);
+
+private:
+    std::vector<qsizetype> matchingRows(qint64 from, qint64 to, quint8 excluded, quint8 required) const;
+
+    std::vector<qint64> m_start;
+    std::vector<qint64> m_end;
+    std::vector<quint8> m_flags;
+    std::vector<Core::CalendarEventPtr> m_events;
+    QHash<QString, qsizetype> m_rows;
+};
+
+} // namespace PersonalCalendar::Local
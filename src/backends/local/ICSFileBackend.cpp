@@ -2,25 +2,63 @@
 // SPDX-License-Identifier: LGPL-2.1-or-later
 
 #include "ICSFileBackend.h"
+#include "ICalWriter.h"
+#include "SnapshotCache.h"
+#include "core/utils/FreeBusyCalculator.h"
+#include "core/utils/RecurrenceCalculator.h"
+#include <QBuffer>
 #include <QDateTime>
 #include <QDebug>
 #include <QFile>
-#include <QTextStream>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QTimer>
+#include <algorithm>
 
 namespace PersonalCalendar::Local
 {
 
-ICSFileBackend::ICSFileBackend(const QString &filePath) : m_filePath(filePath)
+namespace
+{
+// Upper bound on how long GroupCommit lets a steady stream of mutations postpone a flush
+constexpr int kMaxFlushDelayFactor = 10;
+
+// Windows wider than this (year views) bypass the month-bucket cache: they
+// would evict the buckets month views depend on, so they are expanded in
+// parallel instead
+constexpr qint64 kMaxCachedWindowDays = 93;
+
+// Events whose instances go beyond DTSTART: an RRULE, extra RDATEs, or both
+bool isSeries(const Core::CalendarEvent &event)
+{
+    return event.recurrence.isValid() || !event.recurrenceDates.isEmpty();
+}
+} // namespace
+
+ICSFileBackend::ICSFileBackend(const QString &filePath, const QString &snapshotPath)
+    : m_filePath(filePath), m_snapshotPath(snapshotPath)
 {
     qDebug() << "ICSFileBackend: Loading from" << filePath;
-    loadFromFile();
+    if (!loadFromFile() && !QFile::exists(filePath)) {
+        // A new calendar: make sure the file gets created on the first flush
+        m_dirty = true;
+        m_dirtySince.start();
+    }
 }
 
 ICSFileBackend::~ICSFileBackend()
 {
-    // Save before destruction
-    saveToFile();
-    qDebug() << "ICSFileBackend: Destroyed and saved";
+    m_flushTimer.reset();
+
+    // Save pending changes before destruction
+    if (m_dirty) {
+        flush();
+    }
+    if (m_snapshotStale && !m_dirty) {
+        writeSnapshot();
+    }
+    qDebug() << "ICSFileBackend: Destroyed";
 }
 
 bool ICSFileBackend::createEvent(const Core::CalendarEventPtr &event)
@@ -36,7 +74,8 @@ bool ICSFileBackend::createEvent(const Core::CalendarEventPtr &event)
     }
 
     m_events[event->uid] = event;
-    return saveToFile();
+    indexEvent(event);
+    return commitChange();
 }
 
 Core::CalendarEventPtr ICSFileBackend::getEvent(const QString &uid)
@@ -68,7 +107,8 @@ bool ICSFileBackend::updateEvent(const Core::CalendarEventPtr &event)
     }
 
     m_events[event->uid] = event;
-    return saveToFile();
+    indexEvent(event);
+    return commitChange();
 }
 
 bool ICSFileBackend::deleteEvent(const QString &uid)
@@ -84,7 +124,104 @@ bool ICSFileBackend::deleteEvent(const QString &uid)
         return false;
     }
 
-    return saveToFile();
+    unindexEvent(uid);
+    return commitChange();
+}
+
+bool ICSFileBackend::applyBatch(const QList<Core::EventMutation> &mutations)
+{
+    using Type = Core::EventMutation::Type;
+
+    // Validate the whole batch against the state it will see, without touching anything
+    QHash<QString, bool> exists; // UID -> exists after the mutations seen so far
+    for (qsizetype i = 0; i < mutations.size(); ++i) {
+        const auto &mutation = mutations[i];
+        const QString uid = mutation.targetUid();
+        if (uid.isEmpty() || (mutation.type != Type::Delete && (!mutation.event || !mutation.event->isValid()))) {
+            m_lastError = QLatin1String("Invalid mutation at index ") + QString::number(i);
+            return false;
+        }
+
+        auto it = exists.find(uid);
+        if (it == exists.end()) {
+            it = exists.insert(uid, m_events.contains(uid));
+        }
+
+        if (mutation.type == Type::Create ? it.value() : !it.value()) {
+            m_lastError = (mutation.type == Type::Create ? QLatin1String("Event with same UID already exists: ")
+                                                         : QLatin1String("Event not found: ")) +
+                          uid;
+            return false;
+        }
+        it.value() = mutation.type != Type::Delete;
+    }
+
+    if (mutations.isEmpty()) {
+        return true;
+    }
+
+    // QMap is implicitly shared, so the snapshot costs nothing until the first write
+    const auto snapshot = m_events;
+    const bool wasDirty = m_dirty;
+
+    for (const auto &mutation : mutations) {
+        if (mutation.type == Type::Delete) {
+            m_events.remove(mutation.uid);
+            unindexEvent(mutation.uid);
+        } else {
+            m_events[mutation.event->uid] = mutation.event;
+            indexEvent(mutation.event);
+        }
+    }
+
+    if (!commitChange()) {
+        m_events = snapshot;
+        rebuildIndex();
+        m_dirty = wasDirty;
+        return false;
+    }
+
+    return true;
+}
+
+int ICSFileBackend::deleteWhere(const Core::EventPredicate &predicate, const QStringList &calendarIds)
+{
+    if (!predicate) {
+        m_lastError = QLatin1String("Predicate is empty");
+        return -1;
+    }
+
+    // The file is the single "local" collection
+    if (!calendarIds.isEmpty() && !calendarIds.contains(QLatin1String("local"))) {
+        return 0;
+    }
+
+    const auto snapshot = m_events;
+    const bool wasDirty = m_dirty;
+
+    int removed = 0;
+    for (auto it = m_events.begin(); it != m_events.end();) {
+        if (predicate(*it.value())) {
+            unindexEvent(it.key());
+            it = m_events.erase(it);
+            ++removed;
+        } else {
+            ++it;
+        }
+    }
+
+    if (removed == 0) {
+        return 0;
+    }
+
+    if (!commitChange()) {
+        m_events = snapshot;
+        rebuildIndex();
+        m_dirty = wasDirty;
+        return -1;
+    }
+
+    return removed;
 }
 
 QList<Core::CalendarEventPtr> ICSFileBackend::getEventsByDate(const QDate &date)
@@ -96,13 +233,7 @@ QList<Core::CalendarEventPtr> ICSFileBackend::getEventsByDate(const QDate &date)
         return result;
     }
 
-    for (const auto &event : m_events) {
-        if (event->startDateTime.date() <= date && event->endDateTime.date() >= date) {
-            result.append(event);
-        }
-    }
-
-    return result;
+    return m_index.stabbing(date.toJulianDay());
 }
 
 QList<Core::CalendarEventPtr> ICSFileBackend::getEventsByDateRange(const QDate &start, const QDate &end)
@@ -119,12 +250,92 @@ QList<Core::CalendarEventPtr> ICSFileBackend::getEventsByDateRange(const QDate &
         return result;
     }
 
-    for (const auto &event : m_events) {
-        if (event->endDateTime.date() >= start && event->startDateTime.date() <= end) {
-            result.append(event);
+    return m_index.overlapping(start.toJulianDay(), end.toJulianDay());
+}
+
+QList<Core::EventOccurrence> ICSFileBackend::getOccurrencesByDateRange(const QDate &start, const QDate &end)
+{
+    QList<Core::EventOccurrence> result;
+
+    if (!start.isValid() || !end.isValid()) {
+        m_lastError = QLatin1String("Date range is invalid");
+        return result;
+    }
+
+    if (start > end) {
+        m_lastError = QLatin1String("Start date is after end date");
+        return result;
+    }
+
+    return collectOccurrences(start, end, nullptr);
+}
+
+QList<Core::CalendarEventPtr> ICSFileBackend::getEventsWithCategories(const QDate &start, const QDate &end,
+                                                                      const QStringList &categories)
+{
+    const auto events = getEventsByDateRange(start, end);
+    if (categories.isEmpty()) {
+        return events;
+    }
+    return m_categoryIndex.filter(events, m_categoryIndex.mask(categories));
+}
+
+QList<Core::EventOccurrence> ICSFileBackend::getOccurrencesWithCategories(const QDate &start, const QDate &end,
+                                                                          const QStringList &categories)
+{
+    if (categories.isEmpty()) {
+        return getOccurrencesByDateRange(start, end);
+    }
+
+    if (!start.isValid() || !end.isValid()) {
+        m_lastError = QLatin1String("Date range is invalid");
+        return QList<Core::EventOccurrence>();
+    }
+
+    if (start > end) {
+        m_lastError = QLatin1String("Start date is after end date");
+        return QList<Core::EventOccurrence>();
+    }
+
+    const CategoryIndex::Bits mask = m_categoryIndex.mask(categories);
+    if (mask.isEmpty()) {
+        return QList<Core::EventOccurrence>();
+    }
+    return collectOccurrences(start, end, &mask);
+}
+
+QList<Core::EventOccurrence> ICSFileBackend::collectOccurrences(const QDate &start, const QDate &end,
+                                                                const CategoryIndex::Bits *mask)
+{
+    QList<Core::EventOccurrence> result;
+    const qint64 first = start.toJulianDay();
+    const qint64 last = end.toJulianDay();
+
+    auto single = m_index.overlapping(first, last);
+    if (mask) {
+        single = m_categoryIndex.filter(single, *mask);
+    }
+    for (const auto &event : std::as_const(single)) {
+        if (!isSeries(*event)) {
+            const QDateTime eventEnd = event->endDateTime.isValid() ? event->endDateTime : event->startDateTime;
+            result.append(Core::EventOccurrence{event, event->startDateTime, eventEnd});
         }
     }
 
+    auto series = m_seriesIndex.overlapping(first, last);
+    if (mask) {
+        series = m_categoryIndex.filter(series, *mask);
+    }
+    if (last - first >= kMaxCachedWindowDays) {
+        result.append(Core::RecurrenceCalculator::calculateOccurrences(series, start, end));
+    } else {
+        for (const auto &event : series) {
+            result.append(m_occurrenceCache.occurrences(event, start, end));
+        }
+    }
+
+    std::stable_sort(result.begin(), result.end(),
+                     [](const Core::EventOccurrence &a, const Core::EventOccurrence &b) { return a.utcStart < b.utcStart; });
     return result;
 }
 
@@ -137,6 +348,175 @@ QList<Core::CalendarEventPtr> ICSFileBackend::getEventsByCollection(const QStrin
     return QList<Core::CalendarEventPtr>();
 }
 
+Core::SearchResults ICSFileBackend::searchEvents(const Core::SearchQuery &query)
+{
+    if (!query.calendarIds.isEmpty() && !query.calendarIds.contains(QLatin1String("local"))) {
+        return Core::SearchResults();
+    }
+    return rankAndPage(m_searchIndex.search(query), query.offset, query.limit);
+}
+
+Core::FreeBusy ICSFileBackend::getFreeBusy(const Core::FreeBusyQuery &query)
+{
+    Core::FreeBusy result;
+    if (!query.start.isValid() || !query.end.isValid() || query.start >= query.end) {
+        m_lastError = QLatin1String("Date time is invalid");
+        return result;
+    }
+
+    result.start = query.start.toUTC();
+    result.end = query.end.toUTC();
+    if (!query.calendarIds.isEmpty() && !query.calendarIds.contains(QLatin1String("local"))) {
+        return result;
+    }
+
+    const qint64 from = query.start.toSecsSinceEpoch();
+    const qint64 to = query.end.toSecsSinceEpoch();
+    std::vector<Core::BusyPeriod> periods;
+
+    // Single events come straight from the time columns; without an attendee
+    // the flag byte decides every row and the events are never touched
+    quint8 excluded = EventTable::Recurring | EventTable::Cancelled;
+    if (!query.includeAllDay) {
+        excluded |= EventTable::AllDay;
+    }
+    const auto spans = m_table.spans(from, to, excluded);
+    periods.reserve(spans.size());
+    for (const auto &span : spans) {
+        if (query.attendee.isEmpty()) {
+            const auto type = (span.flags & EventTable::Tentative) ? Core::BusyPeriod::Type::Tentative
+                                                                   : Core::BusyPeriod::Type::Busy;
+            periods.push_back(Core::BusyPeriod{span.start, span.end, type});
+        } else if (const auto type = Core::FreeBusyCalculator::busyType(*span.event, query)) {
+            periods.push_back(Core::BusyPeriod{span.start, span.end, *type});
+        }
+    }
+
+    // Series are filed by local day; one day of slack on each side covers any zone
+    const QDate first = result.start.date().addDays(-1);
+    const QDate last = result.end.date().addDays(1);
+    auto series = m_seriesIndex.overlapping(first.toJulianDay(), last.toJulianDay());
+    series.removeIf([&query](const Core::CalendarEventPtr &event) {
+        return !Core::FreeBusyCalculator::busyType(*event, query);
+    });
+
+    QList<Core::EventOccurrence> occurrences;
+    if (first.daysTo(last) >= kMaxCachedWindowDays) {
+        occurrences = Core::RecurrenceCalculator::calculateOccurrences(series, first, last);
+    } else {
+        for (const auto &event : std::as_const(series)) {
+            occurrences.append(m_occurrenceCache.occurrences(event, first, last));
+        }
+    }
+    for (const auto &occurrence : std::as_const(occurrences)) {
+        const qint64 start = occurrence.utcStart.secsSinceEpoch();
+        const qint64 end = occurrence.utcEnd.isValid() ? occurrence.utcEnd.secsSinceEpoch() : start;
+        periods.push_back(Core::BusyPeriod{start, end, *Core::FreeBusyCalculator::busyType(*occurrence.event, query)});
+    }
+
+    result.periods = Core::FreeBusyCalculator::merge(periods, from, to);
+    return result;
+}
+
+bool ICSFileBackend::createTodo(const Core::TodoItemPtr &todo)
+{
+    if (!todo || !todo->isValid()) {
+        m_lastError = QLatin1String("Todo is invalid");
+        return false;
+    }
+
+    if (m_todos.contains(todo->uid)) {
+        m_lastError = QLatin1String("Todo with same UID already exists");
+        return false;
+    }
+
+    m_todos[todo->uid] = todo;
+    m_todoIndex.insert(todo);
+    return commitChange();
+}
+
+Core::TodoItemPtr ICSFileBackend::getTodo(const QString &uid)
+{
+    if (uid.isEmpty()) {
+        m_lastError = QLatin1String("UID is empty");
+        return nullptr;
+    }
+
+    auto it = m_todos.find(uid);
+    if (it != m_todos.end()) {
+        return it.value();
+    }
+
+    m_lastError = QLatin1String("Todo not found");
+    return nullptr;
+}
+
+bool ICSFileBackend::updateTodo(const Core::TodoItemPtr &todo)
+{
+    if (!todo || !todo->isValid()) {
+        m_lastError = QLatin1String("Todo is invalid");
+        return false;
+    }
+
+    if (!m_todos.contains(todo->uid)) {
+        m_lastError = QLatin1String("Todo not found");
+        return false;
+    }
+
+    m_todos[todo->uid] = todo;
+    m_todoIndex.insert(todo);
+    return commitChange();
+}
+
+bool ICSFileBackend::deleteTodo(const QString &uid)
+{
+    if (uid.isEmpty()) {
+        m_lastError = QLatin1String("UID is empty");
+        return false;
+    }
+
+    if (m_todos.remove(uid) == 0) {
+        m_lastError = QLatin1String("Todo not found");
+        return false;
+    }
+
+    m_todoIndex.remove(uid);
+    return commitChange();
+}
+
+QList<Core::TodoItemPtr> ICSFileBackend::getTodos()
+{
+    return m_todos.values();
+}
+
+QList<Core::TodoItemPtr> ICSFileBackend::getOverdueTodos(const QDateTime &now)
+{
+    if (!now.isValid()) {
+        m_lastError = QLatin1String("Date time is invalid");
+        return QList<Core::TodoItemPtr>();
+    }
+    return m_todoIndex.overdue(now.toSecsSinceEpoch());
+}
+
+QList<Core::TodoItemPtr> ICSFileBackend::getTodosDueBetween(const QDateTime &start, const QDateTime &end)
+{
+    if (!start.isValid() || !end.isValid()) {
+        m_lastError = QLatin1String("Date time is invalid");
+        return QList<Core::TodoItemPtr>();
+    }
+    return m_todoIndex.dueBetween(start.toSecsSinceEpoch(), end.toSecsSinceEpoch());
+}
+
+QList<Core::TodoItemPtr> ICSFileBackend::getTodosByStatus(Core::TodoItem::Status status)
+{
+    return m_todoIndex.withStatus(status);
+}
+
+QList<Core::TodoItemPtr> ICSFileBackend::getTopTodosByPriority(int count)
+{
+    return m_todoIndex.topByPriority(count);
+}
+
 QList<QString> ICSFileBackend::getCalendarIds()
 {
     return {QLatin1String("local")};
@@ -186,11 +566,11 @@ void ICSFileBackend::setCalendarVisibility(const QString &id, bool visible)
 
 bool ICSFileBackend::sync()
 {
-    // Reload from file and save
-    if (!loadFromFile()) {
+    // Write pending changes first so reloading cannot lose them
+    if (!flush()) {
         return false;
     }
-    return saveToFile();
+    return loadFromFile();
 }
 
 bool ICSFileBackend::isOnline() const
@@ -207,29 +587,268 @@ QString ICSFileBackend::getLastSyncTime(const QString &collectionId)
     return QString();
 }
 
+QList<Core::CalendarEventPtr> ICSFileBackend::getEventsAt(const QDateTime &when)
+{
+    QList<Core::CalendarEventPtr> result;
+
+    if (!when.isValid()) {
+        m_lastError = QLatin1String("Date time is invalid");
+        return result;
+    }
+
+    const qint64 point = when.toSecsSinceEpoch();
+    return m_table.overlapping(point, point + 1);
+}
+
+QList<Core::CalendarEventPtr> ICSFileBackend::getEventsBetween(const QDateTime &start, const QDateTime &end,
+                                                               bool includeCancelled)
+{
+    if (!start.isValid() || !end.isValid()) {
+        m_lastError = QLatin1String("Date time is invalid");
+        return QList<Core::CalendarEventPtr>();
+    }
+
+    const quint8 excluded = includeCancelled ? 0 : EventTable::Cancelled;
+    return m_table.overlapping(start.toSecsSinceEpoch(), end.toSecsSinceEpoch(), excluded);
+}
+
+void ICSFileBackend::setDurability(Durability durability)
+{
+    m_durability = durability;
+
+    if (durability == Durability::GroupCommit) {
+        if (!m_flushTimer) {
+            m_flushTimer = std::make_unique<QTimer>();
+            m_flushTimer->setSingleShot(true);
+            QObject::connect(m_flushTimer.get(), &QTimer::timeout, [this]() {
+                if (m_dispatcher) {
+                    m_dispatcher([this]() { flush(); });
+                } else {
+                    flush();
+                }
+            });
+        }
+        if (m_dirty) {
+            m_flushTimer->start(m_flushDelay);
+        }
+        return;
+    }
+
+    m_flushTimer.reset();
+    if (durability == Durability::Immediate && m_dirty) {
+        flush();
+    }
+}
+
+void ICSFileBackend::setCallbackDispatcher(CallbackDispatcher dispatcher)
+{
+    m_dispatcher = std::move(dispatcher);
+}
+
+ICSFileBackend::Durability ICSFileBackend::durability() const
+{
+    return m_durability;
+}
+
+void ICSFileBackend::setFlushDelay(int msec)
+{
+    m_flushDelay = qMax(0, msec);
+}
+
+bool ICSFileBackend::flush()
+{
+    if (m_flushTimer) {
+        m_flushTimer->stop();
+    }
+
+    if (!m_dirty) {
+        return true;
+    }
+
+    if (!saveToFile()) {
+        return false;
+    }
+
+    m_dirty = false;
+    return true;
+}
+
+std::optional<ICSFileBackend::PendingWrite> ICSFileBackend::takePendingWrite()
+{
+    if (m_flushTimer) {
+        m_flushTimer->stop();
+    }
+
+    if (!m_dirty) {
+        return std::nullopt;
+    }
+
+    PendingWrite write;
+    write.filePath = m_filePath;
+    QBuffer buffer(&write.content);
+    buffer.open(QIODevice::WriteOnly);
+    if (!writeCalendar(&buffer)) {
+        m_lastError = QLatin1String("Failed to write iCalendar content");
+        return std::nullopt;
+    }
+
+    m_dirty = false;
+    return write;
+}
+
+bool ICSFileBackend::writePending(PendingWrite &write)
+{
+    QSaveFile file(write.filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        write.error = QLatin1String("Cannot open file for writing");
+        return false;
+    }
+
+    if (file.write(write.content) != write.content.size()) {
+        file.cancelWriting();
+        file.commit();
+        write.error = QLatin1String("Failed to write iCalendar content");
+        return false;
+    }
+
+    if (!file.commit()) {
+        write.error = QLatin1String("Cannot commit file");
+        return false;
+    }
+
+    write.written = true;
+    return true;
+}
+
+void ICSFileBackend::finishPendingWrite(const PendingWrite &write)
+{
+    if (!write.written) {
+        m_lastError = write.error;
+        qWarning() << "ICSFileBackend: Cannot write" << m_filePath << write.error;
+        if (!m_dirty) {
+            m_dirty = true;
+            m_dirtySince.start();
+        }
+        return;
+    }
+
+    qDebug() << "ICSFileBackend: Saved" << m_events.size() << "events to" << m_filePath;
+    recordFileState();
+    m_snapshotStale = !m_snapshotPath.isEmpty();
+}
+
+bool ICSFileBackend::isDirty() const
+{
+    return m_dirty;
+}
+
+void ICSFileBackend::discardChanges()
+{
+    if (m_flushTimer) {
+        m_flushTimer->stop();
+    }
+    m_dirty = false;
+    m_snapshotStale = false;
+}
+
+bool ICSFileBackend::commitChange()
+{
+    if (!m_dirty) {
+        m_dirty = true;
+        m_dirtySince.start();
+    }
+
+    switch (m_durability) {
+        case Durability::Immediate:
+            return flush();
+        case Durability::GroupCommit:
+            // Debounce, but do not let a continuous stream of edits starve the flush
+            if (m_dirtySince.elapsed() >= qint64(m_flushDelay) * kMaxFlushDelayFactor) {
+                return flush();
+            }
+            m_flushTimer->start(m_flushDelay);
+            return true;
+        case Durability::Manual:
+            return true;
+    }
+    return true;
+}
+
+void ICSFileBackend::indexEvent(const Core::CalendarEventPtr &event)
+{
+    event->cacheTimes();
+
+    const qint64 start = event->utcStart.localDay();
+    const qint64 end = event->utcEnd.isValid() ? event->utcEnd.lastDayFrom(start) : start;
+    m_index.insert(event, start, end);
+    m_table.insert(event);
+
+    // Recurring series are also indexed by the whole span their instances can cover
+    if (isSeries(*event)) {
+        const auto [first, last] = Core::RecurrenceCalculator::seriesDays(*event);
+        m_seriesIndex.insert(event, first, last);
+    } else {
+        m_seriesIndex.remove(event->uid);
+    }
+    m_occurrenceCache.invalidate(event->uid);
+    m_searchIndex.insert(event);
+    m_categoryIndex.insert(event);
+}
+
+void ICSFileBackend::unindexEvent(const QString &uid)
+{
+    m_index.remove(uid);
+    m_table.remove(uid);
+    m_seriesIndex.remove(uid);
+    m_occurrenceCache.invalidate(uid);
+    m_searchIndex.remove(uid);
+    m_categoryIndex.remove(uid);
+}
+
+void ICSFileBackend::rebuildIndex()
+{
+    m_index.clear();
+    m_table.clear();
+    m_table.reserve(m_events.size());
+    m_seriesIndex.clear();
+    m_occurrenceCache.clear();
+    m_searchIndex.clear();
+    m_categoryIndex.clear();
+    for (const auto &event : std::as_const(m_events)) {
+        indexEvent(event);
+    }
+}
+
 bool ICSFileBackend::loadFromFile()
 {
-    QFile file(m_filePath);
-    if (!file.exists()) {
+    if (!QFile::exists(m_filePath)) {
         qWarning() << "ICSFileBackend: File does not exist:" << m_filePath;
         m_lastError = QLatin1String("File not found");
         return false;
     }
 
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        m_lastError = QLatin1String("Cannot open file for reading");
+    ICalParser::Result result;
+    if (!m_snapshotPath.isEmpty() && SnapshotCache::read(m_snapshotPath, m_filePath, result)) {
+        setParsedContent(std::move(result));
+        recordFileState();
+        m_snapshotStale = false;
+        qDebug() << "ICSFileBackend: Loaded" << m_events.size() << "events from snapshot" << m_snapshotPath;
+        return true;
+    }
+
+    QString error;
+    if (!ICalParser::parseFile(m_filePath, result, &error)) {
+        m_lastError = error;
         qWarning() << "ICSFileBackend: Cannot open file:" << m_filePath;
         return false;
     }
 
-    QTextStream stream(&file);
-    QString content = stream.readAll();
-    file.close();
+    setParsedContent(std::move(result));
+    recordFileState();
 
-    // Parse iCalendar content
-    if (!parseICalendarContent(content)) {
-        m_lastError = QLatin1String("Failed to parse iCalendar content");
-        return false;
+    // Next start can skip the text parse
+    if (!m_snapshotPath.isEmpty()) {
+        writeSnapshot();
     }
 
     qDebug() << "ICSFileBackend: Loaded" << m_events.size() << "events from" << m_filePath;
@@ -238,87 +857,155 @@ bool ICSFileBackend::loadFromFile()
 
 bool ICSFileBackend::saveToFile()
 {
-    QFile file(m_filePath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+    // QSaveFile writes to a temporary file and atomically replaces the target on commit()
+    QSaveFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
         m_lastError = QLatin1String("Cannot open file for writing");
         qWarning() << "ICSFileBackend: Cannot write to" << m_filePath;
         return false;
     }
 
-    QTextStream stream(&file);
-    QString content = generateICalendarContent();
-    stream << content;
-    file.close();
+    // Stream each component straight to the file instead of building the calendar in memory
+    if (!writeCalendar(&file)) {
+        file.cancelWriting();
+        file.commit();
+        m_lastError = QLatin1String("Failed to write iCalendar content");
+        qWarning() << "ICSFileBackend: Write error on" << m_filePath;
+        return false;
+    }
+
+    if (!file.commit()) {
+        m_lastError = QLatin1String("Cannot commit file");
+        qWarning() << "ICSFileBackend: Cannot commit" << m_filePath;
+        return false;
+    }
 
     qDebug() << "ICSFileBackend: Saved" << m_events.size() << "events to" << m_filePath;
+    recordFileState();
+    m_snapshotStale = !m_snapshotPath.isEmpty();
     return true;
 }
 
-QString ICSFileBackend::generateICalendarContent()
+bool ICSFileBackend::writeCalendar(QIODevice *device) const
 {
-    QString content;
-    content += QLatin1String("BEGIN:VCALENDAR\n");
-    content += QLatin1String("VERSION:2.0\n");
-    content += QLatin1String("PRODID:-//Personal Calendar//EN\n");
-    content += QLatin1String("CALSCALE:GREGORIAN\n");
+    ICalWriter writer(device);
+    writer.beginCalendar();
 
-    // Add all events
-    for (const auto &event : m_events) {
+    for (const auto &event : std::as_const(m_events)) {
         if (event && event->isValid()) {
-            content += event->toICalString();
+            writer.writeEvent(*event);
         }
     }
 
-    content += QLatin1String("END:VCALENDAR\n");
-    return content;
+    for (const auto &todo : std::as_const(m_todos)) {
+        if (todo && todo->isValid()) {
+            writer.writeTodo(*todo);
+        }
+    }
+
+    writer.endCalendar();
+    return !writer.hasError();
 }
 
-bool ICSFileBackend::parseICalendarContent(const QString &content)
+void ICSFileBackend::recordFileState()
 {
-    m_events.clear();
+    const QFileInfo info(m_filePath);
+    m_fileSize = info.exists() ? info.size() : -1;
+    m_fileModified = info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1;
+}
 
-    // Simple iCalendar parser
-    // Look for VEVENT blocks
-    int pos = 0;
-    while (true) {
-        int start = content.indexOf(QLatin1String("BEGIN:VEVENT"), pos);
-        if (start == -1) {
-            break;
-        }
+bool ICSFileBackend::hasExternalChanges() const
+{
+    const QFileInfo info(m_filePath);
+    if (!info.exists()) {
+        return m_fileSize >= 0;
+    }
+    return info.size() != m_fileSize || info.lastModified().toMSecsSinceEpoch() != m_fileModified;
+}
 
-        int end = content.indexOf(QLatin1String("END:VEVENT"), start);
-        if (end == -1) {
-            break;
-        }
+bool ICSFileBackend::reload(Changes &changes)
+{
+    if (!flush()) {
+        return false;
+    }
 
-        QString eventBlock = content.mid(start, end - start + 10); // +10 for "END:VEVENT"
+    ICalParser::Result result;
+    QString error;
+    if (!ICalParser::parseFile(m_filePath, result, &error)) {
+        m_lastError = error;
+        return false;
+    }
 
-        // Parse event and create CalendarEvent
-        auto event = std::make_shared<Core::CalendarEvent>();
+    QHash<QString, Core::CalendarEventPtr> incoming;
+    incoming.reserve(result.events.size());
+    for (auto &event : result.events) {
+        incoming.insert(event->uid, std::move(event));
+    }
 
-        // Extract UID
-        int uidPos = eventBlock.indexOf(QLatin1String("UID:"));
-        if (uidPos != -1) {
-            int uidEnd = eventBlock.indexOf(QLatin1Char('\n'), uidPos);
-            event->uid = eventBlock.mid(uidPos + 4, uidEnd - uidPos - 4).trimmed();
+    for (auto it = m_events.begin(); it != m_events.end();) {
+        auto found = incoming.find(it.key());
+        if (found == incoming.end()) {
+            changes.removed.append(it.key());
+            unindexEvent(it.key());
+            it = m_events.erase(it);
+            continue;
         }
 
-        // Extract SUMMARY (title)
-        int summaryPos = eventBlock.indexOf(QLatin1String("SUMMARY:"));
-        if (summaryPos != -1) {
-            int summaryEnd = eventBlock.indexOf(QLatin1Char('\n'), summaryPos);
-            event->title = eventBlock.mid(summaryPos + 8, summaryEnd - summaryPos - 8).trimmed();
+        if (SnapshotCache::contentHash(*found.value()) != SnapshotCache::contentHash(*it.value())) {
+            changes.changed.append(it.key());
+            found.value()->calendarId = it.value()->calendarId;
+            it.value() = found.value();
+            indexEvent(it.value());
         }
+        incoming.erase(found);
+        ++it;
+    }
 
-        // Add to map if valid
-        if (!event->uid.isEmpty() && !event->title.isEmpty()) {
-            m_events[event->uid] = event;
-        }
+    for (auto it = incoming.begin(); it != incoming.end(); ++it) {
+        changes.added.append(it.key());
+        m_events.insert(it.key(), it.value());
+        indexEvent(it.value());
+    }
 
-        pos = end + 10;
+    m_todos.clear();
+    m_todoIndex.clear();
+    for (auto &todo : result.todos) {
+        m_todos[todo->uid] = todo;
+        m_todoIndex.insert(todo);
     }
 
+    recordFileState();
+    m_snapshotStale = !m_snapshotPath.isEmpty();
     return true;
 }
 
+void ICSFileBackend::writeSnapshot()
+{
+    m_snapshotStale = !SnapshotCache::write(m_snapshotPath, m_filePath, m_events.values(), m_todos.values());
+}
+
+void ICSFileBackend::setParsedContent(ICalParser::Result &&result)
+{
+    m_events.clear();
+    m_todos.clear();
+    m_todoIndex.clear();
+    m_index.clear();
+    m_table.clear();
+    m_table.reserve(result.events.size());
+    m_seriesIndex.clear();
+    m_occurrenceCache.clear();
+    m_searchIndex.clear();
+    m_categoryIndex.clear();
+
+    for (auto &event : result.events) {
+        m_events[event->uid] = event;
+        indexEvent(event);
+    }
+
+    for (auto &todo : result.todos) {
+        m_todos[todo->uid] = todo;
+        m_todoIndex.insert(todo);
+    }
+}
+
 } // namespace PersonalCalendar::Local
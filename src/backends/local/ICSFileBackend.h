@@ -3,9 +3,24 @@
 
 #pragma once
 
+#include "CategoryIndex.h"
+#include "EventIntervalIndex.h"
+#include "EventTable.h"
+#include "ICalParser.h"
+#include "OccurrenceCache.h"
+#include "SearchIndex.h"
+#include "TodoIndex.h"
 #include "core/data/ICalendarStorage.h"
+#include <QElapsedTimer>
 #include <QMap>
 #include <QString>
+#include <QStringList>
+#include <functional>
+#include <memory>
+#include <optional>
+
+class QIODevice;
+class QTimer;
 
 namespace PersonalCalendar::Local
 {
@@ -19,11 +34,32 @@ namespace PersonalCalendar::Local
 class ICSFileBackend : public Core::ICalendarStorage
 {
 public:
+    /**
+     * @brief When mutations reach the disk
+     */
+    enum class Durability {
+        Immediate,   // Every mutation rewrites the file before returning
+        GroupCommit, // Mutations are coalesced and flushed after a quiet period
+        Manual       // Only flush() and destruction write the file
+    };
+
+    /**
+     * @brief Events that differ between two versions of the file
+     */
+    struct Changes {
+        QStringList added;
+        QStringList changed;
+        QStringList removed;
+
+        bool isEmpty() const { return added.isEmpty() && changed.isEmpty() && removed.isEmpty(); }
+    };
+
     /**
      * @brief Constructor
      * @param filePath Path to the .ics file
+     * @param snapshotPath Binary snapshot used to skip parsing unchanged files (optional)
      */
-    explicit ICSFileBackend(const QString &filePath);
+    explicit ICSFileBackend(const QString &filePath, const QString &snapshotPath = QString());
 
     ~ICSFileBackend() override;
 
@@ -32,10 +68,29 @@ public:
     Core::CalendarEventPtr getEvent(const QString &uid) override;
     bool updateEvent(const Core::CalendarEventPtr &event) override;
     bool deleteEvent(const QString &uid) override;
+    bool applyBatch(const QList<Core::EventMutation> &mutations) override;
+    int deleteWhere(const Core::EventPredicate &predicate, const QStringList &calendarIds = QStringList()) override;
 
     QList<Core::CalendarEventPtr> getEventsByDate(const QDate &date) override;
     QList<Core::CalendarEventPtr> getEventsByDateRange(const QDate &start, const QDate &end) override;
+    QList<Core::EventOccurrence> getOccurrencesByDateRange(const QDate &start, const QDate &end) override;
+    QList<Core::CalendarEventPtr> getEventsWithCategories(const QDate &start, const QDate &end,
+                                                          const QStringList &categories) override;
+    QList<Core::EventOccurrence> getOccurrencesWithCategories(const QDate &start, const QDate &end,
+                                                              const QStringList &categories) override;
     QList<Core::CalendarEventPtr> getEventsByCollection(const QString &collectionId) override;
+    Core::SearchResults searchEvents(const Core::SearchQuery &query) override;
+    Core::FreeBusy getFreeBusy(const Core::FreeBusyQuery &query) override;
+
+    bool createTodo(const Core::TodoItemPtr &todo) override;
+    Core::TodoItemPtr getTodo(const QString &uid) override;
+    bool updateTodo(const Core::TodoItemPtr &todo) override;
+    bool deleteTodo(const QString &uid) override;
+    QList<Core::TodoItemPtr> getTodos() override;
+    QList<Core::TodoItemPtr> getOverdueTodos(const QDateTime &now) override;
+    QList<Core::TodoItemPtr> getTodosDueBetween(const QDateTime &start, const QDateTime &end) override;
+    QList<Core::TodoItemPtr> getTodosByStatus(Core::TodoItem::Status status) override;
+    QList<Core::TodoItemPtr> getTopTodosByPriority(int count) override;
 
     QList<QString> getCalendarIds() override;
     QString getCalendarName(const QString &id) override;
@@ -51,18 +106,183 @@ public:
     bool isOnline() const override;
     QString getLastSyncTime(const QString &collectionId) override;
 
+    /**
+     * @brief Get events happening at a given instant
+     * @param when Point in time to check
+     * @return Events with start <= when < end, in start order
+     */
+    QList<Core::CalendarEventPtr> getEventsAt(const QDateTime &when);
+
+    /**
+     * @brief Get events overlapping an exact time range
+     * @param start Range start (inclusive)
+     * @param end Range end (exclusive)
+     * @param includeCancelled Whether cancelled events are returned
+     * @return Events whose stored start/end overlap the range, in start order.
+     *         Recurring events are matched by their first instance only.
+     */
+    QList<Core::CalendarEventPtr> getEventsBetween(const QDateTime &start, const QDateTime &end,
+                                                   bool includeCancelled = true);
+
+    // External modifications
+
+    /**
+     * @brief Check whether the file changed since this backend last read or wrote it
+     */
+    bool hasExternalChanges() const;
+
+    /**
+     * @brief Re-read the file and merge it into the loaded events
+     *
+     * Pending changes are flushed first. Events are matched by UID and
+     * compared by content hash; unchanged events keep their instances.
+     *
+     * @param changes Receives the UIDs that were added, changed or removed
+     * @return false if the file could not be read
+     */
+    bool reload(Changes &changes);
+
+    // Write-behind control
+
+    /**
+     * @brief Set the durability mode
+     *
+     * Switching to Immediate flushes any pending changes.
+     */
+    void setDurability(Durability durability);
+    Durability durability() const;
+
+    /**
+     * @brief Runs a callback of the backend's own timers
+     *
+     * A backend shared between threads behind a lock installs a dispatcher
+     * that queues the callback behind other work and takes that lock.
+     * Without one, callbacks run directly on the timer's thread.
+     */
+    using CallbackDispatcher = std::function<void(std::function<void()> callback)>;
+    void setCallbackDispatcher(CallbackDispatcher dispatcher);
+
+    /**
+     * @brief Set the GroupCommit debounce delay
+     * @param msec Quiet period after the last mutation before flushing
+     */
+    void setFlushDelay(int msec);
+
+    /**
+     * @brief Write pending changes atomically (QSaveFile)
+     * @return true if nothing was pending or the write succeeded
+     */
+    bool flush();
+
+    /**
+     * @brief Serialized content waiting to be written
+     *
+     * flush() split in three steps, so a caller that guards the backend with a
+     * mutex only holds it while the content is serialized: takePendingWrite()
+     * and finishPendingWrite() need the lock, writePending() does not touch
+     * the backend.
+     */
+    struct PendingWrite {
+        QString filePath;
+        QByteArray content;
+        bool written = false;
+        QString error;
+    };
+
+    /**
+     * @brief Serialize pending changes and mark the backend clean
+     * @return Nothing if no changes were pending
+     */
+    std::optional<PendingWrite> takePendingWrite();
+
+    /**
+     * @brief Write serialized content atomically (QSaveFile)
+     */
+    static bool writePending(PendingWrite &write);
+
+    /**
+     * @brief Record the outcome of writePending()
+     *
+     * A failed write marks the backend dirty again so the next flush retries.
+     */
+    void finishPendingWrite(const PendingWrite &write);
+
+    /**
+     * @brief Check for changes not yet written to disk
+     */
+    bool isDirty() const;
+
+    /**
+     * @brief Drop pending changes so they are never written
+     *
+     * Used when the underlying file is being removed.
+     */
+    void discardChanges();
+
+    /**
+     * @brief Message describing the last failed operation
+     */
+    QString lastError() const { return m_lastError; }
+
 private:
     QString m_filePath;
     QMap<QString, Core::CalendarEventPtr> m_events;
+    QMap<QString, Core::TodoItemPtr> m_todos;
     QString m_lastError;
 
+    // Due date, status and priority indexes over m_todos
+    TodoIndex m_todoIndex;
+
+    // Day-granular interval index over m_events, and a columnar copy of
+    // their exact bounds for time-precise scans
+    EventIntervalIndex m_index;
+    EventTable m_table;
+    void indexEvent(const Core::CalendarEventPtr &event);
+    void unindexEvent(const QString &uid);
+    void rebuildIndex();
+
+    // Recurring events keyed by the span of their whole series, and their expanded instances
+    EventIntervalIndex m_seriesIndex;
+    OccurrenceCache m_occurrenceCache;
+
+    // Category bitsets, applied to candidates before any series is expanded
+    CategoryIndex m_categoryIndex;
+
+    // Occurrences between start and end, optionally limited to events matching a category mask
+    QList<Core::EventOccurrence> collectOccurrences(const QDate &start, const QDate &end,
+                                                    const CategoryIndex::Bits *mask);
+
+    // Full-text index over titles, locations and descriptions
+    SearchIndex m_searchIndex;
+
+    // Write-behind state
+    Durability m_durability = Durability::Immediate;
+    bool m_dirty = false;
+    int m_flushDelay = 500;
+    QElapsedTimer m_dirtySince;
+    std::unique_ptr<QTimer> m_flushTimer;
+    CallbackDispatcher m_dispatcher;
+
+    // Record a mutation and persist it according to m_durability
+    bool commitChange();
+
     // File I/O
     bool loadFromFile();
     bool saveToFile();
+    bool writeCalendar(QIODevice *device) const;
+
+    // File state after the last load or save, to tell external edits from our own
+    qint64 m_fileSize = -1;
+    qint64 m_fileModified = -1;
+    void recordFileState();
+
+    // Binary snapshot of the file content, refreshed after text parses and saves
+    QString m_snapshotPath;
+    bool m_snapshotStale = false;
+    void writeSnapshot();
 
     // iCalendar format
-    QString generateICalendarContent();
-    bool parseICalendarContent(const QString &content);
+    void setParsedContent(ICalParser::Result &&result);
 };
 
 } // namespace PersonalCalendar::Local
@@ -0,0 +1,957 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "ICalParser.h"
+#include <QDebug>
+#include <QFile>
+#include <QHash>
+#include <QTimeZone>
+#include <QVarLengthArray>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <string_view>
+
+namespace PersonalCalendar::Local
+{
+
+namespace
+{
+
+// ===== Tokens =====
+
+struct Parameter {
+    QByteArrayView name;
+    QByteArrayView value; // Unquoted, may hold a comma separated list
+};
+
+struct ContentLine {
+    QByteArrayView name;
+    QByteArrayView value;
+    QVarLengthArray<Parameter, 4> params;
+
+    QByteArrayView param(std::string_view key) const
+    {
+        for (const auto &p : params) {
+            if (p.name.size() == qsizetype(key.size()) &&
+                std::equal(key.begin(), key.end(), p.name.data(),
+                           [](char a, char b) { return a == (b >= 'a' && b <= 'z' ? char(b - 32) : b); })) {
+                return p.value;
+            }
+        }
+        return {};
+    }
+};
+
+bool equalsUpper(QByteArrayView view, std::string_view upper)
+{
+    if (view.size() != qsizetype(upper.size())) {
+        return false;
+    }
+    for (qsizetype i = 0; i < view.size(); ++i) {
+        char c = view[i];
+        if (c >= 'a' && c <= 'z') {
+            c = char(c - 32);
+        }
+        if (c != upper[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// Fixed-width unsigned field; -1 if out of range or not all digits (yields an invalid QDate/QTime)
+int readInt(QByteArrayView v, qsizetype pos, qsizetype len)
+{
+    if (pos + len > v.size()) {
+        return -1;
+    }
+    int value = 0;
+    for (qsizetype i = pos; i < pos + len; ++i) {
+        if (!isDigit(v[i])) {
+            return -1;
+        }
+        value = value * 10 + (v[i] - '0');
+    }
+    return value;
+}
+
+int toInt(QByteArrayView v, int fallback = 0)
+{
+    if (v.isEmpty()) {
+        return fallback;
+    }
+    bool negative = false;
+    qsizetype i = 0;
+    if (v[0] == '-' || v[0] == '+') {
+        negative = v[0] == '-';
+        ++i;
+    }
+    if (i >= v.size()) {
+        return fallback;
+    }
+    qint64 value = 0;
+    for (; i < v.size(); ++i) {
+        if (!isDigit(v[i])) {
+            return fallback;
+        }
+        value = value * 10 + (v[i] - '0');
+        if (value > std::numeric_limits<int>::max()) {
+            return fallback;
+        }
+    }
+    return static_cast<int>(negative ? -value : value);
+}
+
+QByteArrayView trimmed(QByteArrayView v)
+{
+    while (!v.isEmpty() && (v.front() == ' ' || v.front() == '\t')) {
+        v = v.sliced(1);
+    }
+    while (!v.isEmpty() && (v.back() == ' ' || v.back() == '\t' || v.back() == '\r')) {
+        v.chop(1);
+    }
+    return v;
+}
+
+/**
+ * Call f for every element of a separator-delimited list. Separators escaped
+ * with a backslash (TEXT values) are not split on.
+ */
+template<typename F>
+void forEachListItem(QByteArrayView v, char separator, F f)
+{
+    qsizetype start = 0;
+    for (qsizetype i = 0; i < v.size(); ++i) {
+        if (v[i] == '\\') {
+            ++i;
+            continue;
+        }
+        if (v[i] == separator) {
+            f(v.sliced(start, i - start));
+            start = i + 1;
+        }
+    }
+    f(v.sliced(start));
+}
+
+/**
+ * Tokenize "NAME;P1=V1;P2="V:2":VALUE". The first unquoted ':' ends the
+ * parameters; everything after it is the value.
+ */
+bool tokenize(QByteArrayView line, ContentLine &out)
+{
+    out.params.clear();
+
+    qsizetype i = 0;
+    const qsizetype n = line.size();
+    while (i < n && line[i] != ';' && line[i] != ':') {
+        ++i;
+    }
+    if (i == 0 || i >= n) {
+        return false;
+    }
+    out.name = line.first(i);
+
+    while (i < n && line[i] == ';') {
+        ++i;
+        const qsizetype nameStart = i;
+        while (i < n && line[i] != '=' && line[i] != ':' && line[i] != ';') {
+            ++i;
+        }
+        Parameter param;
+        param.name = line.sliced(nameStart, i - nameStart);
+        if (i < n && line[i] == '=') {
+            ++i;
+            if (i < n && line[i] == '"') {
+                const qsizetype valueStart = ++i;
+                while (i < n && line[i] != '"') {
+                    ++i;
+                }
+                param.value = line.sliced(valueStart, i - valueStart);
+                if (i < n) {
+                    ++i; // closing quote
+                }
+            } else {
+                const qsizetype valueStart = i;
+                while (i < n && line[i] != ';' && line[i] != ':') {
+                    ++i;
+                }
+                param.value = line.sliced(valueStart, i - valueStart);
+            }
+        }
+        out.params.append(param);
+    }
+
+    if (i >= n || line[i] != ':') {
+        return false;
+    }
+    out.value = line.sliced(i + 1);
+    return true;
+}
+
+// ===== Value decoding =====
+
+QString decodeText(QByteArrayView v, QByteArray &scratch)
+{
+    if (!v.contains('\\')) {
+        return QString::fromUtf8(v);
+    }
+
+    scratch.resize(0);
+    scratch.reserve(v.size());
+    for (qsizetype i = 0; i < v.size(); ++i) {
+        char c = v[i];
+        if (c == '\\' && i + 1 < v.size()) {
+            c = v[++i];
+            if (c == 'n' || c == 'N') {
+                c = '\n';
+            }
+        }
+        scratch.append(c);
+    }
+    return QString::fromUtf8(scratch);
+}
+
+// Larger DURATION components are rejected so the seconds total cannot overflow
+constexpr qint64 kMaxDurationNumber = 1000000000;
+
+// Parse a DURATION value ("-PT15M", "P1DT2H", "P2W") into seconds
+bool parseDuration(QByteArrayView v, qint64 &seconds)
+{
+    qsizetype i = 0;
+    bool negative = false;
+    if (i < v.size() && (v[i] == '-' || v[i] == '+')) {
+        negative = v[i] == '-';
+        ++i;
+    }
+    if (i >= v.size() || v[i] != 'P') {
+        return false;
+    }
+    ++i;
+
+    qint64 total = 0;
+    qint64 number = 0;
+    bool inTime = false;
+    for (; i < v.size(); ++i) {
+        const char c = v[i];
+        if (isDigit(c)) {
+            number = number * 10 + (c - '0');
+            if (number > kMaxDurationNumber) {
+                return false;
+            }
+            continue;
+        }
+        switch (c) {
+            case 'T':
+                inTime = true;
+                break;
+            case 'W':
+                total += number * 7 * 86400;
+                break;
+            case 'D':
+                total += number * 86400;
+                break;
+            case 'H':
+                total += number * 3600;
+                break;
+            case 'M':
+                total += inTime ? number * 60 : 0;
+                break;
+            case 'S':
+                total += number;
+                break;
+            default:
+                return false;
+        }
+        number = 0;
+    }
+
+    seconds = negative ? -total : total;
+    return true;
+}
+
+int weekdayFromCode(QByteArrayView code)
+{
+    static constexpr std::string_view days[] = {"MO", "TU", "WE", "TH", "FR", "SA", "SU"};
+    for (int d = 0; d < 7; ++d) {
+        if (equalsUpper(code, days[d])) {
+            return d + 1;
+        }
+    }
+    return 0;
+}
+
+// ===== Parse state =====
+
+enum class Component { None, Calendar, Event, Todo, Other };
+
+struct Context {
+    ICalParser::Result *result = nullptr;
+    Component component = Component::None;
+    int otherDepth = 0; // Nesting inside unsupported components (VTIMEZONE, ...)
+
+    Core::CalendarEventPtr event;
+    Core::TodoItemPtr todo;
+    Core::Alarm alarm;
+    bool inAlarm = false;
+    QDateTime until; // RRULE UNTIL, resolved against DTSTART at the end of the component
+    std::optional<qint64> duration; // DURATION seconds, may precede DTSTART
+
+    QByteArray textScratch;
+    QHash<QByteArray, QTimeZone> zones;
+
+    template<typename F>
+    void withItem(F f)
+    {
+        if (event) {
+            f(*event);
+        } else if (todo) {
+            f(*todo);
+        }
+    }
+
+    QTimeZone zone(QByteArrayView tzid)
+    {
+        const QByteArray key = tzid.toByteArray();
+        auto it = zones.constFind(key);
+        if (it == zones.constEnd()) {
+            it = zones.insert(key, QTimeZone(key));
+        }
+        return it.value();
+    }
+
+    /**
+     * Parse DATE / DATE-TIME values. Accepts RFC 5545 basic format
+     * ("20260110", "20260110T100000", "20260110T100000Z", TZID parameter)
+     * and the ISO 8601 extended format written by earlier versions.
+     */
+    QDateTime dateTime(const ContentLine &line, bool *isDate = nullptr)
+    {
+        const QByteArrayView v = trimmed(line.value);
+        if (isDate) {
+            *isDate = false;
+        }
+
+        if (v.size() >= 8 && isDigit(v[0]) && isDigit(v[7])) {
+            const QDate date(readInt(v, 0, 4), readInt(v, 4, 2), readInt(v, 6, 2));
+            if (v.size() == 8 || equalsUpper(line.param("VALUE"), "DATE")) {
+                if (isDate) {
+                    *isDate = true;
+                }
+                return QDateTime(date, QTime(0, 0));
+            }
+            if (v.size() >= 15 && v[8] == 'T') {
+                const QTime time(readInt(v, 9, 2), readInt(v, 11, 2), readInt(v, 13, 2));
+                if (v.size() > 15 && v[15] == 'Z') {
+                    return QDateTime(date, time, QTimeZone::UTC);
+                }
+                const QByteArrayView tzid = line.param("TZID");
+                if (!tzid.isEmpty()) {
+                    const QTimeZone tz = zone(tzid);
+                    if (tz.isValid()) {
+                        return QDateTime(date, time, tz);
+                    }
+                }
+                return QDateTime(date, time);
+            }
+        }
+
+        // Legacy ISO 8601 ("2026-01-10T10:00:00")
+        const QString iso = QString::fromLatin1(v);
+        if (v.size() == 10) {
+            if (isDate) {
+                *isDate = true;
+            }
+            return QDateTime(QDate::fromString(iso, Qt::ISODate), QTime(0, 0));
+        }
+        return QDateTime::fromString(iso, Qt::ISODate);
+    }
+};
+
+// ===== Property handlers =====
+
+using Handler = void (*)(Context &, const ContentLine &);
+
+void onSummary(Context &ctx, const ContentLine &line)
+{
+    const QString text = decodeText(line.value, ctx.textScratch);
+    ctx.withItem([&](auto &item) { item.title = text; });
+}
+
+void onDescription(Context &ctx, const ContentLine &line)
+{
+    const QString text = decodeText(line.value, ctx.textScratch);
+    if (ctx.inAlarm) {
+        ctx.alarm.description = text;
+        return;
+    }
+    ctx.withItem([&](auto &item) { item.description = text; });
+}
+
+void onLocation(Context &ctx, const ContentLine &line)
+{
+    const QString text = decodeText(line.value, ctx.textScratch);
+    ctx.withItem([&](auto &item) { item.location = text; });
+}
+
+void onUid(Context &ctx, const ContentLine &line)
+{
+    const QString uid = QString::fromUtf8(trimmed(line.value));
+    ctx.withItem([&](auto &item) { item.uid = uid; });
+}
+
+void onDtStart(Context &ctx, const ContentLine &line)
+{
+    bool isDate = false;
+    const QDateTime dt = ctx.dateTime(line, &isDate);
+    ctx.withItem([&](auto &item) {
+        item.startDateTime = dt;
+        item.isAllDay = isDate;
+    });
+}
+
+void onDtEnd(Context &ctx, const ContentLine &line)
+{
+    if (ctx.event) {
+        ctx.event->endDateTime = ctx.dateTime(line);
+    }
+}
+
+void onDuration(Context &ctx, const ContentLine &line)
+{
+    qint64 seconds = 0;
+    if (ctx.event && parseDuration(trimmed(line.value), seconds)) {
+        ctx.duration = seconds;
+    }
+}
+
+void onDue(Context &ctx, const ContentLine &line)
+{
+    if (ctx.todo) {
+        ctx.todo->dueDateTime = ctx.dateTime(line);
+    }
+}
+
+void onCompleted(Context &ctx, const ContentLine &line)
+{
+    if (ctx.todo) {
+        ctx.todo->completedDateTime = ctx.dateTime(line);
+    }
+}
+
+void onPercentComplete(Context &ctx, const ContentLine &line)
+{
+    if (ctx.todo) {
+        ctx.todo->percentComplete = std::clamp(toInt(trimmed(line.value)), 0, 100);
+    }
+}
+
+void onCreated(Context &ctx, const ContentLine &line)
+{
+    const QDateTime dt = ctx.dateTime(line);
+    ctx.withItem([&](auto &item) { item.created = dt; });
+}
+
+void onLastModified(Context &ctx, const ContentLine &line)
+{
+    const QDateTime dt = ctx.dateTime(line);
+    ctx.withItem([&](auto &item) { item.lastModified = dt; });
+}
+
+void onPriority(Context &ctx, const ContentLine &line)
+{
+    const int priority = std::clamp(toInt(trimmed(line.value)), 0, 9);
+    ctx.withItem([&](auto &item) { item.priority = priority; });
+}
+
+void onStatus(Context &ctx, const ContentLine &line)
+{
+    const QByteArrayView v = trimmed(line.value);
+    if (ctx.event) {
+        if (equalsUpper(v, "TENTATIVE")) {
+            ctx.event->status = Core::EventStatus::Tentative;
+        } else if (equalsUpper(v, "CANCELLED")) {
+            ctx.event->status = Core::EventStatus::Cancelled;
+        } else if (equalsUpper(v, "CONFIRMED")) {
+            ctx.event->status = Core::EventStatus::Confirmed;
+        }
+    } else if (ctx.todo) {
+        if (equalsUpper(v, "IN-PROCESS")) {
+            ctx.todo->status = Core::TodoItem::Status::InProcess;
+        } else if (equalsUpper(v, "COMPLETED")) {
+            ctx.todo->status = Core::TodoItem::Status::Completed;
+        } else if (equalsUpper(v, "CANCELLED")) {
+            ctx.todo->status = Core::TodoItem::Status::Cancelled;
+        } else {
+            ctx.todo->status = Core::TodoItem::Status::NeedsAction;
+        }
+    }
+}
+
+void onCategories(Context &ctx, const ContentLine &line)
+{
+    QStringList categories;
+    forEachListItem(line.value, ',', [&](QByteArrayView item) {
+        item = trimmed(item);
+        if (!item.isEmpty()) {
+            categories.append(decodeText(item, ctx.textScratch));
+        }
+    });
+    ctx.withItem([&](auto &item) { item.categories.append(categories); });
+}
+
+void onUrl(Context &ctx, const ContentLine &line)
+{
+    if (ctx.event) {
+        ctx.event->url = QString::fromUtf8(trimmed(line.value));
+    }
+}
+
+QString stripMailto(QByteArrayView v)
+{
+    v = trimmed(v);
+    if (v.size() > 7 && equalsUpper(v.first(7), "MAILTO:")) {
+        v = v.sliced(7);
+    }
+    return QString::fromUtf8(v);
+}
+
+void onOrganizer(Context &ctx, const ContentLine &line)
+{
+    if (ctx.event) {
+        ctx.event->organizer = stripMailto(line.value);
+    }
+}
+
+void onAttendee(Context &ctx, const ContentLine &line)
+{
+    if (!ctx.event) {
+        return;
+    }
+    Core::Attendee attendee;
+    attendee.email = stripMailto(line.value);
+    attendee.name = QString::fromUtf8(line.param("CN"));
+    attendee.role = QString::fromUtf8(line.param("ROLE"));
+    attendee.status = QString::fromUtf8(line.param("PARTSTAT"));
+    attendee.uid = QString::fromUtf8(line.param("X-UID"));
+    ctx.event->attendees.append(attendee);
+}
+
+void onRRule(Context &ctx, const ContentLine &line)
+{
+    Core::Recurrence rule;
+    forEachListItem(trimmed(line.value), ';', [&](QByteArrayView part) {
+        const qsizetype eq = part.indexOf('=');
+        if (eq <= 0) {
+            return;
+        }
+        const QByteArrayView key = part.first(eq);
+        const QByteArrayView value = part.sliced(eq + 1);
+
+        if (equalsUpper(key, "FREQ")) {
+            if (equalsUpper(value, "DAILY")) {
+                rule.pattern = Core::Recurrence::Pattern::Daily;
+            } else if (equalsUpper(value, "WEEKLY")) {
+                rule.pattern = Core::Recurrence::Pattern::Weekly;
+            } else if (equalsUpper(value, "MONTHLY")) {
+                rule.pattern = Core::Recurrence::Pattern::Monthly;
+            } else if (equalsUpper(value, "YEARLY")) {
+                rule.pattern = Core::Recurrence::Pattern::Yearly;
+            }
+        } else if (equalsUpper(key, "INTERVAL")) {
+            rule.interval = std::max(1, toInt(value, 1));
+        } else if (equalsUpper(key, "UNTIL")) {
+            ContentLine untilLine;
+            untilLine.value = value;
+            ctx.until = ctx.dateTime(untilLine);
+            rule.endDate = ctx.until.date();
+        } else if (equalsUpper(key, "COUNT")) {
+            rule.count = std::max(0, toInt(value));
+        } else if (equalsUpper(key, "WKST")) {
+            rule.weekStart = std::max(1, weekdayFromCode(value));
+        } else if (equalsUpper(key, "BYDAY")) {
+            forEachListItem(value, ',', [&](QByteArrayView day) {
+                // Optional ordinal prefix: "2MO", "-1FR"
+                if (day.size() >= 2) {
+                    const int weekday = weekdayFromCode(day.last(2));
+                    if (weekday > 0) {
+                        rule.byDayOfWeek.append(weekday);
+                        rule.byDayOrdinal.append(toInt(day.first(day.size() - 2)));
+                    }
+                }
+            });
+        } else if (equalsUpper(key, "BYMONTHDAY")) {
+            forEachListItem(value, ',', [&](QByteArrayView day) { rule.byDayOfMonth.append(toInt(day)); });
+        } else if (equalsUpper(key, "BYMONTH")) {
+            forEachListItem(value, ',', [&](QByteArrayView month) { rule.byMonth.append(QString::fromLatin1(month)); });
+        } else if (equalsUpper(key, "BYYEARDAY")) {
+            forEachListItem(value, ',', [&](QByteArrayView day) { rule.byYearDay.append(toInt(day)); });
+        } else if (equalsUpper(key, "BYWEEKNO")) {
+            forEachListItem(value, ',', [&](QByteArrayView week) { rule.byWeekNo.append(toInt(week)); });
+        } else if (equalsUpper(key, "BYSETPOS")) {
+            forEachListItem(value, ',', [&](QByteArrayView position) { rule.bySetPos.append(toInt(position)); });
+        }
+    });
+
+    // Ordinals are only kept when at least one weekday carries one
+    if (std::all_of(rule.byDayOrdinal.cbegin(), rule.byDayOrdinal.cend(), [](int ordinal) { return ordinal == 0; })) {
+        rule.byDayOrdinal.clear();
+    }
+
+    ctx.withItem([&](auto &item) { item.recurrence = rule; });
+}
+
+void onExDate(Context &ctx, const ContentLine &line)
+{
+    QList<QDate> dates;
+    ContentLine single = line;
+    forEachListItem(line.value, ',', [&](QByteArrayView item) {
+        single.value = item;
+        const QDateTime dt = ctx.dateTime(single);
+        if (dt.isValid()) {
+            dates.append(dt.date());
+        }
+    });
+    ctx.withItem([&](auto &item) { item.recurrenceExceptions.append(dates); });
+}
+
+void onRDate(Context &ctx, const ContentLine &line)
+{
+    QList<QDateTime> dates;
+    ContentLine single = line;
+    forEachListItem(line.value, ',', [&](QByteArrayView item) {
+        // VALUE=PERIOD entries ("start/end" or "start/duration") contribute their start
+        const qsizetype slash = item.indexOf('/');
+        single.value = slash >= 0 ? item.first(slash) : item;
+        const QDateTime dt = ctx.dateTime(single);
+        if (dt.isValid()) {
+            dates.append(dt);
+        }
+    });
+    ctx.withItem([&](auto &item) { item.recurrenceDates.append(dates); });
+}
+
+void onAttach(Context &ctx, const ContentLine &line)
+{
+    // Only inline binaries are kept; URI attachments have nowhere to go yet
+    if (ctx.event && equalsUpper(line.param("ENCODING"), "BASE64")) {
+        ctx.event->attachment = QByteArray::fromBase64(trimmed(line.value).toByteArray());
+    }
+}
+
+void onAction(Context &ctx, const ContentLine &line)
+{
+    if (ctx.inAlarm) {
+        ctx.alarm.action = QString::fromUtf8(trimmed(line.value));
+    }
+}
+
+void onTrigger(Context &ctx, const ContentLine &line)
+{
+    if (!ctx.inAlarm) {
+        return;
+    }
+
+    const QByteArrayView value = trimmed(line.value);
+    qint64 seconds = 0;
+    if (equalsUpper(line.param("VALUE"), "DATE-TIME")) {
+        ctx.alarm.triggerTime = ctx.dateTime(line);
+    } else if (parseDuration(value, seconds)) {
+        ctx.alarm.minutesBefore = static_cast<int>(-seconds / 60);
+        ctx.alarm.relatedToEnd = equalsUpper(line.param("RELATED"), "END");
+    }
+    if (ctx.alarm.hasTrigger()) {
+        return;
+    }
+
+    // Keep what we cannot interpret so the next save does not drop the alarm
+    QByteArray raw;
+    for (const auto &p : line.params) {
+        raw.append(';');
+        raw.append(p.name);
+        raw.append('=');
+        const bool quote = p.value.contains(':') || p.value.contains(';') || p.value.contains(',');
+        if (quote) {
+            raw.append('"');
+        }
+        raw.append(p.value);
+        if (quote) {
+            raw.append('"');
+        }
+    }
+    raw.append(':');
+    raw.append(value);
+    ctx.alarm.rawTrigger = raw;
+}
+
+struct PropertyHandler {
+    std::string_view name;
+    Handler handler;
+};
+
+// Sorted by name for binary search
+constexpr PropertyHandler kPropertyHandlers[] = {
+    {"ACTION", &onAction},
+    {"ATTACH", &onAttach},
+    {"ATTENDEE", &onAttendee},
+    {"CATEGORIES", &onCategories},
+    {"COMPLETED", &onCompleted},
+    {"CREATED", &onCreated},
+    {"DESCRIPTION", &onDescription},
+    {"DTEND", &onDtEnd},
+    {"DTSTART", &onDtStart},
+    {"DUE", &onDue},
+    {"DURATION", &onDuration},
+    {"EXDATE", &onExDate},
+    {"LAST-MODIFIED", &onLastModified},
+    {"LOCATION", &onLocation},
+    {"ORGANIZER", &onOrganizer},
+    {"PERCENT-COMPLETE", &onPercentComplete},
+    {"PRIORITY", &onPriority},
+    {"RDATE", &onRDate},
+    {"RRULE", &onRRule},
+    {"STATUS", &onStatus},
+    {"SUMMARY", &onSummary},
+    {"TRIGGER", &onTrigger},
+    {"UID", &onUid},
+    {"URL", &onUrl},
+};
+
+constexpr bool handlersSorted()
+{
+    for (std::size_t i = 1; i < std::size(kPropertyHandlers); ++i) {
+        if (!(kPropertyHandlers[i - 1].name < kPropertyHandlers[i].name)) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(handlersSorted(), "kPropertyHandlers must be sorted by name");
+
+Handler findHandler(QByteArrayView name)
+{
+    char upper[32];
+    if (name.size() >= qsizetype(sizeof(upper))) {
+        return nullptr;
+    }
+    for (qsizetype i = 0; i < name.size(); ++i) {
+        const char c = name[i];
+        upper[i] = (c >= 'a' && c <= 'z') ? char(c - 32) : c;
+    }
+    const std::string_view key(upper, std::size_t(name.size()));
+
+    const auto it = std::lower_bound(std::begin(kPropertyHandlers), std::end(kPropertyHandlers), key,
+                                     [](const PropertyHandler &h, std::string_view k) { return h.name < k; });
+    if (it != std::end(kPropertyHandlers) && it->name == key) {
+        return it->handler;
+    }
+    return nullptr;
+}
+
+// ===== Component transitions =====
+
+void beginComponent(Context &ctx, QByteArrayView name)
+{
+    if (ctx.component == Component::Other) {
+        ++ctx.otherDepth;
+        return;
+    }
+
+    if (equalsUpper(name, "VCALENDAR")) {
+        ctx.component = Component::Calendar;
+    } else if (equalsUpper(name, "VEVENT") && ctx.component == Component::Calendar) {
+        ctx.component = Component::Event;
+        ctx.until = QDateTime();
+        ctx.duration.reset();
+        ctx.event = std::make_shared<Core::CalendarEvent>();
+    } else if (equalsUpper(name, "VTODO") && ctx.component == Component::Calendar) {
+        ctx.component = Component::Todo;
+        ctx.until = QDateTime();
+        ctx.todo = std::make_shared<Core::TodoItem>();
+    } else if (equalsUpper(name, "VALARM") && ctx.event && !ctx.inAlarm) {
+        // TodoItem has no alarm storage; a VTODO's VALARM is skipped like any unknown component
+        ctx.inAlarm = true;
+        ctx.alarm = Core::Alarm();
+    } else {
+        ctx.component = Component::Other;
+        ctx.otherDepth = 1;
+    }
+}
+
+// A UTC UNTIL names the last instant; the series end date is that instant's day in DTSTART's zone
+template<typename Item>
+void resolveUntil(Context &ctx, Item &item)
+{
+    if (ctx.until.isValid() && ctx.until.timeSpec() == Qt::UTC && item.startDateTime.isValid()) {
+        item.recurrence.endDate = ctx.until.toTimeZone(item.startDateTime.timeZone()).date();
+    }
+}
+
+void endComponent(Context &ctx, QByteArrayView name)
+{
+    if (ctx.component == Component::Other) {
+        if (--ctx.otherDepth == 0) {
+            ctx.component = (ctx.event ? Component::Event : ctx.todo ? Component::Todo : Component::Calendar);
+        }
+        return;
+    }
+
+    if (ctx.inAlarm && equalsUpper(name, "VALARM")) {
+        ctx.inAlarm = false;
+        ctx.event->alarms.append(ctx.alarm);
+        return;
+    }
+
+    if (ctx.event && equalsUpper(name, "VEVENT")) {
+        resolveUntil(ctx, *ctx.event);
+        // DTEND wins over DURATION; either may appear before DTSTART
+        if (!ctx.event->endDateTime.isValid() && ctx.duration) {
+            ctx.event->endDateTime = ctx.event->startDateTime.addSecs(*ctx.duration);
+        }
+        if (!ctx.event->uid.isEmpty() && !ctx.event->title.isEmpty()) {
+            if (!ctx.event->endDateTime.isValid()) {
+                ctx.event->endDateTime = ctx.event->startDateTime;
+            }
+            ctx.result->events.append(std::move(ctx.event));
+        } else {
+            ++ctx.result->skippedComponents;
+        }
+        ctx.event.reset();
+        ctx.component = Component::Calendar;
+    } else if (ctx.todo && equalsUpper(name, "VTODO")) {
+        resolveUntil(ctx, *ctx.todo);
+        if (ctx.todo->isValid()) {
+            ctx.result->todos.append(std::move(ctx.todo));
+        } else {
+            ++ctx.result->skippedComponents;
+        }
+        ctx.todo.reset();
+        ctx.component = Component::Calendar;
+    } else if (equalsUpper(name, "VCALENDAR")) {
+        ctx.component = Component::None;
+    }
+}
+
+void processLine(Context &ctx, QByteArrayView line)
+{
+    ContentLine content;
+    if (!tokenize(line, content)) {
+        return;
+    }
+
+    if (equalsUpper(content.name, "BEGIN")) {
+        beginComponent(ctx, trimmed(content.value));
+        return;
+    }
+    if (equalsUpper(content.name, "END")) {
+        endComponent(ctx, trimmed(content.value));
+        return;
+    }
+
+    if (ctx.component != Component::Event && ctx.component != Component::Todo) {
+        return;
+    }
+
+    Handler handler = findHandler(content.name);
+    if (!handler) {
+        return;
+    }
+
+    // Inside VALARM only the alarm's own properties apply
+    if (ctx.inAlarm && handler != &onAction && handler != &onDescription && handler != &onTrigger) {
+        return;
+    }
+
+    handler(ctx, content);
+}
+
+} // namespace
+
+ICalParser::Result ICalParser::parse(QByteArrayView data)
+{
+    Result result;
+    Context ctx;
+    ctx.result = &result;
+
+    // Unfolded logical line; only used when a line is actually folded
+    QByteArray folded;
+
+    const char *const begin = data.data();
+    const char *const end = begin + data.size();
+    const char *pos = begin;
+
+    auto nextPhysicalLine = [&](const char *from, QByteArrayView &line) -> const char * {
+        const char *nl = static_cast<const char *>(std::memchr(from, '\n', std::size_t(end - from)));
+        const char *lineEnd = nl ? nl : end;
+        qsizetype length = lineEnd - from;
+        if (length > 0 && from[length - 1] == '\r') {
+            --length;
+        }
+        line = QByteArrayView(from, length);
+        return nl ? nl + 1 : end;
+    };
+
+    while (pos < end) {
+        QByteArrayView line;
+        pos = nextPhysicalLine(pos, line);
+
+        // Continuation lines start with a single space or tab
+        if (pos < end && (*pos == ' ' || *pos == '\t')) {
+            folded.resize(0);
+            folded.append(line.data(), line.size());
+            while (pos < end && (*pos == ' ' || *pos == '\t')) {
+                QByteArrayView continuation;
+                pos = nextPhysicalLine(pos, continuation);
+                folded.append(continuation.data() + 1, continuation.size() - 1);
+            }
+            line = folded;
+        }
+
+        if (!line.isEmpty()) {
+            processLine(ctx, line);
+        }
+    }
+
+    return result;
+}
+
+bool ICalParser::parseFile(const QString &filePath, Result &result, QString *error)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) {
+            *error = QLatin1String("Cannot open file for reading");
+        }
+        return false;
+    }
+
+    const qint64 size = file.size();
+    if (size == 0) {
+        result = Result();
+        return true;
+    }
+
+    if (uchar *mapped = file.map(0, size)) {
+        result = parse(QByteArrayView(reinterpret_cast<const char *>(mapped), size));
+        file.unmap(mapped);
+    } else {
+        // Not mappable (e.g. special file system), fall back to a single read
+        const QByteArray data = file.readAll();
+        result = parse(data);
+    }
+
+    if (result.skippedComponents > 0) {
+        qDebug() << "ICalParser: Skipped" << result.skippedComponents << "incomplete components in" << filePath;
+    }
+    return true;
+}
+
+} // namespace PersonalCalendar::Local
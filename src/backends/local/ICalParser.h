@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include "core/models/CalendarEvent.h"
+#include "core/models/TodoItem.h"
+#include <QByteArrayView>
+#include <QList>
+#include <QString>
+
+namespace PersonalCalendar::Local
+{
+
+/**
+ * @brief Streaming RFC 5545 parser
+ *
+ * Tokenizes raw UTF-8 bytes in a single pass: physical lines are unfolded
+ * into a reused scratch buffer only when a fold is present, parameters are
+ * parsed as views into the input and properties are dispatched through a
+ * sorted compile-time table. Text is decoded to QString once per value.
+ *
+ * Files are memory-mapped when possible, so loading never copies the whole
+ * calendar into a QString.
+ */
+class ICalParser
+{
+public:
+    struct Result {
+        QList<Core::CalendarEventPtr> events;
+        QList<Core::TodoItemPtr> todos;
+        int skippedComponents = 0; // Components dropped for missing UID/SUMMARY
+    };
+
+    /**
+     * @brief Parse an in-memory iCalendar stream
+     * @param data UTF-8 encoded iCalendar data
+     * @return Parsed events and todos
+     */
+    static Result parse(QByteArrayView data);
+
+    /**
+     * @brief Parse an iCalendar file, memory-mapping it when possible
+     * @param filePath Path to the .ics file
+     * @param result Receives parsed events and todos
+     * @param error Receives an error message on failure (optional)
+     * @return true on success
+     */
+    static bool parseFile(const QString &filePath, Result &result, QString *error = nullptr);
+};
+
+} // namespace PersonalCalendar::Local
@@ -0,0 +1,589 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "ICalWriter.h"
+#include <QIODevice>
+#include <QTimeZone>
+#include <cstdio>
+#include <utility>
+
+namespace PersonalCalendar::Local
+{
+
+namespace
+{
+
+// Output is handed to the device once this much has accumulated
+constexpr qsizetype kFlushThreshold = 64 * 1024;
+
+// RFC 5545 3.1: lines should not exceed 75 octets excluding CRLF
+constexpr qsizetype kMaxLineOctets = 75;
+
+QByteArrayView weekdayCode(int weekday)
+{
+    static constexpr const char *codes[] = {"MO", "TU", "WE", "TH", "FR", "SA", "SU"};
+    if (weekday < 1 || weekday > 7) {
+        return {};
+    }
+    return QByteArrayView(codes[weekday - 1], 2);
+}
+
+QByteArrayView frequencyName(Core::Recurrence::Pattern pattern)
+{
+    switch (pattern) {
+        case Core::Recurrence::Pattern::Daily:
+            return "DAILY";
+        case Core::Recurrence::Pattern::Weekly:
+            return "WEEKLY";
+        case Core::Recurrence::Pattern::Monthly:
+            return "MONTHLY";
+        case Core::Recurrence::Pattern::Yearly:
+            return "YEARLY";
+        case Core::Recurrence::Pattern::None:
+            break;
+    }
+    return {};
+}
+
+QByteArrayView eventStatusName(Core::EventStatus status)
+{
+    switch (status) {
+        case Core::EventStatus::Tentative:
+            return "TENTATIVE";
+        case Core::EventStatus::Confirmed:
+            return "CONFIRMED";
+        case Core::EventStatus::Cancelled:
+            return "CANCELLED";
+        case Core::EventStatus::None:
+            break;
+    }
+    return {};
+}
+
+QByteArrayView todoStatusName(Core::TodoItem::Status status)
+{
+    switch (status) {
+        case Core::TodoItem::Status::NeedsAction:
+            return "NEEDS-ACTION";
+        case Core::TodoItem::Status::InProcess:
+            return "IN-PROCESS";
+        case Core::TodoItem::Status::Completed:
+            return "COMPLETED";
+        case Core::TodoItem::Status::Cancelled:
+            return "CANCELLED";
+    }
+    return {};
+}
+
+void appendNumber(QByteArray &out, int value)
+{
+    char buf[16];
+    const int n = std::snprintf(buf, sizeof(buf), "%d", value);
+    out.append(buf, n);
+}
+
+// ";NAME=1,2,-1" rule part; nothing for an empty list
+void appendRulePart(QByteArray &out, QByteArrayView name, const QList<int> &values)
+{
+    if (values.isEmpty()) {
+        return;
+    }
+    out.append(';');
+    out.append(name);
+    out.append('=');
+    for (qsizetype i = 0; i < values.size(); ++i) {
+        if (i > 0) {
+            out.append(',');
+        }
+        appendNumber(out, values[i]);
+    }
+}
+
+} // namespace
+
+ICalWriter::ICalWriter(QIODevice *device) : m_device(device), m_encoder(QStringEncoder::Utf8)
+{
+    m_line.reserve(256);
+    m_output.reserve(kFlushThreshold + 1024);
+}
+
+ICalWriter::~ICalWriter()
+{
+    flush();
+}
+
+void ICalWriter::beginCalendar()
+{
+    writeRaw("BEGIN", "VCALENDAR");
+    writeRaw("VERSION", "2.0");
+    writeRaw("PRODID", "-//Personal Calendar//EN");
+    writeRaw("CALSCALE", "GREGORIAN");
+}
+
+void ICalWriter::endCalendar()
+{
+    writeRaw("END", "VCALENDAR");
+    flush();
+}
+
+void ICalWriter::writeEvent(const Core::CalendarEvent &event)
+{
+    writeRaw("BEGIN", "VEVENT");
+    writeText("UID", event.uid);
+    writeDateTime("DTSTAMP", event.lastModified.isValid() ? event.lastModified.toUTC() : QDateTime::currentDateTimeUtc());
+    writeDateTime("CREATED", event.created.isValid() ? event.created.toUTC() : QDateTime());
+    writeDateTime("LAST-MODIFIED", event.lastModified.isValid() ? event.lastModified.toUTC() : QDateTime());
+    writeText("SUMMARY", event.title);
+    writeText("DESCRIPTION", event.description);
+    writeText("LOCATION", event.location);
+    writeDateTime("DTSTART", event.startDateTime, event.isAllDay);
+    if (event.isAllDay && event.startDateTime.isValid() && event.endDateTime.date() <= event.startDateTime.date()) {
+        // DTEND of an all-day event is exclusive; never write a zero-length day
+        writeDateTime("DTEND", QDateTime(event.startDateTime.date().addDays(1), QTime(0, 0)), true);
+    } else {
+        writeDateTime("DTEND", event.endDateTime, event.isAllDay);
+    }
+    writeRaw("STATUS", eventStatusName(event.status));
+
+    if (event.priority > 0 && event.priority <= 9) {
+        beginLine("PRIORITY");
+        m_line.append(':');
+        appendNumber(m_line, event.priority);
+        endLine();
+    }
+
+    if (!event.url.isEmpty()) {
+        beginLine("URL");
+        m_line.append(':');
+        appendUtf8(m_line, event.url);
+        endLine();
+    }
+
+    if (!event.organizer.isEmpty()) {
+        beginLine("ORGANIZER");
+        m_line.append(":mailto:");
+        appendUtf8(m_line, event.organizer);
+        endLine();
+    }
+
+    for (const auto &attendee : event.attendees) {
+        beginLine("ATTENDEE");
+        addParam("CN", attendee.name);
+        addParam("ROLE", attendee.role);
+        addParam("PARTSTAT", attendee.status);
+        addParam("X-UID", attendee.uid);
+        m_line.append(":mailto:");
+        appendUtf8(m_line, attendee.email);
+        endLine();
+    }
+
+    writeCategories(event.categories);
+    writeRecurrence(event.recurrence, event.recurrenceExceptions, event.recurrenceDates, event.startDateTime,
+                    event.isAllDay);
+
+    if (!event.attachment.isEmpty()) {
+        beginLine("ATTACH");
+        addParam("ENCODING", QByteArrayView("BASE64"));
+        addParam("VALUE", QByteArrayView("BINARY"));
+        m_line.append(':');
+        m_line.append(event.attachment.toBase64());
+        endLine();
+    }
+
+    for (const auto &alarm : event.alarms) {
+        writeAlarm(alarm, event.title);
+    }
+
+    writeRaw("END", "VEVENT");
+}
+
+void ICalWriter::writeTodo(const Core::TodoItem &todo)
+{
+    writeRaw("BEGIN", "VTODO");
+    writeText("UID", todo.uid);
+    writeDateTime("DTSTAMP", todo.lastModified.isValid() ? todo.lastModified.toUTC() : QDateTime::currentDateTimeUtc());
+    writeDateTime("CREATED", todo.created.isValid() ? todo.created.toUTC() : QDateTime());
+    writeDateTime("LAST-MODIFIED", todo.lastModified.isValid() ? todo.lastModified.toUTC() : QDateTime());
+    writeText("SUMMARY", todo.title);
+    writeText("DESCRIPTION", todo.description);
+    writeText("LOCATION", todo.location);
+    writeDateTime("DTSTART", todo.startDateTime, todo.isAllDay);
+    writeDateTime("DUE", todo.dueDateTime, todo.isAllDay);
+    writeDateTime("COMPLETED", todo.completedDateTime.isValid() ? todo.completedDateTime.toUTC() : QDateTime());
+    writeRaw("STATUS", todoStatusName(todo.status));
+
+    if (todo.percentComplete > 0 && todo.percentComplete <= 100) {
+        beginLine("PERCENT-COMPLETE");
+        m_line.append(':');
+        appendNumber(m_line, todo.percentComplete);
+        endLine();
+    }
+
+    if (todo.priority > 0 && todo.priority <= 9) {
+        beginLine("PRIORITY");
+        m_line.append(':');
+        appendNumber(m_line, todo.priority);
+        endLine();
+    }
+
+    writeCategories(todo.categories);
+    writeRecurrence(todo.recurrence, todo.recurrenceExceptions, todo.recurrenceDates, todo.startDateTime,
+                    todo.isAllDay);
+    writeRaw("END", "VTODO");
+}
+
+void ICalWriter::writeFreeBusy(const Core::FreeBusy &freeBusy, const QString &uid, const QString &organizer)
+{
+    writeRaw("BEGIN", "VFREEBUSY");
+    writeText("UID", uid);
+    writeDateTime("DTSTAMP", QDateTime::currentDateTimeUtc());
+
+    if (!organizer.isEmpty()) {
+        beginLine("ORGANIZER");
+        m_line.append(":mailto:");
+        appendUtf8(m_line, organizer);
+        endLine();
+    }
+
+    writeDateTime("DTSTART", freeBusy.start.isValid() ? freeBusy.start.toUTC() : QDateTime());
+    writeDateTime("DTEND", freeBusy.end.isValid() ? freeBusy.end.toUTC() : QDateTime());
+
+    for (const auto &period : freeBusy.periods) {
+        beginLine("FREEBUSY");
+        const bool tentative = period.type == Core::BusyPeriod::Type::Tentative;
+        addParam("FBTYPE", QByteArrayView(tentative ? "BUSY-TENTATIVE" : "BUSY"));
+        m_line.append(':');
+        appendDateTimeValue(m_line, period.startDateTime(), false);
+        m_line.append('/');
+        appendDateTimeValue(m_line, period.endDateTime(), false);
+        endLine();
+    }
+
+    writeRaw("END", "VFREEBUSY");
+}
+
+bool ICalWriter::flush()
+{
+    if (m_output.isEmpty() || !m_device) {
+        return !m_error;
+    }
+
+    if (m_device->write(m_output) != m_output.size()) {
+        m_error = true;
+    }
+    m_output.resize(0);
+    return !m_error;
+}
+
+void ICalWriter::beginLine(QByteArrayView name)
+{
+    m_line.resize(0);
+    m_line.append(name);
+}
+
+void ICalWriter::addParam(QByteArrayView name, QByteArrayView value)
+{
+    if (value.isEmpty()) {
+        return;
+    }
+    m_line.append(';');
+    m_line.append(name);
+    m_line.append('=');
+    m_line.append(value);
+}
+
+void ICalWriter::addParam(QByteArrayView name, const QString &value)
+{
+    if (value.isEmpty()) {
+        return;
+    }
+
+    m_utf8.resize(0);
+    appendUtf8(m_utf8, value);
+
+    // Parameter values containing ':', ';' or ',' must be quoted; DQUOTE itself is not allowed
+    const bool quote = m_utf8.contains(':') || m_utf8.contains(';') || m_utf8.contains(',');
+    m_line.append(';');
+    m_line.append(name);
+    m_line.append('=');
+    if (quote) {
+        m_line.append('"');
+    }
+    for (const char c : std::as_const(m_utf8)) {
+        if (c != '"') {
+            m_line.append(c);
+        }
+    }
+    if (quote) {
+        m_line.append('"');
+    }
+}
+
+void ICalWriter::endLine()
+{
+    const char *data = m_line.constData();
+    qsizetype remaining = m_line.size();
+    qsizetype limit = kMaxLineOctets;
+
+    while (remaining > limit) {
+        // Back off so the next chunk does not start with a UTF-8 continuation byte
+        qsizetype cut = limit;
+        while (cut > 1 && (static_cast<uchar>(data[cut]) & 0xC0) == 0x80) {
+            --cut;
+        }
+        m_output.append(data, cut);
+        m_output.append("\r\n ", 3);
+        data += cut;
+        remaining -= cut;
+        limit = kMaxLineOctets - 1; // The leading space counts towards the limit
+    }
+
+    m_output.append(data, remaining);
+    m_output.append("\r\n", 2);
+
+    if (m_output.size() >= kFlushThreshold) {
+        flush();
+    }
+}
+
+void ICalWriter::writeText(QByteArrayView name, const QString &text)
+{
+    if (text.isEmpty()) {
+        return;
+    }
+    beginLine(name);
+    m_line.append(':');
+    appendEscaped(m_line, text);
+    endLine();
+}
+
+void ICalWriter::writeRaw(QByteArrayView name, QByteArrayView value)
+{
+    if (value.isEmpty()) {
+        return;
+    }
+    beginLine(name);
+    m_line.append(':');
+    m_line.append(value);
+    endLine();
+}
+
+void ICalWriter::writeDateTime(QByteArrayView name, const QDateTime &dt, bool dateOnly)
+{
+    if (!dt.isValid()) {
+        return;
+    }
+
+    beginLine(name);
+    if (dateOnly) {
+        addParam("VALUE", QByteArrayView("DATE"));
+    } else if (dt.timeSpec() == Qt::TimeZone) {
+        addParam("TZID", QByteArrayView(dt.timeZone().id()));
+    }
+    m_line.append(':');
+    appendDateTimeValue(m_line, dt, dateOnly);
+    endLine();
+}
+
+void ICalWriter::writeRecurrence(const Core::Recurrence &recurrence, const QList<QDate> &exceptions,
+                                 const QList<QDateTime> &recurrenceDates, const QDateTime &start, bool allDay)
+{
+    if (recurrence.isValid()) {
+        beginLine("RRULE");
+        m_line.append(":FREQ=");
+        m_line.append(frequencyName(recurrence.pattern));
+
+        if (recurrence.interval > 1) {
+            m_line.append(";INTERVAL=");
+            appendNumber(m_line, recurrence.interval);
+        }
+
+        if (recurrence.count > 0) {
+            m_line.append(";COUNT=");
+            appendNumber(m_line, recurrence.count);
+        }
+
+        if (recurrence.endDate.isValid()) {
+            // UNTIL must match DTSTART: a DATE for all-day series, otherwise the
+            // last possible instance start (in UTC unless DTSTART is floating)
+            m_line.append(";UNTIL=");
+            if (allDay || !start.isValid()) {
+                appendDateTimeValue(m_line, QDateTime(recurrence.endDate, QTime(0, 0)), true);
+            } else {
+                QDateTime until(recurrence.endDate, start.time(), start.timeZone());
+                if (start.timeSpec() != Qt::LocalTime) {
+                    until = until.toUTC();
+                }
+                appendDateTimeValue(m_line, until, false);
+            }
+        }
+
+        if (!recurrence.byDayOfWeek.isEmpty()) {
+            m_line.append(";BYDAY=");
+            for (qsizetype i = 0; i < recurrence.byDayOfWeek.size(); ++i) {
+                if (i > 0) {
+                    m_line.append(',');
+                }
+                if (i < recurrence.byDayOrdinal.size() && recurrence.byDayOrdinal[i] != 0) {
+                    appendNumber(m_line, recurrence.byDayOrdinal[i]);
+                }
+                m_line.append(weekdayCode(recurrence.byDayOfWeek[i]));
+            }
+        }
+
+        appendRulePart(m_line, "BYMONTHDAY", recurrence.byDayOfMonth);
+        appendRulePart(m_line, "BYYEARDAY", recurrence.byYearDay);
+        appendRulePart(m_line, "BYWEEKNO", recurrence.byWeekNo);
+
+        if (!recurrence.byMonth.isEmpty()) {
+            m_line.append(";BYMONTH=");
+            for (qsizetype i = 0; i < recurrence.byMonth.size(); ++i) {
+                if (i > 0) {
+                    m_line.append(',');
+                }
+                appendUtf8(m_line, recurrence.byMonth[i]);
+            }
+        }
+
+        appendRulePart(m_line, "BYSETPOS", recurrence.bySetPos);
+
+        if (recurrence.weekStart > 1 && recurrence.weekStart <= 7) {
+            m_line.append(";WKST=");
+            m_line.append(weekdayCode(recurrence.weekStart));
+        }
+
+        endLine();
+    }
+
+    if (!exceptions.isEmpty()) {
+        beginLine("EXDATE");
+        if (allDay || !start.isValid()) {
+            addParam("VALUE", QByteArrayView("DATE"));
+        } else if (start.timeSpec() == Qt::TimeZone) {
+            addParam("TZID", QByteArrayView(start.timeZone().id()));
+        }
+        m_line.append(':');
+        for (qsizetype i = 0; i < exceptions.size(); ++i) {
+            if (i > 0) {
+                m_line.append(',');
+            }
+            if (allDay || !start.isValid()) {
+                appendDateTimeValue(m_line, QDateTime(exceptions[i], QTime(0, 0)), true);
+            } else {
+                appendDateTimeValue(m_line, QDateTime(exceptions[i], start.time(), start.timeZone()), false);
+            }
+        }
+        endLine();
+    }
+
+    // One RDATE per value: extra instances may carry their own zone
+    for (const QDateTime &date : recurrenceDates) {
+        writeDateTime("RDATE", date, allDay);
+    }
+}
+
+void ICalWriter::writeCategories(const QStringList &categories)
+{
+    if (categories.isEmpty()) {
+        return;
+    }
+    beginLine("CATEGORIES");
+    m_line.append(':');
+    for (qsizetype i = 0; i < categories.size(); ++i) {
+        if (i > 0) {
+            m_line.append(',');
+        }
+        appendEscaped(m_line, categories[i]);
+    }
+    endLine();
+}
+
+void ICalWriter::writeAlarm(const Core::Alarm &alarm, const QString &fallbackDescription)
+{
+    if (!alarm.hasTrigger() && alarm.rawTrigger.isEmpty()) {
+        return;
+    }
+
+    writeRaw("BEGIN", "VALARM");
+    if (alarm.action.isEmpty()) {
+        writeRaw("ACTION", "DISPLAY");
+    } else {
+        writeText("ACTION", alarm.action);
+    }
+    writeText("DESCRIPTION", alarm.description.isEmpty() ? fallbackDescription : alarm.description);
+
+    beginLine("TRIGGER");
+    if (alarm.minutesBefore) {
+        const int minutes = *alarm.minutesBefore;
+        if (alarm.relatedToEnd) {
+            addParam("RELATED", QByteArrayView("END"));
+        }
+        m_line.append(minutes >= 0 ? ":-PT" : ":PT");
+        appendNumber(m_line, minutes >= 0 ? minutes : -minutes);
+        m_line.append('M');
+    } else if (alarm.triggerTime.isValid()) {
+        // Absolute triggers must be in UTC
+        addParam("VALUE", QByteArrayView("DATE-TIME"));
+        m_line.append(':');
+        appendDateTimeValue(m_line, alarm.triggerTime.toUTC(), false);
+    } else {
+        m_line.append(alarm.rawTrigger);
+    }
+    endLine();
+
+    writeRaw("END", "VALARM");
+}
+
+void ICalWriter::appendUtf8(QByteArray &out, QStringView text)
+{
+    const qsizetype old = out.size();
+    out.resize(old + m_encoder.requiredSpace(text.size()));
+    char *end = m_encoder.appendToBuffer(out.data() + old, text);
+    out.resize(end - out.constData());
+}
+
+void ICalWriter::appendEscaped(QByteArray &out, const QString &text)
+{
+    m_utf8.resize(0);
+    appendUtf8(m_utf8, text);
+
+    for (const char c : std::as_const(m_utf8)) {
+        switch (c) {
+            case '\\':
+            case ';':
+            case ',':
+                out.append('\\');
+                out.append(c);
+                break;
+            case '\n':
+                out.append("\\n", 2);
+                break;
+            case '\r':
+                break;
+            default:
+                out.append(c);
+        }
+    }
+}
+
+void ICalWriter::appendDateTimeValue(QByteArray &out, const QDateTime &dt, bool dateOnly)
+{
+    QDateTime value = dt;
+    if (!dateOnly && dt.timeSpec() == Qt::OffsetFromUTC) {
+        value = dt.toUTC();
+    }
+
+    const QDate date = value.date();
+    char buf[20];
+    int n = 0;
+    if (dateOnly) {
+        n = std::snprintf(buf, sizeof(buf), "%04d%02d%02d", date.year(), date.month(), date.day());
+    } else {
+        const QTime time = value.time();
+        n = std::snprintf(buf, sizeof(buf), "%04d%02d%02dT%02d%02d%02d%s", date.year(), date.month(), date.day(),
+                          time.hour(), time.minute(), time.second(), value.timeSpec() == Qt::UTC ? "Z" : "");
+    }
+    out.append(buf, n);
+}
+
+} // namespace PersonalCalendar::Local
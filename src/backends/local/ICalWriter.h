@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include "core/models/CalendarEvent.h"
+#include "core/models/FreeBusy.h"
+#include "core/models/TodoItem.h"
+#include <QByteArray>
+#include <QStringEncoder>
+
+class QIODevice;
+
+namespace PersonalCalendar::Local
+{
+
+/**
+ * @brief Streaming RFC 5545 writer
+ *
+ * Serializes components straight to a QIODevice as UTF-8. Every content
+ * line is assembled in a reused scratch buffer, escaped, folded at 75
+ * octets (never inside a UTF-8 sequence) and appended to an output buffer
+ * that is handed to the device in fixed-size chunks. Peak memory is bounded
+ * by the largest single event, not by the calendar size.
+ */
+class ICalWriter
+{
+public:
+    /**
+     * @brief Constructor
+     * @param device Open, writable device; not owned
+     */
+    explicit ICalWriter(QIODevice *device);
+    ~ICalWriter();
+
+    void beginCalendar();
+    void writeEvent(const Core::CalendarEvent &event);
+    void writeTodo(const Core::TodoItem &todo);
+
+    /**
+     * @brief Write a published VFREEBUSY component
+     * @param freeBusy Merged periods; written in UTC, one FREEBUSY line each
+     * @param uid Component UID
+     * @param organizer Owner's e-mail address, omitted when empty
+     */
+    void writeFreeBusy(const Core::FreeBusy &freeBusy, const QString &uid, const QString &organizer = QString());
+    void endCalendar();
+
+    /**
+     * @brief Push buffered output to the device
+     * @return false if the device reported a write error
+     */
+    bool flush();
+
+    bool hasError() const { return m_error; }
+
+private:
+    // Content line assembly
+    void beginLine(QByteArrayView name);
+    void addParam(QByteArrayView name, QByteArrayView value);
+    void addParam(QByteArrayView name, const QString &value);
+    void endLine();
+
+    // Typed properties
+    void writeText(QByteArrayView name, const QString &text);
+    void writeRaw(QByteArrayView name, QByteArrayView value);
+    void writeDateTime(QByteArrayView name, const QDateTime &dt, bool dateOnly = false);
+    void writeRecurrence(const Core::Recurrence &recurrence, const QList<QDate> &exceptions,
+                         const QList<QDateTime> &recurrenceDates, const QDateTime &start, bool allDay);
+    void writeCategories(const QStringList &categories);
+    void writeAlarm(const Core::Alarm &alarm, const QString &fallbackDescription);
+
+    void appendUtf8(QByteArray &out, QStringView text);
+    void appendEscaped(QByteArray &out, const QString &text);
+    void appendDateTimeValue(QByteArray &out, const QDateTime &dt, bool dateOnly);
+
+    QIODevice *m_device;
+    QStringEncoder m_encoder;
+    QByteArray m_line;    // Current unfolded content line
+    QByteArray m_utf8;    // Encoding scratch
+    QByteArray m_output;  // Folded output waiting for the device
+    bool m_error = false;
+};
+
+} // namespace PersonalCalendar::Local
@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "OccurrenceCache.h"
+#include "core/utils/RecurrenceCalculator.h"
+
+namespace PersonalCalendar::Local
+{
+
+namespace
+{
+int monthIndex(const QDate &date)
+{
+    return date.year() * 12 + date.month() - 1;
+}
+
+QDate firstDayOfMonth(int index)
+{
+    return QDate(index / 12, index % 12 + 1, 1);
+}
+} // namespace
+
+OccurrenceCache::OccurrenceCache(int maxBuckets) : m_buckets(maxBuckets) {}
+
+QList<Core::EventOccurrence> OccurrenceCache::occurrences(const Core::CalendarEventPtr &event, const QDate &start,
+                                                          const QDate &end)
+{
+    QList<Core::EventOccurrence> result;
+    if (!event || !start.isValid() || !end.isValid() || start > end) {
+        return result;
+    }
+
+    const qint64 duration = Core::RecurrenceCalculator::durationSeconds(*event);
+    const quint32 generation = m_generations.value(event->uid);
+
+    // Instances that started up to one duration earlier can still reach into the window
+    const QDate expandFrom = start.addDays(-(duration / 86400) - 1);
+    for (int month = monthIndex(expandFrom); month <= monthIndex(end); ++month) {
+        Key key{event->uid, generation, month};
+
+        QList<QDateTime> starts;
+        if (const QList<QDateTime> *bucket = m_buckets.object(key)) {
+            starts = *bucket;
+        } else {
+            const QDate first = firstDayOfMonth(month);
+            starts = Core::RecurrenceCalculator::calculateInstances(*event, first, first.addMonths(1).addDays(-1));
+            m_buckets.insert(key, new QList<QDateTime>(starts));
+        }
+
+        for (const auto &instance : std::as_const(starts)) {
+            const QDateTime instanceEnd = instance.addSecs(duration);
+            if (Core::CalendarEvent::lastDay(instance, instanceEnd) >= start && instance.date() <= end) {
+                result.append(Core::EventOccurrence{event, instance, instanceEnd});
+            }
+        }
+    }
+    return result;
+}
+
+void OccurrenceCache::invalidate(const QString &uid)
+{
+    ++m_generations[uid];
+}
+
+void OccurrenceCache::clear()
+{
+    m_buckets.clear();
+    m_generations.clear();
+}
+
+} // namespace PersonalCalendar::Local
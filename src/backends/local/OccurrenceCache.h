@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include "core/models/EventOccurrence.h"
+#include <QCache>
+#include <QHash>
+#include <QString>
+
+namespace PersonalCalendar::Local
+{
+
+/**
+ * @brief Cache of expanded recurrence instances
+ *
+ * Instance start times are materialized per event and calendar month, so
+ * scrolling through months only expands the months not seen before and a
+ * recurring series is never re-walked from its first instance for a window
+ * that was already visited. Buckets are keyed by UID, a per-UID generation
+ * and the month; invalidating an event bumps its generation, which makes
+ * its old buckets unreachable until they are evicted (LRU).
+ */
+class OccurrenceCache
+{
+public:
+    /**
+     * @brief Constructor
+     * @param maxBuckets Maximum number of (event, month) buckets kept
+     */
+    explicit OccurrenceCache(int maxBuckets = 8192);
+
+    /**
+     * @brief Occurrences of a recurring event overlapping [start, end]
+     * @return Occurrences referencing @p event, in start order
+     */
+    QList<Core::EventOccurrence> occurrences(const Core::CalendarEventPtr &event, const QDate &start, const QDate &end);
+
+    /**
+     * @brief Drop everything cached for an event (call when it changes)
+     */
+    void invalidate(const QString &uid);
+
+    void clear();
+
+private:
+    struct Key {
+        QString uid;
+        quint32 generation = 0;
+        int month = 0; // year * 12 + month - 1
+
+        bool operator==(const Key &other) const = default;
+    };
+    friend size_t qHash(const Key &key, size_t seed = 0) noexcept
+    {
+        return qHashMulti(seed, key.uid, key.generation, key.month);
+    }
+
+    QCache<Key, QList<QDateTime>> m_buckets;
+    QHash<QString, quint32> m_generations;
+};
+
+} // namespace PersonalCalendar::Local
@@ -0,0 +1,195 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "SearchIndex.h"
+#include "core/utils/RecurrenceCalculator.h"
+#include "core/utils/TextSearch.h"
+#include <algorithm>
+#include <limits>
+#include <tuple>
+
+namespace PersonalCalendar::Local
+{
+
+using Core::TextSearch;
+
+void SearchIndex::insert(const Core::CalendarEventPtr &event)
+{
+    if (!event) {
+        return;
+    }
+
+    remove(event->uid);
+
+    QHash<QString, quint8> fields;
+    const auto collect = [&fields](const QString &text, TextSearch::Field field) {
+        const QStringList tokens = TextSearch::tokenize(text);
+        for (const QString &token : tokens) {
+            fields[token] |= field;
+        }
+    };
+    collect(event->title, TextSearch::Title);
+    collect(event->location, TextSearch::Location);
+    collect(event->description, TextSearch::Description);
+
+    const quint32 id = m_nextDocument++;
+    Document document;
+    document.event = event;
+    document.terms.reserve(fields.size());
+    std::tie(document.firstDay, document.lastDay) = Core::RecurrenceCalculator::seriesDays(*event);
+
+    for (auto it = fields.cbegin(); it != fields.cend(); ++it) {
+        addTerm(it.key(), id, it.value());
+        document.terms.append(it.key());
+    }
+
+    m_documentIds.insert(event->uid, id);
+    m_documents.insert(id, std::move(document));
+}
+
+void SearchIndex::remove(const QString &uid)
+{
+    auto it = m_documentIds.find(uid);
+    if (it == m_documentIds.end()) {
+        return;
+    }
+
+    const quint32 id = it.value();
+    m_documentIds.erase(it);
+
+    const Document document = m_documents.take(id);
+    for (const QString &term : document.terms) {
+        removeTerm(term, id);
+    }
+}
+
+void SearchIndex::clear()
+{
+    m_documentIds.clear();
+    m_documents.clear();
+    m_terms.clear();
+    m_trigrams.clear();
+    m_nextDocument = 0;
+}
+
+int SearchIndex::size() const
+{
+    return int(m_documents.size());
+}
+
+QList<Core::SearchHit> SearchIndex::search(const Core::SearchQuery &query) const
+{
+    QList<Core::SearchHit> hits;
+
+    const QStringList tokens = TextSearch::tokenize(query.text);
+    if (tokens.isEmpty()) {
+        return hits;
+    }
+
+    // Intersect token by token, summing the per-token scores
+    QHash<quint32, double> scores = match(tokens.first());
+    for (qsizetype i = 1; i < tokens.size() && !scores.isEmpty(); ++i) {
+        const QHash<quint32, double> next = match(tokens.at(i));
+        for (auto it = scores.begin(); it != scores.end();) {
+            auto found = next.constFind(it.key());
+            if (found == next.constEnd()) {
+                it = scores.erase(it);
+            } else {
+                it.value() += found.value();
+                ++it;
+            }
+        }
+    }
+
+    const qint64 first = query.start.isValid() ? query.start.toJulianDay() : std::numeric_limits<qint64>::min();
+    const qint64 last = query.end.isValid() ? query.end.toJulianDay() : std::numeric_limits<qint64>::max();
+
+    hits.reserve(scores.size());
+    for (auto it = scores.cbegin(); it != scores.cend(); ++it) {
+        const Document &document = m_documents.constFind(it.key()).value();
+        if (document.firstDay <= last && document.lastDay >= first) {
+            hits.append(Core::SearchHit{document.event, it.value()});
+        }
+    }
+    return hits;
+}
+
+void SearchIndex::addTerm(const QString &term, quint32 document, quint8 fields)
+{
+    auto it = m_terms.find(term);
+    if (it == m_terms.end()) {
+        it = m_terms.insert(term, Postings());
+        const QStringList grams = TextSearch::trigrams(term);
+        for (const QString &gram : grams) {
+            m_trigrams[gram].insert(term);
+        }
+    }
+    it.value().insert(document, fields);
+}
+
+void SearchIndex::removeTerm(const QString &term, quint32 document)
+{
+    auto it = m_terms.find(term);
+    if (it == m_terms.end()) {
+        return;
+    }
+
+    it.value().remove(document);
+    if (!it.value().isEmpty()) {
+        return;
+    }
+
+    m_terms.erase(it);
+    const QStringList grams = TextSearch::trigrams(term);
+    for (const QString &gram : grams) {
+        auto found = m_trigrams.find(gram);
+        if (found != m_trigrams.end()) {
+            found.value().remove(term);
+            if (found.value().isEmpty()) {
+                m_trigrams.erase(found);
+            }
+        }
+    }
+}
+
+QHash<quint32, double> SearchIndex::match(const QString &token) const
+{
+    QHash<quint32, double> best;
+    const auto add = [&best](const Postings &postings, TextSearch::Match kind) {
+        for (auto it = postings.cbegin(); it != postings.cend(); ++it) {
+            double &score = best[it.key()];
+            score = std::max(score, TextSearch::score(kind, it.value()));
+        }
+    };
+
+    // Terms starting with the token are contiguous in the ordered map
+    for (auto it = m_terms.lowerBound(token); it != m_terms.cend() && it.key().startsWith(token); ++it) {
+        add(it.value(), it.key().size() == token.size() ? TextSearch::Match::Exact : TextSearch::Match::Prefix);
+    }
+
+    if (token.size() < 3) {
+        return best;
+    }
+
+    // Infix matches: candidates from the rarest trigram, then verified
+    const QSet<QString> *candidates = nullptr;
+    const QStringList grams = TextSearch::trigrams(token);
+    for (const QString &gram : grams) {
+        auto found = m_trigrams.constFind(gram);
+        if (found == m_trigrams.constEnd()) {
+            return best;
+        }
+        if (!candidates || found.value().size() < candidates->size()) {
+            candidates = &found.value();
+        }
+    }
+
+    for (const QString &term : *candidates) {
+        if (!term.startsWith(token) && term.contains(token)) {
+            add(m_terms.value(term), TextSearch::Match::Infix);
+        }
+    }
+    return best;
+}
+
+} // namespace PersonalCalendar::Local
@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include "core/data/ICalendarStorage.h"
+#include "core/models/CalendarEvent.h"
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+namespace PersonalCalendar::Local
+{
+
+/**
+ * @brief Inverted full-text index over event titles, locations and descriptions
+ *
+ * Text is folded and tokenized with Core::TextSearch. Terms live in an
+ * ordered map, so a query token finds every term it prefixes with one
+ * lower-bound lookup; tokens of three or more characters also reach terms
+ * that contain them in the middle through a trigram-to-terms map. Postings
+ * record which fields a term came from, which drives the ranking.
+ *
+ * Every mutation touches only the terms of the affected event.
+ */
+class SearchIndex
+{
+public:
+    /**
+     * @brief Insert or re-index an event (keyed by its UID)
+     */
+    void insert(const Core::CalendarEventPtr &event);
+
+    /**
+     * @brief Remove an event
+     */
+    void remove(const QString &uid);
+
+    void clear();
+    int size() const;
+
+    /**
+     * @brief Events matching every token of the query
+     *
+     * The calendar filter and pagination are left to the caller; the date
+     * range of @p query is applied here.
+     *
+     * @return Unordered hits with their scores
+     */
+    QList<Core::SearchHit> search(const Core::SearchQuery &query) const;
+
+private:
+    struct Document {
+        Core::CalendarEventPtr event;
+        QStringList terms;
+        qint64 firstDay = 0;
+        qint64 lastDay = 0;
+    };
+
+    // Document ID -> fields (Core::TextSearch::Field) the term appears in
+    using Postings = QHash<quint32, quint8>;
+
+    void addTerm(const QString &term, quint32 document, quint8 fields);
+    void removeTerm(const QString &term, quint32 document);
+
+    // Best score of each document for one query token
+    QHash<quint32, double> match(const QString &token) const;
+
+    QHash<QString, quint32> m_documentIds;
+    QHash<quint32, Document> m_documents;
+    quint32 m_nextDocument = 0;
+
+    QMap<QString, Postings> m_terms;
+    QHash<QString, QSet<QString>> m_trigrams; // Trigram -> terms containing it
+};
+
+} // namespace PersonalCalendar::Local
@@ -0,0 +1,282 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "SnapshotCache.h"
+#include <QBuffer>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHashFunctions>
+#include <QSaveFile>
+
+namespace PersonalCalendar::Local
+{
+
+namespace
+{
+constexpr quint32 kMagic = 0x50435348; // "PCSH"
+constexpr quint32 kVersion = 3;
+constexpr QDataStream::Version kStreamVersion = QDataStream::Qt_6_0;
+
+// Identity of the text file a snapshot was built from
+struct SourceStamp {
+    qint64 size = -1;
+    qint64 modified = -1;
+    quint64 hash = 0;
+
+    bool operator==(const SourceStamp &other) const = default;
+};
+
+bool stampSource(const QString &sourcePath, SourceStamp &stamp)
+{
+    QFile file(sourcePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    stamp.size = file.size();
+    stamp.modified = QFileInfo(file).lastModified().toMSecsSinceEpoch();
+
+    // Hash the mapped bytes; fall back to reading for files that cannot be mapped
+    if (stamp.size == 0) {
+        stamp.hash = 0;
+    } else if (const uchar *data = file.map(0, stamp.size)) {
+        stamp.hash = qHashBits(data, size_t(stamp.size));
+        file.unmap(const_cast<uchar *>(data));
+    } else {
+        const QByteArray content = file.readAll();
+        stamp.hash = qHashBits(content.constData(), size_t(content.size()));
+    }
+    return true;
+}
+
+void writeRecurrence(QDataStream &out, const Core::Recurrence &recurrence, const QList<QDate> &exceptions,
+                     const QList<QDateTime> &recurrenceDates)
+{
+    out << qint32(recurrence.pattern) << qint32(recurrence.interval) << recurrence.endDate << qint32(recurrence.count)
+        << qint32(recurrence.weekStart) << recurrence.byDayOfWeek << recurrence.byDayOrdinal << recurrence.byDayOfMonth
+        << recurrence.byMonth << recurrence.byYearDay << recurrence.byWeekNo << recurrence.bySetPos << exceptions
+        << recurrenceDates;
+}
+
+void readRecurrence(QDataStream &in, Core::Recurrence &recurrence, QList<QDate> &exceptions,
+                    QList<QDateTime> &recurrenceDates)
+{
+    qint32 pattern = 0;
+    qint32 interval = 1;
+    qint32 count = 0;
+    qint32 weekStart = 1;
+    in >> pattern >> interval >> recurrence.endDate >> count >> weekStart >> recurrence.byDayOfWeek
+        >> recurrence.byDayOrdinal >> recurrence.byDayOfMonth >> recurrence.byMonth >> recurrence.byYearDay
+        >> recurrence.byWeekNo >> recurrence.bySetPos >> exceptions >> recurrenceDates;
+    recurrence.pattern = Core::Recurrence::Pattern(pattern);
+    recurrence.interval = interval;
+    recurrence.count = count;
+    recurrence.weekStart = weekStart;
+}
+
+void writeEvent(QDataStream &out, const Core::CalendarEvent &event)
+{
+    out << event.uid << event.title << event.description << event.location << event.startDateTime
+        << event.endDateTime << event.isAllDay;
+    writeRecurrence(out, event.recurrence, event.recurrenceExceptions, event.recurrenceDates);
+    out << qint32(event.type) << qint32(event.status) << qint32(event.priority);
+
+    out << quint32(event.attendees.size());
+    for (const auto &attendee : event.attendees) {
+        out << attendee.uid << attendee.name << attendee.email << attendee.role << attendee.status;
+    }
+    out << event.organizer;
+
+    out << quint32(event.alarms.size());
+    for (const auto &alarm : event.alarms) {
+        out << alarm.minutesBefore.has_value() << qint32(alarm.minutesBefore.value_or(0)) << alarm.relatedToEnd
+            << alarm.triggerTime << alarm.rawTrigger << alarm.action << alarm.description;
+    }
+
+    out << event.categories << event.url << event.attachment << event.created << event.lastModified;
+}
+
+Core::CalendarEventPtr readEvent(QDataStream &in)
+{
+    auto event = std::make_shared<Core::CalendarEvent>();
+    in >> event->uid >> event->title >> event->description >> event->location >> event->startDateTime
+        >> event->endDateTime >> event->isAllDay;
+    readRecurrence(in, event->recurrence, event->recurrenceExceptions, event->recurrenceDates);
+
+    qint32 type = 0;
+    qint32 status = 0;
+    qint32 priority = 0;
+    in >> type >> status >> priority;
+    event->type = Core::EventType(type);
+    event->status = Core::EventStatus(status);
+    event->priority = priority;
+
+    quint32 count = 0;
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        Core::Attendee attendee;
+        in >> attendee.uid >> attendee.name >> attendee.email >> attendee.role >> attendee.status;
+        event->attendees.append(attendee);
+    }
+    in >> event->organizer;
+
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        Core::Alarm alarm;
+        bool relative = false;
+        qint32 minutesBefore = 0;
+        in >> relative >> minutesBefore >> alarm.relatedToEnd >> alarm.triggerTime >> alarm.rawTrigger >> alarm.action
+            >> alarm.description;
+        if (relative) {
+            alarm.minutesBefore = minutesBefore;
+        }
+        event->alarms.append(alarm);
+    }
+
+    in >> event->categories >> event->url >> event->attachment >> event->created >> event->lastModified;
+    return event;
+}
+
+void writeTodo(QDataStream &out, const Core::TodoItem &todo)
+{
+    out << todo.uid << todo.title << todo.description << todo.location << todo.startDateTime << todo.dueDateTime
+        << todo.completedDateTime << todo.isAllDay << qint32(todo.status) << qint32(todo.percentComplete)
+        << qint32(todo.priority) << todo.categories;
+    writeRecurrence(out, todo.recurrence, todo.recurrenceExceptions, todo.recurrenceDates);
+    out << todo.created << todo.lastModified;
+}
+
+Core::TodoItemPtr readTodo(QDataStream &in)
+{
+    auto todo = std::make_shared<Core::TodoItem>();
+    qint32 status = 0;
+    qint32 percentComplete = 0;
+    qint32 priority = 0;
+    in >> todo->uid >> todo->title >> todo->description >> todo->location >> todo->startDateTime >> todo->dueDateTime
+        >> todo->completedDateTime >> todo->isAllDay >> status >> percentComplete >> priority >> todo->categories;
+    todo->status = Core::TodoItem::Status(status);
+    todo->percentComplete = percentComplete;
+    todo->priority = priority;
+    readRecurrence(in, todo->recurrence, todo->recurrenceExceptions, todo->recurrenceDates);
+    in >> todo->created >> todo->lastModified;
+    return todo;
+}
+} // namespace
+
+bool SnapshotCache::read(const QString &snapshotPath, const QString &sourcePath, ICalParser::Result &result)
+{
+    QFile file(snapshotPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    // Decode straight from the mapping; QByteArray::fromRawData does not copy
+    const qint64 size = file.size();
+    const uchar *data = size > 0 ? file.map(0, size) : nullptr;
+    QByteArray bytes;
+    if (data) {
+        bytes = QByteArray::fromRawData(reinterpret_cast<const char *>(data), size);
+    } else {
+        bytes = file.readAll();
+    }
+
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::ReadOnly);
+    QDataStream in(&buffer);
+    in.setVersion(kStreamVersion);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    SourceStamp stored;
+    in >> magic >> version >> stored.size >> stored.modified >> stored.hash;
+    if (in.status() != QDataStream::Ok || magic != kMagic || version != kVersion) {
+        return false;
+    }
+
+    // Cheap checks first: size and mtime reject most stale snapshots without hashing
+    const QFileInfo source(sourcePath);
+    if (!source.exists() || source.size() != stored.size
+        || source.lastModified().toMSecsSinceEpoch() != stored.modified) {
+        return false;
+    }
+
+    SourceStamp current;
+    if (!stampSource(sourcePath, current) || !(current == stored)) {
+        return false;
+    }
+
+    quint32 eventCount = 0;
+    quint32 todoCount = 0;
+    in >> eventCount >> todoCount;
+
+    ICalParser::Result decoded;
+    decoded.events.reserve(eventCount);
+    for (quint32 i = 0; i < eventCount && in.status() == QDataStream::Ok; ++i) {
+        decoded.events.append(readEvent(in));
+    }
+    decoded.todos.reserve(todoCount);
+    for (quint32 i = 0; i < todoCount && in.status() == QDataStream::Ok; ++i) {
+        decoded.todos.append(readTodo(in));
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "SnapshotCache: Corrupt snapshot" << snapshotPath;
+        return false;
+    }
+
+    result = std::move(decoded);
+    return true;
+}
+
+quint64 SnapshotCache::contentHash(const Core::CalendarEvent &event)
+{
+    // Reused per thread: hashing runs once per event on every reload
+    thread_local QByteArray record;
+    record.clear();
+
+    QBuffer buffer(&record);
+    buffer.open(QIODevice::WriteOnly);
+    QDataStream out(&buffer);
+    out.setVersion(kStreamVersion);
+    writeEvent(out, event);
+    return qHashBits(record.constData(), size_t(record.size()));
+}
+
+bool SnapshotCache::write(const QString &snapshotPath, const QString &sourcePath,
+                          const QList<Core::CalendarEventPtr> &events, const QList<Core::TodoItemPtr> &todos)
+{
+    SourceStamp stamp;
+    if (!stampSource(sourcePath, stamp)) {
+        return false;
+    }
+
+    QDir().mkpath(QFileInfo(snapshotPath).absolutePath());
+    QSaveFile file(snapshotPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "SnapshotCache: Cannot write" << snapshotPath;
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(kStreamVersion);
+    out << kMagic << kVersion << stamp.size << stamp.modified << stamp.hash;
+    out << quint32(events.size()) << quint32(todos.size());
+    for (const auto &event : events) {
+        writeEvent(out, *event);
+    }
+    for (const auto &todo : todos) {
+        writeTodo(out, *todo);
+    }
+
+    if (out.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        file.commit();
+        return false;
+    }
+    return file.commit();
+}
+
+} // namespace PersonalCalendar::Local
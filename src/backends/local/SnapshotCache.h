@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include "ICalParser.h"
+#include <QString>
+
+namespace PersonalCalendar::Local
+{
+
+/**
+ * @brief Versioned binary snapshot of a parsed .ics file
+ *
+ * A snapshot stores every component in a compact QDataStream encoding
+ * together with the size, modification time and content hash of the text
+ * file it was built from. Reading memory-maps the snapshot and decodes it
+ * without any tokenizing; a snapshot whose stamp no longer matches the
+ * source file is rejected so the caller falls back to a text parse.
+ */
+class SnapshotCache
+{
+public:
+    /**
+     * @brief Load a snapshot if it is still valid for the source file
+     * @param snapshotPath Path to the .bin snapshot
+     * @param sourcePath Path to the .ics file it mirrors
+     * @param result Receives the decoded events and todos
+     * @return false if the snapshot is missing, stale or corrupt
+     */
+    static bool read(const QString &snapshotPath, const QString &sourcePath, ICalParser::Result &result);
+
+    /**
+     * @brief Write a snapshot of the given components for the source file
+     * @return true if the snapshot was written atomically
+     */
+    static bool write(const QString &snapshotPath, const QString &sourcePath, const QList<Core::CalendarEventPtr> &events,
+                      const QList<Core::TodoItemPtr> &todos);
+
+    /**
+     * @brief Hash of every stored field of an event
+     *
+     * Two events with equal hashes encode to the same snapshot record, so this
+     * detects any content change (calendarId is not part of the content).
+     */
+    static quint64 contentHash(const Core::CalendarEvent &event);
+};
+
+} // namespace PersonalCalendar::Local
@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "TodoIndex.h"
+#include <limits>
+
+namespace PersonalCalendar::Local
+{
+
+namespace
+{
+template<typename Map>
+QList<Core::TodoItemPtr> valuesIn(typename Map::const_iterator first, typename Map::const_iterator last)
+{
+    QList<Core::TodoItemPtr> result;
+    for (auto it = first; it != last; ++it) {
+        result.append(it.value());
+    }
+    return result;
+}
+} // namespace
+
+void TodoIndex::insert(const Core::TodoItemPtr &todo)
+{
+    if (!todo) {
+        return;
+    }
+
+    auto it = m_entries.find(todo->uid);
+    if (it != m_entries.end()) {
+        unfile(todo->uid, it.value());
+    }
+
+    const Keys keys = keysFor(*todo);
+    m_entries.insert(todo->uid, keys);
+
+    if (keys.hasDue) {
+        m_byDue.insert({keys.due, todo->uid}, todo);
+        if (keys.open) {
+            m_openByDue.insert({keys.due, todo->uid}, todo);
+        }
+    }
+    if (keys.open) {
+        m_openByPriority.insert({keys.rank, keys.hasDue ? keys.due : std::numeric_limits<qint64>::max(), todo->uid},
+                                todo);
+    }
+    m_byStatus[size_t(keys.status)].insert(todo->uid, todo);
+}
+
+void TodoIndex::remove(const QString &uid)
+{
+    auto it = m_entries.find(uid);
+    if (it == m_entries.end()) {
+        return;
+    }
+    unfile(uid, it.value());
+    m_entries.erase(it);
+}
+
+void TodoIndex::clear()
+{
+    m_entries.clear();
+    m_byDue.clear();
+    m_openByDue.clear();
+    m_openByPriority.clear();
+    for (auto &map : m_byStatus) {
+        map.clear();
+    }
+}
+
+int TodoIndex::size() const
+{
+    return int(m_entries.size());
+}
+
+QList<Core::TodoItemPtr> TodoIndex::overdue(qint64 now) const
+{
+    return valuesIn<decltype(m_openByDue)>(m_openByDue.cbegin(), m_openByDue.lowerBound({now, QString()}));
+}
+
+QList<Core::TodoItemPtr> TodoIndex::dueBetween(qint64 from, qint64 to) const
+{
+    if (from >= to) {
+        return QList<Core::TodoItemPtr>();
+    }
+    return valuesIn<decltype(m_byDue)>(m_byDue.lowerBound({from, QString()}), m_byDue.lowerBound({to, QString()}));
+}
+
+QList<Core::TodoItemPtr> TodoIndex::withStatus(Core::TodoItem::Status status) const
+{
+    return m_byStatus[size_t(status)].values();
+}
+
+QList<Core::TodoItemPtr> TodoIndex::topByPriority(int count) const
+{
+    QList<Core::TodoItemPtr> result;
+    for (auto it = m_openByPriority.cbegin(); it != m_openByPriority.cend() && result.size() < count; ++it) {
+        result.append(it.value());
+    }
+    return result;
+}
+
+TodoIndex::Keys TodoIndex::keysFor(const Core::TodoItem &todo)
+{
+    Keys keys;
+    keys.hasDue = todo.dueDateTime.isValid();
+    keys.open = todo.isOpen();
+    keys.due = keys.hasDue ? todo.dueDateTime.toSecsSinceEpoch() : 0;
+    keys.rank = todo.priority > 0 ? todo.priority : 10; // Undefined (0) sorts after 9
+    keys.status = todo.status;
+    return keys;
+}
+
+void TodoIndex::unfile(const QString &uid, const Keys &keys)
+{
+    if (keys.hasDue) {
+        m_byDue.remove({keys.due, uid});
+        m_openByDue.remove({keys.due, uid});
+    }
+    m_openByPriority.remove({keys.rank, keys.hasDue ? keys.due : std::numeric_limits<qint64>::max(), uid});
+    m_byStatus[size_t(keys.status)].remove(uid);
+}
+
+} // namespace PersonalCalendar::Local
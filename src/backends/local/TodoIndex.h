@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include "core/models/TodoItem.h"
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <array>
+#include <tuple>
+#include <utility>
+
+namespace PersonalCalendar::Local
+{
+
+/**
+ * @brief Secondary indexes over todos
+ *
+ * Keeps ordered maps by due date (all todos and open ones only), by status
+ * and by priority (open todos only), so overdue, due-in-range, per-status
+ * and top-N queries walk just the entries they return. The keys an entry
+ * was filed under are remembered per UID, so a todo that was edited in
+ * place is still found and re-filed on insert.
+ */
+class TodoIndex
+{
+public:
+    /**
+     * @brief Insert or re-file a todo (keyed by its UID)
+     */
+    void insert(const Core::TodoItemPtr &todo);
+
+    /**
+     * @brief Remove a todo
+     */
+    void remove(const QString &uid);
+
+    void clear();
+    int size() const;
+
+    /**
+     * @brief Open todos due before @p now, in due order
+     */
+    QList<Core::TodoItemPtr> overdue(qint64 now) const;
+
+    /**
+     * @brief Todos of any status due in [from, to), in due order
+     */
+    QList<Core::TodoItemPtr> dueBetween(qint64 from, qint64 to) const;
+
+    /**
+     * @brief Todos with the given status, in UID order
+     */
+    QList<Core::TodoItemPtr> withStatus(Core::TodoItem::Status status) const;
+
+    /**
+     * @brief The @p count highest-priority open todos
+     * @see Core::ICalendarStorage::isHigherPriority
+     */
+    QList<Core::TodoItemPtr> topByPriority(int count) const;
+
+private:
+    using DueKey = std::pair<qint64, QString>;
+    using PriorityKey = std::tuple<int, qint64, QString>;
+
+    struct Keys {
+        bool hasDue = false;
+        bool open = false;
+        qint64 due = 0;
+        int rank = 0;
+        Core::TodoItem::Status status = Core::TodoItem::Status::NeedsAction;
+    };
+
+    static Keys keysFor(const Core::TodoItem &todo);
+    void unfile(const QString &uid, const Keys &keys);
+
+    QHash<QString, Keys> m_entries;
+    QMap<DueKey, Core::TodoItemPtr> m_byDue;
+    QMap<DueKey, Core::TodoItemPtr> m_openByDue;
+    QMap<PriorityKey, Core::TodoItemPtr> m_openByPriority;
+    std::array<QMap<QString, Core::TodoItemPtr>, 4> m_byStatus;
+};
+
+} // namespace PersonalCalendar::Local
@@ -0,0 +1,163 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "UidIndex.h"
+#include <QHashFunctions>
+#include <algorithm>
+#include <utility>
+
+namespace PersonalCalendar::Local
+{
+
+namespace
+{
+constexpr qsizetype kMinCapacity = 16;
+
+// Linear probing degrades quickly past ~70% load
+bool overLoaded(qsizetype size, qsizetype capacity)
+{
+    return size * 10 > capacity * 7;
+}
+}
+
+size_t UidIndex::hashOf(const QString &uid)
+{
+    return qHash(uid, size_t(0x9e3779b97f4a7c15ULL));
+}
+
+qsizetype UidIndex::find(const QString &uid, size_t hash) const
+{
+    if (m_slots.empty()) {
+        return -1;
+    }
+
+    const size_t mask = m_slots.size() - 1;
+    for (size_t pos = hash & mask;; pos = (pos + 1) & mask) {
+        const Slot &slot = m_slots[pos];
+        if (slot.uid.isNull()) {
+            return -1;
+        }
+        if (slot.hash == hash && slot.uid == uid) {
+            return qsizetype(pos);
+        }
+    }
+}
+
+void UidIndex::insert(const QString &uid, const QString &calendarId)
+{
+    if (uid.isEmpty()) {
+        return;
+    }
+
+    const size_t hash = hashOf(uid);
+    const qsizetype existing = find(uid, hash);
+    if (existing >= 0) {
+        m_slots[existing].calendarId = calendarId;
+        return;
+    }
+
+    if (m_slots.empty() || overLoaded(m_size + 1, qsizetype(m_slots.size()))) {
+        rehash(std::max(kMinCapacity, qsizetype(m_slots.size()) * 2));
+    }
+
+    const size_t mask = m_slots.size() - 1;
+    size_t pos = hash & mask;
+    while (!m_slots[pos].uid.isNull()) {
+        pos = (pos + 1) & mask;
+    }
+    m_slots[pos] = Slot{hash, uid, calendarId};
+    ++m_size;
+}
+
+QString UidIndex::value(const QString &uid) const
+{
+    const qsizetype pos = find(uid, hashOf(uid));
+    return pos >= 0 ? m_slots[pos].calendarId : QString();
+}
+
+bool UidIndex::contains(const QString &uid) const
+{
+    return find(uid, hashOf(uid)) >= 0;
+}
+
+bool UidIndex::remove(const QString &uid)
+{
+    const qsizetype pos = find(uid, hashOf(uid));
+    if (pos < 0) {
+        return false;
+    }
+    eraseAt(pos);
+    return true;
+}
+
+void UidIndex::removeCalendar(const QString &calendarId)
+{
+    if (m_size == 0) {
+        return;
+    }
+
+    // Emptying slots breaks probe chains, so re-place the survivors
+    for (auto &slot : m_slots) {
+        if (!slot.uid.isNull() && slot.calendarId == calendarId) {
+            slot = Slot();
+            --m_size;
+        }
+    }
+    rehash(qsizetype(m_slots.size()));
+}
+
+void UidIndex::eraseAt(qsizetype pos)
+{
+    // Backward-shift deletion: pull later members of the cluster into the
+    // hole unless that would move them before their home slot.
+    const size_t mask = m_slots.size() - 1;
+    size_t hole = size_t(pos);
+    for (size_t next = (hole + 1) & mask; !m_slots[next].uid.isNull(); next = (next + 1) & mask) {
+        const size_t home = m_slots[next].hash & mask;
+        const bool movable = hole <= next ? (home <= hole || home > next) : (home <= hole && home > next);
+        if (movable) {
+            m_slots[hole] = std::move(m_slots[next]);
+            hole = next;
+        }
+    }
+    m_slots[hole] = Slot();
+    --m_size;
+}
+
+void UidIndex::reserve(qsizetype count)
+{
+    qsizetype capacity = std::max(kMinCapacity, qsizetype(m_slots.size()));
+    while (overLoaded(count, capacity)) {
+        capacity *= 2;
+    }
+    if (capacity > qsizetype(m_slots.size())) {
+        rehash(capacity);
+    }
+}
+
+void UidIndex::rehash(qsizetype capacity)
+{
+    std::vector<Slot> old;
+    old.swap(m_slots);
+    m_slots.resize(capacity);
+
+    const size_t mask = size_t(capacity) - 1;
+    for (auto &slot : old) {
+        if (slot.uid.isNull()) {
+            continue;
+        }
+        size_t pos = slot.hash & mask;
+        while (!m_slots[pos].uid.isNull()) {
+            pos = (pos + 1) & mask;
+        }
+        m_slots[pos] = std::move(slot);
+    }
+}
+
+void UidIndex::clear()
+{
+    m_slots.clear();
+    m_size = 0;
+}
+
+} // namespace PersonalCalendar::Local
@@ -0,0 +1,72 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include <QString>
+#include <vector>
+
+namespace PersonalCalendar::Local
+{
+
+/**
+ * @brief UID to calendar ID hash index
+ *
+ * Open-addressing table with linear probing. Every slot keeps the full hash
+ * of its UID, so probes compare integers and only touch the string on a hash
+ * match. Removal shifts the following cluster back instead of leaving
+ * tombstones, so lookups stay short no matter how many events were deleted.
+ * Calendar IDs are implicitly shared QStrings and cost one pointer per entry.
+ */
+class UidIndex
+{
+public:
+    /**
+     * @brief Insert a UID or move it to another calendar
+     */
+    void insert(const QString &uid, const QString &calendarId);
+
+    /**
+     * @brief Calendar holding a UID
+     * @return Calendar ID, or a null string if the UID is unknown
+     */
+    QString value(const QString &uid) const;
+
+    bool contains(const QString &uid) const;
+
+    /**
+     * @brief Remove a UID
+     * @return true if it was present
+     */
+    bool remove(const QString &uid);
+
+    /**
+     * @brief Remove every UID that belongs to a calendar
+     */
+    void removeCalendar(const QString &calendarId);
+
+    /**
+     * @brief Make room for at least @p count entries without rehashing
+     */
+    void reserve(qsizetype count);
+
+    void clear();
+    qsizetype size() const { return m_size; }
+
+private:
+    struct Slot {
+        size_t hash = 0;
+        QString uid; // Null for an empty slot
+        QString calendarId;
+    };
+
+    static size_t hashOf(const QString &uid);
+    qsizetype find(const QString &uid, size_t hash) const;
+    void eraseAt(qsizetype pos);
+    void rehash(qsizetype capacity);
+
+    std::vector<Slot> m_slots; // Capacity is zero or a power of two
+    qsizetype m_size = 0;
+};
+
+} // namespace PersonalCalendar::Local
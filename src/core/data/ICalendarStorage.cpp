@@ -0,0 +1,500 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "ICalendarStorage.h"
+#include "../utils/FreeBusyCalculator.h"
+#include "../utils/RecurrenceCalculator.h"
+#include "../utils/TextSearch.h"
+#include <QDebug>
+#include <algorithm>
+#include <limits>
+
+namespace PersonalCalendar::Core
+{
+
+bool ICalendarStorage::applyBatch(const QList<EventMutation> &mutations)
+{
+    // 预先校验，避免明显无效的批次修改任何数据
+    for (const auto &mutation : mutations) {
+        if (mutation.type == EventMutation::Type::Delete) {
+            if (mutation.uid.isEmpty()) {
+                return false;
+            }
+        } else if (!mutation.event || !mutation.event->isValid()) {
+            return false;
+        }
+    }
+
+    // 记录每一步的逆操作，失败时倒序撤销
+    QList<EventMutation> undo;
+    undo.reserve(mutations.size());
+
+    for (const auto &mutation : mutations) {
+        bool success = false;
+        switch (mutation.type) {
+            case EventMutation::Type::Create:
+                success = createEvent(mutation.event);
+                if (success) {
+                    undo.append(EventMutation::remove(mutation.event->uid));
+                }
+                break;
+            case EventMutation::Type::Update: {
+                auto previous = getEvent(mutation.event->uid);
+                auto snapshot = previous ? std::make_shared<CalendarEvent>(*previous) : nullptr;
+                success = updateEvent(mutation.event);
+                if (success && snapshot) {
+                    undo.append(EventMutation::update(snapshot));
+                }
+                break;
+            }
+            case EventMutation::Type::Delete: {
+                auto previous = getEvent(mutation.uid);
+                success = deleteEvent(mutation.uid);
+                if (success && previous) {
+                    undo.append(EventMutation::create(previous));
+                }
+                break;
+            }
+        }
+
+        if (!success) {
+            qWarning() << "ICalendarStorage: Batch failed at" << mutation.targetUid() << ", rolling back";
+            for (auto it = undo.crbegin(); it != undo.crend(); ++it) {
+                switch (it->type) {
+                    case EventMutation::Type::Create:
+                        createEvent(it->event);
+                        break;
+                    case EventMutation::Type::Update:
+                        updateEvent(it->event);
+                        break;
+                    case EventMutation::Type::Delete:
+                        deleteEvent(it->uid);
+                        break;
+                }
+            }
+            return false;
+        }
+    }
+
+    return true;
+}
+
+QList<EventOccurrence> ICalendarStorage::getOccurrencesByDateRange(const QDate &start, const QDate &end)
+{
+    QList<EventOccurrence> occurrences;
+    if (!start.isValid() || !end.isValid() || start > end) {
+        return occurrences;
+    }
+
+    return RecurrenceCalculator::calculateOccurrences(getEventsByDateRange(start, end), start, end);
+}
+
+QList<CalendarEventPtr> ICalendarStorage::getEventsWithCategories(const QDate &start, const QDate &end,
+                                                                  const QStringList &categories)
+{
+    QList<CalendarEventPtr> events = getEventsByDateRange(start, end);
+    if (categories.isEmpty()) {
+        return events;
+    }
+
+    events.removeIf([&categories](const CalendarEventPtr &event) {
+        return std::none_of(categories.cbegin(), categories.cend(),
+                            [&event](const QString &category) { return event->categories.contains(category); });
+    });
+    return events;
+}
+
+QList<EventOccurrence> ICalendarStorage::getOccurrencesWithCategories(const QDate &start, const QDate &end,
+                                                                      const QStringList &categories)
+{
+    if (categories.isEmpty()) {
+        return getOccurrencesByDateRange(start, end);
+    }
+    if (!start.isValid() || !end.isValid() || start > end) {
+        return QList<EventOccurrence>();
+    }
+
+    return RecurrenceCalculator::calculateOccurrences(getEventsWithCategories(start, end, categories), start, end);
+}
+
+int ICalendarStorage::deleteWhere(const EventPredicate &predicate, const QStringList &calendarIds)
+{
+    if (!predicate) {
+        return -1;
+    }
+
+    const QList<QString> ids = calendarIds.isEmpty() ? getCalendarIds() : calendarIds;
+    QList<EventMutation> deletions;
+    for (const auto &id : ids) {
+        const auto events = getEventsByCollection(id);
+        for (const auto &event : events) {
+            if (event && predicate(*event)) {
+                deletions.append(EventMutation::remove(event->uid));
+            }
+        }
+    }
+
+    if (deletions.isEmpty()) {
+        return 0;
+    }
+    return applyBatch(deletions) ? static_cast<int>(deletions.size()) : -1;
+}
+
+int ICalendarStorage::purgeBefore(const QDate &date, const QStringList &calendarIds)
+{
+    if (!date.isValid()) {
+        return -1;
+    }
+
+    // 最后一个实例（含 RDATE）结束在截止日期之前才删除；无限重复的事件结束日为 max，永远保留
+    const qint64 cutoff = date.toJulianDay();
+    return deleteWhere(
+        [&](const CalendarEvent &event) {
+            if (!event.startDateTime.isValid()) {
+                return false;
+            }
+            return RecurrenceCalculator::seriesDays(event).second < cutoff;
+        },
+        calendarIds);
+}
+
+SearchResults ICalendarStorage::searchEvents(const SearchQuery &query)
+{
+    const QStringList tokens = TextSearch::tokenize(query.text);
+    if (tokens.isEmpty()) {
+        return SearchResults();
+    }
+
+    QStringList ids = query.calendarIds;
+    if (ids.isEmpty()) {
+        const auto all = getCalendarIds();
+        for (const auto &id : all) {
+            if (getCalendarVisibility(id)) {
+                ids.append(id);
+            }
+        }
+    }
+
+    const qint64 first = query.start.isValid() ? query.start.toJulianDay() : std::numeric_limits<qint64>::min();
+    const qint64 last = query.end.isValid() ? query.end.toJulianDay() : std::numeric_limits<qint64>::max();
+    constexpr TextSearch::Field kFields[] = {TextSearch::Title, TextSearch::Location, TextSearch::Description};
+
+    QList<SearchHit> hits;
+    for (const auto &id : std::as_const(ids)) {
+        const auto events = getEventsByCollection(id);
+        for (const auto &event : events) {
+            if (!event) {
+                continue;
+            }
+            const auto [eventFirst, eventLast] = RecurrenceCalculator::seriesDays(*event);
+            if (eventFirst > last || eventLast < first) {
+                continue;
+            }
+
+            const QStringList terms[] = {TextSearch::tokenize(event->title), TextSearch::tokenize(event->location),
+                                         TextSearch::tokenize(event->description)};
+
+            // 每个查询词取最好的一次匹配，任何一个词没有匹配则整个事件不匹配
+            double total = 0;
+            for (const auto &token : tokens) {
+                double best = 0;
+                for (int field = 0; field < 3; ++field) {
+                    for (const auto &term : terms[field]) {
+                        best = std::max(best, TextSearch::score(TextSearch::match(term, token), kFields[field]));
+                    }
+                }
+                if (best == 0) {
+                    total = 0;
+                    break;
+                }
+                total += best;
+            }
+
+            if (total > 0) {
+                hits.append(SearchHit{event, total});
+            }
+        }
+    }
+
+    return rankAndPage(std::move(hits), query.offset, query.limit);
+}
+
+bool ICalendarStorage::ranksBefore(const SearchHit &a, const SearchHit &b)
+{
+    if (a.score != b.score) {
+        return a.score > b.score;
+    }
+    if (a.event->startDateTime != b.event->startDateTime) {
+        return a.event->startDateTime > b.event->startDateTime;
+    }
+    return a.event->uid < b.event->uid;
+}
+
+SearchResults ICalendarStorage::rankAndPage(QList<SearchHit> hits, int offset, int limit)
+{
+    SearchResults results;
+    results.total = int(hits.size());
+
+    const qsizetype begin = std::clamp<qsizetype>(offset, 0, hits.size());
+    const qsizetype end = std::clamp<qsizetype>(qsizetype(begin) + std::max(limit, 0), begin, hits.size());
+    if (begin == end) {
+        return results;
+    }
+
+    // 只需要排好前 end 个
+    std::partial_sort(hits.begin(), hits.begin() + end, hits.end(), ranksBefore);
+    results.hits = hits.mid(begin, end - begin);
+    return results;
+}
+
+FreeBusy ICalendarStorage::getFreeBusy(const FreeBusyQuery &query)
+{
+    if (!query.start.isValid() || !query.end.isValid() || query.start >= query.end) {
+        return FreeBusy();
+    }
+
+    // 事件按所在时区的日期归档，两端各多取一天
+    auto occurrences = getOccurrencesByDateRange(query.start.toUTC().date().addDays(-1),
+                                                 query.end.toUTC().date().addDays(1));
+    if (!query.calendarIds.isEmpty()) {
+        occurrences.removeIf([&query](const EventOccurrence &occurrence) {
+            return !occurrence.event || !query.calendarIds.contains(occurrence.event->calendarId);
+        });
+    }
+    return FreeBusyCalculator::compute(occurrences, query);
+}
+
+namespace
+{
+// findFreeSlots 每块最多查询的天数
+constexpr int kMaxSlotChunkDays = 32;
+
+// 把时刻推迟到所在时区一天中 minutes 的整倍数
+qint64 alignUp(qint64 secs, int minutes, const QTimeZone &zone)
+{
+    if (minutes <= 0) {
+        return secs;
+    }
+    const qint64 step = qint64(minutes) * 60;
+    const qint64 remainder = (QDateTime::fromSecsSinceEpoch(secs, zone).time().msecsSinceStartOfDay() / 1000) % step;
+    return remainder == 0 ? secs : secs + step - remainder;
+}
+} // namespace
+
+QList<FreeSlot> ICalendarStorage::findFreeSlots(const FreeSlotQuery &query)
+{
+    QList<FreeSlot> result;
+    if (!query.start.isValid() || !query.end.isValid() || query.start >= query.end || query.durationMinutes <= 0
+        || query.maxResults <= 0) {
+        return result;
+    }
+
+    const QTimeZone zone = query.start.timeRepresentation();
+    const qint64 duration = qint64(query.durationMinutes) * 60;
+
+    FreeBusyQuery busyQuery;
+    busyQuery.calendarIds = query.calendarIds;
+    busyQuery.attendee = query.attendee;
+
+    // 当前这段空闲；它可能延续到下一块，所以要等到确定结束时才判断长度
+    qint64 runStart = -1;
+    qint64 runEnd = -1;
+    auto finishRun = [&]() {
+        if (runStart < 0) {
+            return;
+        }
+        const qint64 start = alignUp(runStart, query.alignMinutes, zone);
+        if (runEnd - start >= duration) {
+            result.append(
+                FreeSlot{QDateTime::fromSecsSinceEpoch(start, zone), QDateTime::fromSecsSinceEpoch(runEnd, zone)});
+        }
+        runStart = -1;
+    };
+    auto addFree = [&](qint64 start, qint64 end) {
+        if (runStart >= 0 && start == runEnd) {
+            runEnd = end;
+            return;
+        }
+        finishRun();
+        runStart = start;
+        runEnd = end;
+    };
+
+    QDateTime chunkStart = query.start;
+    int chunkDays = 1;
+    while (chunkStart < query.end && result.size() < query.maxResults) {
+        // 第一块只查到当天结束，常见的"下一个空闲时段"通常在这里就能找到
+        const QDate chunkDate = QDateTime::fromSecsSinceEpoch(chunkStart.toSecsSinceEpoch(), zone).date();
+        const QDateTime chunkEnd = std::min(QDateTime(chunkDate.addDays(chunkDays), QTime(0, 0), zone), query.end);
+        chunkDays = std::min(chunkDays * 2, kMaxSlotChunkDays);
+
+        busyQuery.start = chunkStart;
+        busyQuery.end = chunkEnd;
+        const QList<BusyPeriod> busy = getFreeBusy(busyQuery).periods;
+        const qint64 to = chunkEnd.toSecsSinceEpoch();
+
+        // 工作时间减去忙碌时间；两个列表都已排序，一次归并即可
+        qsizetype next = 0;
+        const auto allowed = FreeBusyCalculator::workingIntervals(query.workingHours, zone,
+                                                                  chunkStart.toSecsSinceEpoch(), to);
+        for (const auto &[allowedStart, allowedEnd] : allowed) {
+            qint64 cursor = allowedStart;
+            while (next < busy.size() && busy[next].end <= cursor) {
+                ++next;
+            }
+            for (qsizetype i = next; i < busy.size() && busy[i].start < allowedEnd; ++i) {
+                if (query.tentativeIsFree && busy[i].type == BusyPeriod::Type::Tentative) {
+                    continue;
+                }
+                if (busy[i].start > cursor) {
+                    addFree(cursor, busy[i].start);
+                }
+                cursor = std::max(cursor, busy[i].end);
+            }
+            if (cursor < allowedEnd) {
+                addFree(cursor, allowedEnd);
+            }
+        }
+
+        // 没有延续到块尾的空闲已经结束
+        if (runStart >= 0 && runEnd < to) {
+            finishRun();
+        }
+        chunkStart = chunkEnd;
+    }
+
+    finishRun();
+    if (result.size() > query.maxResults) {
+        result.resize(query.maxResults);
+    }
+    return result;
+}
+
+namespace
+{
+bool dueBefore(const TodoItemPtr &a, const TodoItemPtr &b)
+{
+    return a->dueDateTime < b->dueDateTime;
+}
+} // namespace
+
+bool ICalendarStorage::createTodo(const TodoItemPtr &todo)
+{
+    Q_UNUSED(todo)
+    return false;
+}
+
+TodoItemPtr ICalendarStorage::getTodo(const QString &uid)
+{
+    Q_UNUSED(uid)
+    return nullptr;
+}
+
+bool ICalendarStorage::updateTodo(const TodoItemPtr &todo)
+{
+    Q_UNUSED(todo)
+    return false;
+}
+
+bool ICalendarStorage::deleteTodo(const QString &uid)
+{
+    Q_UNUSED(uid)
+    return false;
+}
+
+QList<TodoItemPtr> ICalendarStorage::getTodos()
+{
+    return QList<TodoItemPtr>();
+}
+
+QList<TodoItemPtr> ICalendarStorage::getOverdueTodos(const QDateTime &now)
+{
+    QList<TodoItemPtr> result;
+    const auto todos = getTodos();
+    for (const auto &todo : todos) {
+        if (todo && todo->isOverdue(now)) {
+            result.append(todo);
+        }
+    }
+    std::stable_sort(result.begin(), result.end(), dueBefore);
+    return result;
+}
+
+QList<TodoItemPtr> ICalendarStorage::getTodosDueBetween(const QDateTime &start, const QDateTime &end)
+{
+    QList<TodoItemPtr> result;
+    const auto todos = getTodos();
+    for (const auto &todo : todos) {
+        if (todo && todo->dueDateTime.isValid() && todo->dueDateTime >= start && todo->dueDateTime < end) {
+            result.append(todo);
+        }
+    }
+    std::stable_sort(result.begin(), result.end(), dueBefore);
+    return result;
+}
+
+QList<TodoItemPtr> ICalendarStorage::getTodosDueOn(const QDate &date)
+{
+    if (!date.isValid()) {
+        return QList<TodoItemPtr>();
+    }
+    return getTodosDueBetween(date.startOfDay(), date.addDays(1).startOfDay());
+}
+
+QList<TodoItemPtr> ICalendarStorage::getTodosByStatus(TodoItem::Status status)
+{
+    QList<TodoItemPtr> result;
+    const auto todos = getTodos();
+    for (const auto &todo : todos) {
+        if (todo && todo->status == status) {
+            result.append(todo);
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const TodoItemPtr &a, const TodoItemPtr &b) { return a->uid < b->uid; });
+    return result;
+}
+
+QList<TodoItemPtr> ICalendarStorage::getTopTodosByPriority(int count)
+{
+    QList<TodoItemPtr> result;
+    if (count <= 0) {
+        return result;
+    }
+
+    const auto todos = getTodos();
+    for (const auto &todo : todos) {
+        if (todo && todo->isOpen()) {
+            result.append(todo);
+        }
+    }
+
+    const auto higher = [](const TodoItemPtr &a, const TodoItemPtr &b) { return isHigherPriority(*a, *b); };
+    if (result.size() > count) {
+        std::partial_sort(result.begin(), result.begin() + count, result.end(), higher);
+        result.resize(count);
+    } else {
+        std::sort(result.begin(), result.end(), higher);
+    }
+    return result;
+}
+
+bool ICalendarStorage::isHigherPriority(const TodoItem &a, const TodoItem &b)
+{
+    // 0 表示未定义，排在 9 之后
+    const int rankA = a.priority > 0 ? a.priority : 10;
+    const int rankB = b.priority > 0 ? b.priority : 10;
+    if (rankA != rankB) {
+        return rankA < rankB;
+    }
+
+    // 没有截止时间的排在有截止时间的之后
+    if (a.dueDateTime.isValid() != b.dueDateTime.isValid()) {
+        return a.dueDateTime.isValid();
+    }
+    if (a.dueDateTime.isValid() && a.dueDateTime != b.dueDateTime) {
+        return a.dueDateTime < b.dueDateTime;
+    }
+    return a.uid < b.uid;
+}
+
+} // namespace PersonalCalendar::Core
@@ -4,14 +4,78 @@
 #pragma once
 
 #include "../models/CalendarEvent.h"
+#include "../models/EventOccurrence.h"
+#include "../models/FreeBusy.h"
+#include "../models/TodoItem.h"
+#include <QDateTime>
 #include <QDate>
 #include <QList>
 #include <QString>
+#include <QStringList>
+#include <functional>
 #include <memory>
 
 namespace PersonalCalendar::Core
 {
 
+/**
+ * @brief 批量修改中的单个操作
+ *
+ * Create/Update 使用 event，Delete 使用 uid。
+ */
+struct EventMutation {
+    enum class Type { Create, Update, Delete };
+
+    Type type = Type::Create;
+    CalendarEventPtr event;
+    QString uid;
+
+    static EventMutation create(const CalendarEventPtr &event) { return {Type::Create, event, QString()}; }
+    static EventMutation update(const CalendarEventPtr &event) { return {Type::Update, event, QString()}; }
+    static EventMutation remove(const QString &uid) { return {Type::Delete, nullptr, uid}; }
+
+    /**
+     * @brief 操作针对的事件 UID
+     */
+    QString targetUid() const { return type == Type::Delete ? uid : (event ? event->uid : QString()); }
+};
+
+/**
+ * @brief 批量删除的匹配条件
+ */
+using EventPredicate = std::function<bool(const CalendarEvent &)>;
+
+/**
+ * @brief 全文搜索条件
+ *
+ * 查询文本切分为词（见 TextSearch::tokenize），事件必须匹配所有词。
+ * 词可以匹配标题、描述或地点中某个词的开头，三个字符以上时也可以匹配词的中间。
+ */
+struct SearchQuery {
+    QString text;
+    QStringList calendarIds; // 限定的日历，为空表示所有可见日历
+    QDate start;             // 日期范围，无效表示不限；重复事件按整个系列的跨度判断
+    QDate end;
+    int offset = 0; // 分页：跳过的结果数
+    int limit = 50; // 分页：最多返回的结果数
+};
+
+/**
+ * @brief 一条搜索结果
+ */
+struct SearchHit {
+    CalendarEventPtr event;
+    double score = 0; // 越大越相关
+};
+
+/**
+ * @brief 一页搜索结果
+ */
+struct SearchResults {
+    QList<SearchHit> hits;
+    int total = 0; // 分页前的匹配总数
+};
+
 /**
  * @brief 日历存储的抽象接口
  *
@@ -53,6 +117,39 @@ public:
      */
     virtual bool deleteEvent(const QString &uid) = 0;
 
+    /**
+     * @brief 批量应用修改
+     *
+     * 先校验全部操作，再一次性应用；任何一步失败时回滚已应用的修改。
+     * 默认实现逐个调用单事件接口，后端应重写以实现每个文件只写一次。
+     *
+     * @param mutations 按顺序应用的操作列表
+     * @return 全部成功返回 true，失败时存储保持不变
+     */
+    virtual bool applyBatch(const QList<EventMutation> &mutations);
+
+    /**
+     * @brief 删除所有满足条件的事件
+     *
+     * 默认实现先查询再批量删除，后端应重写为单次遍历、只写一次文件。
+     *
+     * @param predicate 匹配条件
+     * @param calendarIds 限定的日历，为空表示所有日历
+     * @return 删除的事件数量，失败返回 -1
+     */
+    virtual int deleteWhere(const EventPredicate &predicate, const QStringList &calendarIds = QStringList());
+
+    /**
+     * @brief 删除在指定日期之前已经结束的事件
+     *
+     * 重复事件只有在设置了截止日期且最后一次发生也已结束时才会被删除。
+     *
+     * @param date 截止日期（不含）
+     * @param calendarIds 限定的日历，为空表示所有日历
+     * @return 删除的事件数量，失败返回 -1
+     */
+    int purgeBefore(const QDate &date, const QStringList &calendarIds = QStringList());
+
     // ===== 查询 =====
 
     /**
@@ -70,6 +167,46 @@ public:
      */
     virtual QList<CalendarEventPtr> getEventsByDateRange(const QDate &start, const QDate &end) = 0;
 
+    /**
+     * @brief 获取日期范围内的所有事件实例
+     *
+     * 重复事件会被展开，每个实例带有本次的开始/结束时间并引用主事件。
+     * 默认实现只展开 getEventsByDateRange 返回的事件，
+     * 后端应重写以包含开始于范围之前的重复事件。
+     *
+     * @param start 开始日期
+     * @param end 结束日期
+     * @return 按开始时间排序的实例列表
+     */
+    virtual QList<EventOccurrence> getOccurrencesByDateRange(const QDate &start, const QDate &end);
+
+    /**
+     * @brief 获取日期范围内带有任一指定分类的事件
+     *
+     * 分类比较区分大小写。默认实现在 getEventsByDateRange 的结果上逐个比较，
+     * 后端应重写为使用分类索引。
+     *
+     * @param start 开始日期
+     * @param end 结束日期
+     * @param categories 分类列表，为空时不过滤
+     * @return 事件列表
+     */
+    virtual QList<CalendarEventPtr> getEventsWithCategories(const QDate &start, const QDate &end,
+                                                            const QStringList &categories);
+
+    /**
+     * @brief 获取日期范围内带有任一指定分类的事件实例
+     *
+     * 先按分类过滤事件，再展开重复事件，不匹配的系列不会被展开。
+     *
+     * @param start 开始日期
+     * @param end 结束日期
+     * @param categories 分类列表，为空时与 getOccurrencesByDateRange 相同
+     * @return 按开始时间排序的实例列表
+     */
+    virtual QList<EventOccurrence> getOccurrencesWithCategories(const QDate &start, const QDate &end,
+                                                                const QStringList &categories);
+
     /**
      * @brief 获取特定日历集合的事件
      * @param collectionId 日历集合 ID
@@ -77,6 +214,146 @@ public:
      */
     virtual QList<CalendarEventPtr> getEventsByCollection(const QString &collectionId) = 0;
 
+    /**
+     * @brief 全文搜索事件的标题、描述和地点
+     *
+     * 默认实现逐个扫描事件，后端应重写为使用倒排索引。
+     *
+     * @param query 搜索条件
+     * @return 按相关度排序的一页结果
+     */
+    virtual SearchResults searchEvents(const SearchQuery &query);
+
+    /**
+     * @brief 搜索结果的先后
+     *
+     * 相关度高的在前，相同时较新的事件在前。
+     *
+     * @return a 应排在 b 之前时返回 true
+     */
+    static bool ranksBefore(const SearchHit &a, const SearchHit &b);
+
+    /**
+     * @brief 对全部匹配排序并取出一页
+     * @param hits 全部匹配
+     * @param offset 跳过的结果数
+     * @param limit 最多返回的结果数
+     */
+    static SearchResults rankAndPage(QList<SearchHit> hits, int offset, int limit);
+
+    // ===== 忙闲 =====
+
+    /**
+     * @brief 计算窗口内合并后的忙闲时间
+     *
+     * 已取消的事件不占用时间，暂定的事件记为暂定忙碌，全天事件按 query.includeAllDay 决定。
+     * 默认实现展开窗口内的所有实例后合并，后端应重写为直接扫描索引中的开始/结束时间。
+     *
+     * @param query 查询条件
+     * @return 忙闲信息，窗口无效时返回空结果
+     */
+    virtual FreeBusy getFreeBusy(const FreeBusyQuery &query);
+
+    /**
+     * @brief 查找最早的几段空闲时间
+     *
+     * 从窗口开始逐块调用 getFreeBusy，块从一天开始逐次加倍；找到 maxResults 段后立即停止，
+     * 不会展开整个窗口内的事件。空闲时间限制在工作时间内，跨过块边界的空闲会被合并。
+     *
+     * @param query 查询条件
+     * @return 按时间排序的空闲时段，最多 maxResults 段
+     */
+    QList<FreeSlot> findFreeSlots(const FreeSlotQuery &query);
+
+    // ===== 待办 =====
+    //
+    // 默认实现表示后端不支持待办：写操作失败，查询返回空列表。
+    // 查询的默认实现会遍历 getTodos()，后端应按截止时间、状态和优先级
+    // 建立索引并重写这些查询。
+
+    /**
+     * @brief 创建新待办
+     * @param todo 要创建的待办
+     * @return 成功返回 true
+     */
+    virtual bool createTodo(const TodoItemPtr &todo);
+
+    /**
+     * @brief 获取单个待办
+     * @param uid 待办的唯一标识
+     * @return 待办指针，如果不存在返回 nullptr
+     */
+    virtual TodoItemPtr getTodo(const QString &uid);
+
+    /**
+     * @brief 更新现有待办
+     * @param todo 更新的待办
+     * @return 成功返回 true
+     */
+    virtual bool updateTodo(const TodoItemPtr &todo);
+
+    /**
+     * @brief 删除待办
+     * @param uid 待办的唯一标识
+     * @return 成功返回 true
+     */
+    virtual bool deleteTodo(const QString &uid);
+
+    /**
+     * @brief 获取所有待办
+     * @return 待办列表
+     */
+    virtual QList<TodoItemPtr> getTodos();
+
+    /**
+     * @brief 获取已逾期的待办
+     * @param now 当前时间
+     * @return 满足 TodoItem::isOverdue(now) 的待办，按截止时间排序
+     */
+    virtual QList<TodoItemPtr> getOverdueTodos(const QDateTime &now);
+
+    /**
+     * @brief 获取截止时间在 [start, end) 内的待办
+     *
+     * 包含已完成和已取消的待办。
+     *
+     * @param start 开始时间（含）
+     * @param end 结束时间（不含）
+     * @return 待办列表，按截止时间排序
+     */
+    virtual QList<TodoItemPtr> getTodosDueBetween(const QDateTime &start, const QDateTime &end);
+
+    /**
+     * @brief 获取某一天到期的待办
+     * @param date 日期（本地时间）
+     * @return 待办列表，按截止时间排序
+     */
+    QList<TodoItemPtr> getTodosDueOn(const QDate &date);
+
+    /**
+     * @brief 获取指定状态的待办
+     * @param status 状态
+     * @return 待办列表，按 UID 排序
+     */
+    virtual QList<TodoItemPtr> getTodosByStatus(TodoItem::Status status);
+
+    /**
+     * @brief 获取优先级最高的待处理待办
+     *
+     * 优先级 1 最高、9 最低，未定义 (0) 排在最后；
+     * 同优先级按截止时间排序，没有截止时间的排在后面。
+     *
+     * @param count 最多返回的数量
+     * @return 待办列表
+     */
+    virtual QList<TodoItemPtr> getTopTodosByPriority(int count);
+
+    /**
+     * @brief 待办在优先级列表中的先后
+     * @return a 应排在 b 之前时返回 true
+     */
+    static bool isHigherPriority(const TodoItem &a, const TodoItem &b);
+
     // ===== 日历管理 =====
 
     /**
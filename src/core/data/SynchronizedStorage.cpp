@@ -0,0 +1,267 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "SynchronizedStorage.h"
+
+namespace PersonalCalendar::Core
+{
+
+SynchronizedStorage::SynchronizedStorage(ICalendarStoragePtr inner) : m_inner(std::move(inner))
+{
+}
+
+void SynchronizedStorage::setWriteHook(std::function<void()> hook)
+{
+    m_writeHook = std::move(hook);
+}
+
+void SynchronizedStorage::afterWrite()
+{
+    if (m_writeHook) {
+        m_writeHook();
+    }
+}
+
+bool SynchronizedStorage::createEvent(const CalendarEventPtr &event)
+{
+    QMutexLocker locker(&m_mutex);
+    const bool result = m_inner->createEvent(event);
+    locker.unlock();
+    afterWrite();
+    return result;
+}
+
+CalendarEventPtr SynchronizedStorage::getEvent(const QString &uid)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_inner->getEvent(uid);
+}
+
+bool SynchronizedStorage::updateEvent(const CalendarEventPtr &event)
+{
+    QMutexLocker locker(&m_mutex);
+    const bool result = m_inner->updateEvent(event);
+    locker.unlock();
+    afterWrite();
+    return result;
+}
+
+bool SynchronizedStorage::deleteEvent(const QString &uid)
+{
+    QMutexLocker locker(&m_mutex);
+    const bool result = m_inner->deleteEvent(uid);
+    locker.unlock();
+    afterWrite();
+    return result;
+}
+
+bool SynchronizedStorage::applyBatch(const QList<EventMutation> &mutations)
+{
+    QMutexLocker locker(&m_mutex);
+    const bool result = m_inner->applyBatch(mutations);
+    locker.unlock();
+    afterWrite();
+    return result;
+}
+
+int SynchronizedStorage::deleteWhere(const EventPredicate &predicate, const QStringList &calendarIds)
+{
+    QMutexLocker locker(&m_mutex);
+    const int result = m_inner->deleteWhere(predicate, calendarIds);
+    locker.unlock();
+    afterWrite();
+    return result;
+}
+
+QList<CalendarEventPtr> SynchronizedStorage::getEventsByDate(const QDate &date)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_inner->getEventsByDate(date);
+}
+
+QList<CalendarEventPtr> SynchronizedStorage::getEventsByDateRange(const QDate &start, const QDate &end)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_inner->getEventsByDateRange(start, end);
+}
+
+QList<EventOccurrence> SynchronizedStorage::getOccurrencesByDateRange(const QDate &start, const QDate &end)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_inner->getOccurrencesByDateRange(start, end);
+}
+
+QList<CalendarEventPtr> SynchronizedStorage::getEventsWithCategories(const QDate &start, const QDate &end,
+                                                                     const QStringList &categories)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_inner->getEventsWithCategories(start, end, categories);
+}
+
+QList<EventOccurrence> SynchronizedStorage::getOccurrencesWithCategories(const QDate &start, const QDate &end,
+                                                                         const QStringList &categories)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_inner->getOccurrencesWithCategories(start, end, categories);
+}
+
+QList<CalendarEventPtr> SynchronizedStorage::getEventsByCollection(const QString &collectionId)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_inner->getEventsByCollection(collectionId);
+}
+
+SearchResults SynchronizedStorage::searchEvents(const SearchQuery &query)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_inner->searchEvents(query);
+}
+
+FreeBusy SynchronizedStorage::getFreeBusy(const FreeBusyQuery &query)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_inner->getFreeBusy(query);
+}
+
+bool SynchronizedStorage::createTodo(const TodoItemPtr &todo)
+{
+    QMutexLocker locker(&m_mutex);
+    const bool result = m_inner->createTodo(todo);
+    locker.unlock();
+    afterWrite();
+    return result;
+}
+
+TodoItemPtr SynchronizedStorage::getTodo(const QString &uid)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_inner->getTodo(uid);
+}
+
+bool SynchronizedStorage::updateTodo(const TodoItemPtr &todo)
+{
+    QMutexLocker locker(&m_mutex);
+    const bool result = m_inner->updateTodo(todo);
+    locker.unlock();
+    afterWrite();
+    return result;
+}
+
+bool SynchronizedStorage::deleteTodo(const QString &uid)
+{
+    QMutexLocker locker(&m_mutex);
+    const bool result = m_inner->deleteTodo(uid);
+    locker.unlock();
+    afterWrite();
+    return result;
+}
+
+QList<TodoItemPtr> SynchronizedStorage::getTodos()
+{
+    QMutexLocker locker(&m_mutex);
+    return m_inner->getTodos();
+}
+
+QList<TodoItemPtr> SynchronizedStorage::getOverdueTodos(const QDateTime &now)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_inner->getOverdueTodos(now);
+}
+
+QList<TodoItemPtr> SynchronizedStorage::getTodosDueBetween(const QDateTime &start, const QDateTime &end)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_inner->getTodosDueBetween(start, end);
+}
+
+QList<TodoItemPtr> SynchronizedStorage::getTodosByStatus(TodoItem::Status status)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_inner->getTodosByStatus(status);
+}
+
+QList<TodoItemPtr> SynchronizedStorage::getTopTodosByPriority(int count)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_inner->getTopTodosByPriority(count);
+}
+
+QList<QString> SynchronizedStorage::getCalendarIds()
+{
+    QMutexLocker locker(&m_mutex);
+    return m_inner->getCalendarIds();
+}
+
+QString SynchronizedStorage::getCalendarName(const QString &id)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_inner->getCalendarName(id);
+}
+
+bool SynchronizedStorage::createCalendar(const QString &id, const QString &name)
+{
+    QMutexLocker locker(&m_mutex);
+    const bool result = m_inner->createCalendar(id, name);
+    locker.unlock();
+    afterWrite();
+    return result;
+}
+
+bool SynchronizedStorage::deleteCalendar(const QString &id)
+{
+    QMutexLocker locker(&m_mutex);
+    const bool result = m_inner->deleteCalendar(id);
+    locker.unlock();
+    afterWrite();
+    return result;
+}
+
+QString SynchronizedStorage::getCalendarColor(const QString &id)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_inner->getCalendarColor(id);
+}
+
+void SynchronizedStorage::setCalendarColor(const QString &id, const QString &color)
+{
+    QMutexLocker locker(&m_mutex);
+    m_inner->setCalendarColor(id, color);
+    locker.unlock();
+    afterWrite();
+}
+
+bool SynchronizedStorage::getCalendarVisibility(const QString &id)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_inner->getCalendarVisibility(id);
+}
+
+void SynchronizedStorage::setCalendarVisibility(const QString &id, bool visible)
+{
+    QMutexLocker locker(&m_mutex);
+    m_inner->setCalendarVisibility(id, visible);
+    locker.unlock();
+    afterWrite();
+}
+
+bool SynchronizedStorage::sync()
+{
+    // 先在锁外写完待写入的内容，sync() 本身就不必在锁内写盘
+    afterWrite();
+    QMutexLocker locker(&m_mutex);
+    return m_inner->sync();
+}
+
+bool SynchronizedStorage::isOnline() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_inner->isOnline();
+}
+
+QString SynchronizedStorage::getLastSyncTime(const QString &collectionId)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_inner->getLastSyncTime(collectionId);
+}
+
+} // namespace PersonalCalendar::Core
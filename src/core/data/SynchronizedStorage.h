@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include "ICalendarStorage.h"
+#include <QMutex>
+#include <functional>
+
+namespace PersonalCalendar::Core
+{
+
+/**
+ * @brief 加锁的存储装饰器
+ *
+ * 后端本身不是线程安全的。写操作交给 StorageExecutor 的工作线程后，
+ * 界面线程上的模型仍然会直接查询存储；两边都通过这个装饰器访问同一个后端，
+ * 每次调用在一把互斥锁内转发，读到的总是完整提交后的状态。
+ *
+ * 写盘不应占着这把锁：被包装的后端可以只在内存中修改（例如 Manual 持久化），
+ * 再由写操作钩子在锁外把修改写入文件，界面线程的查询不必等待磁盘。
+ */
+class SynchronizedStorage : public ICalendarStorage
+{
+public:
+    explicit SynchronizedStorage(ICalendarStoragePtr inner);
+
+    /**
+     * @brief 被包装的后端（不加锁，仅用于类型判断）
+     */
+    ICalendarStoragePtr inner() const { return m_inner; }
+
+    /**
+     * @brief 在锁内执行任意操作
+     *
+     * 用于直接访问 inner() 的特有接口，例如写操作钩子中序列化待写入的内容，
+     * 或者后端自己的定时器和文件监视回调。
+     */
+    template<typename Function>
+    auto locked(Function &&function)
+    {
+        QMutexLocker locker(&m_mutex);
+        return function();
+    }
+
+    /**
+     * @brief 设置写操作钩子
+     *
+     * 每个写操作（以及 sync() 之前）释放锁之后，在调用写操作的线程上执行。
+     * 钩子需要访问后端时自己用 locked() 加锁。
+     */
+    void setWriteHook(std::function<void()> hook);
+
+    bool createEvent(const CalendarEventPtr &event) override;
+    CalendarEventPtr getEvent(const QString &uid) override;
+    bool updateEvent(const CalendarEventPtr &event) override;
+    bool deleteEvent(const QString &uid) override;
+    bool applyBatch(const QList<EventMutation> &mutations) override;
+    int deleteWhere(const EventPredicate &predicate, const QStringList &calendarIds = QStringList()) override;
+
+    QList<CalendarEventPtr> getEventsByDate(const QDate &date) override;
+    QList<CalendarEventPtr> getEventsByDateRange(const QDate &start, const QDate &end) override;
+    QList<EventOccurrence> getOccurrencesByDateRange(const QDate &start, const QDate &end) override;
+    QList<CalendarEventPtr> getEventsWithCategories(const QDate &start, const QDate &end,
+                                                    const QStringList &categories) override;
+    QList<EventOccurrence> getOccurrencesWithCategories(const QDate &start, const QDate &end,
+                                                        const QStringList &categories) override;
+    QList<CalendarEventPtr> getEventsByCollection(const QString &collectionId) override;
+    SearchResults searchEvents(const SearchQuery &query) override;
+    FreeBusy getFreeBusy(const FreeBusyQuery &query) override;
+
+    bool createTodo(const TodoItemPtr &todo) override;
+    TodoItemPtr getTodo(const QString &uid) override;
+    bool updateTodo(const TodoItemPtr &todo) override;
+    bool deleteTodo(const QString &uid) override;
+    QList<TodoItemPtr> getTodos() override;
+    QList<TodoItemPtr> getOverdueTodos(const QDateTime &now) override;
+    QList<TodoItemPtr> getTodosDueBetween(const QDateTime &start, const QDateTime &end) override;
+    QList<TodoItemPtr> getTodosByStatus(TodoItem::Status status) override;
+    QList<TodoItemPtr> getTopTodosByPriority(int count) override;
+
+    QList<QString> getCalendarIds() override;
+    QString getCalendarName(const QString &id) override;
+    bool createCalendar(const QString &id, const QString &name) override;
+    bool deleteCalendar(const QString &id) override;
+    QString getCalendarColor(const QString &id) override;
+    void setCalendarColor(const QString &id, const QString &color) override;
+    bool getCalendarVisibility(const QString &id) override;
+    void setCalendarVisibility(const QString &id, bool visible) override;
+
+    bool sync() override;
+    bool isOnline() const override;
+    QString getLastSyncTime(const QString &collectionId) override;
+
+private:
+    void afterWrite();
+
+    ICalendarStoragePtr m_inner;
+    mutable QMutex m_mutex;
+    std::function<void()> m_writeHook;
+};
+
+} // namespace PersonalCalendar::Core
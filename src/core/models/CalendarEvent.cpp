@@ -12,6 +12,12 @@ bool CalendarEvent::isValid() const
     return !uid.isEmpty() && !title.isEmpty() && startDateTime.isValid();
 }
 
+void CalendarEvent::cacheTimes()
+{
+    utcStart = UtcTime::fromDateTime(startDateTime);
+    utcEnd = UtcTime::fromDateTime(endDateTime);
+}
+
 QString CalendarEvent::toICalString() const
 {
     // 基础 iCalendar 格式导出
@@ -60,7 +66,17 @@ bool CalendarEvent::hasEnded(const QDateTime &now) const
 
 bool CalendarEvent::occurredOn(const QDate &date) const
 {
-    return startDateTime.date() <= date && endDateTime.date() >= date;
+    return startDateTime.date() <= date && CalendarEvent::lastDay(startDateTime, endDateTime) >= date;
+}
+
+QDate CalendarEvent::lastDay(const QDateTime &start, const QDateTime &end)
+{
+    const QDate first = start.date();
+    if (!end.isValid()) {
+        return first;
+    }
+    const QDate last = end.time().msecsSinceStartOfDay() == 0 ? end.date().addDays(-1) : end.date();
+    return qMax(first, last);
 }
 
 bool CalendarEvent::operator==(const CalendarEvent &other) const
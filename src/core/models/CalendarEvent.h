@@ -3,11 +3,13 @@
 
 #pragma once
 
+#include "UtcTime.h"
 #include <QByteArray>
 #include <QDateTime>
 #include <QList>
 #include <QString>
 #include <memory>
+#include <optional>
 
 namespace PersonalCalendar::Core
 {
@@ -25,9 +27,14 @@ struct Attendee {
 };
 
 struct Alarm {
-    int minutesBefore = -1;
-    QString action; // DISPLAY, EMAIL, PROCEDURE, AUDIO
+    std::optional<int> minutesBefore; // 相对触发提前的分钟数，负数表示之后；为空表示没有相对触发
+    bool relatedToEnd = false;        // 相对于结束时间 (RELATED=END)
+    QDateTime triggerTime;            // 绝对触发时间 (TRIGGER;VALUE=DATE-TIME)
+    QByteArray rawTrigger;            // 无法识别的 TRIGGER（参数和值），保存时原样写回
+    QString action;                   // DISPLAY, EMAIL, PROCEDURE, AUDIO
     QString description;
+
+    bool hasTrigger() const { return minutesBefore.has_value() || triggerTime.isValid(); }
 };
 
 class Recurrence
@@ -37,10 +44,16 @@ public:
 
     Pattern pattern = Pattern::None;
     int interval = 1;
-    QDate endDate;          // 递归截止日期，为空表示无限
-    QList<int> byDayOfWeek; // 1-7 (Monday-Sunday)
+    QDate endDate;           // 递归截止日期，为空表示无限
+    int count = 0;           // 实例总数 (COUNT)，0 表示不限
+    int weekStart = 1;       // 每周第一天 (WKST)，1-7 (Monday-Sunday)
+    QList<int> byDayOfWeek;  // 1-7 (Monday-Sunday)
+    QList<int> byDayOrdinal; // 与 byDayOfWeek 一一对应的序号（"-1FR" 中的 -1），为空或 0 表示每一个
     QList<int> byDayOfMonth;
     QStringList byMonth;
+    QList<int> byYearDay;
+    QList<int> byWeekNo;
+    QList<int> bySetPos;
 
     bool isValid() const { return pattern != Pattern::None; }
 };
@@ -54,14 +67,21 @@ public:
     QString description;
     QString location;
 
-    // 日期时间
+    // 日期时间。结束时间不包含在内（与 RFC 5545 的 DTEND 相同）：
+    // 全天事件从第一天的 00:00 开始，到最后一天的次日 00:00 结束
     QDateTime startDateTime;
     QDateTime endDateTime;
     bool isAllDay = false;
 
+    // 开始/结束时间的紧凑形式，供索引、排序和递归计算使用。
+    // 由 cacheTimes() 根据上面两个字段计算；存储在加载和修改事件时调用。
+    UtcTime utcStart;
+    UtcTime utcEnd;
+
     // 递归
     Recurrence recurrence;
     QList<QDate> recurrenceExceptions;
+    QList<QDateTime> recurrenceDates; // 额外的实例 (RDATE)
 
     // 状态
     EventType type = EventType::Event;
@@ -88,6 +108,11 @@ public:
 public:
     bool isValid() const;
 
+    /**
+     * @brief 根据 startDateTime/endDateTime 重新计算 utcStart/utcEnd
+     */
+    void cacheTimes();
+
     // 序列化
     QString toICalString() const;
     static CalendarEvent fromICalString(const QString &ical);
@@ -97,6 +122,14 @@ public:
     bool hasEnded(const QDateTime &now) const;
     bool occurredOn(const QDate &date) const;
 
+    /**
+     * @brief 从 start 到 end 占用的最后一天
+     *
+     * 结束时间不包含在内（RFC 5545）：恰好在午夜结束时不占用那一天，
+     * 全天事件的 DTEND 总是如此。结果不早于开始日期；end 无效时返回开始日期。
+     */
+    static QDate lastDay(const QDateTime &start, const QDateTime &end);
+
     // 比较
     bool operator==(const CalendarEvent &other) const;
 };
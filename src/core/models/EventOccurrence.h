@@ -0,0 +1,39 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include "CalendarEvent.h"
+#include <QDateTime>
+#include <QList>
+
+namespace PersonalCalendar::Core
+{
+
+/**
+ * @brief 事件的一次具体发生
+ *
+ * 重复事件展开后的单个实例。实例不复制事件数据，
+ * 只引用主事件并记录本次发生的开始和结束时间。
+ */
+struct EventOccurrence {
+    EventOccurrence() = default;
+    EventOccurrence(CalendarEventPtr event, const QDateTime &start, const QDateTime &end)
+        : event(std::move(event))
+        , start(start)
+        , end(end)
+        , utcStart(UtcTime::fromDateTime(start))
+        , utcEnd(UtcTime::fromDateTime(end))
+    {
+    }
+
+    CalendarEventPtr event; // 主事件
+    QDateTime start;        // 本次开始时间
+    QDateTime end;          // 本次结束时间
+    UtcTime utcStart;       // start 的紧凑形式，用于排序和比较
+    UtcTime utcEnd;
+
+    bool isRecurring() const { return event && event->recurrence.isValid(); }
+};
+
+} // namespace PersonalCalendar::Core
@@ -0,0 +1,108 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include <QDateTime>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QTime>
+#include <QTimeZone>
+
+namespace PersonalCalendar::Core
+{
+
+/**
+ * @brief 忙闲查询条件
+ */
+struct FreeBusyQuery {
+    QDateTime start; // 查询窗口开始（含）
+    QDateTime end;   // 查询窗口结束（不含）
+    QStringList calendarIds; // 限定的日历，为空表示所有可见日历
+
+    // 全天事件默认不占用时间（与多数客户端的 TRANSP 默认值一致）
+    bool includeAllDay = false;
+
+    // 查询某个参与者的忙闲时填写其邮箱：该参与者已拒绝的事件不计入，
+    // 尚未答复或暂定接受的事件计为暂定忙碌
+    QString attendee;
+};
+
+/**
+ * @brief 一段忙碌时间
+ */
+struct BusyPeriod {
+    enum class Type : quint8 {
+        Busy,      // FBTYPE=BUSY
+        Tentative, // FBTYPE=BUSY-TENTATIVE
+    };
+
+    qint64 start = 0; // UTC 秒（含）
+    qint64 end = 0;   // UTC 秒（不含）
+    Type type = Type::Busy;
+
+    QDateTime startDateTime() const { return QDateTime::fromSecsSinceEpoch(start, QTimeZone::UTC); }
+    QDateTime endDateTime() const { return QDateTime::fromSecsSinceEpoch(end, QTimeZone::UTC); }
+
+    bool operator==(const BusyPeriod &other) const = default;
+};
+
+/**
+ * @brief 一个窗口内合并后的忙闲信息
+ *
+ * periods 按开始时间排序、互不重叠，相邻的同类时段已合并；
+ * 忙碌与暂定重叠的部分只记为忙碌。
+ */
+struct FreeBusy {
+    QDateTime start;
+    QDateTime end;
+    QList<BusyPeriod> periods;
+};
+
+/**
+ * @brief 每天允许安排事件的时段
+ *
+ * 按查询窗口开始时间所在的时区解释。默认值表示不限制。
+ */
+struct WorkingHours {
+    QTime dayStart;      // 无效表示从 0 点开始
+    QTime dayEnd;        // 无效表示到 24 点；不晚于 dayStart 时跨过午夜
+    QList<int> weekdays; // 1-7 (Monday-Sunday)，为空表示每天
+
+    bool isUnrestricted() const { return !dayStart.isValid() && !dayEnd.isValid() && weekdays.isEmpty(); }
+
+    /**
+     * @brief 周一至周五 9:00-17:00
+     */
+    static WorkingHours officeHours() { return WorkingHours{QTime(9, 0), QTime(17, 0), {1, 2, 3, 4, 5}}; }
+};
+
+/**
+ * @brief 空闲时段查询条件
+ */
+struct FreeSlotQuery {
+    QDateTime start;         // 搜索窗口开始（含），其时区决定工作时间和对齐
+    QDateTime end;           // 搜索窗口结束（不含）
+    QStringList calendarIds; // 限定的日历，为空表示所有可见日历
+    int durationMinutes = 30;
+    WorkingHours workingHours;
+    int maxResults = 1;
+    int alignMinutes = 0;         // 开始时间对齐到一天中的整倍数分钟，0 表示不对齐
+    bool tentativeIsFree = false; // 暂定忙碌的时间是否可以安排
+    QString attendee;             // 见 FreeBusyQuery::attendee
+};
+
+/**
+ * @brief 一段足够长的空闲时间
+ *
+ * start 已按 alignMinutes 对齐，end 是这段空闲的结束；时间使用查询窗口的时区。
+ */
+struct FreeSlot {
+    QDateTime start;
+    QDateTime end;
+
+    bool operator==(const FreeSlot &other) const = default;
+};
+
+} // namespace PersonalCalendar::Core
@@ -17,8 +17,8 @@ bool TodoItem::isOverdue(const QDateTime &now) const
         return false;
     }
 
-    // 已完成的任务不算逾期
-    if (isCompleted()) {
+    // 已完成或已取消的任务不算逾期
+    if (!isOpen()) {
         return false;
     }
 
@@ -55,6 +55,7 @@ public:
     // 递归
     Recurrence recurrence;
     QList<QDate> recurrenceExceptions;
+    QList<QDateTime> recurrenceDates;
 
     // 元数据
     QString calendarId;
@@ -74,8 +75,17 @@ public:
      */
     bool isCompleted() const { return status == Status::Completed; }
 
+    /**
+     * @brief 检查是否仍待处理（未完成且未取消）
+     * @return 待处理返回 true
+     */
+    bool isOpen() const { return status == Status::NeedsAction || status == Status::InProcess; }
+
     /**
      * @brief 检查是否逾期
+     *
+     * 只有待处理的任务会逾期，已完成或已取消的任务不算。
+     *
      * @param now 当前时间
      * @return 逾期返回 true
      */
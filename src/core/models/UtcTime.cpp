@@ -0,0 +1,109 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "UtcTime.h"
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QTimeZone>
+
+namespace PersonalCalendar::Core
+{
+
+namespace
+{
+
+// 进程内驻留的时区表，编号从 3 开始（0-2 保留）
+struct ZoneRegistry {
+    QMutex mutex;
+    QHash<QByteArray, quint16> ids;
+    QList<QTimeZone> zones;
+};
+
+ZoneRegistry &registry()
+{
+    static ZoneRegistry instance;
+    return instance;
+}
+
+constexpr quint16 kFirstInternedZone = 3;
+
+} // namespace
+
+UtcTime UtcTime::fromDateTime(const QDateTime &dateTime)
+{
+    UtcTime time;
+    if (!dateTime.isValid()) {
+        return time;
+    }
+
+    time.m_secs = dateTime.toSecsSinceEpoch();
+    time.m_localDay = qint32(dateTime.date().toJulianDay());
+    time.m_midnight = dateTime.time().msecsSinceStartOfDay() == 0;
+
+    switch (dateTime.timeSpec()) {
+        case Qt::LocalTime:
+            time.m_zone = kLocalZone;
+            break;
+        case Qt::UTC:
+            time.m_zone = kUtcZone;
+            break;
+        case Qt::OffsetFromUTC:
+        case Qt::TimeZone:
+            time.m_zone = internZone(dateTime.timeZone());
+            break;
+    }
+    return time;
+}
+
+QDateTime UtcTime::toDateTime() const
+{
+    switch (m_zone) {
+        case kInvalidZone:
+            return QDateTime();
+        case kLocalZone:
+            return QDateTime::fromSecsSinceEpoch(m_secs);
+        case kUtcZone:
+            return QDateTime::fromSecsSinceEpoch(m_secs, QTimeZone::UTC);
+        default:
+            break;
+    }
+
+    ZoneRegistry &zones = registry();
+    QTimeZone zone;
+    {
+        QMutexLocker locker(&zones.mutex);
+        zone = zones.zones.value(m_zone - kFirstInternedZone);
+    }
+    return QDateTime::fromSecsSinceEpoch(m_secs, zone);
+}
+
+quint16 UtcTime::internZone(const QTimeZone &zone)
+{
+    const QByteArray id = zone.id();
+
+    // 同一线程通常连续处理同一时区的事件，先查最近一次的结果
+    thread_local QByteArray lastId;
+    thread_local quint16 lastZone = kInvalidZone;
+    if (lastZone != kInvalidZone && id == lastId) {
+        return lastZone;
+    }
+
+    ZoneRegistry &zones = registry();
+    QMutexLocker locker(&zones.mutex);
+    auto it = zones.ids.constFind(id);
+    if (it == zones.ids.constEnd()) {
+        // 编号用尽时退回 UTC：时刻仍然正确，只是还原时不再带原时区
+        if (zones.zones.size() >= 0xFFFF - kFirstInternedZone) {
+            return kUtcZone;
+        }
+        it = zones.ids.insert(id, quint16(kFirstInternedZone + zones.zones.size()));
+        zones.zones.append(zone);
+    }
+
+    lastId = id;
+    lastZone = it.value();
+    return lastZone;
+}
+
+} // namespace PersonalCalendar::Core
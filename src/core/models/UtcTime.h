@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include <QDateTime>
+#include <QTimeZone>
+#include <QtGlobal>
+#include <compare>
+
+namespace PersonalCalendar::Core
+{
+
+/**
+ * @brief 紧凑的 UTC 时间
+ *
+ * 保存 UTC 秒数、驻留的时区编号、原时区下的儒略日和是否恰为午夜，共 16 字节。
+ * 比较只比较整数，不再经过 QDateTime 的时区换算；索引按 localDay()
+ * 分桶。需要显示或编辑时再用 toDateTime() 还原为 QDateTime。
+ */
+class UtcTime
+{
+public:
+    UtcTime() = default;
+
+    /**
+     * @brief 由 QDateTime 构造，无效的 QDateTime 得到无效值
+     */
+    static UtcTime fromDateTime(const QDateTime &dateTime);
+
+    /**
+     * @brief 还原为原时区（浮动时间、UTC 或具体时区）下的 QDateTime
+     */
+    QDateTime toDateTime() const;
+
+    bool isValid() const { return m_zone != kInvalidZone; }
+
+    qint64 secsSinceEpoch() const { return m_secs; }
+
+    /**
+     * @brief 原时区下日期的儒略日
+     */
+    qint64 localDay() const { return m_localDay; }
+
+    /**
+     * @brief 作为结束时间时占用的最后一天（儒略日）
+     *
+     * 结束时间不包含在内（RFC 5545）：恰好在原时区午夜结束时不占用那一天，
+     * 全天事件的 DTEND 总是如此。结果不早于 startDay。
+     * QDateTime 版本见 CalendarEvent::lastDay()。
+     */
+    qint64 lastDayFrom(qint64 startDay) const { return qMax(startDay, qint64(m_localDay) - (m_midnight ? 1 : 0)); }
+
+    /**
+     * @brief 驻留的时区编号，相同编号表示相同时区
+     */
+    quint16 zone() const { return m_zone; }
+
+    qint64 secsTo(const UtcTime &other) const { return other.m_secs - m_secs; }
+
+    // 同一时刻在不同时区下也相等，与 QDateTime 一致
+    friend bool operator==(const UtcTime &a, const UtcTime &b)
+    {
+        return a.isValid() == b.isValid() && (!a.isValid() || a.m_secs == b.m_secs);
+    }
+    friend std::strong_ordering operator<=>(const UtcTime &a, const UtcTime &b)
+    {
+        // 无效值排在最前
+        if (a.isValid() != b.isValid()) {
+            return a.isValid() ? std::strong_ordering::greater : std::strong_ordering::less;
+        }
+        return a.isValid() ? a.m_secs <=> b.m_secs : std::strong_ordering::equal;
+    }
+
+private:
+    static constexpr quint16 kInvalidZone = 0;
+    static constexpr quint16 kLocalZone = 1; // 浮动时间（系统时区）
+    static constexpr quint16 kUtcZone = 2;
+
+    static quint16 internZone(const QTimeZone &zone);
+
+    qint64 m_secs = 0;
+    qint32 m_localDay = 0;
+    quint16 m_zone = kInvalidZone;
+    bool m_midnight = false; // 原时区下恰为 00:00
+};
+
+} // namespace PersonalCalendar::Core
@@ -0,0 +1,309 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "AlarmScheduler.h"
+#include "../utils/RecurrenceCalculator.h"
+#include <QTimeZone>
+#include <QTimer>
+#include <algorithm>
+
+namespace PersonalCalendar::Core
+{
+
+namespace
+{
+// 定时器最长间隔。单调时钟在系统休眠期间可能停止，限制间隔可以让唤醒后
+// 错过的提醒最迟一小时内补发
+constexpr qint64 kMaxTimerMsecs = 60 * 60 * 1000;
+
+// 定时器精度为秒，到期时一并触发一秒内的提醒，避免为零头再唤醒一次
+constexpr qint64 kCoalesceSecs = 1;
+
+// 失效项超过此数量且多于有效项时压缩堆
+constexpr int kMinStaleForCompact = 64;
+
+// 堆算法默认建最大堆，反向比较得到最小堆
+constexpr auto firesLater = [](const auto &a, const auto &b) { return a.fireSecs > b.fireSecs; };
+} // namespace
+
+AlarmScheduler::AlarmScheduler(ReminderCallback onReminder)
+    : m_onReminder(std::move(onReminder)), m_clock([]() { return QDateTime::currentDateTimeUtc(); })
+{
+}
+
+AlarmScheduler::~AlarmScheduler() = default;
+
+void AlarmScheduler::setClock(Clock clock)
+{
+    m_clock = std::move(clock);
+    m_armedFor = -1;
+    arm();
+}
+
+void AlarmScheduler::rebuild(ICalendarStorage &storage)
+{
+    QList<CalendarEventPtr> events;
+    const auto ids = storage.getCalendarIds();
+    for (const auto &id : ids) {
+        events.append(storage.getEventsByCollection(id));
+    }
+    setEvents(events);
+}
+
+void AlarmScheduler::setEvents(const QList<CalendarEventPtr> &events)
+{
+    m_sources.clear();
+    m_heap.clear();
+    m_live = 0;
+    m_stale = 0;
+
+    const qint64 from = m_clock().toSecsSinceEpoch();
+    for (const auto &event : events) {
+        addSource(event, from);
+    }
+    arm();
+}
+
+void AlarmScheduler::updateEvent(const CalendarEventPtr &event)
+{
+    if (!event) {
+        return;
+    }
+
+    dropSource(event->uid);
+    addSource(event, m_clock().toSecsSinceEpoch());
+    compact();
+    arm();
+}
+
+void AlarmScheduler::removeEvent(const QString &uid)
+{
+    dropSource(uid);
+    compact();
+    arm();
+}
+
+void AlarmScheduler::clear()
+{
+    setEvents({});
+}
+
+void AlarmScheduler::start()
+{
+    if (!m_timer) {
+        m_timer = std::make_unique<QTimer>();
+        m_timer->setSingleShot(true);
+        m_timer->setTimerType(Qt::VeryCoarseTimer);
+        QObject::connect(m_timer.get(), &QTimer::timeout, [this]() { fireDue(m_clock().addSecs(kCoalesceSecs)); });
+    }
+    m_running = true;
+    m_armedFor = -1;
+    arm();
+}
+
+void AlarmScheduler::stop()
+{
+    m_running = false;
+    m_armedFor = -1;
+    if (m_timer) {
+        m_timer->stop();
+    }
+}
+
+int AlarmScheduler::fireDue(const QDateTime &now)
+{
+    const qint64 nowSecs = now.toSecsSinceEpoch();
+    int fired = 0;
+
+    while (!m_heap.empty() && m_heap.front().fireSecs <= nowSecs) {
+        std::pop_heap(m_heap.begin(), m_heap.end(), firesLater);
+        const HeapEntry entry = std::move(m_heap.back());
+        m_heap.pop_back();
+
+        if (!isLive(entry)) {
+            --m_stale;
+            continue;
+        }
+        --m_live;
+
+        Source &source = m_sources[entry.uid];
+        AlarmCursor &cursor = source.cursors[entry.cursor];
+        cursor.pending = false;
+
+        Reminder reminder;
+        reminder.event = source.event;
+        reminder.alarm = source.event->alarms.at(cursor.alarmIndex);
+        reminder.occurrenceStart = entry.occurrence;
+        reminder.fireTime = QDateTime::fromSecsSinceEpoch(entry.fireSecs, QTimeZone::UTC);
+
+        // 先排好下一次，回调中修改调度器也不会影响本次循环
+        scheduleNext(entry.uid, source, entry.cursor, entry.fireSecs + 1);
+        ++fired;
+
+        if (m_onReminder) {
+            m_onReminder(reminder);
+        }
+    }
+
+    compact();
+    arm();
+    return fired;
+}
+
+QDateTime AlarmScheduler::nextDeadline()
+{
+    discardStaleTop();
+    return m_heap.empty() ? QDateTime() : QDateTime::fromSecsSinceEpoch(m_heap.front().fireSecs, QTimeZone::UTC);
+}
+
+void AlarmScheduler::addSource(const CalendarEventPtr &event, qint64 from)
+{
+    if (!event || event->uid.isEmpty() || event->status == EventStatus::Cancelled ||
+        !event->startDateTime.isValid()) {
+        return;
+    }
+
+    const bool isSeries = event->recurrence.isValid() || !event->recurrenceDates.isEmpty();
+
+    Source source;
+    source.event = event;
+    source.generation = m_nextGeneration++;
+    for (int i = 0; i < event->alarms.size(); ++i) {
+        const Alarm &alarm = event->alarms.at(i);
+        if (!alarm.hasTrigger()) {
+            continue;
+        }
+        AlarmCursor cursor;
+        cursor.alarmIndex = i;
+        if (!alarm.minutesBefore) {
+            cursor.absoluteSecs = alarm.triggerTime.toSecsSinceEpoch();
+        } else {
+            cursor.offsetSecs = -qint64(*alarm.minutesBefore) * 60;
+            if (alarm.relatedToEnd) {
+                cursor.offsetSecs += RecurrenceCalculator::durationSeconds(*event);
+            }
+        }
+        if (isSeries && cursor.absoluteSecs < 0) {
+            cursor.instances.emplace(*event);
+            // 直接跳到第一个可能在 from 之后触发的实例，前一天起留出时区余量
+            const QDate first =
+                QDateTime::fromSecsSinceEpoch(from - cursor.offsetSecs, event->startDateTime.timeZone()).date();
+            cursor.instances->skipTo(first.addDays(-1));
+        }
+        source.cursors.push_back(std::move(cursor));
+    }
+
+    if (source.cursors.empty()) {
+        return;
+    }
+
+    const QString uid = event->uid;
+    Source &stored = m_sources[uid] = std::move(source);
+    for (int i = 0; i < int(stored.cursors.size()); ++i) {
+        scheduleNext(uid, stored, i, from);
+    }
+}
+
+void AlarmScheduler::dropSource(const QString &uid)
+{
+    auto it = m_sources.find(uid);
+    if (it == m_sources.end()) {
+        return;
+    }
+
+    for (const auto &cursor : it.value().cursors) {
+        if (cursor.pending) {
+            --m_live;
+            ++m_stale;
+        }
+    }
+    m_sources.erase(it);
+}
+
+void AlarmScheduler::scheduleNext(const QString &uid, Source &source, int cursorIndex, qint64 from)
+{
+    AlarmCursor &cursor = source.cursors[cursorIndex];
+
+    if (!cursor.instances) {
+        // 非重复事件和绝对触发只有一次，from 越过后即结束
+        const QDateTime start = source.event->startDateTime;
+        const qint64 fireSecs =
+            cursor.absoluteSecs >= 0 ? cursor.absoluteSecs : start.toSecsSinceEpoch() + cursor.offsetSecs;
+        if (fireSecs >= from) {
+            cursor.pending = true;
+            push({fireSecs, start, uid, source.generation, cursorIndex});
+        }
+        return;
+    }
+
+    for (;;) {
+        const QDateTime start = cursor.instances->next();
+        if (!start.isValid()) {
+            return;
+        }
+        const qint64 fireSecs = start.toSecsSinceEpoch() + cursor.offsetSecs;
+        if (fireSecs >= from) {
+            cursor.pending = true;
+            push({fireSecs, start, uid, source.generation, cursorIndex});
+            return;
+        }
+    }
+}
+
+void AlarmScheduler::push(HeapEntry entry)
+{
+    m_heap.push_back(std::move(entry));
+    std::push_heap(m_heap.begin(), m_heap.end(), firesLater);
+    ++m_live;
+}
+
+bool AlarmScheduler::isLive(const HeapEntry &entry) const
+{
+    auto it = m_sources.constFind(entry.uid);
+    return it != m_sources.constEnd() && it.value().generation == entry.generation;
+}
+
+void AlarmScheduler::discardStaleTop()
+{
+    while (!m_heap.empty() && !isLive(m_heap.front())) {
+        std::pop_heap(m_heap.begin(), m_heap.end(), firesLater);
+        m_heap.pop_back();
+        --m_stale;
+    }
+}
+
+void AlarmScheduler::compact()
+{
+    if (m_stale < kMinStaleForCompact || m_stale <= m_live) {
+        return;
+    }
+
+    std::erase_if(m_heap, [this](const HeapEntry &entry) { return !isLive(entry); });
+    std::make_heap(m_heap.begin(), m_heap.end(), firesLater);
+    m_stale = 0;
+}
+
+void AlarmScheduler::arm()
+{
+    if (!m_running || !m_timer) {
+        return;
+    }
+
+    discardStaleTop();
+    if (m_heap.empty()) {
+        m_timer->stop();
+        m_armedFor = -1;
+        return;
+    }
+
+    const qint64 deadline = m_heap.front().fireSecs;
+    if (deadline == m_armedFor && m_timer->isActive()) {
+        return;
+    }
+
+    const qint64 delay = deadline * 1000 - m_clock().toMSecsSinceEpoch();
+    m_timer->start(int(std::clamp<qint64>(delay, 0, kMaxTimerMsecs)));
+    m_armedFor = deadline;
+}
+
+} // namespace PersonalCalendar::Core
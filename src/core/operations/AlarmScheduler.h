@@ -0,0 +1,166 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include "../data/ICalendarStorage.h"
+#include "../models/CalendarEvent.h"
+#include "../utils/RecurrenceIterator.h"
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+class QTimer;
+
+namespace PersonalCalendar::Core
+{
+
+/**
+ * @brief 提醒调度器
+ *
+ * 为所有日历中事件的提醒维护一个按触发时间排序的最小堆，只用一个 QTimer
+ * 等待最早的触发时间，不轮询。
+ *
+ * 提醒可以相对开始或结束时间（RELATED=END），偏移为负时在之后触发；
+ * 绝对时间的提醒（TRIGGER;VALUE=DATE-TIME）只触发一次，不随实例重复。
+ *
+ * 每个事件的每条提醒在堆中只占一项：它的下一次触发时间。重复事件的实例
+ * 由 RecurrenceIterator 惰性展开，一次提醒触发后才计算下一次。事件修改或删除
+ * 时只替换该事件的项，旧项通过代数标记失效，堆中失效项过多时再整体压缩。
+ *
+ * 调用 start() 之前不会启动定时器，可以用 fireDue() 手动驱动（测试用）。
+ */
+class AlarmScheduler
+{
+public:
+    /**
+     * @brief 一次到期的提醒
+     */
+    struct Reminder {
+        CalendarEventPtr event;
+        Alarm alarm;
+        QDateTime occurrenceStart; // 提醒对应的实例开始时间
+        QDateTime fireTime;        // 计划触发时间
+    };
+
+    using ReminderCallback = std::function<void(const Reminder &reminder)>;
+    using Clock = std::function<QDateTime()>;
+
+    /**
+     * @brief 构造函数
+     * @param onReminder 提醒到期时的回调
+     */
+    explicit AlarmScheduler(ReminderCallback onReminder);
+    ~AlarmScheduler();
+
+    AlarmScheduler(const AlarmScheduler &) = delete;
+    AlarmScheduler &operator=(const AlarmScheduler &) = delete;
+
+    /**
+     * @brief 设置时钟（默认为当前 UTC 时间）
+     */
+    void setClock(Clock clock);
+
+    // ===== 事件来源 =====
+
+    /**
+     * @brief 从存储的所有日历重新加载提醒
+     */
+    void rebuild(ICalendarStorage &storage);
+
+    /**
+     * @brief 用给定事件替换全部提醒
+     */
+    void setEvents(const QList<CalendarEventPtr> &events);
+
+    /**
+     * @brief 添加或替换一个事件的提醒
+     *
+     * 只计算当前时间之后的触发时间，已经触发过的提醒不会重复触发。
+     */
+    void updateEvent(const CalendarEventPtr &event);
+
+    /**
+     * @brief 移除一个事件的提醒
+     */
+    void removeEvent(const QString &uid);
+
+    void clear();
+
+    // ===== 调度 =====
+
+    /**
+     * @brief 启动定时器，需要运行中的事件循环
+     */
+    void start();
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    /**
+     * @brief 触发所有不晚于 now 的提醒
+     * @return 触发的提醒数量
+     */
+    int fireDue(const QDateTime &now);
+
+    /**
+     * @brief 最早的待触发时间，没有提醒时返回无效值
+     */
+    QDateTime nextDeadline();
+
+    /**
+     * @brief 待触发的提醒数量（每个事件的每条提醒计一次）
+     */
+    int pendingCount() const { return m_live; }
+
+private:
+    // 事件的一条提醒及其展开位置
+    struct AlarmCursor {
+        int alarmIndex = 0;
+        qint64 offsetSecs = 0;                       // 触发时间 = 实例开始 + offsetSecs
+        qint64 absoluteSecs = -1;                    // 绝对触发时间，-1 表示相对触发
+        std::optional<RecurrenceIterator> instances; // 非重复事件和绝对触发为空
+        bool pending = false;                        // 堆中是否有有效项
+    };
+
+    struct Source {
+        CalendarEventPtr event;
+        quint32 generation = 0;
+        std::vector<AlarmCursor> cursors;
+    };
+
+    struct HeapEntry {
+        qint64 fireSecs = 0;
+        QDateTime occurrence;
+        QString uid;
+        quint32 generation = 0;
+        int cursor = 0;
+    };
+
+    void addSource(const CalendarEventPtr &event, qint64 from);
+    void dropSource(const QString &uid);
+    void scheduleNext(const QString &uid, Source &source, int cursorIndex, qint64 from);
+    void push(HeapEntry entry);
+    bool isLive(const HeapEntry &entry) const;
+    void discardStaleTop();
+    void compact();
+    void arm();
+
+    ReminderCallback m_onReminder;
+    Clock m_clock;
+
+    QHash<QString, Source> m_sources;
+    std::vector<HeapEntry> m_heap; // 按 fireSecs 的最小堆
+    int m_live = 0;
+    int m_stale = 0;
+    quint32 m_nextGeneration = 1;
+
+    std::unique_ptr<QTimer> m_timer;
+    bool m_running = false;
+    qint64 m_armedFor = -1;
+};
+
+} // namespace PersonalCalendar::Core
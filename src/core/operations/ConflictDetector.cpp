@@ -0,0 +1,176 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "ConflictDetector.h"
+#include "../utils/FreeBusyCalculator.h"
+#include "../utils/RecurrenceCalculator.h"
+#include <algorithm>
+#include <vector>
+
+namespace PersonalCalendar::Core
+{
+
+namespace
+{
+
+// 只有占用时间、且长度不为零的实例参与检测
+bool blocksTime(const EventOccurrence &occurrence)
+{
+    return occurrence.event && occurrence.utcEnd.isValid() && occurrence.utcStart < occurrence.utcEnd
+        && FreeBusyCalculator::busyType(*occurrence.event, FreeBusyQuery());
+}
+
+bool overlapStartsBefore(const EventConflict &a, const EventConflict &b)
+{
+    if (a.second.utcStart != b.second.utcStart) {
+        return a.second.utcStart < b.second.utcStart;
+    }
+    if (a.first.utcStart != b.first.utcStart) {
+        return a.first.utcStart < b.first.utcStart;
+    }
+    return a.first.event->uid < b.first.event->uid;
+}
+
+} // namespace
+
+QList<EventConflict> ConflictDetector::findConflicts(QList<EventOccurrence> occurrences)
+{
+    occurrences.removeIf([](const EventOccurrence &occurrence) { return !blocksTime(occurrence); });
+    std::sort(occurrences.begin(), occurrences.end(),
+              [](const EventOccurrence &a, const EventOccurrence &b) { return a.utcStart < b.utcStart; });
+
+    const QList<EventOccurrence> &sorted = occurrences;
+    QList<EventConflict> conflicts;
+
+    // 进行中的实例，按结束时间的最小堆：先结束的先出堆
+    std::vector<qsizetype> active;
+    const auto endsLater = [&sorted](qsizetype a, qsizetype b) { return sorted[b].utcEnd < sorted[a].utcEnd; };
+
+    for (qsizetype i = 0; i < sorted.size(); ++i) {
+        const EventOccurrence &current = sorted[i];
+        while (!active.empty() && sorted[active.front()].utcEnd <= current.utcStart) {
+            std::pop_heap(active.begin(), active.end(), endsLater);
+            active.pop_back();
+        }
+
+        // 堆中剩下的都与当前实例重叠
+        for (const qsizetype other : active) {
+            const EventOccurrence &earlier = sorted[other];
+            if (earlier.event->uid == current.event->uid) {
+                continue;
+            }
+            const QDateTime overlapEnd = earlier.utcEnd < current.utcEnd ? earlier.end : current.end;
+            conflicts.append(EventConflict{earlier, current, overlapEnd});
+        }
+
+        active.push_back(i);
+        std::push_heap(active.begin(), active.end(), endsLater);
+    }
+
+    std::sort(conflicts.begin(), conflicts.end(), overlapStartsBefore);
+    return conflicts;
+}
+
+void ConflictDetector::scan(ICalendarStorage &storage, const QDate &start, const QDate &end)
+{
+    m_start = start;
+    m_end = end;
+    m_conflicts.clear();
+    if (start.isValid() && end.isValid() && start <= end) {
+        m_conflicts = findConflicts(storage.getOccurrencesByDateRange(start, end));
+    }
+    rebuildLookup();
+}
+
+void ConflictDetector::eventChanged(ICalendarStorage &storage, const CalendarEventPtr &event)
+{
+    if (!event || !m_start.isValid() || !m_end.isValid()) {
+        return;
+    }
+
+    const QString uid = event->uid;
+    m_conflicts.removeIf([&uid](const EventConflict &conflict) {
+        return conflict.first.event->uid == uid || conflict.second.event->uid == uid;
+    });
+
+    // 修改后的实例覆盖的日期，前后各多一天（实例按所在时区的日期归档）；相邻的范围合并
+    const qint64 first = m_start.toJulianDay();
+    const qint64 last = m_end.toJulianDay();
+    std::vector<std::pair<qint64, qint64>> ranges;
+    const auto own = RecurrenceCalculator::calculateOccurrences(event, m_start, m_end);
+    for (const auto &occurrence : own) {
+        if (!blocksTime(occurrence)) {
+            continue;
+        }
+        const qint64 from = std::max(first, occurrence.utcStart.localDay() - 1);
+        const qint64 to = std::min(last, occurrence.utcEnd.localDay() + 1);
+        if (!ranges.empty() && from <= ranges.back().second + 1) {
+            ranges.back().second = std::max(ranges.back().second, to);
+        } else {
+            ranges.emplace_back(from, to);
+        }
+    }
+
+    QList<EventOccurrence> nearby;
+    for (const auto &[from, to] : ranges) {
+        nearby.append(storage.getOccurrencesByDateRange(QDate::fromJulianDay(from), QDate::fromJulianDay(to)));
+    }
+
+    // 跨过两个范围的实例会被取到两次
+    std::sort(nearby.begin(), nearby.end(), [](const EventOccurrence &a, const EventOccurrence &b) {
+        return a.utcStart != b.utcStart ? a.utcStart < b.utcStart : a.event < b.event;
+    });
+    nearby.erase(std::unique(nearby.begin(), nearby.end(),
+                             [](const EventOccurrence &a, const EventOccurrence &b) {
+                                 return a.event == b.event && a.utcStart == b.utcStart;
+                             }),
+                 nearby.end());
+
+    QList<EventConflict> found = findConflicts(std::move(nearby));
+    found.removeIf([&uid](const EventConflict &conflict) {
+        return conflict.first.event->uid != uid && conflict.second.event->uid != uid;
+    });
+    addConflicts(found);
+}
+
+void ConflictDetector::eventRemoved(const QString &uid)
+{
+    const qsizetype removed = m_conflicts.removeIf([&uid](const EventConflict &conflict) {
+        return conflict.first.event->uid == uid || conflict.second.event->uid == uid;
+    });
+    if (removed > 0) {
+        rebuildLookup();
+    }
+}
+
+bool ConflictDetector::hasConflict(const QString &uid, const QDateTime &occurrenceStart) const
+{
+    auto it = m_conflicting.constFind(uid);
+    return it != m_conflicting.constEnd() && it.value().contains(occurrenceStart.toSecsSinceEpoch());
+}
+
+int ConflictDetector::conflictsOn(const QDate &date) const
+{
+    const qint64 day = date.toJulianDay();
+    return int(std::count_if(m_conflicts.cbegin(), m_conflicts.cend(), [day](const EventConflict &conflict) {
+        return conflict.second.utcStart.localDay() == day;
+    }));
+}
+
+void ConflictDetector::addConflicts(const QList<EventConflict> &conflicts)
+{
+    m_conflicts.append(conflicts);
+    std::sort(m_conflicts.begin(), m_conflicts.end(), overlapStartsBefore);
+    rebuildLookup();
+}
+
+void ConflictDetector::rebuildLookup()
+{
+    m_conflicting.clear();
+    for (const auto &conflict : std::as_const(m_conflicts)) {
+        m_conflicting[conflict.first.event->uid].insert(conflict.first.utcStart.secsSinceEpoch());
+        m_conflicting[conflict.second.event->uid].insert(conflict.second.utcStart.secsSinceEpoch());
+    }
+}
+
+} // namespace PersonalCalendar::Core
@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include "../data/ICalendarStorage.h"
+#include "../models/EventOccurrence.h"
+#include <QDate>
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+
+namespace PersonalCalendar::Core
+{
+
+/**
+ * @brief 两个时间重叠的事件实例
+ */
+struct EventConflict {
+    EventOccurrence first;  // 开始较早的一方
+    EventOccurrence second; // 开始较晚的一方，重叠从它的开始时间算起
+    QDateTime overlapEnd;   // 重叠结束时间（两者结束时间中较早的一个）
+
+    QDateTime overlapStart() const { return second.start; }
+};
+
+/**
+ * @brief 重复预订检测
+ *
+ * 把范围内所有日历的实例按开始时间排序一次，再用扫描线维护"仍在进行中"的
+ * 实例集合（按结束时间的最小堆）：每个新实例只与集合中的实例比较，代价为
+ * O(n log n + 冲突数)，而不是两两比较的 O(n²)。
+ *
+ * 与忙闲计算一致，已取消和全天事件不参与检测，暂定事件参与；
+ * 同一事件的不同实例之间不算冲突。
+ *
+ * scan() 计算整个范围；之后某个事件被修改时，eventChanged() 只重新检查该事件
+ * 实例所在的几天，其余冲突保持不变。
+ */
+class ConflictDetector
+{
+public:
+    /**
+     * @brief 找出实例之间的全部重叠
+     * @param occurrences 任意顺序的实例
+     * @return 按重叠开始时间排序的冲突
+     */
+    static QList<EventConflict> findConflicts(QList<EventOccurrence> occurrences);
+
+    /**
+     * @brief 计算范围内所有可见日历的冲突
+     * @param storage 存储（DirectoryBackend 会合并所有可见日历）
+     * @param start 开始日期
+     * @param end 结束日期
+     */
+    void scan(ICalendarStorage &storage, const QDate &start, const QDate &end);
+
+    /**
+     * @brief 事件被创建或修改后，只重新检查它附近的冲突
+     *
+     * 存储中必须已经是修改后的事件。
+     */
+    void eventChanged(ICalendarStorage &storage, const CalendarEventPtr &event);
+
+    /**
+     * @brief 事件被删除后移除它的冲突
+     */
+    void eventRemoved(const QString &uid);
+
+    /**
+     * @brief 当前范围内的冲突，按重叠开始时间排序
+     */
+    const QList<EventConflict> &conflicts() const { return m_conflicts; }
+
+    /**
+     * @brief 检查某个实例是否与其他事件冲突
+     * @param uid 事件 UID
+     * @param occurrenceStart 实例开始时间
+     */
+    bool hasConflict(const QString &uid, const QDateTime &occurrenceStart) const;
+
+    /**
+     * @brief 重叠开始于某天的冲突数量（按开始时间所在时区的日期）
+     */
+    int conflictsOn(const QDate &date) const;
+
+private:
+    void addConflicts(const QList<EventConflict> &conflicts);
+    void rebuildLookup();
+
+    QDate m_start;
+    QDate m_end;
+    QList<EventConflict> m_conflicts;
+    QHash<QString, QSet<qint64>> m_conflicting; // UID -> 冲突实例的开始时间（UTC 秒）
+};
+
+} // namespace PersonalCalendar::Core
@@ -3,33 +3,86 @@
 
 #include "EventOperations.h"
 #include <QDebug>
+#include <QObject>
 #include <QUuid>
 
 namespace PersonalCalendar::Core
 {
 
-EventOperations::EventOperations(ICalendarStoragePtr storage) : m_storage(storage)
+namespace
+{
+
+template<typename T>
+OperationResult<T> failure(const QString &error)
+{
+    qWarning() << QLatin1String("EventOperations error:") << error;
+    return OperationResult<T>{T{}, error};
+}
+
+// 校验失败时不经过工作线程
+template<typename T>
+QFuture<OperationResult<T>> rejected(const QString &error)
+{
+    return QtFuture::makeReadyValueFuture(failure<T>(error));
+}
+
+} // namespace
+
+EventOperations::EventOperations(ICalendarStoragePtr storage, std::shared_ptr<StorageExecutor> executor)
+    : m_storage(storage), m_executor(std::move(executor)), m_context(std::make_unique<QObject>())
 {
     if (!m_storage) {
         qWarning() << QLatin1String("EventOperations: storage is nullptr!");
     }
 }
 
-void EventOperations::createEvent(const CalendarEventPtr &event, SuccessCallback onSuccess, ErrorCallback onError)
+// 销毁上下文对象会取消尚未投递的回调；已提交的存储调用仍会执行
+EventOperations::~EventOperations() = default;
+
+template<typename T>
+QFuture<OperationResult<T>> EventOperations::submit(std::function<OperationResult<T>()> task)
 {
-    if (!event) {
-        handleError(QLatin1String("Event is nullptr"), onError);
+    if (!m_executor) {
+        return QtFuture::makeReadyValueFuture(task());
+    }
+    return m_executor->run(std::move(task));
+}
+
+template<typename T, typename Callback>
+void EventOperations::deliver(QFuture<OperationResult<T>> future, Callback onSuccess, ErrorCallback onError)
+{
+    auto handle = [onSuccess = std::move(onSuccess), onError = std::move(onError)](const OperationResult<T> &result) {
+        if (!result.ok()) {
+            if (onError) {
+                onError(result.error);
+            }
+            return;
+        }
+        if (onSuccess) {
+            onSuccess(result.value);
+        }
+    };
+
+    // 同步执行时结果已经就绪，保持原来的调用时机
+    if (!m_executor) {
+        handle(future.result());
         return;
     }
+    future.then(m_context.get(), std::move(handle));
+}
+
+QFuture<OperationResult<CalendarEventPtr>> EventOperations::createEventAsync(const CalendarEventPtr &event)
+{
+    if (!event) {
+        return rejected<CalendarEventPtr>(QLatin1String("Event is nullptr"));
+    }
 
     if (!event->isValid()) {
-        handleError(QLatin1String("Event is not valid"), onError);
-        return;
+        return rejected<CalendarEventPtr>(QLatin1String("Event is not valid"));
     }
 
     if (!m_storage) {
-        handleError(QLatin1String("Storage not initialized"), onError);
-        return;
+        return rejected<CalendarEventPtr>(QLatin1String("Storage not initialized"));
     }
 
     // 生成 UID（如果没有）
@@ -42,146 +95,258 @@ void EventOperations::createEvent(const CalendarEventPtr &event, SuccessCallback
     event->lastModified = QDateTime::currentDateTime();
 
     // 调用存储实现
-    bool success = m_storage->createEvent(event);
-    if (success) {
-        if (onSuccess) {
-            onSuccess(event);
+    return submit<CalendarEventPtr>([storage = m_storage, event]() {
+        if (!storage->createEvent(event)) {
+            return failure<CalendarEventPtr>(QLatin1String("Failed to create event in storage"));
         }
-    } else {
-        handleError(QLatin1String("Failed to create event in storage"), onError);
-    }
+        return OperationResult<CalendarEventPtr>{event};
+    });
 }
 
-void EventOperations::updateEvent(const CalendarEventPtr &event, SuccessCallback onSuccess, ErrorCallback onError)
+QFuture<OperationResult<CalendarEventPtr>> EventOperations::updateEventAsync(const CalendarEventPtr &event)
 {
     if (!event) {
-        handleError(QLatin1String("Event is nullptr"), onError);
-        return;
+        return rejected<CalendarEventPtr>(QLatin1String("Event is nullptr"));
     }
 
     if (!event->isValid()) {
-        handleError(QLatin1String("Event is not valid"), onError);
-        return;
+        return rejected<CalendarEventPtr>(QLatin1String("Event is not valid"));
     }
 
     if (!m_storage) {
-        handleError(QLatin1String("Storage not initialized"), onError);
-        return;
+        return rejected<CalendarEventPtr>(QLatin1String("Storage not initialized"));
     }
 
     // 更新修改时间
     event->lastModified = QDateTime::currentDateTime();
 
     // 调用存储实现
-    bool success = m_storage->updateEvent(event);
-    if (success) {
-        if (onSuccess) {
-            onSuccess(event);
+    return submit<CalendarEventPtr>([storage = m_storage, event]() {
+        if (!storage->updateEvent(event)) {
+            return failure<CalendarEventPtr>(QLatin1String("Failed to update event in storage"));
         }
-    } else {
-        handleError(QLatin1String("Failed to update event in storage"), onError);
-    }
+        return OperationResult<CalendarEventPtr>{event};
+    });
 }
 
-void EventOperations::deleteEvent(const QString &uid, SuccessCallback onSuccess, ErrorCallback onError)
+QFuture<OperationResult<CalendarEventPtr>> EventOperations::deleteEventAsync(const QString &uid)
 {
     if (uid.isEmpty()) {
-        handleError(QLatin1String("Event UID is empty"), onError);
-        return;
+        return rejected<CalendarEventPtr>(QLatin1String("Event UID is empty"));
     }
 
     if (!m_storage) {
-        handleError(QLatin1String("Storage not initialized"), onError);
-        return;
+        return rejected<CalendarEventPtr>(QLatin1String("Storage not initialized"));
     }
 
-    // 获取事件（用于回调）
-    auto event = m_storage->getEvent(uid);
+    return submit<CalendarEventPtr>([storage = m_storage, uid]() {
+        // 获取事件（用于回调）
+        auto event = storage->getEvent(uid);
 
-    // 调用存储实现
-    bool success = m_storage->deleteEvent(uid);
-    if (success) {
-        if (onSuccess && event) {
-            onSuccess(event);
+        // 调用存储实现
+        if (!storage->deleteEvent(uid)) {
+            return failure<CalendarEventPtr>(QLatin1String("Failed to delete event from storage"));
         }
-    } else {
-        handleError(QLatin1String("Failed to delete event from storage"), onError);
-    }
+        return OperationResult<CalendarEventPtr>{event};
+    });
 }
 
-void EventOperations::getEvent(const QString &uid, SuccessCallback onSuccess, ErrorCallback onError)
+QFuture<OperationResult<CalendarEventPtr>> EventOperations::getEventAsync(const QString &uid)
 {
     if (uid.isEmpty()) {
-        handleError(QLatin1String("Event UID is empty"), onError);
-        return;
+        return rejected<CalendarEventPtr>(QLatin1String("Event UID is empty"));
     }
 
     if (!m_storage) {
-        handleError(QLatin1String("Storage not initialized"), onError);
-        return;
+        return rejected<CalendarEventPtr>(QLatin1String("Storage not initialized"));
     }
 
     // 调用存储实现
-    auto event = m_storage->getEvent(uid);
-    if (event) {
-        if (onSuccess) {
-            onSuccess(event);
+    return submit<CalendarEventPtr>([storage = m_storage, uid]() {
+        auto event = storage->getEvent(uid);
+        if (!event) {
+            return failure<CalendarEventPtr>(QLatin1String("Event not found"));
+        }
+        return OperationResult<CalendarEventPtr>{event};
+    });
+}
+
+QFuture<OperationResult<int>> EventOperations::applyBatchAsync(const QList<EventMutation> &mutations)
+{
+    if (!m_storage) {
+        return rejected<int>(QLatin1String("Storage not initialized"));
+    }
+
+    // 先校验整批，避免部分变更被修改了时间戳
+    for (const auto &mutation : mutations) {
+        if (mutation.type == EventMutation::Type::Delete) {
+            if (mutation.targetUid().isEmpty()) {
+                return rejected<int>(QLatin1String("Event UID is empty"));
+            }
+        } else if (!mutation.event || !mutation.event->isValid()) {
+            return rejected<int>(QLatin1String("Event is not valid"));
+        }
+    }
+
+    const QDateTime now = QDateTime::currentDateTime();
+    for (const auto &mutation : mutations) {
+        if (mutation.type == EventMutation::Type::Create) {
+            if (mutation.event->uid.isEmpty()) {
+                mutation.event->uid = QUuid::createUuid().toString();
+            }
+            mutation.event->created = now;
+            mutation.event->lastModified = now;
+        } else if (mutation.type == EventMutation::Type::Update) {
+            mutation.event->lastModified = now;
         }
-    } else {
-        handleError(QLatin1String("Event not found"), onError);
     }
+
+    // 调用存储实现
+    return submit<int>([storage = m_storage, mutations]() {
+        if (!storage->applyBatch(mutations)) {
+            return failure<int>(QLatin1String("Failed to apply batch in storage"));
+        }
+        return OperationResult<int>{static_cast<int>(mutations.size())};
+    });
 }
 
-void EventOperations::getEventsForDate(const QDate &date, EventListCallback onSuccess, ErrorCallback onError)
+QFuture<OperationResult<int>> EventOperations::purgeBeforeAsync(const QDate &date, const QStringList &calendarIds)
 {
     if (!date.isValid()) {
-        handleError(QLatin1String("Date is not valid"), onError);
-        return;
+        return rejected<int>(QLatin1String("Date is not valid"));
     }
 
     if (!m_storage) {
-        handleError(QLatin1String("Storage not initialized"), onError);
-        return;
+        return rejected<int>(QLatin1String("Storage not initialized"));
     }
 
     // 调用存储实现
-    auto events = m_storage->getEventsByDate(date);
-    if (onSuccess) {
-        onSuccess(events);
+    return submit<int>([storage = m_storage, date, calendarIds]() {
+        const int removed = storage->purgeBefore(date, calendarIds);
+        if (removed < 0) {
+            return failure<int>(QLatin1String("Failed to purge events from storage"));
+        }
+        return OperationResult<int>{removed};
+    });
+}
+
+QFuture<OperationResult<QList<CalendarEventPtr>>> EventOperations::getEventsForDateAsync(const QDate &date)
+{
+    using Events = QList<CalendarEventPtr>;
+
+    if (!date.isValid()) {
+        return rejected<Events>(QLatin1String("Date is not valid"));
+    }
+
+    if (!m_storage) {
+        return rejected<Events>(QLatin1String("Storage not initialized"));
     }
+
+    // 调用存储实现
+    return submit<Events>([storage = m_storage, date]() {
+        return OperationResult<Events>{storage->getEventsByDate(date)};
+    });
 }
 
-void EventOperations::getEventsForDateRange(const QDate &start, const QDate &end, EventListCallback onSuccess,
-                                            ErrorCallback onError)
+QFuture<OperationResult<QList<CalendarEventPtr>>> EventOperations::getEventsForDateRangeAsync(const QDate &start,
+                                                                                               const QDate &end)
 {
+    using Events = QList<CalendarEventPtr>;
+
     if (!start.isValid() || !end.isValid()) {
-        handleError(QLatin1String("Start or end date is not valid"), onError);
-        return;
+        return rejected<Events>(QLatin1String("Start or end date is not valid"));
     }
 
     if (start > end) {
-        handleError(QLatin1String("Start date is after end date"), onError);
-        return;
+        return rejected<Events>(QLatin1String("Start date is after end date"));
     }
 
     if (!m_storage) {
-        handleError(QLatin1String("Storage not initialized"), onError);
-        return;
+        return rejected<Events>(QLatin1String("Storage not initialized"));
     }
 
     // 调用存储实现
-    auto events = m_storage->getEventsByDateRange(start, end);
-    if (onSuccess) {
-        onSuccess(events);
-    }
+    return submit<Events>([storage = m_storage, start, end]() {
+        return OperationResult<Events>{storage->getEventsByDateRange(start, end)};
+    });
 }
 
-void EventOperations::handleError(const QString &error, ErrorCallback callback)
+QFuture<OperationResult<QList<EventOccurrence>>> EventOperations::getOccurrencesForDateRangeAsync(const QDate &start,
+                                                                                                  const QDate &end)
 {
-    qWarning() << QLatin1String("EventOperations error:") << error;
-    if (callback) {
-        callback(error);
+    using Occurrences = QList<EventOccurrence>;
+
+    if (!start.isValid() || !end.isValid()) {
+        return rejected<Occurrences>(QLatin1String("Start or end date is not valid"));
+    }
+
+    if (start > end) {
+        return rejected<Occurrences>(QLatin1String("Start date is after end date"));
+    }
+
+    if (!m_storage) {
+        return rejected<Occurrences>(QLatin1String("Storage not initialized"));
     }
+
+    // 调用存储实现
+    return submit<Occurrences>([storage = m_storage, start, end]() {
+        return OperationResult<Occurrences>{storage->getOccurrencesByDateRange(start, end)};
+    });
+}
+
+void EventOperations::createEvent(const CalendarEventPtr &event, SuccessCallback onSuccess, ErrorCallback onError)
+{
+    deliver(createEventAsync(event), std::move(onSuccess), std::move(onError));
+}
+
+void EventOperations::updateEvent(const CalendarEventPtr &event, SuccessCallback onSuccess, ErrorCallback onError)
+{
+    deliver(updateEventAsync(event), std::move(onSuccess), std::move(onError));
+}
+
+void EventOperations::deleteEvent(const QString &uid, SuccessCallback onSuccess, ErrorCallback onError)
+{
+    // 事件本来就不存在时删除也算成功，但没有可回调的事件
+    SuccessCallback onDeleted = [onSuccess = std::move(onSuccess)](const CalendarEventPtr &event) {
+        if (onSuccess && event) {
+            onSuccess(event);
+        }
+    };
+    deliver(deleteEventAsync(uid), std::move(onDeleted), std::move(onError));
+}
+
+void EventOperations::getEvent(const QString &uid, SuccessCallback onSuccess, ErrorCallback onError)
+{
+    deliver(getEventAsync(uid), std::move(onSuccess), std::move(onError));
+}
+
+void EventOperations::applyBatch(const QList<EventMutation> &mutations, BatchCallback onSuccess,
+                                 ErrorCallback onError)
+{
+    deliver(applyBatchAsync(mutations), std::move(onSuccess), std::move(onError));
+}
+
+void EventOperations::purgeBefore(const QDate &date, const QStringList &calendarIds, BatchCallback onSuccess,
+                                  ErrorCallback onError)
+{
+    deliver(purgeBeforeAsync(date, calendarIds), std::move(onSuccess), std::move(onError));
+}
+
+void EventOperations::getEventsForDate(const QDate &date, EventListCallback onSuccess, ErrorCallback onError)
+{
+    deliver(getEventsForDateAsync(date), std::move(onSuccess), std::move(onError));
+}
+
+void EventOperations::getEventsForDateRange(const QDate &start, const QDate &end, EventListCallback onSuccess,
+                                            ErrorCallback onError)
+{
+    deliver(getEventsForDateRangeAsync(start, end), std::move(onSuccess), std::move(onError));
+}
+
+void EventOperations::getOccurrencesForDateRange(const QDate &start, const QDate &end,
+                                                 OccurrenceListCallback onSuccess, ErrorCallback onError)
+{
+    deliver(getOccurrencesForDateRangeAsync(start, end), std::move(onSuccess), std::move(onError));
 }
 
 } // namespace PersonalCalendar::Core
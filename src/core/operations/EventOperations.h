@@ -5,18 +5,40 @@
 
 #include "../data/ICalendarStorage.h"
 #include "../models/CalendarEvent.h"
+#include "StorageExecutor.h"
 #include <QDate>
+#include <QFuture>
 #include <QString>
 #include <functional>
+#include <memory>
+
+class QObject;
 
 namespace PersonalCalendar::Core
 {
 
+/**
+ * @brief 异步操作的结果
+ */
+template<typename T>
+struct OperationResult {
+    T value{};
+    QString error; // 为空表示成功
+
+    bool ok() const { return error.isEmpty(); }
+};
+
 /**
  * @brief 事件操作的高级业务逻辑层
  *
  * 这一层为 UI 提供高级别的事件操作，隐藏底层存储实现细节。
- * 使用回调风格来处理异步操作。
+ *
+ * 每个操作有两种形式：*Async() 返回 QFuture（可以 co_await，见 FutureAwaiter.h），
+ * 回调形式在结果就绪后调用回调。参数校验、UID 和时间戳在调用线程完成；
+ * 构造时给出 StorageExecutor 时，存储调用在它的工作线程上按提交顺序执行，
+ * 回调总是在构造 EventOperations 的线程上调用。没有执行器时在调用线程上同步执行。
+ *
+ * 与执行器共用的存储应包装为 SynchronizedStorage，以便其他线程同时查询。
  */
 class EventOperations
 {
@@ -25,13 +47,37 @@ public:
     using SuccessCallback = std::function<void(const CalendarEventPtr &)>;
     using ErrorCallback = std::function<void(const QString &error)>;
     using EventListCallback = std::function<void(const QList<CalendarEventPtr> &)>;
+    using BatchCallback = std::function<void(int appliedCount)>;
+    using OccurrenceListCallback = std::function<void(const QList<EventOccurrence> &)>;
 
     /**
      * @brief 构造函数
      * @param storage 实现了 ICalendarStorage 接口的后端
+     * @param executor 执行存储调用的工作线程，为空时同步执行
      */
-    explicit EventOperations(ICalendarStoragePtr storage);
-    virtual ~EventOperations() = default;
+    explicit EventOperations(ICalendarStoragePtr storage, std::shared_ptr<StorageExecutor> executor = nullptr);
+    virtual ~EventOperations();
+
+    EventOperations(const EventOperations &) = delete;
+    EventOperations &operator=(const EventOperations &) = delete;
+
+    // ===== 返回 QFuture 的操作 =====
+
+    QFuture<OperationResult<CalendarEventPtr>> createEventAsync(const CalendarEventPtr &event);
+    QFuture<OperationResult<CalendarEventPtr>> updateEventAsync(const CalendarEventPtr &event);
+
+    /**
+     * @brief 删除事件，结果为被删除的事件（不存在时为空）
+     */
+    QFuture<OperationResult<CalendarEventPtr>> deleteEventAsync(const QString &uid);
+    QFuture<OperationResult<CalendarEventPtr>> getEventAsync(const QString &uid);
+    QFuture<OperationResult<int>> applyBatchAsync(const QList<EventMutation> &mutations);
+    QFuture<OperationResult<int>> purgeBeforeAsync(const QDate &date, const QStringList &calendarIds);
+    QFuture<OperationResult<QList<CalendarEventPtr>>> getEventsForDateAsync(const QDate &date);
+    QFuture<OperationResult<QList<CalendarEventPtr>>> getEventsForDateRangeAsync(const QDate &start,
+                                                                                  const QDate &end);
+    QFuture<OperationResult<QList<EventOccurrence>>> getOccurrencesForDateRangeAsync(const QDate &start,
+                                                                                     const QDate &end);
 
     // ===== 高级事件操作 =====
 
@@ -67,6 +113,28 @@ public:
      */
     void getEvent(const QString &uid, SuccessCallback onSuccess, ErrorCallback onError);
 
+    /**
+     * @brief 批量执行创建/更新/删除操作
+     *
+     * 所有变更作为一个整体提交：要么全部成功，要么全部不生效。
+     * 存储后端每个文件只写一次，适合导入和批量编辑。
+     *
+     * @param mutations 变更列表（按顺序执行）
+     * @param onSuccess 成功回调（已应用的变更数量）
+     * @param onError 错误回调
+     */
+    void applyBatch(const QList<EventMutation> &mutations, BatchCallback onSuccess, ErrorCallback onError);
+
+    /**
+     * @brief 清理在指定日期之前结束的事件
+     * @param date 截止日期（不含）
+     * @param calendarIds 限定的日历，为空表示所有日历
+     * @param onSuccess 成功回调（删除的事件数量）
+     * @param onError 错误回调
+     */
+    void purgeBefore(const QDate &date, const QStringList &calendarIds, BatchCallback onSuccess,
+                     ErrorCallback onError);
+
     /**
      * @brief 获取特定日期的事件
      * @param date 查询日期
@@ -85,11 +153,28 @@ public:
     void getEventsForDateRange(const QDate &start, const QDate &end, EventListCallback onSuccess,
                                ErrorCallback onError);
 
+    /**
+     * @brief 获取日期范围内的事件实例（展开重复事件）
+     * @param start 开始日期
+     * @param end 结束日期
+     * @param onSuccess 成功回调（按开始时间排序的实例）
+     * @param onError 错误回调
+     */
+    void getOccurrencesForDateRange(const QDate &start, const QDate &end, OccurrenceListCallback onSuccess,
+                                    ErrorCallback onError);
+
 protected:
     ICalendarStoragePtr m_storage;
 
 private:
-    void handleError(const QString &error, ErrorCallback callback);
+    template<typename T>
+    QFuture<OperationResult<T>> submit(std::function<OperationResult<T>()> task);
+
+    template<typename T, typename Callback>
+    void deliver(QFuture<OperationResult<T>> future, Callback onSuccess, ErrorCallback onError);
+
+    std::shared_ptr<StorageExecutor> m_executor;
+    std::unique_ptr<QObject> m_context; // 驻留在构造线程，回调经由它投递
 };
 
 } // namespace PersonalCalendar::Core
@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include <QFuture>
+#include <QObject>
+#include <QString>
+#include <coroutine>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace PersonalCalendar::Core
+{
+
+/**
+ * @brief 让协程等待 QFuture
+ *
+ * 挂起时在当前线程创建一个上下文对象，future 完成后经由它的事件队列
+ * 恢复协程，所以 co_await 之后的代码总在等待它的线程上执行，
+ * 即使 future 在工作线程上完成。等待的线程需要运行事件循环。
+ *
+ * future 被取消时（例如执行器在任务完成前析构）同样恢复协程，此时没有结果：
+ * co_await 返回默认构造的值；带 error 字段的结果（如 OperationResult）
+ * 填入错误信息，ok() 为 false。
+ */
+template<typename T>
+class FutureAwaiter
+{
+public:
+    explicit FutureAwaiter(QFuture<T> future) : m_future(std::move(future)) {}
+
+    bool await_ready() const { return m_future.isFinished(); }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        m_context = std::make_unique<QObject>();
+        // 取消的 future 不会执行 then() 的回调，两者只有一个恢复协程
+        m_future.then(m_context.get(), [handle](QFuture<T>) { handle.resume(); });
+        m_future.onCanceled(m_context.get(), [handle]() { handle.resume(); });
+    }
+
+    T await_resume()
+    {
+        if (m_context) {
+            // 此时仍在上下文对象的事件处理中，不能直接删除
+            m_context.release()->deleteLater();
+        }
+        if constexpr (!std::is_void_v<T>) {
+            if (m_future.isCanceled() && m_future.resultCount() == 0) {
+                T result{};
+                if constexpr (requires { result.error = QString(); }) {
+                    result.error = QStringLiteral("Operation canceled");
+                }
+                return result;
+            }
+            return m_future.result();
+        }
+    }
+
+    /**
+     * @brief future 是否被取消（此时 co_await 的结果是默认值）
+     */
+    bool isCanceled() const { return m_future.isCanceled(); }
+
+private:
+    QFuture<T> m_future;
+    // 协程未恢复就被销毁时随等待对象立即删除，连同尚未投递的恢复回调
+    std::unique_ptr<QObject> m_context;
+};
+
+/**
+ * @brief co_await future 返回它的结果
+ *
+ * 结果类型在本命名空间内（如 OperationResult）时通过 ADL 找到，
+ * 其他类型需要 using 本命名空间。
+ */
+template<typename T>
+FutureAwaiter<T> operator co_await(QFuture<T> future)
+{
+    return FutureAwaiter<T>(std::move(future));
+}
+
+} // namespace PersonalCalendar::Core
@@ -0,0 +1,37 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "StorageExecutor.h"
+#include <QMetaObject>
+#include <QObject>
+#include <QThread>
+
+namespace PersonalCalendar::Core
+{
+
+StorageExecutor::StorageExecutor() : m_thread(std::make_unique<QThread>()), m_worker(std::make_unique<QObject>())
+{
+    m_thread->setObjectName(QLatin1String("StorageExecutor"));
+    m_worker->moveToThread(m_thread.get());
+    m_thread->start();
+}
+
+StorageExecutor::~StorageExecutor()
+{
+    // 退出请求排在所有已提交任务之后
+    post([]() { QThread::currentThread()->quit(); });
+    m_thread->wait();
+}
+
+void StorageExecutor::post(std::function<void()> task)
+{
+    // 同一接收者的排队调用按投递顺序执行
+    QMetaObject::invokeMethod(m_worker.get(), std::move(task), Qt::QueuedConnection);
+}
+
+bool StorageExecutor::isWorkerThread() const
+{
+    return QThread::currentThread() == m_thread.get();
+}
+
+} // namespace PersonalCalendar::Core
@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include <QFuture>
+#include <QPromise>
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+class QObject;
+class QThread;
+
+namespace PersonalCalendar::Core
+{
+
+/**
+ * @brief 存储工作线程
+ *
+ * 在一个专用线程上按提交顺序逐个执行任务，界面线程提交后立即返回。
+ * 只有一个工作线程，所以同一日历的写入不会乱序，跨日历的查询也总能看到
+ * 之前提交的写入；后端本身不是线程安全的，不按日历并行执行。
+ *
+ * 析构时先执行完所有已提交的任务，再停止线程，不会丢失写入。
+ */
+class StorageExecutor
+{
+public:
+    StorageExecutor();
+    ~StorageExecutor();
+
+    StorageExecutor(const StorageExecutor &) = delete;
+    StorageExecutor &operator=(const StorageExecutor &) = delete;
+
+    /**
+     * @brief 提交任务，不关心结果
+     */
+    void post(std::function<void()> task);
+
+    /**
+     * @brief 提交任务，返回它的结果
+     *
+     * 返回的 QFuture 在工作线程上完成；需要回到调用线程时用
+     * QFuture::then(context, ...) 或 co_await（见 FutureAwaiter.h）。
+     */
+    template<typename Task>
+    auto run(Task task) -> QFuture<std::invoke_result_t<Task &>>;
+
+    /**
+     * @brief 当前线程是否为工作线程
+     */
+    bool isWorkerThread() const;
+
+private:
+    std::unique_ptr<QThread> m_thread;
+    std::unique_ptr<QObject> m_worker; // 驻留在工作线程，任务投递到它的事件队列
+};
+
+template<typename Task>
+auto StorageExecutor::run(Task task) -> QFuture<std::invoke_result_t<Task &>>
+{
+    using Result = std::invoke_result_t<Task &>;
+
+    auto promise = std::make_shared<QPromise<Result>>();
+    QFuture<Result> future = promise->future();
+    promise->start();
+
+    post([promise, task = std::move(task)]() mutable {
+        if constexpr (std::is_void_v<Result>) {
+            task();
+        } else {
+            promise->addResult(task());
+        }
+        promise->finish();
+    });
+    return future;
+}
+
+} // namespace PersonalCalendar::Core
@@ -0,0 +1,164 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "FreeBusyCalculator.h"
+#include <algorithm>
+
+namespace PersonalCalendar::Core
+{
+
+namespace
+{
+
+// 扫描线上的一个端点：进入区间时计数加一，离开时减一
+struct Edge {
+    qint64 at;
+    int busy;
+    int tentative;
+};
+
+} // namespace
+
+std::optional<BusyPeriod::Type> FreeBusyCalculator::busyType(const CalendarEvent &event, const FreeBusyQuery &query)
+{
+    if (event.status == EventStatus::Cancelled) {
+        return std::nullopt;
+    }
+    if (event.isAllDay && !query.includeAllDay) {
+        return std::nullopt;
+    }
+
+    const BusyPeriod::Type type = event.status == EventStatus::Tentative ? BusyPeriod::Type::Tentative
+                                                                         : BusyPeriod::Type::Busy;
+    if (query.attendee.isEmpty() || event.organizer.compare(query.attendee, Qt::CaseInsensitive) == 0) {
+        return type;
+    }
+
+    for (const Attendee &attendee : event.attendees) {
+        if (attendee.email.compare(query.attendee, Qt::CaseInsensitive) != 0) {
+            continue;
+        }
+        if (attendee.status == QLatin1String("DECLINED")) {
+            return std::nullopt;
+        }
+        // 未填写 PARTSTAT 等同于 NEEDS-ACTION
+        if (attendee.status.isEmpty() || attendee.status == QLatin1String("NEEDS-ACTION")
+            || attendee.status == QLatin1String("TENTATIVE")) {
+            return BusyPeriod::Type::Tentative;
+        }
+        break;
+    }
+    return type;
+}
+
+QList<BusyPeriod> FreeBusyCalculator::merge(const std::vector<BusyPeriod> &periods, qint64 from, qint64 to)
+{
+    std::vector<Edge> edges;
+    edges.reserve(periods.size() * 2);
+    for (const BusyPeriod &period : periods) {
+        const qint64 start = std::max(period.start, from);
+        const qint64 end = std::min(period.end, to);
+        if (start >= end) {
+            continue;
+        }
+        const int busy = period.type == BusyPeriod::Type::Busy ? 1 : 0;
+        edges.push_back(Edge{start, busy, 1 - busy});
+        edges.push_back(Edge{end, -busy, busy - 1});
+    }
+    std::sort(edges.begin(), edges.end(), [](const Edge &a, const Edge &b) { return a.at < b.at; });
+
+    QList<BusyPeriod> result;
+    int busy = 0;
+    int tentative = 0;
+    std::optional<BusyPeriod::Type> current;
+    qint64 openedAt = 0;
+
+    for (size_t i = 0; i < edges.size();) {
+        // 同一时刻的端点一起处理，首尾相接的区间因此不会被拆开
+        const qint64 at = edges[i].at;
+        for (; i < edges.size() && edges[i].at == at; ++i) {
+            busy += edges[i].busy;
+            tentative += edges[i].tentative;
+        }
+
+        std::optional<BusyPeriod::Type> state;
+        if (busy > 0) {
+            state = BusyPeriod::Type::Busy;
+        } else if (tentative > 0) {
+            state = BusyPeriod::Type::Tentative;
+        }
+        if (state == current) {
+            continue;
+        }
+
+        if (current) {
+            result.append(BusyPeriod{openedAt, at, *current});
+        }
+        current = state;
+        openedAt = at;
+    }
+    return result;
+}
+
+FreeBusy FreeBusyCalculator::compute(const QList<EventOccurrence> &occurrences, const FreeBusyQuery &query)
+{
+    FreeBusy result;
+    if (!query.start.isValid() || !query.end.isValid()) {
+        return result;
+    }
+    result.start = query.start.toUTC();
+    result.end = query.end.toUTC();
+
+    std::vector<BusyPeriod> periods;
+    periods.reserve(size_t(occurrences.size()));
+    for (const EventOccurrence &occurrence : occurrences) {
+        if (!occurrence.event) {
+            continue;
+        }
+        const auto type = busyType(*occurrence.event, query);
+        if (!type) {
+            continue;
+        }
+        const qint64 start = occurrence.utcStart.secsSinceEpoch();
+        const qint64 end = occurrence.utcEnd.isValid() ? occurrence.utcEnd.secsSinceEpoch() : start;
+        periods.push_back(BusyPeriod{start, end, *type});
+    }
+
+    result.periods = merge(periods, query.start.toSecsSinceEpoch(), query.end.toSecsSinceEpoch());
+    return result;
+}
+
+std::vector<std::pair<qint64, qint64>> FreeBusyCalculator::workingIntervals(const WorkingHours &hours,
+                                                                            const QTimeZone &zone, qint64 from,
+                                                                            qint64 to)
+{
+    std::vector<std::pair<qint64, qint64>> result;
+    if (from >= to) {
+        return result;
+    }
+    if (hours.isUnrestricted()) {
+        result.emplace_back(from, to);
+        return result;
+    }
+
+    const QTime dayStart = hours.dayStart.isValid() ? hours.dayStart : QTime(0, 0);
+    const QTime dayEnd = hours.dayEnd.isValid() ? hours.dayEnd : QTime(0, 0);
+    const int endOffset = hours.dayEnd.isValid() && dayEnd > dayStart ? 0 : 1;
+
+    // 从前一天开始：前一天跨午夜的时段可能落在窗口内
+    const QDate first = QDateTime::fromSecsSinceEpoch(from, zone).date().addDays(-1);
+    const QDate last = QDateTime::fromSecsSinceEpoch(to, zone).date();
+    for (QDate date = first; date <= last; date = date.addDays(1)) {
+        if (!hours.weekdays.isEmpty() && !hours.weekdays.contains(date.dayOfWeek())) {
+            continue;
+        }
+        const qint64 start = std::max(from, QDateTime(date, dayStart, zone).toSecsSinceEpoch());
+        const qint64 end = std::min(to, QDateTime(date.addDays(endOffset), dayEnd, zone).toSecsSinceEpoch());
+        if (start < end) {
+            result.emplace_back(start, end);
+        }
+    }
+    return result;
+}
+
+} // namespace PersonalCalendar::Core
@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include "../models/CalendarEvent.h"
+#include "../models/EventOccurrence.h"
+#include "../models/FreeBusy.h"
+#include <QList>
+#include <QTimeZone>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace PersonalCalendar::Core
+{
+
+/**
+ * @brief 忙闲计算
+ *
+ * 各后端只负责找出窗口内的忙碌区间，排序、合并和忙碌/暂定的取舍统一在这里完成。
+ */
+class FreeBusyCalculator
+{
+public:
+    /**
+     * @brief 事件占用时间的方式
+     * @return 不占用时间（已取消、全天、参与者已拒绝）时返回 std::nullopt
+     */
+    static std::optional<BusyPeriod::Type> busyType(const CalendarEvent &event, const FreeBusyQuery &query);
+
+    /**
+     * @brief 用扫描线合并任意顺序、可能重叠的区间
+     *
+     * 区间先裁剪到 [from, to)，长度为零的区间不占用时间。
+     * 任一忙碌区间覆盖的时间记为忙碌，其余被暂定区间覆盖的时间记为暂定。
+     *
+     * @param periods 待合并的区间
+     * @param from 窗口开始，UTC 秒
+     * @param to 窗口结束，UTC 秒
+     * @return 排序且互不重叠的区间
+     */
+    static QList<BusyPeriod> merge(const std::vector<BusyPeriod> &periods, qint64 from, qint64 to);
+
+    /**
+     * @brief 由事件实例计算忙闲
+     *
+     * 不检查实例所属的日历，调用者应事先过滤。
+     */
+    static FreeBusy compute(const QList<EventOccurrence> &occurrences, const FreeBusyQuery &query);
+
+    /**
+     * @brief 窗口内属于工作时间的区间
+     * @param hours 工作时间
+     * @param zone 解释工作时间的时区
+     * @param from 窗口开始，UTC 秒
+     * @param to 窗口结束，UTC 秒
+     * @return 按时间排序、互不重叠的 [开始, 结束) 区间，UTC 秒
+     */
+    static std::vector<std::pair<qint64, qint64>> workingIntervals(const WorkingHours &hours, const QTimeZone &zone,
+                                                                   qint64 from, qint64 to);
+};
+
+} // namespace PersonalCalendar::Core
@@ -2,44 +2,172 @@
 // SPDX-License-Identifier: LGPL-2.1-or-later
 
 #include "RecurrenceCalculator.h"
+#include "RecurrenceIterator.h"
+#include <QSemaphore>
+#include <QThreadPool>
+#include <algorithm>
+#include <limits>
+#include <vector>
 
 namespace PersonalCalendar::Core
 {
 
+namespace
+{
+
+// 事件少于该数量时，分发到线程池的开销超过并行的收益
+constexpr qsizetype kMinParallelEvents = 64;
+
+// 每块至少包含的事件数
+constexpr qsizetype kMinChunkEvents = 16;
+
+bool startsBefore(const EventOccurrence &a, const EventOccurrence &b)
+{
+    return a.utcStart < b.utcStart;
+}
+
+} // namespace
+
 QList<QDateTime> RecurrenceCalculator::calculateInstances(const CalendarEvent &event, const QDate &rangeStart,
                                                           const QDate &rangeEnd)
 {
     QList<QDateTime> instances;
-
-    // 非递归事件，只返回原始时间（如果在范围内）
-    if (event.recurrence.pattern == Recurrence::Pattern::None) {
-        if (event.startDateTime.date() >= rangeStart && event.startDateTime.date() <= rangeEnd) {
-            instances.append(event.startDateTime);
-        }
+    if (!rangeStart.isValid() || !rangeEnd.isValid()) {
         return instances;
     }
 
-    // 根据递归模式计算
-    switch (event.recurrence.pattern) {
-        case Recurrence::Pattern::Daily:
-            instances = expandDaily(event, rangeStart, rangeEnd);
-            break;
-        case Recurrence::Pattern::Weekly:
-            instances = expandWeekly(event, rangeStart, rangeEnd);
-            break;
-        case Recurrence::Pattern::Monthly:
-            instances = expandMonthly(event, rangeStart, rangeEnd);
-            break;
-        case Recurrence::Pattern::Yearly:
-            instances = expandYearly(event, rangeStart, rangeEnd);
-            break;
-        case Recurrence::Pattern::None:
-            break;
+    // 非递归事件只产生 DTSTART（和 RDATE），同样由迭代器处理
+    RecurrenceIterator iterator(event);
+    iterator.skipTo(rangeStart);
+    for (QDateTime instance = iterator.next(); instance.isValid() && instance.date() <= rangeEnd;
+         instance = iterator.next()) {
+        instances.append(instance);
     }
 
     return instances;
 }
 
+QList<EventOccurrence> RecurrenceCalculator::calculateOccurrences(const CalendarEventPtr &event, const QDate &rangeStart,
+                                                                 const QDate &rangeEnd)
+{
+    QList<EventOccurrence> occurrences;
+    if (!event || !rangeStart.isValid() || !rangeEnd.isValid()) {
+        return occurrences;
+    }
+
+    const qint64 duration = durationSeconds(*event);
+
+    // 向前扩展持续天数，以包含跨入范围的实例
+    const QDate expandFrom = rangeStart.addDays(-(duration / 86400) - 1);
+    const auto starts = calculateInstances(*event, expandFrom, rangeEnd);
+    for (const auto &start : starts) {
+        const QDateTime end = start.addSecs(duration);
+        if (CalendarEvent::lastDay(start, end) >= rangeStart && start.date() <= rangeEnd) {
+            occurrences.append(EventOccurrence{event, start, end});
+        }
+    }
+    return occurrences;
+}
+
+QList<EventOccurrence> RecurrenceCalculator::calculateOccurrences(const QList<CalendarEventPtr> &events,
+                                                                 const QDate &rangeStart, const QDate &rangeEnd)
+{
+    const auto expand = [&](qsizetype first, qsizetype last) {
+        QList<EventOccurrence> occurrences;
+        for (qsizetype i = first; i < last; ++i) {
+            occurrences.append(calculateOccurrences(events[i], rangeStart, rangeEnd));
+        }
+        std::stable_sort(occurrences.begin(), occurrences.end(), startsBefore);
+        return occurrences;
+    };
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const qsizetype count = events.size();
+    if (count < kMinParallelEvents || pool->maxThreadCount() < 2) {
+        return expand(0, count);
+    }
+
+    // 每个线程分几块，使展开开销不同的系列能够均衡分布
+    const qsizetype chunkCount = qMin<qsizetype>(qsizetype(pool->maxThreadCount()) * 4, count / kMinChunkEvents);
+    const qsizetype chunkSize = (count + chunkCount - 1) / chunkCount;
+
+    std::vector<QList<EventOccurrence>> chunks(chunkCount);
+    QSemaphore done;
+    for (qsizetype chunk = 1; chunk < chunkCount; ++chunk) {
+        const qsizetype first = qMin(count, chunk * chunkSize);
+        const qsizetype last = qMin(count, first + chunkSize);
+        const auto task = [&, chunk, first, last]() {
+            chunks[chunk] = expand(first, last);
+            done.release();
+        };
+
+        // 线程池已满（例如调用方本身运行在池中）时就地执行，避免互相等待
+        if (!pool->tryStart(task)) {
+            task();
+        }
+    }
+    chunks[0] = expand(0, qMin(count, chunkSize));
+    done.acquire(int(chunkCount - 1));
+
+    // 块内已排序，两两归并直到只剩一块
+    QList<EventOccurrence> occurrences;
+    QList<qsizetype> bounds{0};
+    for (auto &chunk : chunks) {
+        occurrences.append(std::move(chunk));
+        bounds.append(occurrences.size());
+    }
+
+    while (bounds.size() > 2) {
+        QList<qsizetype> merged{0};
+        for (qsizetype i = 0; i + 2 < bounds.size(); i += 2) {
+            std::inplace_merge(occurrences.begin() + bounds[i], occurrences.begin() + bounds[i + 1],
+                               occurrences.begin() + bounds[i + 2], startsBefore);
+            merged.append(bounds[i + 2]);
+        }
+        if (bounds.size() % 2 == 0) {
+            merged.append(bounds.last());
+        }
+        bounds = merged;
+    }
+
+    return occurrences;
+}
+
+qint64 RecurrenceCalculator::durationSeconds(const CalendarEvent &event)
+{
+    // 优先使用缓存的紧凑时间，避免时区换算
+    if (event.utcStart.isValid() && event.utcEnd.isValid()) {
+        return qMax<qint64>(0, event.utcStart.secsTo(event.utcEnd));
+    }
+    if (!event.endDateTime.isValid() || !event.startDateTime.isValid()) {
+        return 0;
+    }
+    return qMax<qint64>(0, event.startDateTime.secsTo(event.endDateTime));
+}
+
+std::pair<qint64, qint64> RecurrenceCalculator::seriesDays(const CalendarEvent &event)
+{
+    const qint64 start = event.utcStart.isValid() ? event.utcStart.localDay() : event.startDateTime.date().toJulianDay();
+    qint64 end = start;
+    if (event.utcEnd.isValid()) {
+        end = event.utcEnd.lastDayFrom(start);
+    } else if (event.endDateTime.isValid()) {
+        end = CalendarEvent::lastDay(event.startDateTime, event.endDateTime).toJulianDay();
+    }
+
+    const qint64 span = end - start;
+    if (event.recurrence.isValid()) {
+        if (!event.recurrence.endDate.isValid()) {
+            return {start, std::numeric_limits<qint64>::max()};
+        }
+        end = std::max(end, event.recurrence.endDate.toJulianDay() + span);
+    }
+    for (const QDateTime &date : event.recurrenceDates) {
+        end = std::max(end, date.date().toJulianDay() + span);
+    }
+    return {start, end};
+}
+
 bool RecurrenceCalculator::occurredOn(const CalendarEvent &event, const QDate &date)
 {
     if (!date.isValid()) {
@@ -48,7 +176,7 @@ bool RecurrenceCalculator::occurredOn(const CalendarEvent &event, const QDate &d
 
     // 单一事件，检查是否在该日期
     if (event.recurrence.pattern == Recurrence::Pattern::None) {
-        return event.startDateTime.date() <= date && event.endDateTime.date() >= date;
+        return event.occurredOn(date);
     }
 
     // 递归事件，计算该日期范围内的实例
@@ -62,14 +190,9 @@ QDate RecurrenceCalculator::getNextOccurrence(const CalendarEvent &event, const
         return QDate();
     }
 
-    // 查询之后 365 天内的实例
-    auto instances = calculateInstances(event, afterDate.addDays(1), afterDate.addDays(365));
-
-    if (!instances.isEmpty()) {
-        return instances.first().date();
-    }
-
-    return QDate();
+    RecurrenceIterator iterator(event);
+    iterator.skipTo(afterDate.addDays(1));
+    return iterator.next().date();
 }
 
 QDate RecurrenceCalculator::getPreviousOccurrence(const CalendarEvent &event, const QDate &beforeDate)
@@ -78,129 +201,176 @@ QDate RecurrenceCalculator::getPreviousOccurrence(const CalendarEvent &event, co
         return QDate();
     }
 
-    // 查询之前 365 天内的实例
-    auto instances = calculateInstances(event, beforeDate.addDays(-365), beforeDate.addDays(-1));
-
-    if (!instances.isEmpty()) {
-        return instances.last().date();
+    const QDate start = event.startDateTime.date();
+    if (!start.isValid() || start >= beforeDate) {
+        return QDate();
     }
 
-    return QDate();
-}
-
-QList<QDateTime> RecurrenceCalculator::expandDaily(const CalendarEvent &event, const QDate &rangeStart,
-                                                   const QDate &rangeEnd)
-{
-    QList<QDateTime> instances;
-
-    QDate current = event.startDateTime.date();
-    int daysInterval = event.recurrence.interval;
+    if (isSimpleSeries(event)) {
+        QDate last = beforeDate.addDays(-1);
+        if (event.recurrence.endDate.isValid() && event.recurrence.endDate < last) {
+            last = event.recurrence.endDate;
+        }
 
-    // 如果开始日期在范围之前，调整到范围内
-    if (current < rangeStart) {
-        int daysUntilRange = current.daysTo(rangeStart);
-        int steps = daysUntilRange / daysInterval;
-        if (daysUntilRange % daysInterval != 0) {
-            steps++; // 向上取整
+        for (qint64 index = lastIndexOnOrBefore(event, last); index >= 0; --index) {
+            const QDate current = instanceDate(event, index);
+            if (!isException(event, current)) {
+                return current;
+            }
         }
-        current = current.addDays(steps * daysInterval);
+        return QDate();
     }
 
-    // 生成所有实例
-    while (current <= rangeEnd) {
-        // 检查递归截止日期
-        if (event.recurrence.endDate.isValid() && current > event.recurrence.endDate) {
-            break;
-        }
+    // 迭代器只能向前：从逐步加倍的窗口起点向前扫描，取窗口内最后一个实例
+    for (qint64 window = 366;; window *= 2) {
+        const QDate from = qMax(start, beforeDate.addDays(-window));
+        RecurrenceIterator iterator(event);
+        iterator.skipTo(from);
 
-        // 检查排除日期
-        if (!isException(event, current)) {
-            QDateTime instance = QDateTime(current, event.startDateTime.time());
-            instances.append(instance);
+        QDate previous;
+        for (QDateTime instance = iterator.next(); instance.isValid() && instance.date() < beforeDate;
+             instance = iterator.next()) {
+            previous = instance.date();
         }
 
-        current = current.addDays(daysInterval);
+        if (previous.isValid() || from == start) {
+            return previous;
+        }
     }
-
-    return instances;
 }
 
-QList<QDateTime> RecurrenceCalculator::expandWeekly(const CalendarEvent &event, const QDate &rangeStart,
-                                                    const QDate &rangeEnd)
+qint64 RecurrenceCalculator::occurrenceCount(const CalendarEvent &event, const QDate &rangeStart,
+                                             const QDate &rangeEnd)
 {
-    QList<QDateTime> instances;
+    if (!rangeStart.isValid() || !rangeEnd.isValid() || rangeStart > rangeEnd) {
+        return 0;
+    }
 
-    // 简化版本：每周按 byDayOfWeek 规则生成
-    // 完整实现需要处理更多边界情况
+    // 带 COUNT、BY* 规则或 RDATE 的系列逐个计数，但不保存实例
+    if (!isSimpleSeries(event)) {
+        qint64 count = 0;
+        RecurrenceIterator iterator(event);
+        iterator.skipTo(rangeStart);
+        for (QDateTime instance = iterator.next(); instance.isValid() && instance.date() <= rangeEnd;
+             instance = iterator.next()) {
+            ++count;
+        }
+        return count;
+    }
 
-    QDate current = event.startDateTime.date();
-    int weeksInterval = event.recurrence.interval;
+    QDate last = rangeEnd;
+    if (event.recurrence.endDate.isValid() && event.recurrence.endDate < last) {
+        last = event.recurrence.endDate;
+    }
 
-    while (current <= rangeEnd) {
-        if (event.recurrence.endDate.isValid() && current > event.recurrence.endDate) {
-            break;
-        }
+    const qint64 first = firstIndexOnOrAfter(event, rangeStart);
+    const qint64 count = lastIndexOnOrBefore(event, last) - first + 1;
+    if (count <= 0) {
+        return 0;
+    }
 
-        if (current >= rangeStart && !isException(event, current)) {
-            QDateTime instance = QDateTime(current, event.startDateTime.time());
-            instances.append(instance);
+    // 只扣除恰好落在实例上的排除日期（排除列表可能含重复或无关日期）
+    QList<QDate> excluded;
+    for (const QDate &date : event.recurrenceExceptions) {
+        if (date < rangeStart || date > last || excluded.contains(date)) {
+            continue;
         }
+        if (instanceDate(event, firstIndexOnOrAfter(event, date)) == date) {
+            excluded.append(date);
+        }
+    }
+    return count - excluded.size();
+}
 
-        current = current.addDays(7 * weeksInterval);
+bool RecurrenceCalculator::isSimpleSeries(const CalendarEvent &event)
+{
+    const Recurrence &rule = event.recurrence;
+    if (!rule.isValid() || !event.startDateTime.isValid() || rule.count > 0 || !event.recurrenceDates.isEmpty() ||
+        !rule.byDayOfWeek.isEmpty() || !rule.byDayOfMonth.isEmpty() || !rule.byMonth.isEmpty() ||
+        !rule.byYearDay.isEmpty() || !rule.byWeekNo.isEmpty() || !rule.bySetPos.isEmpty()) {
+        return false;
     }
 
-    return instances;
+    // 不存在于每个月/每年的日期会被跳过，不能按编号直接换算
+    const QDate start = event.startDateTime.date();
+    switch (rule.pattern) {
+        case Recurrence::Pattern::Monthly:
+            return start.day() <= 28;
+        case Recurrence::Pattern::Yearly:
+            return !(start.month() == 2 && start.day() == 29);
+        default:
+            return true;
+    }
 }
 
-QList<QDateTime> RecurrenceCalculator::expandMonthly(const CalendarEvent &event, const QDate &rangeStart,
-                                                     const QDate &rangeEnd)
+int RecurrenceCalculator::stepInterval(const CalendarEvent &event)
 {
-    QList<QDateTime> instances;
-
-    // 简化版本：每月同一天
-    // 完整实现需要处理 byDayOfMonth 等规则
+    return qMax(1, event.recurrence.interval);
+}
 
-    QDate current = event.startDateTime.date();
-    int monthsInterval = event.recurrence.interval;
+QDate RecurrenceCalculator::instanceDate(const CalendarEvent &event, qint64 index)
+{
+    const QDate start = event.startDateTime.date();
+    const qint64 steps = index * stepInterval(event);
 
-    while (current <= rangeEnd) {
-        if (event.recurrence.endDate.isValid() && current > event.recurrence.endDate) {
+    switch (event.recurrence.pattern) {
+        case Recurrence::Pattern::Daily:
+            return start.addDays(steps);
+        case Recurrence::Pattern::Weekly:
+            return start.addDays(7 * steps);
+        case Recurrence::Pattern::Monthly:
+            return start.addMonths(static_cast<int>(steps));
+        case Recurrence::Pattern::Yearly:
+            return start.addYears(static_cast<int>(steps));
+        case Recurrence::Pattern::None:
             break;
-        }
-
-        if (current >= rangeStart && !isException(event, current)) {
-            QDateTime instance = QDateTime(current, event.startDateTime.time());
-            instances.append(instance);
-        }
-
-        current = current.addMonths(monthsInterval);
     }
-
-    return instances;
+    return start;
 }
 
-QList<QDateTime> RecurrenceCalculator::expandYearly(const CalendarEvent &event, const QDate &rangeStart,
-                                                    const QDate &rangeEnd)
+qint64 RecurrenceCalculator::firstIndexOnOrAfter(const CalendarEvent &event, const QDate &date)
 {
-    QList<QDateTime> instances;
+    const QDate start = event.startDateTime.date();
+    if (date <= start) {
+        return 0;
+    }
 
-    QDate current = event.startDateTime.date();
-    int yearsInterval = event.recurrence.interval;
+    const qint64 interval = stepInterval(event);
+    const qint64 days = start.daysTo(date);
+    qint64 index = 0;
 
-    while (current <= rangeEnd) {
-        if (event.recurrence.endDate.isValid() && current > event.recurrence.endDate) {
+    switch (event.recurrence.pattern) {
+        case Recurrence::Pattern::Daily:
+            return (days + interval - 1) / interval; // 向上取整
+        case Recurrence::Pattern::Weekly:
+            return (days + 7 * interval - 1) / (7 * interval);
+        case Recurrence::Pattern::Monthly: {
+            const qint64 months = (date.year() - start.year()) * 12 + (date.month() - start.month());
+            index = months / interval;
             break;
         }
+        case Recurrence::Pattern::Yearly:
+            index = (date.year() - start.year()) / interval;
+            break;
+        case Recurrence::Pattern::None:
+            return 0;
+    }
 
-        if (current >= rangeStart && !isException(event, current)) {
-            QDateTime instance = QDateTime(current, event.startDateTime.time());
-            instances.append(instance);
-        }
+    // 按月/年估算的实例落在目标所在月/年，至多再前进一步
+    if (instanceDate(event, index) < date) {
+        ++index;
+    }
+    return index;
+}
 
-        current = current.addYears(yearsInterval);
+qint64 RecurrenceCalculator::lastIndexOnOrBefore(const CalendarEvent &event, const QDate &date)
+{
+    if (date < event.startDateTime.date()) {
+        return -1;
     }
 
-    return instances;
+    const qint64 index = firstIndexOnOrAfter(event, date);
+    return instanceDate(event, index) > date ? index - 1 : index;
 }
 
 bool RecurrenceCalculator::isException(const CalendarEvent &event, const QDate &date)
@@ -4,9 +4,11 @@
 #pragma once
 
 #include "../models/CalendarEvent.h"
+#include "../models/EventOccurrence.h"
 #include <QDate>
 #include <QDateTime>
 #include <QList>
+#include <utility>
 
 namespace PersonalCalendar::Core
 {
@@ -15,7 +17,8 @@ namespace PersonalCalendar::Core
  * @brief 递归事件计算器
  *
  * 计算递归规则生成的所有事件实例。
- * 支持日递归、周递归、月递归、年递归。
+ * 实例由 RecurrenceIterator 按 RFC 5545 惰性展开；没有 BY* 规则、COUNT 和
+ * RDATE 的简单系列直接按编号换算日期。
  */
 class RecurrenceCalculator
 {
@@ -30,6 +33,60 @@ public:
     static QList<QDateTime> calculateInstances(const CalendarEvent &event, const QDate &rangeStart,
                                                const QDate &rangeEnd);
 
+    /**
+     * @brief 计算与日期范围重叠的所有实例
+     *
+     * 与 calculateInstances 不同，开始于范围之前但持续到范围内的实例也会返回。
+     *
+     * @param event 事件（实例引用该事件，不做复制）
+     * @param rangeStart 范围开始日期
+     * @param rangeEnd 范围结束日期
+     * @return 按开始时间排序的实例
+     */
+    static QList<EventOccurrence> calculateOccurrences(const CalendarEventPtr &event, const QDate &rangeStart,
+                                                       const QDate &rangeEnd);
+
+    /**
+     * @brief 批量计算多个事件与日期范围重叠的实例
+     *
+     * 事件按块分发到全局线程池并行展开，结果按开始时间归并，开始时间相同时保持
+     * 输入顺序。事件较少或线程池已满时在调用线程中展开。
+     *
+     * @param events 事件列表，展开期间不得修改
+     * @param rangeStart 范围开始日期
+     * @param rangeEnd 范围结束日期
+     * @return 按开始时间排序的实例
+     */
+    static QList<EventOccurrence> calculateOccurrences(const QList<CalendarEventPtr> &events, const QDate &rangeStart,
+                                                       const QDate &rangeEnd);
+
+    /**
+     * @brief 统计日期范围内的实例数量，不生成实例列表
+     *
+     * 用于年视图、十年视图等只需要数量的场景，耗时与排除日期数量成正比，
+     * 与范围长度无关。
+     *
+     * @param event 事件
+     * @param rangeStart 范围开始日期
+     * @param rangeEnd 范围结束日期
+     * @return 范围内开始的实例数量
+     */
+    static qint64 occurrenceCount(const CalendarEvent &event, const QDate &rangeStart, const QDate &rangeEnd);
+
+    /**
+     * @brief 事件单次发生的持续时间（秒）
+     */
+    static qint64 durationSeconds(const CalendarEvent &event);
+
+    /**
+     * @brief 事件所有实例可能覆盖的日期范围（儒略日，闭区间）
+     *
+     * 非重复事件即自身的开始和结束日期。重复事件只看截止日期和 RDATE，
+     * 没有截止日期（包括只有 COUNT）时结束为 std::numeric_limits<qint64>::max()。
+     * 结果可能偏大，但不会漏掉实例。
+     */
+    static std::pair<qint64, qint64> seriesDays(const CalendarEvent &event);
+
     /**
      * @brief 检查事件是否在指定日期发生
      * @param event 事件
@@ -55,14 +112,16 @@ public:
     static QDate getPreviousOccurrence(const CalendarEvent &event, const QDate &beforeDate);
 
 private:
-    // 各种递归模式的计算函数
-    static QList<QDateTime> expandDaily(const CalendarEvent &event, const QDate &rangeStart, const QDate &rangeEnd);
-
-    static QList<QDateTime> expandWeekly(const CalendarEvent &event, const QDate &rangeStart, const QDate &rangeEnd);
-
-    static QList<QDateTime> expandMonthly(const CalendarEvent &event, const QDate &rangeStart, const QDate &rangeEnd);
+    /**
+     * @brief 是否可以按编号直接换算实例日期（每个周期恰好一个实例）
+     */
+    static bool isSimpleSeries(const CalendarEvent &event);
 
-    static QList<QDateTime> expandYearly(const CalendarEvent &event, const QDate &rangeStart, const QDate &rangeEnd);
+    // 简单系列的实例编号与日期的换算：第 index 个实例从开始日期直接计算，均为 O(1)
+    static int stepInterval(const CalendarEvent &event);
+    static QDate instanceDate(const CalendarEvent &event, qint64 index);
+    static qint64 firstIndexOnOrAfter(const CalendarEvent &event, const QDate &date);
+    static qint64 lastIndexOnOrBefore(const CalendarEvent &event, const QDate &date);
 
     /**
      * @brief 检查日期是否在排除列表中
@@ -0,0 +1,417 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "RecurrenceIterator.h"
+#include <algorithm>
+
+namespace PersonalCalendar::Core
+{
+
+namespace
+{
+
+// 公历每 400 年循环一次：连续这么多个周期都没有实例，之后也不会再有
+qint64 maxEmptyPeriods(Recurrence::Pattern pattern)
+{
+    switch (pattern) {
+        case Recurrence::Pattern::Daily:
+            return 146097;
+        case Recurrence::Pattern::Weekly:
+            return 20871;
+        case Recurrence::Pattern::Monthly:
+            return 4800;
+        case Recurrence::Pattern::Yearly:
+            return 400;
+        case Recurrence::Pattern::None:
+            break;
+    }
+    return 0;
+}
+
+} // namespace
+
+RecurrenceIterator::RecurrenceIterator(const CalendarEvent &event)
+    : RecurrenceIterator(event.recurrence, event.startDateTime, event.recurrenceExceptions, event.recurrenceDates)
+{
+}
+
+RecurrenceIterator::RecurrenceIterator(const Recurrence &rule, const QDateTime &start, const QList<QDate> &exceptions,
+                                       const QList<QDateTime> &recurrenceDates)
+    : m_pattern(rule.pattern)
+    , m_interval(qMax(1, rule.interval))
+    , m_count(qMax(0, rule.count))
+    , m_weekStart((rule.weekStart >= 1 && rule.weekStart <= 7) ? rule.weekStart : 1)
+    , m_until(rule.endDate)
+    , m_start(start)
+    , m_byYearDay(rule.byYearDay)
+    , m_byMonthDay(rule.byDayOfMonth)
+    , m_bySetPos(rule.bySetPos)
+    , m_exceptions(exceptions)
+{
+    for (const QString &month : rule.byMonth) {
+        bool ok = false;
+        const int value = month.toInt(&ok);
+        if (ok && value >= 1 && value <= 12) {
+            m_byMonth.append(value);
+        }
+    }
+
+    // RFC 5545：BYWEEKNO 只用于 YEARLY，BYDAY 的序号只用于 MONTHLY 和 YEARLY
+    if (m_pattern == Recurrence::Pattern::Yearly) {
+        m_byWeekNo = rule.byWeekNo;
+    }
+    const bool ordinals = (m_pattern == Recurrence::Pattern::Monthly || m_pattern == Recurrence::Pattern::Yearly);
+    for (qsizetype i = 0; i < rule.byDayOfWeek.size(); ++i) {
+        const int weekday = rule.byDayOfWeek[i];
+        if (weekday >= 1 && weekday <= 7) {
+            const int ordinal = (ordinals && i < rule.byDayOrdinal.size()) ? rule.byDayOrdinal[i] : 0;
+            m_byDay.append(WeekdayRule{weekday, ordinal});
+        }
+    }
+
+    // 没有展开规则时由 DTSTART 推出：每年同月同日、每月同日、每周同一天
+    if (m_start.isValid() && m_byWeekNo.isEmpty() && m_byYearDay.isEmpty() && m_byMonthDay.isEmpty() &&
+        m_byDay.isEmpty()) {
+        const QDate date = m_start.date();
+        switch (m_pattern) {
+            case Recurrence::Pattern::Yearly:
+                if (m_byMonth.isEmpty()) {
+                    m_byMonth.append(date.month());
+                }
+                m_byMonthDay.append(date.day());
+                break;
+            case Recurrence::Pattern::Monthly:
+                m_byMonthDay.append(date.day());
+                break;
+            case Recurrence::Pattern::Weekly:
+                m_byDay.append(WeekdayRule{date.dayOfWeek(), 0});
+                break;
+            case Recurrence::Pattern::Daily:
+            case Recurrence::Pattern::None:
+                break;
+        }
+    }
+
+    std::sort(m_exceptions.begin(), m_exceptions.end());
+
+    for (const QDateTime &dt : recurrenceDates) {
+        if (dt.isValid()) {
+            m_recurrenceDates.append(dt);
+        }
+    }
+    std::sort(m_recurrenceDates.begin(), m_recurrenceDates.end());
+}
+
+QDateTime RecurrenceIterator::next()
+{
+    while (true) {
+        const QDate ruleDate = peekRule();
+        const QDateTime ruleNext = ruleDate.isValid() ? instanceAt(ruleDate) : QDateTime();
+        const QDateTime dateNext = m_cursor.recurrenceDateIndex < m_recurrenceDates.size()
+            ? m_recurrenceDates[m_cursor.recurrenceDateIndex]
+            : QDateTime();
+
+        if (!ruleNext.isValid() && !dateNext.isValid()) {
+            return QDateTime();
+        }
+
+        QDateTime result;
+        if (ruleNext.isValid() && (!dateNext.isValid() || ruleNext <= dateNext)) {
+            result = ruleNext;
+            consumeRule();
+            // 与规则实例重合的 RDATE 只算一次
+            if (dateNext == ruleNext) {
+                ++m_cursor.recurrenceDateIndex;
+            }
+        } else {
+            result = dateNext;
+            ++m_cursor.recurrenceDateIndex;
+        }
+
+        if (!isException(result.date())) {
+            return result;
+        }
+    }
+}
+
+void RecurrenceIterator::skipTo(const QDate &date)
+{
+    if (!date.isValid()) {
+        return;
+    }
+
+    while (m_cursor.recurrenceDateIndex < m_recurrenceDates.size() &&
+           m_recurrenceDates[m_cursor.recurrenceDateIndex].date() < date) {
+        ++m_cursor.recurrenceDateIndex;
+    }
+
+    if (!m_start.isValid() || date <= m_start.date()) {
+        return;
+    }
+
+    // 没有 COUNT 时不需要知道之前生成了多少个实例，直接跳到目标周期
+    if (m_count == 0 && m_pattern != Recurrence::Pattern::None) {
+        m_cursor.generated = qMax(m_cursor.generated, 1);
+        const qint64 period = periodFor(date);
+        if (period > m_cursor.period) {
+            m_cursor.period = period;
+            m_cursor.position = 0;
+        }
+    }
+
+    for (QDate ruleDate = peekRule(); ruleDate.isValid() && ruleDate < date; ruleDate = peekRule()) {
+        consumeRule();
+    }
+}
+
+void RecurrenceIterator::restore(const Cursor &cursor)
+{
+    m_cursor = cursor;
+    m_setPeriod = -1;
+    m_ruleDone = false;
+}
+
+QDate RecurrenceIterator::peekRule()
+{
+    if (m_ruleDone || !m_start.isValid()) {
+        return QDate();
+    }
+
+    if (m_count > 0 && m_cursor.generated >= m_count) {
+        return QDate();
+    }
+
+    // DTSTART 总是第一个实例
+    const QDate startDate = m_start.date();
+    if (m_cursor.generated == 0) {
+        return startDate;
+    }
+
+    if (m_pattern == Recurrence::Pattern::None) {
+        m_ruleDone = true;
+        return QDate();
+    }
+
+    qint64 emptyPeriods = 0;
+    while (true) {
+        if (m_setPeriod != m_cursor.period) {
+            expandPeriod(m_cursor.period);
+        }
+
+        while (m_cursor.position < m_set.size()) {
+            const QDate date = m_set[m_cursor.position];
+            if (date <= startDate) {
+                ++m_cursor.position;
+                continue;
+            }
+            if (m_until.isValid() && date > m_until) {
+                m_ruleDone = true;
+                return QDate();
+            }
+            return date;
+        }
+
+        // 按 BYWEEKNO 展开时周期可能从上一年年末开始，留出一周余量
+        const QDate anchor = periodAnchor(m_cursor.period + 1);
+        if (!anchor.isValid() || anchor.year() > 9999 || (m_until.isValid() && anchor.addDays(-7) > m_until) ||
+            ++emptyPeriods > maxEmptyPeriods(m_pattern)) {
+            m_ruleDone = true;
+            return QDate();
+        }
+
+        ++m_cursor.period;
+        m_cursor.position = 0;
+    }
+}
+
+void RecurrenceIterator::consumeRule()
+{
+    if (m_cursor.generated > 0) {
+        ++m_cursor.position;
+    }
+    ++m_cursor.generated;
+}
+
+qint64 RecurrenceIterator::periodFor(const QDate &date) const
+{
+    const QDate start = m_start.date();
+    switch (m_pattern) {
+        case Recurrence::Pattern::Daily:
+            return start.daysTo(date) / m_interval;
+        case Recurrence::Pattern::Weekly:
+            return periodAnchor(0).daysTo(date) / (7 * qint64(m_interval));
+        case Recurrence::Pattern::Monthly:
+            return ((date.year() - start.year()) * 12 + (date.month() - start.month())) / m_interval;
+        case Recurrence::Pattern::Yearly:
+            return (date.year() - start.year()) / m_interval;
+        case Recurrence::Pattern::None:
+            break;
+    }
+    return 0;
+}
+
+QDate RecurrenceIterator::periodAnchor(qint64 period) const
+{
+    const QDate start = m_start.date();
+    const qint64 steps = period * m_interval;
+
+    switch (m_pattern) {
+        case Recurrence::Pattern::Daily:
+            return start.addDays(steps);
+        case Recurrence::Pattern::Weekly: {
+            const int offset = (start.dayOfWeek() - m_weekStart + 7) % 7;
+            return start.addDays(7 * steps - offset);
+        }
+        case Recurrence::Pattern::Monthly:
+            if (steps > 12 * 10000) {
+                return QDate();
+            }
+            return QDate(start.year(), start.month(), 1).addMonths(int(steps));
+        case Recurrence::Pattern::Yearly:
+            if (start.year() + steps > 9999) {
+                return QDate();
+            }
+            return QDate(int(start.year() + steps), 1, 1);
+        case Recurrence::Pattern::None:
+            break;
+    }
+    return start;
+}
+
+void RecurrenceIterator::expandPeriod(qint64 period)
+{
+    m_set.clear();
+    m_setPeriod = period;
+
+    const QDate anchor = periodAnchor(period);
+    if (!anchor.isValid()) {
+        return;
+    }
+
+    QDate first = anchor;
+    QDate last = anchor;
+    QDate weekOne;
+    int weekCount = 0;
+
+    switch (m_pattern) {
+        case Recurrence::Pattern::Weekly:
+            last = anchor.addDays(6);
+            break;
+        case Recurrence::Pattern::Monthly:
+            last = anchor.addMonths(1).addDays(-1);
+            break;
+        case Recurrence::Pattern::Yearly:
+            last = QDate(anchor.year(), 12, 31);
+            // 按周编号时，周期为该年第一周到下一年第一周之前
+            if (!m_byWeekNo.isEmpty()) {
+                weekOne = firstWeek(anchor.year());
+                const QDate nextWeekOne = firstWeek(anchor.year() + 1);
+                weekCount = int(weekOne.daysTo(nextWeekOne) / 7);
+                first = weekOne;
+                last = nextWeekOne.addDays(-1);
+            }
+            break;
+        case Recurrence::Pattern::Daily:
+        case Recurrence::Pattern::None:
+            break;
+    }
+
+    for (QDate date = first; date <= last; date = date.addDays(1)) {
+        if (!m_byWeekNo.isEmpty()) {
+            const int week = int(weekOne.daysTo(date) / 7) + 1;
+            if (!m_byWeekNo.contains(week) && !m_byWeekNo.contains(week - weekCount - 1)) {
+                continue;
+            }
+        }
+        if (matches(date)) {
+            m_set.append(date);
+        }
+    }
+
+    if (!m_bySetPos.isEmpty() && !m_set.isEmpty()) {
+        QList<QDate> selected;
+        for (const int position : std::as_const(m_bySetPos)) {
+            const qsizetype index = position > 0 ? position - 1 : m_set.size() + position;
+            if (position != 0 && index >= 0 && index < m_set.size() && !selected.contains(m_set[index])) {
+                selected.append(m_set[index]);
+            }
+        }
+        std::sort(selected.begin(), selected.end());
+        m_set = selected;
+    }
+}
+
+bool RecurrenceIterator::matches(const QDate &date) const
+{
+    if (!m_byMonth.isEmpty() && !m_byMonth.contains(date.month())) {
+        return false;
+    }
+
+    // 负数从末尾倒数：-1 为最后一天
+    if (!m_byYearDay.isEmpty()) {
+        const int day = date.dayOfYear();
+        if (!m_byYearDay.contains(day) && !m_byYearDay.contains(day - date.daysInYear() - 1)) {
+            return false;
+        }
+    }
+
+    if (!m_byMonthDay.isEmpty()) {
+        const int day = date.day();
+        if (!m_byMonthDay.contains(day) && !m_byMonthDay.contains(day - date.daysInMonth() - 1)) {
+            return false;
+        }
+    }
+
+    if (!m_byDay.isEmpty()) {
+        return std::any_of(m_byDay.cbegin(), m_byDay.cend(),
+                           [&](const WeekdayRule &rule) { return matchesWeekday(rule, date); });
+    }
+
+    return true;
+}
+
+bool RecurrenceIterator::matchesWeekday(const WeekdayRule &rule, const QDate &date) const
+{
+    if (date.dayOfWeek() != rule.weekday) {
+        return false;
+    }
+    if (rule.ordinal == 0) {
+        return true;
+    }
+
+    // 序号相对于月（MONTHLY，或带 BYMONTH 的 YEARLY），否则相对于年
+    int index = date.dayOfYear();
+    int length = date.daysInYear();
+    if (m_pattern == Recurrence::Pattern::Monthly || !m_byMonth.isEmpty()) {
+        index = date.day();
+        length = date.daysInMonth();
+    }
+
+    if (rule.ordinal > 0) {
+        return (index - 1) / 7 + 1 == rule.ordinal;
+    }
+    return (length - index) / 7 + 1 == -rule.ordinal;
+}
+
+QDate RecurrenceIterator::firstWeek(int year) const
+{
+    // 第一周是至少有四天落在该年内的那一周
+    const QDate january1(year, 1, 1);
+    const int offset = (january1.dayOfWeek() - m_weekStart + 7) % 7;
+    return offset <= 3 ? january1.addDays(-offset) : january1.addDays(7 - offset);
+}
+
+bool RecurrenceIterator::isException(const QDate &date) const
+{
+    return std::binary_search(m_exceptions.cbegin(), m_exceptions.cend(), date);
+}
+
+QDateTime RecurrenceIterator::instanceAt(const QDate &date) const
+{
+    // 保留 DTSTART 的时间和时区
+    QDateTime instance = m_start;
+    instance.setDate(date);
+    return instance;
+}
+
+} // namespace PersonalCalendar::Core
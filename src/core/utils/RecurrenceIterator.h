@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include "../models/CalendarEvent.h"
+#include <QDate>
+#include <QDateTime>
+#include <QList>
+
+namespace PersonalCalendar::Core
+{
+
+/**
+ * @brief 惰性递归实例迭代器
+ *
+ * 按 RFC 5545 展开 RRULE、RDATE 和 EXDATE。每次只展开一个周期（日/周/月/年）
+ * 内的候选日期，依次应用 BYMONTH、BYWEEKNO、BYYEARDAY、BYMONTHDAY、BYDAY（含序号）
+ * 和 BYSETPOS，再与 RDATE 合并并剔除 EXDATE。内存占用与系列长度无关，调用方可以
+ * 随时停止，也可以保存游标稍后继续。
+ *
+ * 规则生成的实例沿用 DTSTART 的时间，RDATE 保留自身的时间。
+ * 频率最小为每天，不支持 BYHOUR/BYMINUTE/BYSECOND。
+ */
+class RecurrenceIterator
+{
+public:
+    /**
+     * @brief 迭代位置，可保存后通过 restore() 继续
+     */
+    struct Cursor {
+        qint64 period = 0;           // 当前周期编号
+        int position = 0;            // 周期内已经过的候选日期数
+        int generated = 0;           // 已生成的规则实例数（含 DTSTART，用于 COUNT）
+        int recurrenceDateIndex = 0; // 下一个待合并的 RDATE
+
+        bool operator==(const Cursor &other) const = default;
+    };
+
+    /**
+     * @brief 构造事件的迭代器
+     * @param event 事件，迭代器保存所需数据的副本
+     */
+    explicit RecurrenceIterator(const CalendarEvent &event);
+
+    /**
+     * @brief 由规则各部分构造迭代器
+     * @param rule 递归规则
+     * @param start 第一个实例 (DTSTART)
+     * @param exceptions 排除日期 (EXDATE)
+     * @param recurrenceDates 额外实例 (RDATE)
+     */
+    RecurrenceIterator(const Recurrence &rule, const QDateTime &start, const QList<QDate> &exceptions = {},
+                       const QList<QDateTime> &recurrenceDates = {});
+
+    /**
+     * @brief 取出下一个实例
+     * @return 实例开始时间，没有更多实例时返回无效值
+     */
+    QDateTime next();
+
+    /**
+     * @brief 跳到日期不早于 date 的第一个实例
+     *
+     * 没有 COUNT 时直接计算 date 所在的周期，不生成之前的实例；
+     * 有 COUNT 时需要计数，逐个跳过之前的实例。
+     */
+    void skipTo(const QDate &date);
+
+    Cursor cursor() const { return m_cursor; }
+    void restore(const Cursor &cursor);
+
+private:
+    struct WeekdayRule {
+        int weekday = 0; // 1-7 (Monday-Sunday)
+        int ordinal = 0; // 0 表示周期内的每一个
+    };
+
+    // 规则生成的下一个日期（不含 RDATE/EXDATE），不消耗该实例
+    QDate peekRule();
+    void consumeRule();
+
+    qint64 periodFor(const QDate &date) const;
+    QDate periodAnchor(qint64 period) const;
+    void expandPeriod(qint64 period);
+    bool matches(const QDate &date) const;
+    bool matchesWeekday(const WeekdayRule &rule, const QDate &date) const;
+    QDate firstWeek(int year) const;
+
+    bool isException(const QDate &date) const;
+    QDateTime instanceAt(const QDate &date) const;
+
+    Recurrence::Pattern m_pattern = Recurrence::Pattern::None;
+    int m_interval = 1;
+    int m_count = 0;
+    int m_weekStart = 1;
+    QDate m_until;
+    QDateTime m_start;
+
+    QList<int> m_byMonth;
+    QList<int> m_byWeekNo;
+    QList<int> m_byYearDay;
+    QList<int> m_byMonthDay;
+    QList<WeekdayRule> m_byDay;
+    QList<int> m_bySetPos;
+
+    QList<QDate> m_exceptions;          // 已排序
+    QList<QDateTime> m_recurrenceDates; // 已排序
+
+    Cursor m_cursor;
+    QList<QDate> m_set; // 当前周期的候选日期
+    qint64 m_setPeriod = -1;
+    bool m_ruleDone = false;
+};
+
+} // namespace PersonalCalendar::Core
@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "TextSearch.h"
+#include <QSet>
+
+namespace PersonalCalendar::Core
+{
+
+QString TextSearch::fold(const QString &text)
+{
+    const QString decomposed = text.normalized(QString::NormalizationForm_KD);
+
+    QString folded;
+    folded.reserve(decomposed.size());
+    for (const QChar ch : decomposed) {
+        const QChar::Category category = ch.category();
+        if (category == QChar::Mark_NonSpacing || category == QChar::Mark_SpacingCombining ||
+            category == QChar::Mark_Enclosing) {
+            continue;
+        }
+        folded.append(ch);
+    }
+    return folded.toCaseFolded();
+}
+
+QStringList TextSearch::tokenize(const QString &text)
+{
+    const QString folded = fold(text);
+
+    QStringList tokens;
+    QSet<QString> seen;
+    auto addToken = [&](const QString &token) {
+        if (!token.isEmpty() && !seen.contains(token)) {
+            seen.insert(token);
+            tokens.append(token);
+        }
+    };
+
+    QString current;
+    for (qsizetype i = 0; i < folded.size(); ++i) {
+        // 按码点处理，代理对中的汉字（扩展区）也能识别
+        char32_t ucs4 = folded.at(i).unicode();
+        qsizetype width = 1;
+        if (folded.at(i).isHighSurrogate() && i + 1 < folded.size() && folded.at(i + 1).isLowSurrogate()) {
+            ucs4 = QChar::surrogateToUcs4(folded.at(i), folded.at(i + 1));
+            width = 2;
+        }
+        const QString piece = folded.mid(i, width);
+        i += width - 1;
+
+        if (QChar::script(ucs4) == QChar::Script_Han) {
+            addToken(current);
+            current.clear();
+            addToken(piece);
+        } else if (QChar::isLetterOrNumber(ucs4)) {
+            current.append(piece);
+        } else {
+            addToken(current);
+            current.clear();
+        }
+    }
+    addToken(current);
+    return tokens;
+}
+
+QStringList TextSearch::trigrams(const QString &term)
+{
+    QStringList grams;
+    for (qsizetype i = 0; i + 3 <= term.size(); ++i) {
+        grams.append(term.mid(i, 3));
+    }
+    grams.removeDuplicates();
+    return grams;
+}
+
+TextSearch::Match TextSearch::match(const QString &term, const QString &token)
+{
+    if (!term.startsWith(token)) {
+        return token.size() >= 3 && term.contains(token) ? Match::Infix : Match::None;
+    }
+    return term.size() == token.size() ? Match::Exact : Match::Prefix;
+}
+
+double TextSearch::score(Match match, quint8 fields)
+{
+    const double weight = (fields & Title) ? 4.0 : (fields & Location) ? 2.0 : (fields & Description) ? 1.0 : 0.0;
+    return weight * int(match);
+}
+
+} // namespace PersonalCalendar::Core
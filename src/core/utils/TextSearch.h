@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+
+namespace PersonalCalendar::Core
+{
+
+/**
+ * @brief 全文搜索的文本处理
+ *
+ * 索引和查询必须使用同一套规则，否则查询词与索引词对不上。
+ */
+class TextSearch
+{
+public:
+    /**
+     * @brief 被搜索的字段，可按位组合
+     */
+    enum Field : quint8 {
+        Title = 0x1,
+        Location = 0x2,
+        Description = 0x4,
+    };
+
+    /**
+     * @brief 查询词与索引词的匹配程度
+     */
+    enum class Match {
+        None = 0,
+        Infix = 1,  // 查询词出现在索引词中间（至少 3 个字符）
+        Prefix = 2, // 查询词是索引词的开头
+        Exact = 3,  // 完全相同
+    };
+
+    /**
+     * @brief 折叠大小写和重音
+     *
+     * 先做兼容分解 (NFKD) 去掉组合附加符号，再做大小写折叠，
+     * 例如 "Café" 与 "CAFE" 折叠后相同。
+     */
+    static QString fold(const QString &text);
+
+    /**
+     * @brief 把文本切分为折叠后的词
+     *
+     * 字母和数字的连续序列构成一个词；汉字没有空格分隔，每个字单独成词。
+     * 重复的词只保留一次。
+     */
+    static QStringList tokenize(const QString &text);
+
+    /**
+     * @brief 词的所有三字母组，用于词中间的子串匹配
+     * @return 长度不足 3 时返回空列表
+     */
+    static QStringList trigrams(const QString &term);
+
+    /**
+     * @brief 查询词与索引词的匹配程度，两者都应已折叠
+     */
+    static Match match(const QString &term, const QString &token);
+
+    /**
+     * @brief 一个查询词的得分
+     * @param match 匹配程度
+     * @param fields 索引词出现的字段，取其中权重最高的（标题 > 地点 > 描述）
+     */
+    static double score(Match match, quint8 fields);
+};
+
+} // namespace PersonalCalendar::Core
@@ -8,6 +8,7 @@
 #include "incidenceoccurrencemodel.h"
 
 #include <QMetaEnum>
+#include <algorithm>
 #include <akonadi_version.h>
 #if AKONADI_VERSION >= QT_VERSION_CHECK(5, 18, 41)
 #include <Akonadi/EntityTreeModel>
@@ -124,8 +125,22 @@ void IncidenceOccurrenceModel::updateFromSource()
 
         Incidence::List allIncidences = Calendar::mergeIncidenceList(allEvents, allTodos, {});
 
+        // Every occurrence shares the categories of its incidence, so the tag
+        // filter is applied once per incidence, before any expansion.
+        const QStringList tags = mFilter.value(QLatin1String("tags")).toStringList();
+
         // process all recurring events and their exceptions.
         for (const auto &incidence : allIncidences) {
+            if (!tags.isEmpty()) {
+                const QStringList categories = incidence->categories();
+                const bool match = std::any_of(tags.cbegin(), tags.cend(), [&categories](const QString &tag) {
+                    return categories.contains(tag);
+                });
+                if (!match) {
+                    continue;
+                }
+            }
+
             KCalendarCore::MemoryCalendar calendar{QTimeZone::systemTimeZone()};
             calendar.addIncidence(incidence);
 
@@ -135,21 +150,6 @@ void IncidenceOccurrenceModel::updateFromSource()
                 occurrenceIterator.next();
                 const auto incidence = occurrenceIterator.incidence();
 
-                if (mFilter.contains(QLatin1String("tags")) && mFilter[QLatin1String("tags")].toStringList().length() > 0) {
-                    bool match = false;
-                    QStringList tags = mFilter[QLatin1String("tags")].toStringList();
-                    for (const auto &tag : tags) {
-                        if (incidence->categories().contains(tag)) {
-                            match = true;
-                            break;
-                        }
-                    }
-
-                    if (!match) {
-                        continue;
-                    }
-                }
-
                 auto start = occurrenceIterator.occurrenceStartDate();
                 auto end = incidence->endDateForStart(start);
 
@@ -3,6 +3,8 @@
 
 #include <todosortfilterproxymodel.h>
 
+#include <algorithm>
+
 TodoSortFilterProxyModel::TodoSortFilterProxyModel(QObject *parent)
     : QSortFilterProxyModel(parent)
 {
@@ -77,16 +79,12 @@ bool TodoSortFilterProxyModel::filterAcceptsRowCheck(int row, const QModelIndex
         break;
     }
 
-    if (m_filter.contains(QLatin1String("tags")) && !m_filter[QLatin1String("tags")].toStringList().isEmpty()) {
-        auto tags = m_filter[QLatin1String("tags")].toStringList();
-        bool containsTag = false;
-        for (const auto &tag : tags) {
-            if (sourceIndex.data(ExtraTodoModel::CategoriesRole).toStringList().contains(tag)) {
-                containsTag = true;
-                break;
-            }
-        }
-        acceptRow = acceptRow && containsTag;
+    if (acceptRow && !m_tags.isEmpty()) {
+        const auto categories = sourceIndex.data(ExtraTodoModel::CategoriesRole).toStringList();
+        const bool containsTag = std::any_of(m_tags.cbegin(), m_tags.cend(), [&categories](const QString &tag) {
+            return categories.contains(tag);
+        });
+        acceptRow = containsTag;
     }
 
     return acceptRow ? QSortFilterProxyModel::filterAcceptsRow(row, sourceParent) : acceptRow;
@@ -165,6 +163,7 @@ void TodoSortFilterProxyModel::setFilter(const QVariantMap &filter)
     Q_EMIT layoutAboutToBeChanged();
 
     m_filter = filter;
+    m_tags = m_filter.value(QLatin1String("tags")).toStringList();
 
     invalidateFilter();
 
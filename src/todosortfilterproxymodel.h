@@ -91,6 +91,7 @@ private:
     int m_showCompleted = ShowComplete::ShowAll;
     int m_showCompletedStore; // For when searches happen
     QVariantMap m_filter;
+    QStringList m_tags; // m_filter["tags"], parsed once per setFilter
     int m_sortColumn = EndTimeColumn;
     bool m_sortAscending = false;
     QTimer mRefreshTimer;
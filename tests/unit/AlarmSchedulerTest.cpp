@@ -0,0 +1,137 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "core/operations/AlarmScheduler.h"
+#include <QTimeZone>
+#include <gtest/gtest.h>
+
+using namespace PersonalCalendar::Core;
+
+class AlarmSchedulerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        scheduler.setClock([this]() { return now; });
+    }
+
+    CalendarEventPtr makeEvent(const QString &uid, const QDateTime &start, int minutesBefore)
+    {
+        auto event = std::make_shared<CalendarEvent>();
+        event->uid = uid;
+        event->title = uid;
+        event->startDateTime = start;
+        event->endDateTime = start.addSecs(3600);
+        Alarm alarm;
+        alarm.minutesBefore = minutesBefore;
+        alarm.action = QLatin1String("DISPLAY");
+        event->alarms.append(alarm);
+        return event;
+    }
+
+    static QDateTime at(int day, int hour, int minute = 0)
+    {
+        return QDateTime(QDate(2026, 3, day), QTime(hour, minute), QTimeZone::UTC);
+    }
+
+    QDateTime now = at(1, 0);
+    QList<AlarmScheduler::Reminder> fired;
+    AlarmScheduler scheduler{[this](const AlarmScheduler::Reminder &reminder) { fired.append(reminder); }};
+};
+
+TEST_F(AlarmSchedulerTest, FiresInDeadlineOrder)
+{
+    scheduler.setEvents({makeEvent(QLatin1String("late"), at(2, 10), 15), makeEvent(QLatin1String("early"), at(1, 9), 30),
+                         makeEvent(QLatin1String("past"), at(1, 0).addSecs(-3600), 0)});
+
+    EXPECT_EQ(scheduler.pendingCount(), 2);
+    EXPECT_EQ(scheduler.nextDeadline(), at(1, 8, 30));
+
+    EXPECT_EQ(scheduler.fireDue(at(1, 8, 29)), 0);
+    EXPECT_EQ(scheduler.fireDue(at(3, 0)), 2);
+    ASSERT_EQ(fired.size(), 2);
+    EXPECT_EQ(fired[0].event->uid, QLatin1String("early"));
+    EXPECT_EQ(fired[0].occurrenceStart, at(1, 9));
+    EXPECT_EQ(fired[1].fireTime, at(2, 9, 45));
+    EXPECT_FALSE(scheduler.nextDeadline().isValid());
+}
+
+TEST_F(AlarmSchedulerTest, RecurringInstancesExpandLazily)
+{
+    // Daily since 2020: only the next instance is ever queued
+    auto event = makeEvent(QLatin1String("standup"), QDateTime(QDate(2020, 1, 1), QTime(9, 0), QTimeZone::UTC), 10);
+    event->recurrence.pattern = Recurrence::Pattern::Daily;
+    scheduler.setEvents({event});
+
+    EXPECT_EQ(scheduler.pendingCount(), 1);
+    EXPECT_EQ(scheduler.nextDeadline(), at(1, 8, 50));
+
+    EXPECT_EQ(scheduler.fireDue(at(3, 12)), 3);
+    EXPECT_EQ(fired.last().occurrenceStart, at(3, 9));
+    EXPECT_EQ(scheduler.nextDeadline(), at(4, 8, 50));
+    EXPECT_EQ(scheduler.pendingCount(), 1);
+}
+
+TEST_F(AlarmSchedulerTest, UpdateReplacesOnlyThatEvent)
+{
+    auto moved = makeEvent(QLatin1String("moved"), at(1, 12), 0);
+    scheduler.setEvents({moved, makeEvent(QLatin1String("other"), at(1, 18), 0)});
+
+    auto edited = std::make_shared<CalendarEvent>(*moved);
+    edited->startDateTime = at(1, 20);
+    scheduler.updateEvent(edited);
+    EXPECT_EQ(scheduler.pendingCount(), 2);
+    EXPECT_EQ(scheduler.nextDeadline(), at(1, 18));
+
+    scheduler.removeEvent(QLatin1String("other"));
+    EXPECT_EQ(scheduler.nextDeadline(), at(1, 20));
+
+    EXPECT_EQ(scheduler.fireDue(at(2, 0)), 1);
+    EXPECT_EQ(fired.first().event->uid, QLatin1String("moved"));
+}
+
+TEST_F(AlarmSchedulerTest, EditsDoNotRefireDeliveredAlarms)
+{
+    auto event = makeEvent(QLatin1String("call"), at(1, 10), 30);
+    scheduler.setEvents({event});
+    EXPECT_EQ(scheduler.fireDue(at(1, 9, 40)), 1);
+
+    // Editing the title after the reminder went off must not repeat it
+    now = at(1, 9, 45);
+    event->title = QLatin1String("Call back");
+    scheduler.updateEvent(event);
+    EXPECT_EQ(scheduler.pendingCount(), 0);
+    EXPECT_EQ(scheduler.fireDue(at(1, 11)), 0);
+}
+
+TEST_F(AlarmSchedulerTest, EveryTriggerKindIsScheduled)
+{
+    // Five minutes after the start, and ten minutes before the end
+    auto after = makeEvent(QLatin1String("after"), at(1, 9), -5);
+    auto beforeEnd = makeEvent(QLatin1String("before-end"), at(1, 12), 10);
+    beforeEnd->alarms[0].relatedToEnd = true;
+
+    // An absolute trigger fires once even on a daily series
+    auto absolute = makeEvent(QLatin1String("absolute"), at(1, 7), 0);
+    absolute->recurrence.pattern = Recurrence::Pattern::Daily;
+    absolute->alarms[0].minutesBefore.reset();
+    absolute->alarms[0].triggerTime = at(2, 6);
+
+    // No trigger at all: nothing to schedule
+    auto none = makeEvent(QLatin1String("none"), at(1, 8), 0);
+    none->alarms[0].minutesBefore.reset();
+    none->alarms[0].rawTrigger = QByteArrayLiteral(":UNKNOWN");
+
+    scheduler.setEvents({after, beforeEnd, absolute, none});
+    EXPECT_EQ(scheduler.pendingCount(), 3);
+
+    EXPECT_EQ(scheduler.fireDue(at(5, 0)), 3);
+    ASSERT_EQ(fired.size(), 3);
+    EXPECT_EQ(fired[0].event->uid, QLatin1String("after"));
+    EXPECT_EQ(fired[0].fireTime, at(1, 9, 5));
+    EXPECT_EQ(fired[1].event->uid, QLatin1String("before-end"));
+    EXPECT_EQ(fired[1].fireTime, at(1, 12, 50));
+    EXPECT_EQ(fired[2].event->uid, QLatin1String("absolute"));
+    EXPECT_EQ(fired[2].fireTime, at(2, 6));
+    EXPECT_EQ(scheduler.pendingCount(), 0);
+}
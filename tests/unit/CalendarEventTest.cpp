@@ -152,3 +152,31 @@ TEST_F(CalendarEventTest, Equality)
 
     EXPECT_TRUE(event1 == event2);
 }
+
+TEST_F(CalendarEventTest, CachedTimesKeepZone)
+{
+    const QTimeZone tokyo("Asia/Tokyo");
+    event.startDateTime = QDateTime(QDate(2026, 3, 1), QTime(23, 30), tokyo);
+    event.endDateTime = QDateTime(QDate(2026, 3, 2), QTime(0, 30), tokyo);
+    event.cacheTimes();
+
+    EXPECT_EQ(event.utcStart.secsSinceEpoch(), event.startDateTime.toSecsSinceEpoch());
+    EXPECT_EQ(event.utcStart.localDay(), QDate(2026, 3, 1).toJulianDay());
+    EXPECT_EQ(event.utcEnd.localDay(), QDate(2026, 3, 2).toJulianDay());
+    EXPECT_EQ(event.utcStart.toDateTime(), event.startDateTime);
+    EXPECT_EQ(event.utcStart.toDateTime().timeZone(), tokyo);
+    EXPECT_EQ(event.utcStart.secsTo(event.utcEnd), 3600);
+}
+
+TEST_F(CalendarEventTest, CachedTimesCompareAcrossZones)
+{
+    const UtcTime tokyo = UtcTime::fromDateTime(QDateTime(QDate(2026, 3, 1), QTime(9, 0), QTimeZone("Asia/Tokyo")));
+    const UtcTime utc = UtcTime::fromDateTime(QDateTime(QDate(2026, 3, 1), QTime(0, 0), QTimeZone::UTC));
+    const UtcTime later = UtcTime::fromDateTime(QDateTime(QDate(2026, 3, 1), QTime(0, 1), QTimeZone::UTC));
+
+    EXPECT_EQ(tokyo, utc);
+    EXPECT_NE(tokyo.zone(), utc.zone());
+    EXPECT_LT(utc, later);
+    EXPECT_LT(UtcTime(), utc); // 无效值排在最前
+    EXPECT_FALSE(UtcTime::fromDateTime(QDateTime()).isValid());
+}
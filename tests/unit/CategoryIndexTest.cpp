@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "backends/local/CategoryIndex.h"
+#include <gtest/gtest.h>
+
+using namespace PersonalCalendar;
+
+class CategoryIndexTest : public ::testing::Test
+{
+protected:
+    Core::CalendarEventPtr makeEvent(const QString &uid, const QStringList &categories)
+    {
+        auto event = std::make_shared<Core::CalendarEvent>();
+        event->uid = uid;
+        event->title = uid;
+        event->startDateTime = QDateTime(QDate(2026, 1, 5), QTime(9, 0));
+        event->endDateTime = QDateTime(QDate(2026, 1, 5), QTime(10, 0));
+        event->categories = categories;
+        return event;
+    }
+
+    QStringList uids(const QList<Core::CalendarEventPtr> &events) const
+    {
+        QStringList result;
+        for (const auto &event : events) {
+            result.append(event->uid);
+        }
+        return result;
+    }
+
+    Local::CategoryIndex index;
+};
+
+TEST_F(CategoryIndexTest, MatchesAnyCategory)
+{
+    const QList<Core::CalendarEventPtr> events = {
+        makeEvent(QStringLiteral("a"), {QStringLiteral("work")}),
+        makeEvent(QStringLiteral("b"), {QStringLiteral("home"), QStringLiteral("sport")}),
+        makeEvent(QStringLiteral("c"), {}),
+        makeEvent(QStringLiteral("d"), {QStringLiteral("travel")}),
+    };
+    for (const auto &event : events) {
+        index.insert(event);
+    }
+    EXPECT_EQ(index.categoryCount(), 4);
+
+    const auto mask = index.mask({QStringLiteral("work"), QStringLiteral("sport")});
+    EXPECT_EQ(uids(index.filter(events, mask)), (QStringList{QStringLiteral("a"), QStringLiteral("b")}));
+    EXPECT_FALSE(index.matches(QStringLiteral("c"), mask));
+}
+
+TEST_F(CategoryIndexTest, UnknownCategoryMatchesNothing)
+{
+    const auto event = makeEvent(QStringLiteral("a"), {QStringLiteral("work")});
+    index.insert(event);
+
+    const auto mask = index.mask({QStringLiteral("missing")});
+    EXPECT_TRUE(mask.isEmpty());
+    EXPECT_TRUE(index.filter({event}, mask).isEmpty());
+}
+
+TEST_F(CategoryIndexTest, ReinsertReplacesCategories)
+{
+    auto event = makeEvent(QStringLiteral("a"), {QStringLiteral("work")});
+    index.insert(event);
+
+    event->categories = {QStringLiteral("home")};
+    index.insert(event);
+    EXPECT_FALSE(index.matches(QStringLiteral("a"), index.mask({QStringLiteral("work")})));
+    EXPECT_TRUE(index.matches(QStringLiteral("a"), index.mask({QStringLiteral("home")})));
+
+    index.remove(QStringLiteral("a"));
+    EXPECT_FALSE(index.matches(QStringLiteral("a"), index.mask({QStringLiteral("home")})));
+}
+
+TEST_F(CategoryIndexTest, MoreThanSixtyFourCategories)
+{
+    QStringList many;
+    for (int i = 0; i < 130; ++i) {
+        many.append(QStringLiteral("tag%1").arg(i));
+    }
+    index.insert(makeEvent(QStringLiteral("all"), many));
+    index.insert(makeEvent(QStringLiteral("low"), {QStringLiteral("tag3")}));
+    index.insert(makeEvent(QStringLiteral("high"), {QStringLiteral("tag129")}));
+    EXPECT_EQ(index.categoryCount(), 130);
+
+    const auto high = index.mask({QStringLiteral("tag129")});
+    EXPECT_TRUE(index.matches(QStringLiteral("all"), high));
+    EXPECT_TRUE(index.matches(QStringLiteral("high"), high));
+    EXPECT_FALSE(index.matches(QStringLiteral("low"), high));
+
+    const auto middle = index.mask({QStringLiteral("tag70")});
+    EXPECT_TRUE(index.matches(QStringLiteral("all"), middle));
+    EXPECT_FALSE(index.matches(QStringLiteral("high"), middle));
+}
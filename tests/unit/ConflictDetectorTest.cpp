@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "core/operations/ConflictDetector.h"
+#include <QTimeZone>
+#include <gtest/gtest.h>
+
+using namespace PersonalCalendar::Core;
+
+class ConflictDetectorTest : public ::testing::Test
+{
+protected:
+    EventOccurrence occurrence(const QString &uid, int startHour, int endHour)
+    {
+        auto &event = events[uid];
+        if (!event) {
+            event = std::make_shared<CalendarEvent>();
+            event->uid = uid;
+        }
+        return EventOccurrence(event, at(startHour), at(endHour));
+    }
+
+    static QDateTime at(int hour)
+    {
+        return QDateTime(QDate(2026, 2, 2), QTime(0, 0), QTimeZone::UTC).addSecs(hour * 3600);
+    }
+
+    static QStringList pairs(const QList<EventConflict> &conflicts)
+    {
+        QStringList result;
+        for (const auto &conflict : conflicts) {
+            result.append(conflict.first.event->uid + QLatin1Char('/') + conflict.second.event->uid);
+        }
+        return result;
+    }
+
+    QHash<QString, CalendarEventPtr> events;
+};
+
+TEST_F(ConflictDetectorTest, FindsEveryOverlappingPair)
+{
+    const QList<EventOccurrence> occurrences = {
+        occurrence(QLatin1String("c"), 11, 12), occurrence(QLatin1String("a"), 9, 12),
+        occurrence(QLatin1String("b"), 10, 11), occurrence(QLatin1String("d"), 12, 13), // touches, no overlap
+    };
+
+    const auto conflicts = ConflictDetector::findConflicts(occurrences);
+    EXPECT_EQ(pairs(conflicts), (QStringList{QLatin1String("a/b"), QLatin1String("a/c")}));
+    EXPECT_EQ(conflicts[0].overlapStart(), at(10));
+    EXPECT_EQ(conflicts[0].overlapEnd, at(11));
+    EXPECT_EQ(conflicts[1].overlapEnd, at(12));
+}
+
+TEST_F(ConflictDetectorTest, SkipsEventsThatDoNotBlockTime)
+{
+    auto cancelled = occurrence(QLatin1String("cancelled"), 9, 10);
+    cancelled.event->status = EventStatus::Cancelled;
+    auto allDay = occurrence(QLatin1String("holiday"), 0, 24);
+    allDay.event->isAllDay = true;
+
+    const QList<EventOccurrence> occurrences = {
+        occurrence(QLatin1String("meeting"), 9, 10), cancelled, allDay,
+        // Instances of one series never conflict with each other
+        occurrence(QLatin1String("series"), 14, 16), occurrence(QLatin1String("series"), 15, 17),
+    };
+    EXPECT_TRUE(ConflictDetector::findConflicts(occurrences).isEmpty());
+}
+
+TEST_F(ConflictDetectorTest, LongEventStaysActive)
+{
+    QList<EventOccurrence> occurrences = {occurrence(QLatin1String("workshop"), 8, 18)};
+    for (int hour = 8; hour < 18; hour += 2) {
+        occurrences.append(occurrence(QLatin1String("slot-") + QString::number(hour), hour, hour + 1));
+    }
+
+    const auto conflicts = ConflictDetector::findConflicts(occurrences);
+    ASSERT_EQ(conflicts.size(), 5);
+    for (const auto &conflict : conflicts) {
+        EXPECT_EQ(conflict.first.event->uid, QLatin1String("workshop"));
+    }
+}
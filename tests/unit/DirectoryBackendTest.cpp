@@ -2,8 +2,12 @@
 // SPDX-License-Identifier: LGPL-2.1-or-later
 
 #include "backends/local/DirectoryBackend.h"
+#include "core/operations/ConflictDetector.h"
+#include <QCoreApplication>
+#include <QDeadlineTimer>
 #include <QFile>
 #include <QTemporaryDir>
+#include <QTimeZone>
 #include <gtest/gtest.h>
 
 using namespace PersonalCalendar;
@@ -123,6 +127,172 @@ TEST_F(DirectoryBackendTest, EventsAcrossCalendars)
     EXPECT_EQ(e2->title, QLatin1String("Vacation"));
 }
 
+TEST_F(DirectoryBackendTest, SearchAcrossCalendarsPaginated)
+{
+    Local::DirectoryBackend backend(dirPath);
+    backend.createCalendar(QLatin1String("work"), QLatin1String("Work"));
+    backend.createCalendar(QLatin1String("personal"), QLatin1String("Personal"));
+
+    for (int i = 0; i < 3; ++i) {
+        auto work = createTestEvent(QLatin1String("work-") + QString::number(i), QLatin1String("Project sync"));
+        work->calendarId = QLatin1String("work");
+        work->startDateTime = work->startDateTime.addDays(i * 2);
+        EXPECT_TRUE(backend.createEvent(work));
+
+        auto personal = createTestEvent(QLatin1String("personal-") + QString::number(i), QLatin1String("Sync photos"));
+        personal->calendarId = QLatin1String("personal");
+        personal->startDateTime = personal->startDateTime.addDays(i * 2 + 1);
+        EXPECT_TRUE(backend.createEvent(personal));
+    }
+
+    Core::SearchQuery query;
+    query.text = QLatin1String("sync");
+    query.offset = 1;
+    query.limit = 2;
+
+    // Equal scores: newest first
+    auto results = backend.searchEvents(query);
+    EXPECT_EQ(results.total, 6);
+    ASSERT_EQ(results.hits.size(), 2);
+    EXPECT_EQ(results.hits[0].event->uid, QLatin1String("work-2"));
+    EXPECT_EQ(results.hits[1].event->uid, QLatin1String("personal-1"));
+
+    query.calendarIds = {QLatin1String("work")};
+    query.offset = 0;
+    EXPECT_EQ(backend.searchEvents(query).total, 3);
+}
+
+TEST_F(DirectoryBackendTest, FreeBusyAcrossCalendars)
+{
+    Local::DirectoryBackend backend(dirPath);
+    backend.createCalendar(QLatin1String("work"), QLatin1String("Work"));
+    backend.createCalendar(QLatin1String("personal"), QLatin1String("Personal"));
+
+    // Daily stand-up since last year, 09:00-09:30 UTC
+    auto standup = createTestEvent(QLatin1String("standup"), QLatin1String("Stand-up"));
+    standup->calendarId = QLatin1String("work");
+    standup->startDateTime = QDateTime(QDate(2025, 6, 2), QTime(9, 0), QTimeZone::UTC);
+    standup->endDateTime = QDateTime(QDate(2025, 6, 2), QTime(9, 30), QTimeZone::UTC);
+    standup->recurrence.pattern = Core::Recurrence::Pattern::Daily;
+    ASSERT_TRUE(backend.createEvent(standup));
+
+    auto dentist = createTestEvent(QLatin1String("dentist"), QLatin1String("Dentist"));
+    dentist->calendarId = QLatin1String("personal");
+    dentist->startDateTime = QDateTime(QDate(2026, 1, 10), QTime(9, 15), QTimeZone::UTC);
+    dentist->endDateTime = QDateTime(QDate(2026, 1, 10), QTime(10, 0), QTimeZone::UTC);
+    dentist->status = Core::EventStatus::Tentative;
+    ASSERT_TRUE(backend.createEvent(dentist));
+
+    auto holiday = createTestEvent(QLatin1String("holiday"), QLatin1String("Holiday"));
+    holiday->calendarId = QLatin1String("personal");
+    holiday->startDateTime = QDateTime(QDate(2026, 1, 10), QTime(0, 0));
+    holiday->endDateTime = QDateTime(QDate(2026, 1, 11), QTime(0, 0));
+    holiday->isAllDay = true;
+    ASSERT_TRUE(backend.createEvent(holiday));
+
+    Core::FreeBusyQuery query;
+    query.start = QDateTime(QDate(2026, 1, 10), QTime(8, 0), QTimeZone::UTC);
+    query.end = QDateTime(QDate(2026, 1, 10), QTime(12, 0), QTimeZone::UTC);
+
+    auto freeBusy = backend.getFreeBusy(query);
+    ASSERT_EQ(freeBusy.periods.size(), 2);
+    EXPECT_EQ(freeBusy.periods[0].startDateTime(), QDateTime(QDate(2026, 1, 10), QTime(9, 0), QTimeZone::UTC));
+    EXPECT_EQ(freeBusy.periods[0].endDateTime(), QDateTime(QDate(2026, 1, 10), QTime(9, 30), QTimeZone::UTC));
+    EXPECT_EQ(freeBusy.periods[0].type, Core::BusyPeriod::Type::Busy);
+    EXPECT_EQ(freeBusy.periods[1].endDateTime(), QDateTime(QDate(2026, 1, 10), QTime(10, 0), QTimeZone::UTC));
+    EXPECT_EQ(freeBusy.periods[1].type, Core::BusyPeriod::Type::Tentative);
+
+    query.calendarIds = {QLatin1String("personal")};
+    freeBusy = backend.getFreeBusy(query);
+    ASSERT_EQ(freeBusy.periods.size(), 1);
+    EXPECT_EQ(freeBusy.periods[0].startDateTime(), QDateTime(QDate(2026, 1, 10), QTime(9, 15), QTimeZone::UTC));
+}
+
+TEST_F(DirectoryBackendTest, FindFreeSlotsWithinWorkingHours)
+{
+    Local::DirectoryBackend backend(dirPath);
+    backend.createCalendar(QLatin1String("work"), QLatin1String("Work"));
+
+    // Monday 2026-01-12 is booked apart from 10:00-10:15 and 12:00-12:30
+    const auto monday = [](int hour, int minute) {
+        return QDateTime(QDate(2026, 1, 12), QTime(hour, minute), QTimeZone::UTC);
+    };
+    const QList<std::pair<QDateTime, QDateTime>> bookings = {
+        {monday(9, 0), monday(10, 0)}, {monday(10, 15), monday(12, 0)}, {monday(12, 30), monday(17, 0)}};
+    for (qsizetype i = 0; i < bookings.size(); ++i) {
+        auto event = createTestEvent(QLatin1String("busy-") + QString::number(i), QLatin1String("Busy"));
+        event->calendarId = QLatin1String("work");
+        event->startDateTime = bookings[i].first;
+        event->endDateTime = bookings[i].second;
+        ASSERT_TRUE(backend.createEvent(event));
+    }
+
+    Core::FreeSlotQuery query;
+    query.start = monday(8, 0);
+    query.end = query.start.addDays(30);
+    query.durationMinutes = 30;
+    query.workingHours = Core::WorkingHours::officeHours();
+    query.maxResults = 2;
+
+    auto slots = backend.findFreeSlots(query);
+    ASSERT_EQ(slots.size(), 2);
+    EXPECT_EQ(slots[0], (Core::FreeSlot{monday(12, 0), monday(12, 30)}));
+    EXPECT_EQ(slots[1], (Core::FreeSlot{monday(9, 0).addDays(1), monday(17, 0).addDays(1)}));
+
+    // Late on Friday: the weekend is skipped and the start is aligned
+    query.start = QDateTime(QDate(2026, 1, 16), QTime(16, 40), QTimeZone::UTC);
+    query.maxResults = 1;
+    query.alignMinutes = 15;
+    slots = backend.findFreeSlots(query);
+    ASSERT_EQ(slots.size(), 1);
+    EXPECT_EQ(slots[0].start, QDateTime(QDate(2026, 1, 19), QTime(9, 0), QTimeZone::UTC));
+}
+
+TEST_F(DirectoryBackendTest, ConflictsAcrossCalendarsAndIncrementalUpdate)
+{
+    Local::DirectoryBackend backend(dirPath);
+    backend.createCalendar(QLatin1String("work"), QLatin1String("Work"));
+    backend.createCalendar(QLatin1String("team"), QLatin1String("Team"));
+
+    const auto at = [](int day, int hour) { return QDateTime(QDate(2026, 3, day), QTime(hour, 0), QTimeZone::UTC); };
+
+    // Weekly review on Mondays 10-11 (2026-03-02 is a Monday)
+    auto review = createTestEvent(QLatin1String("review"), QLatin1String("Review"));
+    review->calendarId = QLatin1String("team");
+    review->startDateTime = at(2, 10);
+    review->endDateTime = at(2, 11);
+    review->recurrence.pattern = Core::Recurrence::Pattern::Weekly;
+    ASSERT_TRUE(backend.createEvent(review));
+
+    auto call = createTestEvent(QLatin1String("call"), QLatin1String("Call"));
+    call->calendarId = QLatin1String("work");
+    call->startDateTime = at(9, 10);
+    call->endDateTime = at(9, 12);
+    ASSERT_TRUE(backend.createEvent(call));
+
+    Core::ConflictDetector detector;
+    detector.scan(backend, QDate(2026, 3, 1), QDate(2026, 3, 31));
+    ASSERT_EQ(detector.conflicts().size(), 1);
+    EXPECT_TRUE(detector.hasConflict(QLatin1String("review"), at(9, 10)));
+    EXPECT_FALSE(detector.hasConflict(QLatin1String("review"), at(2, 10)));
+    EXPECT_EQ(detector.conflictsOn(QDate(2026, 3, 9)), 1);
+
+    // Moving the call to Monday the 16th only rechecks that neighbourhood
+    auto moved = std::make_shared<Core::CalendarEvent>(*call);
+    moved->startDateTime = at(16, 9);
+    moved->endDateTime = at(16, 11);
+    ASSERT_TRUE(backend.updateEvent(moved));
+    detector.eventChanged(backend, moved);
+    ASSERT_EQ(detector.conflicts().size(), 1);
+    EXPECT_EQ(detector.conflicts()[0].overlapStart(), at(16, 10));
+    EXPECT_FALSE(detector.hasConflict(QLatin1String("call"), at(9, 10)));
+    EXPECT_TRUE(detector.hasConflict(QLatin1String("call"), at(16, 9)));
+
+    ASSERT_TRUE(backend.deleteEvent(QLatin1String("call")));
+    detector.eventRemoved(QLatin1String("call"));
+    EXPECT_TRUE(detector.conflicts().isEmpty());
+}
+
 TEST_F(DirectoryBackendTest, DeleteCalendar)
 {
     Local::DirectoryBackend backend(dirPath);
@@ -139,6 +309,63 @@ TEST_F(DirectoryBackendTest, DeleteCalendar)
     EXPECT_FALSE(backend.getEvent(QLatin1String("temp-1")));
 }
 
+TEST_F(DirectoryBackendTest, ApplyBatchAcrossCalendars)
+{
+    {
+        Local::DirectoryBackend backend(dirPath);
+        backend.createCalendar(QLatin1String("work"), QLatin1String("Work"));
+        backend.createCalendar(QLatin1String("home"), QLatin1String("Home"));
+
+        auto meeting = createTestEvent(QLatin1String("meeting"), QLatin1String("Meeting"));
+        meeting->calendarId = QLatin1String("work");
+        auto dinner = createTestEvent(QLatin1String("dinner"), QLatin1String("Dinner"));
+        dinner->calendarId = QLatin1String("home");
+        EXPECT_TRUE(backend.applyBatch({Core::EventMutation::create(meeting), Core::EventMutation::create(dinner)}));
+
+        // Moving an event to another calendar is an update with a new calendarId
+        auto moved = createTestEvent(QLatin1String("meeting"), QLatin1String("Meeting at home"));
+        moved->calendarId = QLatin1String("home");
+        EXPECT_TRUE(backend.applyBatch({Core::EventMutation::update(moved)}));
+        EXPECT_EQ(backend.getEventsByCollection(QLatin1String("work")).size(), 0);
+        EXPECT_EQ(backend.getEventsByCollection(QLatin1String("home")).size(), 2);
+    }
+
+    Local::DirectoryBackend backend(dirPath);
+    EXPECT_EQ(backend.getEventsByCollection(QLatin1String("work")).size(), 0);
+    EXPECT_EQ(backend.getEvent(QLatin1String("meeting"))->title, QLatin1String("Meeting at home"));
+}
+
+TEST_F(DirectoryBackendTest, ApplyBatchRejectedAsAWhole)
+{
+    Local::DirectoryBackend backend(dirPath);
+    backend.createCalendar(QLatin1String("work"), QLatin1String("Work"));
+
+    QList<Core::EventMutation> batch;
+    batch.append(Core::EventMutation::create(createTestEvent(QLatin1String("a"), QLatin1String("A"))));
+    batch.append(Core::EventMutation::update(createTestEvent(QLatin1String("missing"), QLatin1String("B"))));
+    EXPECT_FALSE(backend.applyBatch(batch));
+    EXPECT_FALSE(backend.getEvent(QLatin1String("a")));
+}
+
+TEST_F(DirectoryBackendTest, DeleteWhereLimitedToCalendars)
+{
+    Local::DirectoryBackend backend(dirPath);
+    backend.createCalendar(QLatin1String("work"), QLatin1String("Work"));
+    backend.createCalendar(QLatin1String("home"), QLatin1String("Home"));
+
+    auto meeting = createTestEvent(QLatin1String("meeting"), QLatin1String("Cancelled"));
+    meeting->calendarId = QLatin1String("work");
+    auto dinner = createTestEvent(QLatin1String("dinner"), QLatin1String("Cancelled"));
+    dinner->calendarId = QLatin1String("home");
+    backend.createEvent(meeting);
+    backend.createEvent(dinner);
+
+    auto isCancelled = [](const Core::CalendarEvent &event) { return event.title == QLatin1String("Cancelled"); };
+    EXPECT_EQ(backend.deleteWhere(isCancelled, {QLatin1String("work")}), 1);
+    EXPECT_FALSE(backend.getEvent(QLatin1String("meeting")));
+    EXPECT_TRUE(backend.getEvent(QLatin1String("dinner")) != nullptr);
+}
+
 TEST_F(DirectoryBackendTest, GetEventsByDate)
 {
     Local::DirectoryBackend backend(dirPath);
@@ -214,6 +441,105 @@ TEST_F(DirectoryBackendTest, PersistenceAcrossInstances)
     }
 }
 
+TEST_F(DirectoryBackendTest, ModifyEventsLoadedFromDisk)
+{
+    {
+        Local::DirectoryBackend backend(dirPath);
+        backend.createCalendar(QLatin1String("work"), QLatin1String("Work"));
+        backend.createCalendar(QLatin1String("home"), QLatin1String("Home"));
+        auto meeting = createTestEvent(QLatin1String("meeting"), QLatin1String("Meeting"));
+        meeting->calendarId = QLatin1String("work");
+        auto dinner = createTestEvent(QLatin1String("dinner"), QLatin1String("Dinner"));
+        dinner->calendarId = QLatin1String("home");
+        backend.createEvent(meeting);
+        backend.createEvent(dinner);
+    }
+
+    Local::DirectoryBackend backend(dirPath);
+    auto dinner = backend.getEvent(QLatin1String("dinner"));
+    ASSERT_TRUE(dinner != nullptr);
+    EXPECT_EQ(dinner->calendarId, QLatin1String("home"));
+
+    auto renamed = createTestEvent(QLatin1String("meeting"), QLatin1String("Renamed"));
+    EXPECT_TRUE(backend.updateEvent(renamed));
+    EXPECT_TRUE(backend.deleteEvent(QLatin1String("dinner")));
+
+    EXPECT_TRUE(backend.sync());
+    EXPECT_EQ(backend.getEvent(QLatin1String("meeting"))->title, QLatin1String("Renamed"));
+    EXPECT_FALSE(backend.getEvent(QLatin1String("dinner")));
+}
+
+TEST_F(DirectoryBackendTest, ParallelLoadReportsProgress)
+{
+    {
+        Local::DirectoryBackend backend(dirPath);
+        for (int i = 0; i < 8; ++i) {
+            const QString id = QLatin1String("cal-") + QString::number(i);
+            backend.createCalendar(id, id);
+            auto event = createTestEvent(QLatin1String("event-") + QString::number(i), QLatin1String("Event"));
+            event->calendarId = id;
+            backend.createEvent(event);
+        }
+    }
+
+    QStringList reported;
+    int lastLoaded = 0;
+    Local::DirectoryBackend backend(dirPath, false, [&](int loaded, int total, const QString &calendarId) {
+        EXPECT_EQ(total, 8);
+        EXPECT_EQ(loaded, lastLoaded + 1);
+        lastLoaded = loaded;
+        reported.append(calendarId);
+    });
+
+    EXPECT_EQ(reported.size(), 8);
+    EXPECT_EQ(backend.getCalendarIds().size(), 8);
+    EXPECT_EQ(backend.getEvent(QLatin1String("event-5"))->calendarId, QLatin1String("cal-5"));
+    EXPECT_EQ(backend.getEventsByDate(QDate(2026, 1, 10)).size(), 8);
+}
+
+TEST_F(DirectoryBackendTest, LazyModeDefersHiddenCalendars)
+{
+    {
+        Local::DirectoryBackend backend(dirPath);
+        backend.createCalendar(QLatin1String("work"), QLatin1String("Work"));
+        backend.createCalendar(QLatin1String("archive"), QLatin1String("Archive"));
+
+        for (int year = 2010; year <= 2012; ++year) {
+            auto old = createTestEvent(QLatin1String("old-") + QString::number(year), QLatin1String("Old"));
+            old->startDateTime = QDateTime(QDate(year, 3, 1), QTime(9, 0));
+            old->endDateTime = QDateTime(QDate(year, 3, 1), QTime(10, 0));
+            old->calendarId = QLatin1String("archive");
+            backend.createEvent(old);
+        }
+        auto meeting = createTestEvent(QLatin1String("meeting"), QLatin1String("Meeting"));
+        meeting->calendarId = QLatin1String("work");
+        backend.createEvent(meeting);
+
+        backend.setCalendarVisibility(QLatin1String("archive"), false);
+    }
+
+    using LoadMode = Local::DirectoryBackend::LoadMode;
+    Local::DirectoryBackend backend(dirPath, false, nullptr, LoadMode::LazyHidden);
+    EXPECT_EQ(backend.getCalendarIds().size(), 2);
+    EXPECT_TRUE(backend.isCalendarLoaded(QLatin1String("work")));
+    EXPECT_FALSE(backend.isCalendarLoaded(QLatin1String("archive")));
+
+    // The summary is available without parsing the file
+    auto summary = backend.getCalendarSummary(QLatin1String("archive"));
+    EXPECT_EQ(summary.eventCount, 3);
+    EXPECT_EQ(summary.firstDate, QDate(2010, 3, 1));
+    EXPECT_EQ(summary.lastDate, QDate(2012, 3, 1));
+
+    EXPECT_EQ(backend.getEventsByDate(QDate(2026, 1, 10)).size(), 1);
+    EXPECT_FALSE(backend.isCalendarLoaded(QLatin1String("archive")));
+
+    // Addressing an archived event by UID loads its calendar
+    auto old = backend.getEvent(QLatin1String("old-2011"));
+    ASSERT_TRUE(old != nullptr);
+    EXPECT_EQ(old->calendarId, QLatin1String("archive"));
+    EXPECT_TRUE(backend.isCalendarLoaded(QLatin1String("archive")));
+}
+
 TEST_F(DirectoryBackendTest, Sync)
 {
     Local::DirectoryBackend backend(dirPath);
@@ -229,6 +555,178 @@ TEST_F(DirectoryBackendTest, Sync)
     EXPECT_TRUE(retrieved != nullptr);
 }
 
+TEST_F(DirectoryBackendTest, SyncReportsExternalChanges)
+{
+    Local::DirectoryBackend backend(dirPath);
+    backend.createCalendar(QLatin1String("work"), QLatin1String("Work"));
+    backend.createEvent(createTestEvent(QLatin1String("keep"), QLatin1String("Keep")));
+    backend.createEvent(createTestEvent(QLatin1String("edit"), QLatin1String("Edit")));
+    backend.createEvent(createTestEvent(QLatin1String("drop"), QLatin1String("Drop")));
+
+    QList<Local::DirectoryBackend::CalendarChanges> reported;
+    backend.setChangeCallback([&](const Local::DirectoryBackend::CalendarChanges &changes) {
+        reported.append(changes);
+    });
+
+    // Nothing changed on disk: nothing is reparsed or reported
+    EXPECT_TRUE(backend.sync());
+    EXPECT_TRUE(reported.isEmpty());
+
+    auto kept = backend.getEvent(QLatin1String("keep"));
+
+    // Another program edits the calendar and adds a new one
+    {
+        Local::ICSFileBackend external(dirPath + QLatin1String("/work.ics"));
+        external.updateEvent(createTestEvent(QLatin1String("edit"), QLatin1String("Edited elsewhere")));
+        external.deleteEvent(QLatin1String("drop"));
+        external.createEvent(createTestEvent(QLatin1String("new"), QLatin1String("New")));
+
+        Local::ICSFileBackend other(dirPath + QLatin1String("/shared.ics"));
+        other.createEvent(createTestEvent(QLatin1String("shared-1"), QLatin1String("Shared")));
+    }
+
+    EXPECT_TRUE(backend.sync());
+    ASSERT_EQ(reported.size(), 2);
+
+    EXPECT_EQ(reported[0].calendarId, QLatin1String("shared"));
+    EXPECT_TRUE(reported[0].calendarAdded);
+    EXPECT_EQ(reported[0].added, QStringList{QLatin1String("shared-1")});
+
+    EXPECT_EQ(reported[1].calendarId, QLatin1String("work"));
+    EXPECT_EQ(reported[1].added, QStringList{QLatin1String("new")});
+    EXPECT_EQ(reported[1].changed, QStringList{QLatin1String("edit")});
+    EXPECT_EQ(reported[1].removed, QStringList{QLatin1String("drop")});
+
+    // Unchanged events keep their instances
+    EXPECT_EQ(backend.getEvent(QLatin1String("keep")), kept);
+    EXPECT_EQ(backend.getEvent(QLatin1String("edit"))->title, QLatin1String("Edited elsewhere"));
+    EXPECT_EQ(backend.getEvent(QLatin1String("new"))->calendarId, QLatin1String("work"));
+    EXPECT_FALSE(backend.getEvent(QLatin1String("drop")));
+}
+
+TEST_F(DirectoryBackendTest, MetadataSurvivesCalendarFileRemoval)
+{
+    const QString file = dirPath + QLatin1String("/work.ics");
+    const QString moved = dirPath + QLatin1String("/work.bak");
+    {
+        Local::DirectoryBackend backend(dirPath);
+        backend.createCalendar(QLatin1String("work"), QLatin1String("Work"));
+        backend.setCalendarColor(QLatin1String("work"), QLatin1String("#FF5722"));
+        backend.createEvent(createTestEvent(QLatin1String("w-1"), QLatin1String("Standup")));
+
+        // The file disappears while the backend is running and comes back
+        ASSERT_TRUE(QFile::rename(file, moved));
+        EXPECT_TRUE(backend.sync());
+        EXPECT_FALSE(backend.getCalendarIds().contains(QLatin1String("work")));
+
+        ASSERT_TRUE(QFile::rename(moved, file));
+        EXPECT_TRUE(backend.sync());
+        ASSERT_TRUE(backend.getCalendarIds().contains(QLatin1String("work")));
+        EXPECT_EQ(backend.getCalendarName(QLatin1String("work")), QLatin1String("Work"));
+        EXPECT_EQ(backend.getCalendarColor(QLatin1String("work")), QLatin1String("#FF5722"));
+
+        ASSERT_TRUE(QFile::rename(file, moved));
+    }
+
+    // Started without the file, then the file is restored
+    {
+        Local::DirectoryBackend backend(dirPath);
+        EXPECT_TRUE(backend.getCalendarIds().isEmpty());
+    }
+    ASSERT_TRUE(QFile::rename(moved, file));
+    {
+        Local::DirectoryBackend backend(dirPath);
+        EXPECT_EQ(backend.getCalendarName(QLatin1String("work")), QLatin1String("Work"));
+        EXPECT_EQ(backend.getCalendarColor(QLatin1String("work")), QLatin1String("#FF5722"));
+        EXPECT_TRUE(backend.getEvent(QLatin1String("w-1")));
+
+        // An explicit delete forgets the calendar for good
+        EXPECT_TRUE(backend.deleteCalendar(QLatin1String("work")));
+    }
+    Local::ICSFileBackend restored(file);
+    restored.createEvent(createTestEvent(QLatin1String("w-2"), QLatin1String("Fresh")));
+
+    Local::DirectoryBackend backend(dirPath);
+    EXPECT_EQ(backend.getCalendarName(QLatin1String("work")), QLatin1String("work"));
+    EXPECT_TRUE(backend.getCalendarColor(QLatin1String("work")).isEmpty());
+}
+
+TEST_F(DirectoryBackendTest, PendingWritesLeaveTheBackendUntouched)
+{
+    const QString file = dirPath + QLatin1String("/work.ics");
+    Local::DirectoryBackend backend(dirPath);
+    backend.setDurability(Local::ICSFileBackend::Durability::Manual);
+    backend.createCalendar(QLatin1String("work"), QLatin1String("Work"));
+    backend.setCalendarColor(QLatin1String("work"), QLatin1String("#4CAF50"));
+    backend.createEvent(createTestEvent(QLatin1String("w-1"), QLatin1String("Review")));
+
+    auto writes = backend.takePendingWrites();
+    ASSERT_EQ(writes.size(), 2); // The calendar file and .calendars.json
+    EXPECT_TRUE(backend.takePendingWrites().isEmpty());
+    EXPECT_FALSE(Local::ICSFileBackend(file).getEvent(QLatin1String("w-1")));
+
+    // Written without the backend, as a caller would outside its lock
+    for (auto &write : writes) {
+        EXPECT_TRUE(Local::ICSFileBackend::writePending(write));
+    }
+    backend.finishPendingWrites(writes);
+    EXPECT_TRUE(backend.flush());
+
+    // Our own write is not mistaken for an external edit
+    QList<Local::DirectoryBackend::CalendarChanges> reported;
+    backend.setChangeCallback([&](const Local::DirectoryBackend::CalendarChanges &changes) {
+        reported.append(changes);
+    });
+    EXPECT_TRUE(backend.reloadCalendar(QLatin1String("work")));
+    EXPECT_TRUE(reported.isEmpty());
+
+    Local::DirectoryBackend reopened(dirPath);
+    EXPECT_TRUE(reopened.getEvent(QLatin1String("w-1")));
+    EXPECT_EQ(reopened.getCalendarColor(QLatin1String("work")), QLatin1String("#4CAF50"));
+}
+
+TEST_F(DirectoryBackendTest, TimerCallbacksGoThroughDispatcher)
+{
+    // GroupCommit 定时器需要事件循环
+    if (!QCoreApplication::instance()) {
+        static int argc = 1;
+        static char name[] = "local-backend-tests";
+        static char *argv[] = {name, nullptr};
+        static QCoreApplication app(argc, argv);
+    }
+
+    Local::DirectoryBackend backend(dirPath);
+    QList<std::function<void()>> queued;
+    backend.setCallbackDispatcher([&](std::function<void()> callback) { queued.append(std::move(callback)); });
+    backend.setDurability(Local::ICSFileBackend::Durability::GroupCommit);
+
+    backend.createCalendar(QLatin1String("work"), QLatin1String("Work"));
+    backend.createCalendar(QLatin1String("home"), QLatin1String("Home"));
+    auto work = createTestEvent(QLatin1String("w-1"), QLatin1String("Standup"));
+    work->calendarId = QLatin1String("work");
+    auto home = createTestEvent(QLatin1String("h-1"), QLatin1String("Dinner"));
+    home->calendarId = QLatin1String("home");
+    backend.createEvent(work);
+    backend.createEvent(home);
+
+    QDeadlineTimer deadline(5000);
+    while (queued.size() < 2 && !deadline.hasExpired()) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    ASSERT_EQ(queued.size(), 2);
+
+    // The timers fired, but nothing is written until the dispatcher runs the callbacks
+    EXPECT_FALSE(Local::ICSFileBackend(dirPath + QLatin1String("/work.ics")).getEvent(QLatin1String("w-1")));
+
+    // A callback of a calendar deleted in the meantime is dropped
+    backend.deleteCalendar(QLatin1String("home"));
+    for (const auto &callback : std::as_const(queued)) {
+        callback();
+    }
+    EXPECT_TRUE(Local::ICSFileBackend(dirPath + QLatin1String("/work.ics")).getEvent(QLatin1String("w-1")));
+    EXPECT_FALSE(QFile::exists(dirPath + QLatin1String("/home.ics")));
+}
+
 TEST_F(DirectoryBackendTest, IsOnline)
 {
     Local::DirectoryBackend backend(dirPath);
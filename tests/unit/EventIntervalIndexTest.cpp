@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "backends/local/EventIntervalIndex.h"
+#include <QHash>
+#include <algorithm>
+#include <gtest/gtest.h>
+
+using namespace PersonalCalendar;
+
+class EventIntervalIndexTest : public ::testing::Test
+{
+protected:
+    Core::CalendarEventPtr makeEvent(const QString &uid)
+    {
+        auto event = std::make_shared<Core::CalendarEvent>();
+        event->uid = uid;
+        event->title = uid;
+        return event;
+    }
+
+    Local::EventIntervalIndex index;
+};
+
+TEST_F(EventIntervalIndexTest, OverlappingQuery)
+{
+    index.insert(makeEvent(QLatin1String("a")), 1, 3);
+    index.insert(makeEvent(QLatin1String("b")), 5, 10);
+    index.insert(makeEvent(QLatin1String("c")), 2, 20);
+    index.insert(makeEvent(QLatin1String("d")), 15, 16);
+
+    auto result = index.overlapping(4, 6);
+    ASSERT_EQ(result.size(), 2);
+    EXPECT_EQ(result[0]->uid, QLatin1String("c")); // 按开始时间排序
+    EXPECT_EQ(result[1]->uid, QLatin1String("b"));
+
+    EXPECT_EQ(index.overlapping(0, 100).size(), 4);
+    EXPECT_TRUE(index.overlapping(21, 30).isEmpty());
+}
+
+TEST_F(EventIntervalIndexTest, StabbingQuery)
+{
+    index.insert(makeEvent(QLatin1String("a")), 1, 3);
+    index.insert(makeEvent(QLatin1String("b")), 3, 3);
+    index.insert(makeEvent(QLatin1String("c")), 4, 8);
+
+    auto result = index.stabbing(3);
+    ASSERT_EQ(result.size(), 2);
+    EXPECT_EQ(result[0]->uid, QLatin1String("a"));
+    EXPECT_EQ(result[1]->uid, QLatin1String("b"));
+}
+
+TEST_F(EventIntervalIndexTest, ReplaceAndRemove)
+{
+    auto event = makeEvent(QLatin1String("a"));
+    index.insert(event, 1, 2);
+    EXPECT_EQ(index.stabbing(1).size(), 1);
+
+    // 同一 UID 再次插入会替换原区间
+    index.insert(event, 10, 12);
+    EXPECT_EQ(index.size(), 1);
+    EXPECT_TRUE(index.stabbing(1).isEmpty());
+    EXPECT_EQ(index.stabbing(11).size(), 1);
+
+    index.remove(QLatin1String("a"));
+    EXPECT_EQ(index.size(), 0);
+    EXPECT_TRUE(index.stabbing(11).isEmpty());
+}
+
+TEST_F(EventIntervalIndexTest, ManyIntervals)
+{
+    for (int i = 0; i < 1000; ++i) {
+        index.insert(makeEvent(QString::number(i)), i, i + 9);
+    }
+
+    // 点 500 被 [491, 500] 到 [500, 509] 覆盖
+    EXPECT_EQ(index.stabbing(500).size(), 10);
+    EXPECT_EQ(index.overlapping(0, 0).size(), 1);
+    EXPECT_EQ(index.overlapping(1005, 2000).size(), 4);
+}
+
+TEST_F(EventIntervalIndexTest, InterleavedMutationsMatchScan)
+{
+    // 插入、替换、删除与查询交错进行，结果须与线性扫描一致
+    QHash<QString, std::pair<qint64, qint64>> expected;
+    quint32 seed = 12345;
+    auto next = [&seed](quint32 bound) {
+        seed = seed * 1103515245u + 12345u;
+        return static_cast<qint64>((seed >> 8) % bound);
+    };
+
+    for (int step = 0; step < 5000; ++step) {
+        const QString uid = QString::number(next(200));
+        switch (next(3)) {
+            case 0: {
+                const qint64 start = next(1000);
+                const qint64 end = start + next(40);
+                index.insert(makeEvent(uid), start, end);
+                expected.insert(uid, {start, end});
+                break;
+            }
+            case 1: {
+                index.remove(uid);
+                expected.remove(uid);
+                break;
+            }
+            default: {
+                const qint64 from = next(1050);
+                const qint64 to = from + next(60);
+                QList<std::pair<qint64, QString>> scan;
+                for (auto it = expected.constBegin(); it != expected.constEnd(); ++it) {
+                    if (it->first <= to && it->second >= from) {
+                        scan.append({it->first, it.key()});
+                    }
+                }
+                std::sort(scan.begin(), scan.end());
+
+                const auto result = index.overlapping(from, to);
+                ASSERT_EQ(result.size(), scan.size());
+                for (int i = 0; i < result.size(); ++i) {
+                    EXPECT_EQ(result[i]->uid, scan[i].second);
+                }
+                break;
+            }
+        }
+        ASSERT_EQ(index.size(), expected.size());
+    }
+}
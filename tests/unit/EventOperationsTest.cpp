@@ -0,0 +1,287 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "core/data/SynchronizedStorage.h"
+#include "core/operations/EventOperations.h"
+#include "core/operations/FutureAwaiter.h"
+#include <QCoreApplication>
+#include <QDeadlineTimer>
+#include <QHash>
+#include <QPromise>
+#include <QThread>
+#include <atomic>
+#include <coroutine>
+#include <gtest/gtest.h>
+
+using namespace PersonalCalendar::Core;
+
+namespace
+{
+
+/**
+ * @brief 记录调用线程和写入顺序的内存存储
+ */
+class RecordingStorage : public ICalendarStorage
+{
+public:
+    bool createEvent(const CalendarEventPtr &event) override
+    {
+        record(event->uid);
+        m_events[event->uid] = event;
+        return true;
+    }
+
+    CalendarEventPtr getEvent(const QString &uid) override { return m_events.value(uid); }
+
+    bool updateEvent(const CalendarEventPtr &event) override
+    {
+        record(event->uid);
+        m_events[event->uid] = event;
+        return true;
+    }
+
+    bool deleteEvent(const QString &uid) override
+    {
+        record(uid);
+        return m_events.remove(uid) > 0;
+    }
+
+    QList<CalendarEventPtr> getEventsByDate(const QDate &) override { return m_events.values(); }
+    QList<CalendarEventPtr> getEventsByDateRange(const QDate &, const QDate &) override { return m_events.values(); }
+    QList<CalendarEventPtr> getEventsByCollection(const QString &) override { return m_events.values(); }
+
+    QList<QString> getCalendarIds() override { return {QStringLiteral("personal")}; }
+    QString getCalendarName(const QString &id) override { return id; }
+    bool createCalendar(const QString &, const QString &) override { return true; }
+    bool deleteCalendar(const QString &) override { return true; }
+    QString getCalendarColor(const QString &) override { return QString(); }
+    void setCalendarColor(const QString &, const QString &) override {}
+    bool getCalendarVisibility(const QString &) override { return true; }
+    void setCalendarVisibility(const QString &, bool) override {}
+
+    bool sync() override { return true; }
+    bool isOnline() const override { return true; }
+    QString getLastSyncTime(const QString &) override { return QString(); }
+
+    QStringList writes;
+    QList<QThread *> writeThreads;
+
+private:
+    void record(const QString &uid)
+    {
+        writes.append(uid);
+        writeThreads.append(QThread::currentThread());
+    }
+
+    QHash<QString, CalendarEventPtr> m_events;
+};
+
+// 不保存句柄的协程，随 co_await 挂起和恢复
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+struct Outcome {
+    bool done = false;
+    QThread *resumedOn = nullptr;
+    QString fetchedTitle;
+    QString error;
+};
+
+Detached createAndFetch(EventOperations &operations, CalendarEventPtr event, Outcome &outcome)
+{
+    const OperationResult<CalendarEventPtr> created = co_await operations.createEventAsync(event);
+    outcome.resumedOn = QThread::currentThread();
+    if (!created.ok()) {
+        co_return;
+    }
+
+    const OperationResult<CalendarEventPtr> fetched = co_await operations.getEventAsync(created.value->uid);
+    outcome.fetchedTitle = fetched.ok() ? fetched.value->title : QString();
+    outcome.done = true;
+}
+
+Detached awaitResult(QFuture<OperationResult<int>> future, Outcome &outcome)
+{
+    const OperationResult<int> result = co_await future;
+    outcome.error = result.error;
+    outcome.done = true;
+}
+
+} // namespace
+
+class EventOperationsTest : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        // 回调经由事件队列投递，需要一个事件循环
+        if (!QCoreApplication::instance()) {
+            static int argc = 1;
+            static char name[] = "core-unit-tests";
+            static char *argv[] = {name, nullptr};
+            s_app = new QCoreApplication(argc, argv);
+        }
+    }
+
+    static void TearDownTestSuite()
+    {
+        delete s_app;
+        s_app = nullptr;
+    }
+
+    void SetUp() override
+    {
+        backend = std::make_shared<RecordingStorage>();
+        executor = std::make_shared<StorageExecutor>();
+    }
+
+    static CalendarEventPtr makeEvent(const QString &uid)
+    {
+        auto event = std::make_shared<CalendarEvent>();
+        event->uid = uid;
+        event->title = QStringLiteral("Event ") + uid;
+        event->startDateTime = QDateTime(QDate(2026, 3, 2), QTime(9, 0));
+        event->endDateTime = QDateTime(QDate(2026, 3, 2), QTime(10, 0));
+        return event;
+    }
+
+    static bool waitFor(const std::function<bool()> &done)
+    {
+        QDeadlineTimer deadline(5000);
+        while (!done() && !deadline.hasExpired()) {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+        }
+        return done();
+    }
+
+    static inline QCoreApplication *s_app = nullptr;
+
+    std::shared_ptr<RecordingStorage> backend;
+    std::shared_ptr<StorageExecutor> executor;
+};
+
+TEST_F(EventOperationsTest, WithoutExecutorRunsInline)
+{
+    EventOperations operations(backend);
+
+    bool called = false;
+    operations.createEvent(makeEvent(QStringLiteral("a")), [&](const CalendarEventPtr &) { called = true; }, nullptr);
+    EXPECT_TRUE(called);
+    EXPECT_EQ(backend->writeThreads.value(0), QThread::currentThread());
+
+    auto future = operations.getEventAsync(QStringLiteral("missing"));
+    ASSERT_TRUE(future.isFinished());
+    EXPECT_EQ(future.result().error, QLatin1String("Event not found"));
+}
+
+TEST_F(EventOperationsTest, WritesRunOnWorkerInOrder)
+{
+    EventOperations operations(std::make_shared<SynchronizedStorage>(backend), executor);
+
+    QStringList completed;
+    QList<QThread *> callbackThreads;
+    auto onSuccess = [&](const CalendarEventPtr &event) {
+        completed.append(event->uid);
+        callbackThreads.append(QThread::currentThread());
+    };
+
+    operations.createEvent(makeEvent(QStringLiteral("a")), onSuccess, nullptr);
+    operations.createEvent(makeEvent(QStringLiteral("b")), onSuccess, nullptr);
+    operations.updateEvent(makeEvent(QStringLiteral("a")), onSuccess, nullptr);
+    operations.deleteEvent(QStringLiteral("b"), onSuccess, nullptr);
+
+    // 回调只在调用线程的事件循环中执行
+    EXPECT_TRUE(completed.isEmpty());
+    ASSERT_TRUE(waitFor([&]() { return completed.size() == 4; }));
+
+    const QStringList expected = {QStringLiteral("a"), QStringLiteral("b"), QStringLiteral("a"), QStringLiteral("b")};
+    EXPECT_EQ(completed, expected);
+    EXPECT_EQ(backend->writes, expected);
+    for (QThread *thread : std::as_const(backend->writeThreads)) {
+        EXPECT_NE(thread, QThread::currentThread());
+    }
+    for (QThread *thread : std::as_const(callbackThreads)) {
+        EXPECT_EQ(thread, QThread::currentThread());
+    }
+}
+
+TEST_F(EventOperationsTest, WriteHookRunsOutsideTheLock)
+{
+    auto storage = std::make_shared<SynchronizedStorage>(backend);
+    EventOperations operations(storage, executor);
+
+    // 钩子内的查询需要同一把锁：钩子在锁内执行会死锁
+    std::atomic<int> seen = 0;
+    storage->setWriteHook([&]() {
+        if (storage->getEvent(QStringLiteral("a"))) {
+            ++seen;
+        }
+    });
+
+    bool done = false;
+    operations.createEvent(makeEvent(QStringLiteral("a")), [&](const CalendarEventPtr &) { done = true; }, nullptr);
+    ASSERT_TRUE(waitFor([&]() { return done; }));
+    EXPECT_EQ(seen.load(), 1);
+}
+
+TEST_F(EventOperationsTest, ValidationErrorsAreDeliveredAsynchronously)
+{
+    EventOperations operations(backend, executor);
+
+    QString error;
+    operations.createEvent(nullptr, nullptr, [&](const QString &message) { error = message; });
+    EXPECT_TRUE(error.isEmpty());
+    ASSERT_TRUE(waitFor([&]() { return !error.isEmpty(); }));
+    EXPECT_EQ(error, QLatin1String("Event is nullptr"));
+    EXPECT_TRUE(backend->writes.isEmpty());
+}
+
+TEST_F(EventOperationsTest, CoAwaitResumesOnCallerThread)
+{
+    EventOperations operations(std::make_shared<SynchronizedStorage>(backend), executor);
+
+    Outcome outcome;
+    createAndFetch(operations, makeEvent(QStringLiteral("a")), outcome);
+    EXPECT_FALSE(outcome.done);
+
+    ASSERT_TRUE(waitFor([&]() { return outcome.done; }));
+    EXPECT_EQ(outcome.resumedOn, QThread::currentThread());
+    EXPECT_EQ(outcome.fetchedTitle, QLatin1String("Event a"));
+    EXPECT_NE(backend->writeThreads.value(0), QThread::currentThread());
+}
+
+TEST_F(EventOperationsTest, CoAwaitResumesOnCancellation)
+{
+    auto promise = std::make_unique<QPromise<OperationResult<int>>>();
+    promise->start();
+
+    Outcome outcome;
+    awaitResult(promise->future(), outcome);
+    EXPECT_FALSE(outcome.done);
+
+    // 未完成就销毁的 QPromise 会取消它的 future
+    promise.reset();
+    ASSERT_TRUE(waitFor([&]() { return outcome.done; }));
+    EXPECT_FALSE(outcome.error.isEmpty());
+}
+
+TEST_F(EventOperationsTest, ExecutorDrainsQueueOnDestruction)
+{
+    std::atomic<int> ran = 0;
+    for (int i = 0; i < 100; ++i) {
+        executor->post([&ran]() { ++ran; });
+    }
+    QFuture<int> last = executor->run([&ran]() { return ran.load(); });
+
+    executor.reset();
+    EXPECT_EQ(ran.load(), 100);
+    ASSERT_TRUE(last.isFinished());
+    EXPECT_EQ(last.result(), 100);
+}
@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "backends/local/EventTable.h"
+#include <QTimeZone>
+#include <gtest/gtest.h>
+
+using namespace PersonalCalendar;
+
+class EventTableTest : public ::testing::Test
+{
+protected:
+    Core::CalendarEventPtr makeEvent(const QString &uid, int startHour, int endHour)
+    {
+        auto event = std::make_shared<Core::CalendarEvent>();
+        event->uid = uid;
+        event->title = uid;
+        event->startDateTime = QDateTime(QDate(2026, 1, 10), QTime(startHour, 0), QTimeZone::UTC);
+        event->endDateTime = QDateTime(QDate(2026, 1, 10), QTime(endHour, 0), QTimeZone::UTC);
+        return event;
+    }
+
+    qint64 at(int hour) const { return QDateTime(QDate(2026, 1, 10), QTime(hour, 0), QTimeZone::UTC).toSecsSinceEpoch(); }
+
+    Local::EventTable table;
+};
+
+TEST_F(EventTableTest, OverlappingIsHalfOpen)
+{
+    table.insert(makeEvent(QLatin1String("late"), 14, 16));
+    table.insert(makeEvent(QLatin1String("early"), 9, 10));
+    table.insert(makeEvent(QLatin1String("point"), 12, 12));
+
+    auto result = table.overlapping(at(10), at(15));
+    ASSERT_EQ(result.size(), 2);
+    EXPECT_EQ(result[0]->uid, QLatin1String("point")); // 按开始时间排序
+    EXPECT_EQ(result[1]->uid, QLatin1String("late"));
+
+    EXPECT_TRUE(table.overlapping(at(16), at(18)).isEmpty());
+    EXPECT_EQ(table.overlapping(at(12), at(12) + 1).size(), 1);
+}
+
+TEST_F(EventTableTest, FlagFilters)
+{
+    auto cancelled = makeEvent(QLatin1String("cancelled"), 9, 10);
+    cancelled->status = Core::EventStatus::Cancelled;
+    auto recurring = makeEvent(QLatin1String("recurring"), 9, 10);
+    recurring->recurrence.pattern = Core::Recurrence::Pattern::Daily;
+    table.insert(cancelled);
+    table.insert(recurring);
+    table.insert(makeEvent(QLatin1String("plain"), 9, 10));
+
+    EXPECT_EQ(table.overlapping(at(0), at(23)).size(), 3);
+    EXPECT_EQ(table.overlapping(at(0), at(23), Local::EventTable::Cancelled).size(), 2);
+
+    auto series = table.overlapping(at(0), at(23), 0, Local::EventTable::Recurring);
+    ASSERT_EQ(series.size(), 1);
+    EXPECT_EQ(series[0]->uid, QLatin1String("recurring"));
+}
+
+TEST_F(EventTableTest, ReplaceAndRemoveAcrossBlocks)
+{
+    // Enough rows to span several scan blocks
+    for (int i = 0; i < 1000; ++i) {
+        table.insert(makeEvent(QLatin1String("e") + QString::number(i), i % 2 ? 9 : 20, i % 2 ? 10 : 21));
+    }
+    EXPECT_EQ(table.overlapping(at(9), at(10)).size(), 500);
+
+    // Removal moves the last row into the hole; it must stay findable
+    table.remove(QLatin1String("e1"));
+    table.remove(QLatin1String("e999"));
+    table.insert(makeEvent(QLatin1String("e997"), 20, 21));
+    EXPECT_EQ(table.size(), 998);
+    EXPECT_EQ(table.overlapping(at(9), at(10)).size(), 497);
+
+    table.remove(QLatin1String("e997"));
+    EXPECT_EQ(table.size(), 997);
+    EXPECT_EQ(table.overlapping(at(20), at(21)).size(), 500);
+}
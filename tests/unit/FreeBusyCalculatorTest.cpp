@@ -0,0 +1,121 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "core/utils/FreeBusyCalculator.h"
+#include <QTimeZone>
+#include <gtest/gtest.h>
+
+using namespace PersonalCalendar::Core;
+
+namespace
+{
+constexpr auto Busy = BusyPeriod::Type::Busy;
+constexpr auto Tentative = BusyPeriod::Type::Tentative;
+} // namespace
+
+TEST(FreeBusyCalculatorTest, MergesOverlappingAndAdjacent)
+{
+    const std::vector<BusyPeriod> periods = {
+        {30, 50, Busy},
+        {10, 20, Busy},
+        {20, 25, Busy}, // touches the previous one
+        {40, 60, Busy},
+        {70, 70, Busy}, // zero length
+    };
+    EXPECT_EQ(FreeBusyCalculator::merge(periods, 0, 100),
+              (QList<BusyPeriod>{{10, 25, Busy}, {30, 60, Busy}}));
+}
+
+TEST(FreeBusyCalculatorTest, BusyWinsOverTentative)
+{
+    const std::vector<BusyPeriod> periods = {
+        {10, 50, Tentative},
+        {20, 30, Busy},
+        {45, 60, Busy},
+        {55, 70, Tentative},
+    };
+    EXPECT_EQ(FreeBusyCalculator::merge(periods, 0, 100),
+              (QList<BusyPeriod>{{10, 20, Tentative}, {20, 30, Busy}, {30, 45, Tentative}, {45, 60, Busy},
+                                 {60, 70, Tentative}}));
+}
+
+TEST(FreeBusyCalculatorTest, ClampsToWindow)
+{
+    const std::vector<BusyPeriod> periods = {{0, 15, Busy}, {90, 200, Tentative}, {200, 300, Busy}};
+    EXPECT_EQ(FreeBusyCalculator::merge(periods, 10, 100), (QList<BusyPeriod>{{10, 15, Busy}, {90, 100, Tentative}}));
+}
+
+TEST(FreeBusyCalculatorTest, BusyTypeFollowsStatusAndAttendee)
+{
+    CalendarEvent event;
+    FreeBusyQuery query;
+    EXPECT_EQ(FreeBusyCalculator::busyType(event, query), Busy);
+
+    event.status = EventStatus::Tentative;
+    EXPECT_EQ(FreeBusyCalculator::busyType(event, query), Tentative);
+
+    event.status = EventStatus::Cancelled;
+    EXPECT_FALSE(FreeBusyCalculator::busyType(event, query));
+
+    event.status = EventStatus::Confirmed;
+    event.isAllDay = true;
+    EXPECT_FALSE(FreeBusyCalculator::busyType(event, query));
+    query.includeAllDay = true;
+    EXPECT_EQ(FreeBusyCalculator::busyType(event, query), Busy);
+
+    event.attendees.append(
+        {QString(), QString(), QLatin1String("ann@example.com"), QString(), QLatin1String("DECLINED")});
+    event.attendees.append(
+        {QString(), QString(), QLatin1String("bob@example.com"), QString(), QLatin1String("ACCEPTED")});
+    event.attendees.append({QString(), QString(), QLatin1String("cat@example.com"), QString(), QString()});
+    query.attendee = QLatin1String("Ann@Example.com");
+    EXPECT_FALSE(FreeBusyCalculator::busyType(event, query));
+    query.attendee = QLatin1String("bob@example.com");
+    EXPECT_EQ(FreeBusyCalculator::busyType(event, query), Busy);
+    query.attendee = QLatin1String("cat@example.com");
+    EXPECT_EQ(FreeBusyCalculator::busyType(event, query), Tentative);
+}
+
+TEST(FreeBusyCalculatorTest, WorkingIntervals)
+{
+    const auto at = [](int day, int hour) {
+        return QDateTime(QDate(2026, 1, day), QTime(hour, 0), QTimeZone::UTC).toSecsSinceEpoch();
+    };
+
+    // Friday 2026-01-09 noon to Tuesday 2026-01-13 noon
+    const auto office =
+        FreeBusyCalculator::workingIntervals(WorkingHours::officeHours(), QTimeZone::UTC, at(9, 12), at(13, 12));
+    EXPECT_EQ(office, (std::vector<std::pair<qint64, qint64>>{
+                          {at(9, 12), at(9, 17)}, {at(12, 9), at(12, 17)}, {at(13, 9), at(13, 12)}}));
+
+    // Night shift crossing midnight; the one starting the day before reaches into the window
+    const WorkingHours night{QTime(22, 0), QTime(6, 0), {}};
+    const auto nights = FreeBusyCalculator::workingIntervals(night, QTimeZone::UTC, at(10, 0), at(11, 0));
+    EXPECT_EQ(nights, (std::vector<std::pair<qint64, qint64>>{{at(10, 0), at(10, 6)}, {at(10, 22), at(11, 0)}}));
+
+    EXPECT_EQ(FreeBusyCalculator::workingIntervals(WorkingHours(), QTimeZone::UTC, at(10, 0), at(11, 0)),
+              (std::vector<std::pair<qint64, qint64>>{{at(10, 0), at(11, 0)}}));
+}
+
+TEST(FreeBusyCalculatorTest, ComputeFromOccurrences)
+{
+    auto meeting = std::make_shared<CalendarEvent>();
+    auto cancelled = std::make_shared<CalendarEvent>();
+    cancelled->status = EventStatus::Cancelled;
+
+    const QDateTime nine(QDate(2026, 3, 2), QTime(9, 0), QTimeZone::UTC);
+    const QList<EventOccurrence> occurrences = {
+        EventOccurrence(meeting, nine, nine.addSecs(3600)),
+        EventOccurrence(cancelled, nine.addSecs(7200), nine.addSecs(10800)),
+        EventOccurrence(meeting, nine.addSecs(1800), nine.addSecs(5400)),
+    };
+
+    FreeBusyQuery query;
+    query.start = QDateTime(QDate(2026, 3, 2), QTime(0, 0), QTimeZone::UTC);
+    query.end = query.start.addDays(1);
+
+    const FreeBusy freeBusy = FreeBusyCalculator::compute(occurrences, query);
+    ASSERT_EQ(freeBusy.periods.size(), 1);
+    EXPECT_EQ(freeBusy.periods[0].startDateTime(), nine);
+    EXPECT_EQ(freeBusy.periods[0].endDateTime(), nine.addSecs(5400));
+}
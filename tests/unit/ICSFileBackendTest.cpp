@@ -117,6 +117,78 @@ TEST_F(ICSFileBackendTest, GetEventsByDateRange)
     EXPECT_EQ(events.size(), 2);
 }
 
+TEST_F(ICSFileBackendTest, MultiDayEventIndexed)
+{
+    Local::ICSFileBackend backend(filePath);
+
+    auto event = createTestEvent(QLatin1String("trip"), QLatin1String("Trip"));
+    event->startDateTime = QDateTime(QDate(2026, 2, 1), QTime(9, 0));
+    event->endDateTime = QDateTime(QDate(2026, 2, 5), QTime(18, 0));
+    backend.createEvent(event);
+
+    EXPECT_EQ(backend.getEventsByDate(QDate(2026, 2, 3)).size(), 1);
+    EXPECT_EQ(backend.getEventsByDateRange(QDate(2026, 1, 20), QDate(2026, 2, 1)).size(), 1);
+    EXPECT_TRUE(backend.getEventsByDate(QDate(2026, 2, 6)).isEmpty());
+
+    // 更新后索引应跟随新的时间范围
+    event->startDateTime = QDateTime(QDate(2026, 3, 1), QTime(9, 0));
+    event->endDateTime = QDateTime(QDate(2026, 3, 1), QTime(10, 0));
+    backend.updateEvent(event);
+
+    EXPECT_TRUE(backend.getEventsByDate(QDate(2026, 2, 3)).isEmpty());
+    EXPECT_EQ(backend.getEventsByDate(QDate(2026, 3, 1)).size(), 1);
+}
+
+TEST_F(ICSFileBackendTest, ExclusiveEndsStayOffTheNextDay)
+{
+    // DTEND is exclusive: all-day ends and timed ends at midnight do not occupy their end day
+    QFile file(filePath);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("BEGIN:VCALENDAR\r\n"
+               "BEGIN:VEVENT\r\n"
+               "UID:holiday\r\n"
+               "SUMMARY:Holiday\r\n"
+               "DTSTART;VALUE=DATE:20260501\r\n"
+               "DTEND;VALUE=DATE:20260502\r\n"
+               "END:VEVENT\r\n"
+               "BEGIN:VEVENT\r\n"
+               "UID:weekly\r\n"
+               "SUMMARY:Weekly\r\n"
+               "DTSTART;VALUE=DATE:20260504\r\n"
+               "DTEND;VALUE=DATE:20260505\r\n"
+               "RRULE:FREQ=WEEKLY;COUNT=3\r\n"
+               "END:VEVENT\r\n"
+               "BEGIN:VEVENT\r\n"
+               "UID:late\r\n"
+               "SUMMARY:Late\r\n"
+               "DTSTART:20260506T220000\r\n"
+               "DTEND:20260507T000000\r\n"
+               "END:VEVENT\r\n"
+               "END:VCALENDAR\r\n");
+    file.close();
+
+    Local::ICSFileBackend backend(filePath);
+    EXPECT_EQ(backend.getEventsByDate(QDate(2026, 5, 1)).size(), 1);
+    EXPECT_TRUE(backend.getEventsByDate(QDate(2026, 5, 2)).isEmpty());
+    EXPECT_TRUE(backend.getOccurrencesByDateRange(QDate(2026, 5, 2), QDate(2026, 5, 2)).isEmpty());
+
+    EXPECT_TRUE(backend.getOccurrencesByDateRange(QDate(2026, 5, 5), QDate(2026, 5, 5)).isEmpty());
+    EXPECT_EQ(backend.getOccurrencesByDateRange(QDate(2026, 5, 11), QDate(2026, 5, 11)).size(), 1);
+
+    EXPECT_EQ(backend.getEventsByDate(QDate(2026, 5, 6)).size(), 1);
+    EXPECT_TRUE(backend.getEventsByDate(QDate(2026, 5, 7)).isEmpty());
+}
+
+TEST_F(ICSFileBackendTest, GetEventsAt)
+{
+    Local::ICSFileBackend backend(filePath);
+    backend.createEvent(createTestEvent(QLatin1String("event-12"), QLatin1String("Standup")));
+
+    EXPECT_EQ(backend.getEventsAt(QDateTime(QDate(2026, 1, 10), QTime(10, 30))).size(), 1);
+    EXPECT_TRUE(backend.getEventsAt(QDateTime(QDate(2026, 1, 10), QTime(11, 0))).isEmpty());
+    EXPECT_TRUE(backend.getEventsAt(QDateTime(QDate(2026, 1, 10), QTime(9, 59))).isEmpty());
+}
+
 TEST_F(ICSFileBackendTest, CalendarIds)
 {
     Local::ICSFileBackend backend(filePath);
@@ -167,7 +239,236 @@ TEST_F(ICSFileBackendTest, PersistenceAcrossInstances)
         auto retrieved = backend.getEvent(QLatin1String("event-10"));
         EXPECT_TRUE(retrieved != nullptr);
         EXPECT_EQ(retrieved->title, QLatin1String("Persistent"));
+        EXPECT_EQ(retrieved->startDateTime, QDateTime(QDate(2026, 1, 10), QTime(10, 0)));
+        EXPECT_EQ(retrieved->endDateTime, QDateTime(QDate(2026, 1, 10), QTime(11, 0)));
+    }
+}
+
+TEST_F(ICSFileBackendTest, ManualDurabilityDefersWrites)
+{
+    {
+        Local::ICSFileBackend backend(filePath);
+        backend.setDurability(Local::ICSFileBackend::Durability::Manual);
+
+        for (int i = 0; i < 100; ++i) {
+            EXPECT_TRUE(backend.createEvent(
+                createTestEvent(QLatin1String("bulk-") + QString::number(i), QLatin1String("Bulk"))));
+        }
+        EXPECT_TRUE(backend.isDirty());
+
+        // 未刷新前磁盘上还没有任何事件
+        Local::ICSFileBackend reader(filePath);
+        EXPECT_FALSE(reader.getEvent(QLatin1String("bulk-0")));
+
+        EXPECT_TRUE(backend.flush());
+        EXPECT_FALSE(backend.isDirty());
+    }
+
+    Local::ICSFileBackend backend(filePath);
+    EXPECT_TRUE(backend.getEvent(QLatin1String("bulk-99")) != nullptr);
+}
+
+TEST_F(ICSFileBackendTest, PendingChangesFlushedOnDestruction)
+{
+    {
+        Local::ICSFileBackend backend(filePath);
+        backend.setDurability(Local::ICSFileBackend::Durability::GroupCommit);
+        backend.createEvent(createTestEvent(QLatin1String("deferred"), QLatin1String("Deferred")));
+        EXPECT_TRUE(backend.isDirty());
     }
+
+    Local::ICSFileBackend backend(filePath);
+    EXPECT_TRUE(backend.getEvent(QLatin1String("deferred")) != nullptr);
+}
+
+TEST_F(ICSFileBackendTest, ApplyBatch)
+{
+    Local::ICSFileBackend backend(filePath);
+    backend.createEvent(createTestEvent(QLatin1String("old"), QLatin1String("Old")));
+
+    auto renamed = createTestEvent(QLatin1String("new-1"), QLatin1String("Renamed"));
+    QList<Core::EventMutation> batch;
+    batch.append(Core::EventMutation::create(createTestEvent(QLatin1String("new-1"), QLatin1String("New 1"))));
+    batch.append(Core::EventMutation::create(createTestEvent(QLatin1String("new-2"), QLatin1String("New 2"))));
+    batch.append(Core::EventMutation::update(renamed));
+    batch.append(Core::EventMutation::remove(QLatin1String("old")));
+    EXPECT_TRUE(backend.applyBatch(batch));
+
+    Local::ICSFileBackend reader(filePath);
+    EXPECT_FALSE(reader.getEvent(QLatin1String("old")));
+    EXPECT_EQ(reader.getEvent(QLatin1String("new-1"))->title, QLatin1String("Renamed"));
+    EXPECT_TRUE(reader.getEvent(QLatin1String("new-2")) != nullptr);
+    EXPECT_EQ(reader.getEventsByDate(QDate(2026, 1, 10)).size(), 2);
+}
+
+TEST_F(ICSFileBackendTest, ApplyBatchIsAllOrNothing)
+{
+    Local::ICSFileBackend backend(filePath);
+    backend.createEvent(createTestEvent(QLatin1String("keep"), QLatin1String("Keep")));
+
+    QList<Core::EventMutation> batch;
+    batch.append(Core::EventMutation::create(createTestEvent(QLatin1String("fresh"), QLatin1String("Fresh"))));
+    batch.append(Core::EventMutation::remove(QLatin1String("keep")));
+    batch.append(Core::EventMutation::remove(QLatin1String("missing")));
+    EXPECT_FALSE(backend.applyBatch(batch));
+
+    EXPECT_FALSE(backend.getEvent(QLatin1String("fresh")));
+    EXPECT_TRUE(backend.getEvent(QLatin1String("keep")) != nullptr);
+    EXPECT_EQ(backend.getEventsByDate(QDate(2026, 1, 10)).size(), 1);
+}
+
+TEST_F(ICSFileBackendTest, PurgeBefore)
+{
+    {
+        Local::ICSFileBackend backend(filePath);
+        for (int year = 2016; year <= 2025; ++year) {
+            auto event = createTestEvent(QLatin1String("old-") + QString::number(year), QLatin1String("Old"));
+            event->startDateTime = QDateTime(QDate(year, 6, 1), QTime(9, 0));
+            event->endDateTime = QDateTime(QDate(year, 6, 1), QTime(10, 0));
+            backend.createEvent(event);
+        }
+
+        // Weekly series that ended in 2019 and one that never ends
+        auto ended = createTestEvent(QLatin1String("ended-series"), QLatin1String("Ended"));
+        ended->startDateTime = QDateTime(QDate(2018, 1, 1), QTime(9, 0));
+        ended->endDateTime = QDateTime(QDate(2018, 1, 1), QTime(10, 0));
+        ended->recurrence.pattern = Core::Recurrence::Pattern::Weekly;
+        ended->recurrence.endDate = QDate(2019, 12, 30);
+        backend.createEvent(ended);
+
+        auto endless = createTestEvent(QLatin1String("endless-series"), QLatin1String("Endless"));
+        endless->startDateTime = QDateTime(QDate(2018, 1, 1), QTime(9, 0));
+        endless->endDateTime = QDateTime(QDate(2018, 1, 1), QTime(10, 0));
+        endless->recurrence.pattern = Core::Recurrence::Pattern::Weekly;
+        backend.createEvent(endless);
+
+        // Started in 2018 but has an extra instance after the cutoff
+        auto moved = createTestEvent(QLatin1String("rdate-only"), QLatin1String("Moved"));
+        moved->startDateTime = QDateTime(QDate(2018, 3, 1), QTime(9, 0));
+        moved->endDateTime = QDateTime(QDate(2018, 3, 1), QTime(10, 0));
+        moved->recurrenceDates.append(QDateTime(QDate(2021, 3, 1), QTime(9, 0)));
+        backend.createEvent(moved);
+
+        EXPECT_EQ(backend.purgeBefore(QDate(2020, 1, 1)), 5);
+        EXPECT_EQ(backend.purgeBefore(QDate(2020, 1, 1), {QLatin1String("other")}), 0);
+    }
+
+    Local::ICSFileBackend backend(filePath);
+    EXPECT_FALSE(backend.getEvent(QLatin1String("old-2019")));
+    EXPECT_FALSE(backend.getEvent(QLatin1String("ended-series")));
+    EXPECT_TRUE(backend.getEvent(QLatin1String("old-2020")) != nullptr);
+    EXPECT_TRUE(backend.getEvent(QLatin1String("endless-series")) != nullptr);
+    EXPECT_TRUE(backend.getEvent(QLatin1String("rdate-only")) != nullptr);
+    EXPECT_EQ(backend.getEventsByCollection(QLatin1String("local")).size(), 8);
+}
+
+TEST_F(ICSFileBackendTest, OccurrencesOfOldSeries)
+{
+    Local::ICSFileBackend backend(filePath);
+    auto series = createTestEvent(QLatin1String("weekly"), QLatin1String("Weekly"));
+    series->startDateTime = QDateTime(QDate(2019, 1, 7), QTime(9, 0));
+    series->endDateTime = QDateTime(QDate(2019, 1, 7), QTime(10, 0));
+    series->recurrence.pattern = Core::Recurrence::Pattern::Weekly;
+    backend.createEvent(series);
+    backend.createEvent(createTestEvent(QLatin1String("single"), QLatin1String("Single")));
+
+    // 2026-01-05 is a Monday; the range covers two instances plus the single event
+    auto occurrences = backend.getOccurrencesByDateRange(QDate(2026, 1, 5), QDate(2026, 1, 12));
+    ASSERT_EQ(occurrences.size(), 3);
+    EXPECT_EQ(occurrences[0].event, backend.getEvent(QLatin1String("weekly")));
+    EXPECT_EQ(occurrences[0].start, QDateTime(QDate(2026, 1, 5), QTime(9, 0)));
+    EXPECT_EQ(occurrences[0].end, QDateTime(QDate(2026, 1, 5), QTime(10, 0)));
+    EXPECT_TRUE(occurrences[0].isRecurring());
+    EXPECT_EQ(occurrences[1].event->uid, QLatin1String("single"));
+    EXPECT_EQ(occurrences[2].start, QDateTime(QDate(2026, 1, 12), QTime(9, 0)));
+
+    // Same query again is served from the cache and must still see updates
+    auto moved = std::make_shared<Core::CalendarEvent>(*series);
+    moved->startDateTime = QDateTime(QDate(2019, 1, 8), QTime(14, 0));
+    moved->endDateTime = QDateTime(QDate(2019, 1, 8), QTime(15, 0));
+    ASSERT_TRUE(backend.updateEvent(moved));
+
+    occurrences = backend.getOccurrencesByDateRange(QDate(2026, 1, 5), QDate(2026, 1, 12));
+    ASSERT_EQ(occurrences.size(), 2);
+    EXPECT_EQ(occurrences[0].start, QDateTime(QDate(2026, 1, 6), QTime(14, 0)));
+    EXPECT_EQ(occurrences[1].event->uid, QLatin1String("single"));
+}
+
+TEST_F(ICSFileBackendTest, OccurrencesFilteredByCategory)
+{
+    Local::ICSFileBackend backend(filePath);
+    auto series = createTestEvent(QLatin1String("weekly"), QLatin1String("Weekly"));
+    series->startDateTime = QDateTime(QDate(2026, 1, 5), QTime(9, 0));
+    series->endDateTime = QDateTime(QDate(2026, 1, 5), QTime(10, 0));
+    series->recurrence.pattern = Core::Recurrence::Pattern::Weekly;
+    series->categories = {QLatin1String("work")};
+    backend.createEvent(series);
+
+    auto single = createTestEvent(QLatin1String("single"), QLatin1String("Single"));
+    single->categories = {QLatin1String("home")};
+    backend.createEvent(single);
+    backend.createEvent(createTestEvent(QLatin1String("plain"), QLatin1String("Plain")));
+
+    auto occurrences = backend.getOccurrencesWithCategories(QDate(2026, 1, 5), QDate(2026, 1, 12), {QLatin1String("work")});
+    ASSERT_EQ(occurrences.size(), 2);
+    EXPECT_EQ(occurrences[0].event->uid, QLatin1String("weekly"));
+    EXPECT_EQ(occurrences[1].start, QDateTime(QDate(2026, 1, 12), QTime(9, 0)));
+
+    auto events = backend.getEventsWithCategories(QDate(2026, 1, 1), QDate(2026, 1, 31),
+                                                  {QLatin1String("home"), QLatin1String("unknown")});
+    ASSERT_EQ(events.size(), 1);
+    EXPECT_EQ(events[0]->uid, QLatin1String("single"));
+
+    // Changing the categories re-files the event
+    auto moved = std::make_shared<Core::CalendarEvent>(*single);
+    moved->categories = {QLatin1String("work")};
+    ASSERT_TRUE(backend.updateEvent(moved));
+    occurrences = backend.getOccurrencesWithCategories(QDate(2026, 1, 5), QDate(2026, 1, 12), {QLatin1String("work")});
+    EXPECT_EQ(occurrences.size(), 3);
+    EXPECT_TRUE(backend.getEventsWithCategories(QDate(2026, 1, 1), QDate(2026, 1, 31), {QLatin1String("home")}).isEmpty());
+
+    // No categories means no filter
+    EXPECT_EQ(backend.getOccurrencesWithCategories(QDate(2026, 1, 5), QDate(2026, 1, 12), {}).size(), 4);
+}
+
+TEST_F(ICSFileBackendTest, TodoCrudAndQueries)
+{
+    {
+        Local::ICSFileBackend backend(filePath);
+
+        auto overdue = std::make_shared<Core::TodoItem>();
+        overdue->uid = QLatin1String("todo-1");
+        overdue->title = QLatin1String("File taxes");
+        overdue->dueDateTime = QDateTime(QDate(2026, 1, 5), QTime(17, 0));
+        overdue->priority = 2;
+        EXPECT_TRUE(backend.createTodo(overdue));
+
+        auto today = std::make_shared<Core::TodoItem>();
+        today->uid = QLatin1String("todo-2");
+        today->title = QLatin1String("Call back");
+        today->dueDateTime = QDateTime(QDate(2026, 1, 10), QTime(15, 0));
+        today->priority = 1;
+        EXPECT_TRUE(backend.createTodo(today));
+        EXPECT_FALSE(backend.createTodo(today));
+
+        const QDateTime now(QDate(2026, 1, 10), QTime(9, 0));
+        ASSERT_EQ(backend.getOverdueTodos(now).size(), 1);
+        EXPECT_EQ(backend.getTodosDueOn(QDate(2026, 1, 10)).first()->uid, QLatin1String("todo-2"));
+        EXPECT_EQ(backend.getTopTodosByPriority(1).first()->uid, QLatin1String("todo-2"));
+
+        overdue->markCompleted();
+        EXPECT_TRUE(backend.updateTodo(overdue));
+        EXPECT_TRUE(backend.getOverdueTodos(now).isEmpty());
+        EXPECT_EQ(backend.getTodosByStatus(Core::TodoItem::Status::Completed).size(), 1);
+    }
+
+    // Todos are written to the file and indexed again on load
+    Local::ICSFileBackend backend(filePath);
+    EXPECT_EQ(backend.getTodos().size(), 2);
+    EXPECT_EQ(backend.getTodosByStatus(Core::TodoItem::Status::NeedsAction).size(), 1);
+    EXPECT_TRUE(backend.deleteTodo(QLatin1String("todo-2")));
+    EXPECT_EQ(backend.getTodo(QLatin1String("todo-2")), nullptr);
+    EXPECT_TRUE(backend.getTopTodosByPriority(5).isEmpty());
 }
 
 TEST_F(ICSFileBackendTest, InvalidOperations)
@@ -0,0 +1,207 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "backends/local/ICalParser.h"
+#include <QTimeZone>
+#include <gtest/gtest.h>
+
+using namespace PersonalCalendar;
+
+TEST(ICalParserTest, ParsesCompleteEvent)
+{
+    const QByteArray data = QByteArrayLiteral(
+        "BEGIN:VCALENDAR\r\n"
+        "VERSION:2.0\r\n"
+        "BEGIN:VTIMEZONE\r\n"
+        "TZID:Europe/Berlin\r\n"
+        "BEGIN:STANDARD\r\n"
+        "DTSTART:19701025T030000\r\n"
+        "END:STANDARD\r\n"
+        "END:VTIMEZONE\r\n"
+        "BEGIN:VEVENT\r\n"
+        "UID:event-1\r\n"
+        "SUMMARY:Weekly sync\\, team\r\n"
+        "DESCRIPTION:Line one\\nLine two is long enough to be fol\r\n"
+        " ded by the writer\r\n"
+        "DTSTART;TZID=Europe/Berlin:20260110T100000\r\n"
+        "DTEND;TZID=Europe/Berlin:20260110T110000\r\n"
+        "RRULE:FREQ=WEEKLY;INTERVAL=2;BYDAY=MO,WE;UNTIL=20261231T000000Z\r\n"
+        "EXDATE;VALUE=DATE:20260119,20260121\r\n"
+        "CATEGORIES:Work,Meeting\r\n"
+        "STATUS:TENTATIVE\r\n"
+        "PRIORITY:3\r\n"
+        "ORGANIZER:mailto:boss@example.com\r\n"
+        "ATTENDEE;CN=\"Doe, Jane\";ROLE=REQ-PARTICIPANT;PARTSTAT=ACCEPTED:mailto:jane@example.com\r\n"
+        "BEGIN:VALARM\r\n"
+        "ACTION:DISPLAY\r\n"
+        "DESCRIPTION:Reminder\r\n"
+        "TRIGGER:-PT15M\r\n"
+        "END:VALARM\r\n"
+        "END:VEVENT\r\n"
+        "END:VCALENDAR\r\n");
+
+    auto result = Local::ICalParser::parse(data);
+    ASSERT_EQ(result.events.size(), 1);
+
+    const auto &event = result.events.first();
+    EXPECT_EQ(event->uid, QLatin1String("event-1"));
+    EXPECT_EQ(event->title, QLatin1String("Weekly sync, team"));
+    EXPECT_EQ(event->description, QLatin1String("Line one\nLine two is long enough to be folded by the writer"));
+    EXPECT_EQ(event->startDateTime.timeZone(), QTimeZone("Europe/Berlin"));
+    EXPECT_EQ(event->startDateTime.time(), QTime(10, 0));
+    EXPECT_EQ(event->endDateTime.time(), QTime(11, 0));
+    EXPECT_FALSE(event->isAllDay);
+
+    EXPECT_EQ(event->recurrence.pattern, Core::Recurrence::Pattern::Weekly);
+    EXPECT_EQ(event->recurrence.interval, 2);
+    EXPECT_EQ(event->recurrence.endDate, QDate(2026, 12, 31));
+    EXPECT_EQ(event->recurrence.byDayOfWeek, (QList<int>{1, 3}));
+    EXPECT_EQ(event->recurrenceExceptions.size(), 2);
+
+    EXPECT_EQ(event->categories, (QStringList{QLatin1String("Work"), QLatin1String("Meeting")}));
+    EXPECT_EQ(event->status, Core::EventStatus::Tentative);
+    EXPECT_EQ(event->priority, 3);
+    EXPECT_EQ(event->organizer, QLatin1String("boss@example.com"));
+
+    ASSERT_EQ(event->attendees.size(), 1);
+    EXPECT_EQ(event->attendees[0].name, QLatin1String("Doe, Jane"));
+    EXPECT_EQ(event->attendees[0].email, QLatin1String("jane@example.com"));
+    EXPECT_EQ(event->attendees[0].status, QLatin1String("ACCEPTED"));
+
+    ASSERT_EQ(event->alarms.size(), 1);
+    EXPECT_EQ(event->alarms[0].minutesBefore, 15);
+    EXPECT_EQ(event->alarms[0].action, QLatin1String("DISPLAY"));
+    EXPECT_EQ(event->alarms[0].description, QLatin1String("Reminder"));
+}
+
+TEST(ICalParserTest, ParsesAllDayAndUtc)
+{
+    const QByteArray data = QByteArrayLiteral(
+        "BEGIN:VCALENDAR\n"
+        "BEGIN:VEVENT\n"
+        "UID:holiday\n"
+        "SUMMARY:Holiday\n"
+        "DTSTART;VALUE=DATE:20260501\n"
+        "DTEND;VALUE=DATE:20260502\n"
+        "END:VEVENT\n"
+        "BEGIN:VEVENT\n"
+        "UID:call\n"
+        "SUMMARY:Call\n"
+        "DTSTART:20260110T090000Z\n"
+        "DURATION:PT30M\n"
+        "END:VEVENT\n"
+        "END:VCALENDAR\n");
+
+    auto result = Local::ICalParser::parse(data);
+    ASSERT_EQ(result.events.size(), 2);
+
+    EXPECT_TRUE(result.events[0]->isAllDay);
+    EXPECT_EQ(result.events[0]->startDateTime.date(), QDate(2026, 5, 1));
+
+    EXPECT_EQ(result.events[1]->startDateTime.timeSpec(), Qt::UTC);
+    EXPECT_EQ(result.events[1]->startDateTime.secsTo(result.events[1]->endDateTime), 30 * 60);
+}
+
+TEST(ICalParserTest, DurationBeforeDtStart)
+{
+    const QByteArray data = QByteArrayLiteral(
+        "BEGIN:VCALENDAR\n"
+        "BEGIN:VEVENT\n"
+        "UID:call\n"
+        "SUMMARY:Call\n"
+        "DURATION:PT45M\n"
+        "DTSTART:20260110T090000Z\n"
+        "END:VEVENT\n"
+        "END:VCALENDAR\n");
+
+    auto result = Local::ICalParser::parse(data);
+    ASSERT_EQ(result.events.size(), 1);
+    EXPECT_EQ(result.events[0]->endDateTime, QDateTime(QDate(2026, 1, 10), QTime(9, 45), QTimeZone::UTC));
+}
+
+TEST(ICalParserTest, ParsesLegacyIsoFormat)
+{
+    const QByteArray data = QByteArrayLiteral(
+        "BEGIN:VCALENDAR\n"
+        "BEGIN:VEVENT\n"
+        "UID:legacy\n"
+        "SUMMARY:Legacy\n"
+        "DTSTART:2026-01-10T10:00:00\n"
+        "DTEND:2026-01-10T11:00:00\n"
+        "END:VEVENT\n"
+        "END:VCALENDAR\n");
+
+    auto result = Local::ICalParser::parse(data);
+    ASSERT_EQ(result.events.size(), 1);
+    EXPECT_EQ(result.events[0]->startDateTime, QDateTime(QDate(2026, 1, 10), QTime(10, 0)));
+    EXPECT_EQ(result.events[0]->endDateTime, QDateTime(QDate(2026, 1, 10), QTime(11, 0)));
+}
+
+TEST(ICalParserTest, RejectsOutOfRangeNumbers)
+{
+    const QByteArray data = QByteArrayLiteral(
+        "BEGIN:VCALENDAR\n"
+        "BEGIN:VEVENT\n"
+        "UID:huge\n"
+        "SUMMARY:Huge\n"
+        "DTSTART:2026x110T100000Z\n"
+        "DURATION:PT99999999999999999999S\n"
+        "RRULE:FREQ=DAILY;INTERVAL=99999999999\n"
+        "END:VEVENT\n"
+        "END:VCALENDAR\n");
+
+    auto result = Local::ICalParser::parse(data);
+    ASSERT_EQ(result.events.size(), 1);
+    EXPECT_FALSE(result.events[0]->startDateTime.isValid());
+    EXPECT_EQ(result.events[0]->recurrence.interval, 1);
+}
+
+TEST(ICalParserTest, ParsesTodosAndSkipsIncomplete)
+{
+    const QByteArray data = QByteArrayLiteral(
+        "BEGIN:VCALENDAR\n"
+        "BEGIN:VTODO\n"
+        "UID:todo-1\n"
+        "SUMMARY:Write report\n"
+        "DUE:20260115T170000\n"
+        "STATUS:IN-PROCESS\n"
+        "PERCENT-COMPLETE:40\n"
+        "PRIORITY:1\n"
+        "END:VTODO\n"
+        "BEGIN:VEVENT\n"
+        "SUMMARY:No UID\n"
+        "END:VEVENT\n"
+        "END:VCALENDAR\n");
+
+    auto result = Local::ICalParser::parse(data);
+    EXPECT_TRUE(result.events.isEmpty());
+    EXPECT_EQ(result.skippedComponents, 1);
+
+    ASSERT_EQ(result.todos.size(), 1);
+    EXPECT_EQ(result.todos[0]->status, Core::TodoItem::Status::InProcess);
+    EXPECT_EQ(result.todos[0]->percentComplete, 40);
+    EXPECT_EQ(result.todos[0]->dueDateTime, QDateTime(QDate(2026, 1, 15), QTime(17, 0)));
+}
+
+TEST(ICalParserTest, SkipsAlarmInsideTodo)
+{
+    const QByteArray data = QByteArrayLiteral(
+        "BEGIN:VCALENDAR\n"
+        "BEGIN:VTODO\n"
+        "UID:todo-1\n"
+        "SUMMARY:Write report\n"
+        "DESCRIPTION:Quarterly numbers\n"
+        "BEGIN:VALARM\n"
+        "ACTION:DISPLAY\n"
+        "DESCRIPTION:Reminder\n"
+        "TRIGGER:-PT15M\n"
+        "END:VALARM\n"
+        "PRIORITY:2\n"
+        "END:VTODO\n"
+        "END:VCALENDAR\n");
+
+    auto result = Local::ICalParser::parse(data);
+    ASSERT_EQ(result.todos.size(), 1);
+    EXPECT_EQ(result.todos[0]->description, QLatin1String("Quarterly numbers"));
+    EXPECT_EQ(result.todos[0]->priority, 2);
+}
@@ -0,0 +1,227 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "backends/local/ICalParser.h"
+#include "backends/local/ICalWriter.h"
+#include <QBuffer>
+#include <QTimeZone>
+#include <gtest/gtest.h>
+
+using namespace PersonalCalendar;
+
+class ICalWriterTest : public ::testing::Test
+{
+protected:
+    QByteArray write(const Core::CalendarEvent &event)
+    {
+        QByteArray data;
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+        {
+            Local::ICalWriter writer(&buffer);
+            writer.beginCalendar();
+            writer.writeEvent(event);
+            writer.endCalendar();
+        }
+        return data;
+    }
+};
+
+TEST_F(ICalWriterTest, RoundTripAllFields)
+{
+    Core::CalendarEvent event;
+    event.uid = QLatin1String("event-1");
+    event.title = QLatin1String("Planning; Q1, Q2");
+    event.description = QLatin1String("First line\nSecond line");
+    event.location = QLatin1String("Room 1");
+    event.startDateTime = QDateTime(QDate(2026, 1, 10), QTime(10, 0), QTimeZone::UTC);
+    event.endDateTime = QDateTime(QDate(2026, 1, 10), QTime(11, 30), QTimeZone::UTC);
+    event.status = Core::EventStatus::Cancelled;
+    event.priority = 2;
+    event.url = QLatin1String("https://example.com/meeting");
+    event.organizer = QLatin1String("boss@example.com");
+    event.attendees.append({QString(), QLatin1String("Doe, Jane"), QLatin1String("jane@example.com"),
+                            QLatin1String("CHAIR"), QLatin1String("ACCEPTED")});
+    event.categories = {QLatin1String("Work"), QLatin1String("A,B")};
+    event.recurrence.pattern = Core::Recurrence::Pattern::Weekly;
+    event.recurrence.interval = 2;
+    event.recurrence.endDate = QDate(2026, 6, 30);
+    event.recurrence.byDayOfWeek = {1, 5};
+    event.recurrenceExceptions = {QDate(2026, 1, 24)};
+    event.alarms.append(
+        {.minutesBefore = 10, .action = QLatin1String("DISPLAY"), .description = QLatin1String("Soon")});
+    event.attachment = QByteArrayLiteral("binary\x01\x02");
+
+    auto result = Local::ICalParser::parse(write(event));
+    ASSERT_EQ(result.events.size(), 1);
+    const auto &parsed = *result.events.first();
+
+    EXPECT_EQ(parsed.title, event.title);
+    EXPECT_EQ(parsed.description, event.description);
+    EXPECT_EQ(parsed.location, event.location);
+    EXPECT_EQ(parsed.startDateTime, event.startDateTime);
+    EXPECT_EQ(parsed.endDateTime, event.endDateTime);
+    EXPECT_EQ(parsed.status, event.status);
+    EXPECT_EQ(parsed.priority, event.priority);
+    EXPECT_EQ(parsed.url, event.url);
+    EXPECT_EQ(parsed.organizer, event.organizer);
+    ASSERT_EQ(parsed.attendees.size(), 1);
+    EXPECT_EQ(parsed.attendees[0].name, QLatin1String("Doe, Jane"));
+    EXPECT_EQ(parsed.attendees[0].role, QLatin1String("CHAIR"));
+    EXPECT_EQ(parsed.categories, event.categories);
+    EXPECT_EQ(parsed.recurrence.pattern, event.recurrence.pattern);
+    EXPECT_EQ(parsed.recurrence.interval, 2);
+    EXPECT_EQ(parsed.recurrence.endDate, event.recurrence.endDate);
+    EXPECT_EQ(parsed.recurrence.byDayOfWeek, event.recurrence.byDayOfWeek);
+    EXPECT_EQ(parsed.recurrenceExceptions, event.recurrenceExceptions);
+    ASSERT_EQ(parsed.alarms.size(), 1);
+    EXPECT_EQ(parsed.alarms[0].minutesBefore, 10);
+    EXPECT_EQ(parsed.attachment, event.attachment);
+}
+
+TEST_F(ICalWriterTest, RoundTripRecurrenceRuleParts)
+{
+    Core::CalendarEvent event;
+    event.uid = QLatin1String("event-rrule");
+    event.title = QLatin1String("Board meeting");
+    event.startDateTime = QDateTime(QDate(2026, 1, 26), QTime(9, 0), QTimeZone::UTC);
+    event.endDateTime = QDateTime(QDate(2026, 1, 26), QTime(10, 0), QTimeZone::UTC);
+    event.recurrence.pattern = Core::Recurrence::Pattern::Yearly;
+    event.recurrence.count = 10;
+    event.recurrence.weekStart = 7;
+    event.recurrence.byMonth = {QLatin1String("1"), QLatin1String("7")};
+    event.recurrence.byDayOfWeek = {1, 5};
+    event.recurrence.byDayOrdinal = {-1, 0};
+    event.recurrence.bySetPos = {1, -1};
+    event.recurrence.byYearDay = {1, -1};
+    event.recurrence.byWeekNo = {20};
+    event.recurrenceDates = {QDateTime(QDate(2026, 3, 2), QTime(14, 0), QTimeZone::UTC)};
+
+    const QByteArray data = write(event);
+    EXPECT_TRUE(data.contains("BYDAY=-1MO,FR"));
+
+    auto result = Local::ICalParser::parse(data);
+    ASSERT_EQ(result.events.size(), 1);
+    const auto &parsed = result.events.first()->recurrence;
+
+    EXPECT_EQ(parsed.count, 10);
+    EXPECT_EQ(parsed.weekStart, 7);
+    EXPECT_EQ(parsed.byMonth, event.recurrence.byMonth);
+    EXPECT_EQ(parsed.byDayOfWeek, event.recurrence.byDayOfWeek);
+    EXPECT_EQ(parsed.byDayOrdinal, event.recurrence.byDayOrdinal);
+    EXPECT_EQ(parsed.bySetPos, event.recurrence.bySetPos);
+    EXPECT_EQ(parsed.byYearDay, event.recurrence.byYearDay);
+    EXPECT_EQ(parsed.byWeekNo, event.recurrence.byWeekNo);
+    EXPECT_EQ(result.events.first()->recurrenceDates, event.recurrenceDates);
+}
+
+TEST_F(ICalWriterTest, RoundTripAlarmTriggers)
+{
+    const QByteArray data = QByteArrayLiteral(
+        "BEGIN:VCALENDAR\r\n"
+        "BEGIN:VEVENT\r\n"
+        "UID:alarms\r\n"
+        "SUMMARY:Alarms\r\n"
+        "DTSTART:20260110T100000Z\r\n"
+        "DTEND:20260110T110000Z\r\n"
+        "BEGIN:VALARM\r\nACTION:DISPLAY\r\nTRIGGER:PT1M\r\nEND:VALARM\r\n"
+        "BEGIN:VALARM\r\nACTION:DISPLAY\r\nTRIGGER;RELATED=END:-PT10M\r\nEND:VALARM\r\n"
+        "BEGIN:VALARM\r\nACTION:DISPLAY\r\nTRIGGER;VALUE=DATE-TIME:20260109T180000Z\r\nEND:VALARM\r\n"
+        "BEGIN:VALARM\r\nACTION:DISPLAY\r\nTRIGGER;X-VENDOR=1:soon\r\nEND:VALARM\r\n"
+        "END:VEVENT\r\n"
+        "END:VCALENDAR\r\n");
+
+    auto result = Local::ICalParser::parse(data);
+    ASSERT_EQ(result.events.size(), 1);
+    const auto alarms = result.events[0]->alarms;
+    ASSERT_EQ(alarms.size(), 4);
+    EXPECT_EQ(alarms[0].minutesBefore, -1); // One minute after the start, not "no trigger"
+    EXPECT_EQ(alarms[1].minutesBefore, 10);
+    EXPECT_TRUE(alarms[1].relatedToEnd);
+    EXPECT_EQ(alarms[2].triggerTime, QDateTime(QDate(2026, 1, 9), QTime(18, 0), QTimeZone::UTC));
+    EXPECT_FALSE(alarms[3].hasTrigger());
+
+    const QByteArray written = write(*result.events[0]);
+    EXPECT_TRUE(written.contains("TRIGGER:PT1M\r\n"));
+    EXPECT_TRUE(written.contains("TRIGGER;RELATED=END:-PT10M\r\n"));
+    EXPECT_TRUE(written.contains("TRIGGER;VALUE=DATE-TIME:20260109T180000Z\r\n"));
+    EXPECT_TRUE(written.contains("TRIGGER;X-VENDOR=1:soon\r\n"));
+}
+
+TEST_F(ICalWriterTest, AllDayEvent)
+{
+    Core::CalendarEvent event;
+    event.uid = QLatin1String("holiday");
+    event.title = QLatin1String("Holiday");
+    event.isAllDay = true;
+    event.startDateTime = QDateTime(QDate(2026, 5, 1), QTime(0, 0));
+    event.endDateTime = QDateTime(QDate(2026, 5, 2), QTime(0, 0));
+
+    const QByteArray data = write(event);
+    EXPECT_TRUE(data.contains("DTSTART;VALUE=DATE:20260501\r\n"));
+    EXPECT_TRUE(data.contains("DTEND;VALUE=DATE:20260502\r\n"));
+
+    auto result = Local::ICalParser::parse(data);
+    ASSERT_EQ(result.events.size(), 1);
+    EXPECT_TRUE(result.events[0]->isAllDay);
+    EXPECT_EQ(result.events[0]->startDateTime.date(), QDate(2026, 5, 1));
+    EXPECT_EQ(result.events[0]->endDateTime.date(), QDate(2026, 5, 2));
+
+    // An end on the start date would be an empty day; it is written as one whole day
+    event.endDateTime = QDateTime(QDate(2026, 5, 1), QTime(23, 59));
+    EXPECT_TRUE(write(event).contains("DTEND;VALUE=DATE:20260502\r\n"));
+}
+
+TEST_F(ICalWriterTest, FreeBusyComponent)
+{
+    Core::FreeBusy freeBusy;
+    freeBusy.start = QDateTime(QDate(2026, 1, 10), QTime(8, 0), QTimeZone::UTC);
+    freeBusy.end = QDateTime(QDate(2026, 1, 10), QTime(18, 0), QTimeZone::UTC);
+    const qint64 nine = QDateTime(QDate(2026, 1, 10), QTime(9, 0), QTimeZone::UTC).toSecsSinceEpoch();
+    freeBusy.periods = {{nine, nine + 1800, Core::BusyPeriod::Type::Busy},
+                        {nine + 1800, nine + 3600, Core::BusyPeriod::Type::Tentative}};
+
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    {
+        Local::ICalWriter writer(&buffer);
+        writer.beginCalendar();
+        writer.writeFreeBusy(freeBusy, QLatin1String("fb-1"), QLatin1String("me@example.com"));
+        writer.endCalendar();
+    }
+
+    EXPECT_TRUE(data.contains("BEGIN:VFREEBUSY\r\nUID:fb-1\r\n"));
+    EXPECT_TRUE(data.contains("ORGANIZER:mailto:me@example.com\r\n"));
+    EXPECT_TRUE(data.contains("DTSTART:20260110T080000Z\r\nDTEND:20260110T180000Z\r\n"));
+    EXPECT_TRUE(data.contains("FREEBUSY;FBTYPE=BUSY:20260110T090000Z/20260110T093000Z\r\n"));
+    EXPECT_TRUE(data.contains("FREEBUSY;FBTYPE=BUSY-TENTATIVE:20260110T093000Z/20260110T100000Z\r\n"));
+    EXPECT_TRUE(data.contains("END:VFREEBUSY\r\n"));
+}
+
+TEST_F(ICalWriterTest, FoldsLongLinesWithoutSplittingUtf8)
+{
+    Core::CalendarEvent event;
+    event.uid = QLatin1String("long");
+    event.title = QLatin1String("Long");
+    event.startDateTime = QDateTime(QDate(2026, 1, 10), QTime(10, 0));
+    event.endDateTime = event.startDateTime.addSecs(3600);
+    event.description = QString(200, QChar(0x65E5)); // 每个字符 3 个 UTF-8 字节
+
+    const QByteArray data = write(event);
+    for (const QByteArray &line : data.split('\n')) {
+        QByteArray content = line;
+        if (content.endsWith('\r')) {
+            content.chop(1);
+        }
+        EXPECT_LE(content.size(), 75);
+        // 续行在前导空格之后不能以 UTF-8 延续字节开头
+        if (content.startsWith(' ') && content.size() > 1) {
+            EXPECT_NE(static_cast<uchar>(content[1]) & 0xC0, 0x80);
+        }
+    }
+
+    auto result = Local::ICalParser::parse(data);
+    ASSERT_EQ(result.events.size(), 1);
+    EXPECT_EQ(result.events[0]->description, event.description);
+}
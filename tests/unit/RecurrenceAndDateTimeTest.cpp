@@ -77,6 +77,86 @@ TEST_F(RecurrenceCalculatorTest, NextOccurrence)
     EXPECT_EQ(nextAfter, QDate(2026, 1, 8));
 }
 
+TEST_F(RecurrenceCalculatorTest, SkipsAheadToDistantRange)
+{
+    event.uid = QLatin1String("event-5");
+    event.title = QLatin1String("Old Series");
+    event.startDateTime = QDateTime(QDate(2016, 1, 31), QTime(9, 0));
+    event.endDateTime = QDateTime(QDate(2016, 1, 31), QTime(10, 0));
+
+    event.recurrence.pattern = Recurrence::Pattern::Monthly;
+    event.recurrence.interval = 1;
+
+    // Months without a 31st are skipped (RFC 5545) and the series does not drift to the 28th
+    auto instances = RecurrenceCalculator::calculateInstances(event, QDate(2026, 2, 1), QDate(2026, 3, 31));
+    ASSERT_EQ(instances.size(), 1);
+    EXPECT_EQ(instances[0], QDateTime(QDate(2026, 3, 31), QTime(9, 0)));
+
+    event.recurrence.pattern = Recurrence::Pattern::Weekly;
+    event.recurrence.interval = 2;
+    event.recurrenceExceptions = {QDate(2026, 1, 18)};
+
+    // 2016-01-31 is a Sunday; every other Sunday lands on 2026-01-04, 01-18, 02-01
+    EXPECT_EQ(RecurrenceCalculator::getNextOccurrence(event, QDate(2026, 1, 5)), QDate(2026, 2, 1));
+    EXPECT_EQ(RecurrenceCalculator::getPreviousOccurrence(event, QDate(2026, 2, 1)), QDate(2026, 1, 4));
+}
+
+TEST_F(RecurrenceCalculatorTest, OccurrenceCount)
+{
+    event.uid = QLatin1String("event-6");
+    event.title = QLatin1String("Daily Event");
+    event.startDateTime = QDateTime(QDate(2016, 1, 1), QTime(8, 0));
+    event.endDateTime = QDateTime(QDate(2016, 1, 1), QTime(8, 30));
+
+    event.recurrence.pattern = Recurrence::Pattern::Daily;
+    event.recurrence.interval = 1;
+    event.recurrenceExceptions = {QDate(2026, 3, 1), QDate(2026, 3, 1), QDate(2015, 6, 1)};
+
+    EXPECT_EQ(RecurrenceCalculator::occurrenceCount(event, QDate(2026, 1, 1), QDate(2026, 12, 31)), 364);
+    EXPECT_EQ(RecurrenceCalculator::occurrenceCount(event, QDate(2010, 1, 1), QDate(2015, 12, 31)), 0);
+
+    event.recurrence.pattern = Recurrence::Pattern::Yearly;
+    event.recurrence.endDate = QDate(2030, 1, 1);
+    EXPECT_EQ(RecurrenceCalculator::occurrenceCount(event, QDate(2020, 1, 1), QDate(2039, 12, 31)), 11);
+
+    const QDate from(2024, 5, 1);
+    const QDate to(2029, 8, 31);
+    EXPECT_EQ(RecurrenceCalculator::occurrenceCount(event, from, to),
+              RecurrenceCalculator::calculateInstances(event, from, to).size());
+}
+
+TEST_F(RecurrenceCalculatorTest, BatchOccurrencesMatchSequential)
+{
+    QList<CalendarEventPtr> events;
+    for (int i = 0; i < 300; ++i) {
+        auto series = std::make_shared<CalendarEvent>();
+        series->uid = QLatin1String("series-") + QString::number(i);
+        series->title = QLatin1String("Series");
+        series->startDateTime = QDateTime(QDate(2020, 1, 1).addDays(i), QTime(i % 24, 0));
+        series->endDateTime = series->startDateTime.addSecs(3600);
+        series->recurrence.pattern = (i % 3 == 0) ? Recurrence::Pattern::Daily : Recurrence::Pattern::Weekly;
+        series->recurrence.interval = 1 + i % 4;
+        events.append(series);
+    }
+
+    const QDate from(2026, 1, 1);
+    const QDate to(2026, 12, 31);
+
+    QList<EventOccurrence> expected;
+    for (const auto &series : std::as_const(events)) {
+        expected.append(RecurrenceCalculator::calculateOccurrences(series, from, to));
+    }
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const EventOccurrence &a, const EventOccurrence &b) { return a.start < b.start; });
+
+    const auto batch = RecurrenceCalculator::calculateOccurrences(events, from, to);
+    ASSERT_EQ(batch.size(), expected.size());
+    for (qsizetype i = 0; i < batch.size(); ++i) {
+        EXPECT_EQ(batch[i].event, expected[i].event);
+        EXPECT_EQ(batch[i].start, expected[i].start);
+    }
+}
+
 // DateTime Utils Tests
 class DateTimeUtilsTest : public ::testing::Test
 {
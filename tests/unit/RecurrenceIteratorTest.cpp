@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "core/utils/RecurrenceIterator.h"
+#include <gtest/gtest.h>
+
+using namespace PersonalCalendar::Core;
+
+class RecurrenceIteratorTest : public ::testing::Test
+{
+protected:
+    QList<QDate> take(RecurrenceIterator &iterator, int n)
+    {
+        QList<QDate> dates;
+        for (int i = 0; i < n; ++i) {
+            const QDateTime instance = iterator.next();
+            if (!instance.isValid()) {
+                break;
+            }
+            dates.append(instance.date());
+        }
+        return dates;
+    }
+
+    Recurrence rule;
+};
+
+TEST_F(RecurrenceIteratorTest, LastWeekdayOfMonth)
+{
+    rule.pattern = Recurrence::Pattern::Monthly;
+    rule.byDayOfWeek = {1, 2, 3, 4, 5};
+    rule.bySetPos = {-1};
+    rule.count = 3;
+
+    RecurrenceIterator iterator(rule, QDateTime(QDate(2026, 1, 30), QTime(17, 0)));
+    EXPECT_EQ(take(iterator, 10), (QList<QDate>{QDate(2026, 1, 30), QDate(2026, 2, 27), QDate(2026, 3, 31)}));
+    EXPECT_FALSE(iterator.next().isValid());
+}
+
+TEST_F(RecurrenceIteratorTest, OrdinalWeekday)
+{
+    // Second Monday of every month
+    rule.pattern = Recurrence::Pattern::Monthly;
+    rule.byDayOfWeek = {1};
+    rule.byDayOrdinal = {2};
+
+    RecurrenceIterator iterator(rule, QDateTime(QDate(2026, 1, 12), QTime(9, 0)));
+    EXPECT_EQ(take(iterator, 3), (QList<QDate>{QDate(2026, 1, 12), QDate(2026, 2, 9), QDate(2026, 3, 9)}));
+}
+
+TEST_F(RecurrenceIteratorTest, ExceptionsConsumeCount)
+{
+    rule.pattern = Recurrence::Pattern::Daily;
+    rule.count = 5;
+
+    RecurrenceIterator iterator(rule, QDateTime(QDate(2026, 1, 1), QTime(8, 0)), {QDate(2026, 1, 3)});
+    EXPECT_EQ(take(iterator, 10),
+              (QList<QDate>{QDate(2026, 1, 1), QDate(2026, 1, 2), QDate(2026, 1, 4), QDate(2026, 1, 5)}));
+}
+
+TEST_F(RecurrenceIteratorTest, RecurrenceDatesMerged)
+{
+    rule.pattern = Recurrence::Pattern::Weekly;
+    rule.count = 3;
+
+    const QDateTime start(QDate(2026, 1, 5), QTime(9, 0));
+    RecurrenceIterator iterator(rule, start, {},
+                                {QDateTime(QDate(2026, 1, 12), QTime(9, 0)), QDateTime(QDate(2026, 1, 7), QTime(14, 0))});
+
+    EXPECT_EQ(iterator.next(), start);
+    EXPECT_EQ(iterator.next(), QDateTime(QDate(2026, 1, 7), QTime(14, 0)));
+    EXPECT_EQ(iterator.next(), QDateTime(QDate(2026, 1, 12), QTime(9, 0)));
+    EXPECT_EQ(iterator.next(), QDateTime(QDate(2026, 1, 19), QTime(9, 0)));
+    EXPECT_FALSE(iterator.next().isValid());
+}
+
+TEST_F(RecurrenceIteratorTest, SkipToAndResume)
+{
+    // Tuesdays and Thursdays since 2010
+    rule.pattern = Recurrence::Pattern::Weekly;
+    rule.byDayOfWeek = {2, 4};
+
+    RecurrenceIterator iterator(rule, QDateTime(QDate(2010, 1, 5), QTime(18, 0)));
+    iterator.skipTo(QDate(2026, 1, 1));
+    EXPECT_EQ(take(iterator, 2), (QList<QDate>{QDate(2026, 1, 1), QDate(2026, 1, 6)}));
+
+    const RecurrenceIterator::Cursor cursor = iterator.cursor();
+    const QList<QDate> expected = take(iterator, 3);
+
+    RecurrenceIterator resumed(rule, QDateTime(QDate(2010, 1, 5), QTime(18, 0)));
+    resumed.restore(cursor);
+    EXPECT_EQ(take(resumed, 3), expected);
+    EXPECT_EQ(expected.first(), QDate(2026, 1, 8));
+}
+
+TEST_F(RecurrenceIteratorTest, WeekNumbersCrossYearBoundary)
+{
+    // Monday of ISO week 1 can fall in the previous December
+    rule.pattern = Recurrence::Pattern::Yearly;
+    rule.byWeekNo = {1};
+    rule.byDayOfWeek = {1};
+
+    RecurrenceIterator iterator(rule, QDateTime(QDate(2025, 12, 29), QTime(9, 0)));
+    EXPECT_EQ(take(iterator, 3), (QList<QDate>{QDate(2025, 12, 29), QDate(2027, 1, 4), QDate(2028, 1, 3)}));
+}
+
+TEST_F(RecurrenceIteratorTest, UnmatchableRuleTerminates)
+{
+    rule.pattern = Recurrence::Pattern::Yearly;
+    rule.byMonth = {QLatin1String("2")};
+    rule.byDayOfMonth = {30};
+
+    RecurrenceIterator iterator(rule, QDateTime(QDate(2026, 1, 1), QTime(9, 0)));
+    EXPECT_EQ(iterator.next().date(), QDate(2026, 1, 1)); // DTSTART is always an instance
+    EXPECT_FALSE(iterator.next().isValid());
+}
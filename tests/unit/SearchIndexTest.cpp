@@ -0,0 +1,102 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "backends/local/SearchIndex.h"
+#include <gtest/gtest.h>
+
+using namespace PersonalCalendar;
+
+class SearchIndexTest : public ::testing::Test
+{
+protected:
+    Core::CalendarEventPtr makeEvent(const QString &uid, const QString &title, const QString &location = QString(),
+                                     const QDate &date = QDate(2026, 1, 10))
+    {
+        auto event = std::make_shared<Core::CalendarEvent>();
+        event->uid = uid;
+        event->title = title;
+        event->location = location;
+        event->startDateTime = QDateTime(date, QTime(10, 0));
+        event->endDateTime = QDateTime(date, QTime(11, 0));
+        return event;
+    }
+
+    QStringList search(const QString &text, const QDate &start = QDate(), const QDate &end = QDate())
+    {
+        Core::SearchQuery query;
+        query.text = text;
+        query.start = start;
+        query.end = end;
+        const auto results = Core::ICalendarStorage::rankAndPage(index.search(query), 0, 100);
+
+        QStringList uids;
+        for (const auto &hit : results.hits) {
+            uids.append(hit.event->uid);
+        }
+        return uids;
+    }
+
+    Local::SearchIndex index;
+};
+
+TEST_F(SearchIndexTest, CaseAndAccentFolded)
+{
+    index.insert(makeEvent(QLatin1String("cafe"), QStringLiteral("Café with Zoë")));
+
+    EXPECT_EQ(search(QLatin1String("CAFE")), QStringList{QLatin1String("cafe")});
+    EXPECT_EQ(search(QLatin1String("zoe")), QStringList{QLatin1String("cafe")});
+    EXPECT_EQ(search(QStringLiteral("Zoë")), QStringList{QLatin1String("cafe")});
+}
+
+TEST_F(SearchIndexTest, PrefixAndInfixMatches)
+{
+    index.insert(makeEvent(QLatin1String("standup"), QLatin1String("Daily standup")));
+    index.insert(makeEvent(QLatin1String("handover"), QLatin1String("Shift handover")));
+
+    EXPECT_EQ(search(QLatin1String("stand")), QStringList{QLatin1String("standup")});
+    EXPECT_EQ(search(QLatin1String("and")), (QStringList{QLatin1String("handover"), QLatin1String("standup")}));
+    EXPECT_TRUE(search(QLatin1String("an")).isEmpty()); // Infix needs three characters
+}
+
+TEST_F(SearchIndexTest, AllTokensMustMatchAndTitleRanksFirst)
+{
+    index.insert(makeEvent(QLatin1String("in-title"), QLatin1String("Berlin trip"), QLatin1String("Airport")));
+    index.insert(makeEvent(QLatin1String("in-location"), QLatin1String("Flight"), QLatin1String("Berlin airport")));
+    index.insert(makeEvent(QLatin1String("other"), QLatin1String("Berlin dinner")));
+
+    EXPECT_EQ(search(QLatin1String("berlin air")),
+              (QStringList{QLatin1String("in-title"), QLatin1String("in-location")}));
+}
+
+TEST_F(SearchIndexTest, HanCharactersAreTokens)
+{
+    index.insert(makeEvent(QLatin1String("meeting"), QStringLiteral("项目周会")));
+
+    EXPECT_EQ(search(QStringLiteral("周会")), QStringList{QLatin1String("meeting")});
+    EXPECT_TRUE(search(QStringLiteral("年会")).isEmpty());
+}
+
+TEST_F(SearchIndexTest, DateRangeFilter)
+{
+    index.insert(makeEvent(QLatin1String("old"), QLatin1String("Review"), QString(), QDate(2016, 5, 1)));
+    index.insert(makeEvent(QLatin1String("new"), QLatin1String("Review"), QString(), QDate(2026, 5, 1)));
+
+    EXPECT_EQ(search(QLatin1String("review")), (QStringList{QLatin1String("new"), QLatin1String("old")}));
+    EXPECT_EQ(search(QLatin1String("review"), QDate(2026, 1, 1), QDate(2026, 12, 31)),
+              QStringList{QLatin1String("new")});
+}
+
+TEST_F(SearchIndexTest, UpdateAndRemove)
+{
+    auto event = makeEvent(QLatin1String("e"), QLatin1String("Dentist"));
+    index.insert(event);
+
+    event->title = QLatin1String("Doctor");
+    index.insert(event);
+    EXPECT_TRUE(search(QLatin1String("dentist")).isEmpty());
+    EXPECT_EQ(search(QLatin1String("doc")), QStringList{QLatin1String("e")});
+
+    index.remove(QLatin1String("e"));
+    EXPECT_TRUE(search(QLatin1String("doc")).isEmpty());
+    EXPECT_EQ(index.size(), 0);
+}
@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "backends/local/ICSFileBackend.h"
+#include "backends/local/SnapshotCache.h"
+#include <QFile>
+#include <QTemporaryDir>
+#include <gtest/gtest.h>
+
+using namespace PersonalCalendar;
+
+class SnapshotCacheTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(tempDir.isValid());
+        icsPath = tempDir.filePath(QLatin1String("calendar.ics"));
+        snapshotPath = tempDir.filePath(QLatin1String("cache/calendar.bin"));
+    }
+
+    Core::CalendarEventPtr createTestEvent(const QString &uid, const QString &title)
+    {
+        auto event = std::make_shared<Core::CalendarEvent>();
+        event->uid = uid;
+        event->title = title;
+        event->startDateTime = QDateTime(QDate(2026, 1, 10), QTime(10, 0));
+        event->endDateTime = QDateTime(QDate(2026, 1, 10), QTime(11, 0));
+        return event;
+    }
+
+    QTemporaryDir tempDir;
+    QString icsPath;
+    QString snapshotPath;
+};
+
+TEST_F(SnapshotCacheTest, RoundTrip)
+{
+    {
+        Local::ICSFileBackend backend(icsPath);
+        auto event = createTestEvent(QLatin1String("standup"), QLatin1String("Standup"));
+        event->recurrence.pattern = Core::Recurrence::Pattern::Weekly;
+        event->recurrence.byDayOfWeek = {1, 3};
+        event->categories = {QLatin1String("work")};
+        event->attendees.append(Core::Attendee{QString(), QLatin1String("Ann"), QLatin1String("ann@example.com"),
+                                               QLatin1String("CHAIR"), QLatin1String("ACCEPTED")});
+        event->alarms.append(
+            Core::Alarm{.minutesBefore = 15, .action = QLatin1String("DISPLAY"), .description = QLatin1String("Soon")});
+        backend.createEvent(event);
+    }
+
+    Local::ICSFileBackend parsed(icsPath);
+    auto expected = parsed.getEvent(QLatin1String("standup"));
+    ASSERT_TRUE(expected != nullptr);
+    ASSERT_TRUE(Local::SnapshotCache::write(snapshotPath, icsPath, {expected}, {}));
+
+    Local::ICalParser::Result result;
+    ASSERT_TRUE(Local::SnapshotCache::read(snapshotPath, icsPath, result));
+    ASSERT_EQ(result.events.size(), 1);
+    const auto &event = *result.events.first();
+    EXPECT_EQ(event.title, QLatin1String("Standup"));
+    EXPECT_EQ(event.startDateTime, expected->startDateTime);
+    EXPECT_EQ(event.recurrence.byDayOfWeek, expected->recurrence.byDayOfWeek);
+    EXPECT_EQ(event.categories, expected->categories);
+    ASSERT_EQ(event.attendees.size(), 1);
+    EXPECT_EQ(event.attendees.first().email, QLatin1String("ann@example.com"));
+    ASSERT_EQ(event.alarms.size(), 1);
+    EXPECT_EQ(event.alarms.first().minutesBefore, 15);
+}
+
+TEST_F(SnapshotCacheTest, StaleSnapshotRejected)
+{
+    {
+        Local::ICSFileBackend backend(icsPath, snapshotPath);
+        backend.createEvent(createTestEvent(QLatin1String("a"), QLatin1String("A")));
+    }
+    EXPECT_TRUE(QFile::exists(snapshotPath));
+
+    Local::ICalParser::Result result;
+    EXPECT_TRUE(Local::SnapshotCache::read(snapshotPath, icsPath, result));
+    EXPECT_EQ(result.events.size(), 1);
+
+    // Edit the text file behind the snapshot's back
+    {
+        Local::ICSFileBackend backend(icsPath);
+        backend.createEvent(createTestEvent(QLatin1String("b"), QLatin1String("B")));
+    }
+    EXPECT_FALSE(Local::SnapshotCache::read(snapshotPath, icsPath, result));
+
+    // A backend falls back to the text file and refreshes the snapshot
+    Local::ICSFileBackend backend(icsPath, snapshotPath);
+    EXPECT_TRUE(backend.getEvent(QLatin1String("b")) != nullptr);
+    EXPECT_TRUE(Local::SnapshotCache::read(snapshotPath, icsPath, result));
+    EXPECT_EQ(result.events.size(), 2);
+}
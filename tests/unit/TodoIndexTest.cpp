@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "backends/local/TodoIndex.h"
+#include <QTimeZone>
+#include <gtest/gtest.h>
+
+using namespace PersonalCalendar;
+
+class TodoIndexTest : public ::testing::Test
+{
+protected:
+    Core::TodoItemPtr makeTodo(const QString &uid, int dueDay, int priority = 0,
+                               Core::TodoItem::Status status = Core::TodoItem::Status::NeedsAction)
+    {
+        auto todo = std::make_shared<Core::TodoItem>();
+        todo->uid = uid;
+        todo->title = uid;
+        if (dueDay > 0) {
+            todo->dueDateTime = QDateTime(QDate(2026, 1, dueDay), QTime(12, 0), QTimeZone::UTC);
+        }
+        todo->priority = priority;
+        todo->status = status;
+        return todo;
+    }
+
+    qint64 day(int d) const { return QDateTime(QDate(2026, 1, d), QTime(0, 0), QTimeZone::UTC).toSecsSinceEpoch(); }
+
+    QStringList uids(const QList<Core::TodoItemPtr> &todos) const
+    {
+        QStringList result;
+        for (const auto &todo : todos) {
+            result.append(todo->uid);
+        }
+        return result;
+    }
+
+    Local::TodoIndex index;
+};
+
+TEST_F(TodoIndexTest, OverdueSkipsClosedTodos)
+{
+    index.insert(makeTodo(QLatin1String("b"), 5));
+    index.insert(makeTodo(QLatin1String("a"), 3));
+    index.insert(makeTodo(QLatin1String("done"), 2, 0, Core::TodoItem::Status::Completed));
+    index.insert(makeTodo(QLatin1String("dropped"), 2, 0, Core::TodoItem::Status::Cancelled));
+    index.insert(makeTodo(QLatin1String("later"), 20));
+    index.insert(makeTodo(QLatin1String("undated"), 0));
+
+    EXPECT_EQ(uids(index.overdue(day(10))), (QStringList{QLatin1String("a"), QLatin1String("b")}));
+}
+
+TEST_F(TodoIndexTest, DueBetweenIsHalfOpen)
+{
+    index.insert(makeTodo(QLatin1String("open"), 10));
+    index.insert(makeTodo(QLatin1String("done"), 10, 0, Core::TodoItem::Status::Completed));
+    index.insert(makeTodo(QLatin1String("next"), 11));
+
+    EXPECT_EQ(uids(index.dueBetween(day(10), day(11))), (QStringList{QLatin1String("done"), QLatin1String("open")}));
+    EXPECT_TRUE(index.dueBetween(day(11), day(11)).isEmpty());
+}
+
+TEST_F(TodoIndexTest, TopByPriority)
+{
+    index.insert(makeTodo(QLatin1String("undefined"), 1, 0));
+    index.insert(makeTodo(QLatin1String("low"), 1, 9));
+    index.insert(makeTodo(QLatin1String("high-late"), 20, 1));
+    index.insert(makeTodo(QLatin1String("high-early"), 5, 1));
+    index.insert(makeTodo(QLatin1String("high-undated"), 0, 1));
+    index.insert(makeTodo(QLatin1String("high-done"), 1, 1, Core::TodoItem::Status::Completed));
+
+    EXPECT_EQ(uids(index.topByPriority(4)), (QStringList{QLatin1String("high-early"), QLatin1String("high-late"),
+                                                        QLatin1String("high-undated"), QLatin1String("low")}));
+    EXPECT_EQ(index.topByPriority(10).size(), 5);
+}
+
+TEST_F(TodoIndexTest, EditedInPlaceIsRefiled)
+{
+    auto todo = makeTodo(QLatin1String("task"), 3);
+    index.insert(todo);
+    ASSERT_EQ(index.overdue(day(10)).size(), 1);
+
+    // The caller mutates the shared item before handing it back
+    todo->markCompleted();
+    todo->dueDateTime = QDateTime(QDate(2026, 1, 15), QTime(12, 0), QTimeZone::UTC);
+    index.insert(todo);
+
+    EXPECT_TRUE(index.overdue(day(10)).isEmpty());
+    EXPECT_TRUE(index.withStatus(Core::TodoItem::Status::NeedsAction).isEmpty());
+    EXPECT_EQ(index.withStatus(Core::TodoItem::Status::Completed).size(), 1);
+    EXPECT_EQ(index.dueBetween(day(15), day(16)).size(), 1);
+    EXPECT_TRUE(index.dueBetween(day(3), day(4)).isEmpty());
+
+    index.remove(QLatin1String("task"));
+    EXPECT_EQ(index.size(), 0);
+    EXPECT_TRUE(index.withStatus(Core::TodoItem::Status::Completed).isEmpty());
+}
@@ -71,6 +71,10 @@ TEST_F(TodoItemTest, IsOverdue)
     // Completed tasks are never overdue
     todo.markCompleted();
     EXPECT_FALSE(todo.isOverdue(now));
+
+    // Neither are cancelled ones
+    todo.markCancelled();
+    EXPECT_FALSE(todo.isOverdue(now));
 }
 
 TEST_F(TodoItemTest, Priorities)
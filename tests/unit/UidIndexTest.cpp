@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: 2026 Personal Calendar Project
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include "backends/local/UidIndex.h"
+#include <gtest/gtest.h>
+
+using namespace PersonalCalendar;
+
+TEST(UidIndexTest, InsertAndLookup)
+{
+    Local::UidIndex index;
+    index.insert(QLatin1String("a"), QLatin1String("work"));
+    index.insert(QLatin1String("b"), QLatin1String("home"));
+
+    EXPECT_EQ(index.size(), 2);
+    EXPECT_EQ(index.value(QLatin1String("a")), QLatin1String("work"));
+    EXPECT_EQ(index.value(QLatin1String("b")), QLatin1String("home"));
+    EXPECT_TRUE(index.value(QLatin1String("c")).isNull());
+    EXPECT_FALSE(index.contains(QLatin1String("c")));
+}
+
+TEST(UidIndexTest, InsertMovesExistingUid)
+{
+    Local::UidIndex index;
+    index.insert(QLatin1String("a"), QLatin1String("work"));
+    index.insert(QLatin1String("a"), QLatin1String("home"));
+
+    EXPECT_EQ(index.size(), 1);
+    EXPECT_EQ(index.value(QLatin1String("a")), QLatin1String("home"));
+}
+
+TEST(UidIndexTest, RemoveKeepsProbeChainsIntact)
+{
+    Local::UidIndex index;
+    for (int i = 0; i < 1000; ++i) {
+        index.insert(QLatin1String("uid-") + QString::number(i), QLatin1String("cal"));
+    }
+
+    for (int i = 0; i < 1000; i += 2) {
+        EXPECT_TRUE(index.remove(QLatin1String("uid-") + QString::number(i)));
+    }
+    EXPECT_FALSE(index.remove(QLatin1String("uid-0")));
+    EXPECT_EQ(index.size(), 500);
+
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(index.contains(QLatin1String("uid-") + QString::number(i)), i % 2 == 1) << i;
+    }
+}
+
+TEST(UidIndexTest, RemoveCalendar)
+{
+    Local::UidIndex index;
+    for (int i = 0; i < 100; ++i) {
+        index.insert(QLatin1String("uid-") + QString::number(i),
+                     i % 3 == 0 ? QLatin1String("work") : QLatin1String("home"));
+    }
+
+    index.removeCalendar(QLatin1String("work"));
+    EXPECT_EQ(index.size(), 66);
+    EXPECT_FALSE(index.contains(QLatin1String("uid-0")));
+    EXPECT_EQ(index.value(QLatin1String("uid-1")), QLatin1String("home"));
+    EXPECT_EQ(index.value(QLatin1String("uid-98")), QLatin1String("home"));
+}